@@ -0,0 +1,134 @@
+#ifndef SOMEIP_BENCH_COMMON_HPP
+#define SOMEIP_BENCH_COMMON_HPP
+
+// Minimal benchmark harness shared by the benchmark targets: auto-calibrated timing loops
+// and a JSON report so results can be tracked over time.
+
+#include "someip/metrics.hpp"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace someip {
+namespace bench {
+
+using Clock = std::chrono::steady_clock;
+
+inline Uint64 now_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count());
+}
+
+// Keep the compiler from optimizing a benchmarked value away
+template <typename T>
+inline void do_not_optimize(T const& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+struct Result {
+    std::string name;
+    Uint64 iterations = 0;
+    double ns_per_op = 0;
+    std::vector<std::pair<std::string, double>> extra;  // additional numeric fields
+};
+
+// Collects results and writes them as JSON to `--json <path>` (or stdout with `--json -`)
+class Report {
+public:
+    Report(std::string suite, int argc, char** argv) : suite_(std::move(suite)) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) json_path_ = argv[++i];
+            else if (std::strcmp(argv[i], "--quick") == 0) quick_ = true;
+        }
+    }
+
+    bool quick() const { return quick_; }
+
+    // Time `fn` (one operation per call) for roughly `min_time_ms`, after a short warm-up
+    template <typename Fn>
+    Result& run(const std::string& name, Fn&& fn, int min_time_ms = 300) {
+        if (quick_) min_time_ms = 20;
+        Uint64 iters = 1;
+        for (;;) {
+            Uint64 t0 = now_ns();
+            for (Uint64 i = 0; i < iters; ++i) fn();
+            Uint64 dt = now_ns() - t0;
+            if (dt >= Uint64(min_time_ms) * 1000000ULL || iters >= (Uint64(1) << 34)) {
+                return add(name, iters, double(dt) / double(iters));
+            }
+            iters = dt < 1000000 ? iters * 10 : iters * 2;
+        }
+    }
+
+    Result& add(const std::string& name, Uint64 iterations, double ns_per_op) {
+        results_.push_back({name, iterations, ns_per_op, {}});
+        printf("%-40s %12.1f ns/op %14.0f ops/s\n", name.c_str(), ns_per_op,
+               ns_per_op > 0 ? 1e9 / ns_per_op : 0.0);
+        return results_.back();
+    }
+
+    // Record a result measured outside run() (e.g. a load test) with custom fields only
+    Result& add_fields(const std::string& name, std::vector<std::pair<std::string, double>> fields) {
+        results_.push_back({name, 0, 0, std::move(fields)});
+        printf("%s:", name.c_str());
+        for (const auto& f : results_.back().extra) printf(" %s=%.6g", f.first.c_str(), f.second);
+        printf("\n");
+        return results_.back();
+    }
+
+    ~Report() { write_json(); }
+
+private:
+    void write_json() const {
+        if (json_path_.empty()) return;
+        FILE* out = json_path_ == "-" ? stdout : fopen(json_path_.c_str(), "w");
+        if (!out) {
+            fprintf(stderr, "[ERROR] cannot write %s\n", json_path_.c_str());
+            return;
+        }
+        auto ts = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        fprintf(out, "{\"suite\":\"%s\",\"timestamp\":%lld,\"results\":[", suite_.c_str(), (long long)ts);
+        for (size_t i = 0; i < results_.size(); ++i) {
+            const Result& r = results_[i];
+            fprintf(out, "%s\n  {\"name\":\"%s\"", i ? "," : "", r.name.c_str());
+            if (r.iterations) {
+                fprintf(out, ",\"iterations\":%llu,\"ns_per_op\":%.3f,\"ops_per_sec\":%.1f",
+                        (unsigned long long)r.iterations, r.ns_per_op, r.ns_per_op > 0 ? 1e9 / r.ns_per_op : 0.0);
+            }
+            for (const auto& f : r.extra) fprintf(out, ",\"%s\":%.6g", f.first.c_str(), f.second);
+            fprintf(out, "}");
+        }
+        fprintf(out, "\n]}\n");
+        if (out != stdout) fclose(out);
+    }
+
+    std::string suite_;
+    std::string json_path_;
+    bool quick_ = false;
+    std::vector<Result> results_;
+};
+
+// Latency summary fields (ns) for a histogram, ready for Report::add_fields
+inline std::vector<std::pair<std::string, double>> latency_fields(const metrics::LatencyHistogram& h) {
+    return {
+        {"p50_ns", double(h.percentile(0.50))},
+        {"p99_ns", double(h.percentile(0.99))},
+        {"p999_ns", double(h.percentile(0.999))},
+        {"max_ns", double(h.max())},
+    };
+}
+
+} // namespace bench
+} // namespace someip
+
+#endif // SOMEIP_BENCH_COMMON_HPP
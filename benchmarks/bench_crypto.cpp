@@ -0,0 +1,105 @@
+// AES-256-GCM throughput: the allocating encrypt() API against in-place and batch encryption
+// on a reused key schedule. Reports GB/s and the fixed per-message overhead, i.e. the time
+// left after subtracting the bulk cost of the bytes at the 64 KB throughput.
+// The secoc_* cases compare per-message verification of authentication-only SecOC tags
+// (precomputed key schedules) with one-shot Crypto::hmac_sha256 and full GCM decryption.
+#include "bench_common.hpp"
+#include "someip/crypto.hpp"
+#include "someip/secoc.hpp"
+
+using namespace someip;
+
+int main(int argc, char** argv) {
+    bench::Report report("crypto", argc, argv);
+    Crypto crypto;
+    crypto.set_key(Crypto::generate_key());
+    Payload aad(20, 0x11);
+
+    const size_t sizes[] = {65536, 1024, 64};
+    double bulk_ns_per_byte = 0;
+    for (size_t size : sizes) {
+        std::string suffix = size >= 1024 ? std::to_string(size / 1024) + "KB" : std::to_string(size) + "B";
+        auto annotate = [&](bench::Result& r, double ns_per_msg) {
+            r.extra.push_back({"bytes", double(size)});
+            r.extra.push_back({"gb_per_sec", double(size) / ns_per_msg});
+            r.extra.push_back({"overhead_ns", ns_per_msg - bulk_ns_per_byte * double(size)});
+        };
+
+        Payload buf(Crypto::OVERHEAD + size, 0x5A);
+        bench::Result& in_place = report.run("gcm_in_place_" + suffix, [&] {
+            crypto.encrypt_in_place(buf.data(), size, aad.data(), aad.size());
+            bench::do_not_optimize(buf);
+        });
+        if (size == 65536) bulk_ns_per_byte = in_place.ns_per_op / double(size);
+        annotate(in_place, in_place.ns_per_op);
+
+        const size_t batch = 32;
+        std::vector<Payload> bufs(batch, Payload(Crypto::OVERHEAD + size, 0x5A));
+        std::vector<Crypto::BufferRef> refs;
+        for (auto& p : bufs) refs.push_back({p.data(), size, false});
+        bench::Result& batched = report.run("gcm_batch32_" + suffix, [&] {
+            crypto.encrypt_batch(refs.data(), refs.size(), aad.data(), aad.size());
+            bench::do_not_optimize(bufs);
+        });
+        batched.extra.push_back({"ns_per_msg", batched.ns_per_op / batch});
+        annotate(batched, batched.ns_per_op / batch);
+
+        Payload plaintext(size, 0x5A);
+        bench::Result& legacy = report.run("gcm_optional_payload_" + suffix, [&] {
+            auto out = crypto.encrypt(plaintext, aad);
+            bench::do_not_optimize(out);
+        });
+        annotate(legacy, legacy.ns_per_op);
+
+        Payload sealed = *crypto.encrypt(plaintext, aad);
+        Payload scratch(sealed.size());
+        bench::Result& dec = report.run("gcm_decrypt_in_place_" + suffix, [&] {
+            std::copy(sealed.begin(), sealed.end(), scratch.begin());
+            crypto.decrypt_in_place(scratch.data(), scratch.size(), aad.data(), aad.size());
+            bench::do_not_optimize(scratch);
+        });
+        annotate(dec, dec.ns_per_op);
+    }
+
+    SomeIpHeader h{0x1300, 0x0010, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    SecOcProfile cmac_profile;
+    cmac_profile.key = Payload(16, 0x2B);
+    SecOcProfile hmac_profile;
+    hmac_profile.algorithm = SecOcProfile::Algorithm::HMAC_SHA256;
+    hmac_profile.key = Payload(32, 0x0B);
+    hmac_profile.mac_bytes = 8;
+    auto cmac = SecOcStage::create(cmac_profile);
+    auto hmac = SecOcStage::create(hmac_profile);
+    Payload hmac_key(32, 0x0B);
+    for (size_t size : {size_t(16), size_t(64)}) {
+        std::string suffix = std::to_string(size) + "B";
+        Payload data(size, 0x5A);
+        uint8_t mac[32];
+        Uint32 freshness = 0;
+        auto wire = [&](bench::Result& r, size_t overhead) {
+            r.extra.push_back({"bytes", double(size)});
+            r.extra.push_back({"wire_overhead", double(overhead)});
+        };
+        wire(report.run("secoc_cmac_aes128_verify_" + suffix, [&] {
+            cmac->compute_mac(h, data.data(), data.size(), ++freshness, mac);
+            bench::do_not_optimize(mac);
+        }), cmac->overhead());
+        wire(report.run("secoc_hmac_sha256_verify_" + suffix, [&] {
+            hmac->compute_mac(h, data.data(), data.size(), ++freshness, mac);
+            bench::do_not_optimize(mac);
+        }), hmac->overhead());
+        wire(report.run("hmac_sha256_oneshot_" + suffix, [&] {
+            Payload out = Crypto::hmac_sha256(hmac_key, data);
+            bench::do_not_optimize(out);
+        }), 32);
+        Payload sealed = *crypto.encrypt(data, aad);
+        Payload scratch(sealed.size());
+        wire(report.run("gcm_verify_decrypt_" + suffix, [&] {
+            std::copy(sealed.begin(), sealed.end(), scratch.begin());
+            crypto.decrypt_in_place(scratch.data(), scratch.size(), aad.data(), aad.size());
+            bench::do_not_optimize(scratch);
+        }), Crypto::OVERHEAD + 6);
+    }
+    return 0;
+}
@@ -0,0 +1,159 @@
+// Gateway forwarding cost. In process: one request forwarded and its response mapped back per
+// operation, through the Gateway (header rewrite, original buffer sent on) against parsing into
+// a SomeIpMessage and serializing again. Over UDP: request/response rate through a gateway
+// between a client and a server socket on loopback.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include "someip/gateway.hpp"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+namespace {
+
+// Transport that hands received bytes to its datagram hook and remembers what it was asked to send
+class NullTransport : public Transport {
+public:
+    bool start() override { return true; }
+    void stop() override {}
+    bool send_to(const Payload& data, const Endpoint&) override {
+        last = data.data();
+        last_len = data.size();
+        return true;
+    }
+    bool send_bytes(const uint8_t* data, size_t len, const Endpoint&) override {
+        last = data;
+        last_len = len;
+        return true;
+    }
+    bool join_multicast(const std::string&) override { return true; }
+    bool leave_multicast(const std::string&) override { return true; }
+    std::string local_ip() const override { return "10.0.0.1"; }
+    uint16_t local_port() const override { return 30501; }
+
+    bool deliver(uint8_t* data, size_t len) { return hook_ && hook_(data, len, 0x0A000002, 40000); }
+
+    const uint8_t* last = nullptr;
+    size_t last_len = 0;
+};
+
+Payload datagram(MessageType type, ClientId client, size_t payload) {
+    SomeIpHeader h{0x1300, 0x0010, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + payload), client, 1, 1, 1,
+                   static_cast<uint8_t>(type), 0};
+    Payload out = h.serialize();
+    out.resize(SomeIpHeader::SIZE + payload, 0x5A);
+    return out;
+}
+
+void in_process(bench::Report& report, size_t payload) {
+    const std::string suffix = std::to_string(payload) + "B";
+    auto clients = std::make_shared<NullTransport>();
+    auto servers = std::make_shared<NullTransport>();
+    Gateway gateway(0x7F00);
+    gateway.attach(clients);
+    GatewayRule rule;
+    rule.service = 0x1300;
+    rule.to = servers;
+    rule.dest = Endpoint("10.0.2.10", 30501);
+    gateway.add_rule(rule);
+
+    Payload request = datagram(MessageType::REQUEST, 0x0042, payload);
+    Payload response = datagram(MessageType::RESPONSE, 0x7F00, payload);
+    report.run("gateway_forward_" + suffix, [&] {
+        clients->deliver(request.data(), request.size());
+        // The server answers with the session the gateway assigned
+        response[10] = servers->last[10];
+        response[11] = servers->last[11];
+        servers->deliver(response.data(), response.size());
+        bench::do_not_optimize(clients->last);
+    });
+
+    // What a gateway on the message API does: parse, patch the header, serialize, send
+    report.run("reserialize_forward_" + suffix, [&] {
+        SomeIpMessage req = SomeIpMessage::deserialize(request.data(), request.size());
+        req.header.client_id = 0x7F00;
+        servers->send_to(req.serialize(), rule.dest);
+        SomeIpMessage res = SomeIpMessage::deserialize(response.data(), response.size());
+        res.header.client_id = 0x0042;
+        clients->send_to(res.serialize(), Endpoint("10.0.0.2", 40000));
+        bench::do_not_optimize(clients->last);
+    });
+}
+
+void over_udp(bench::Report& report, size_t count) {
+    EndpointOptions options;
+    options.rcvbuf = 4 << 20;
+    auto server = create_udp_endpoint("127.0.0.1", 32701, options);
+    auto gw_clients = create_udp_endpoint("127.0.0.1", 32702, options);
+    auto gw_servers = create_udp_endpoint("127.0.0.1", 32703, options);
+    auto client = create_udp_endpoint("127.0.0.1", 32704, options);
+    if (!server || !gw_clients || !gw_servers || !client) {
+        std::cerr << "[ERROR] cannot bind ports 32701-32704\n";
+        return;
+    }
+    ServiceRegistry registry;
+    registry.register_method(0x1300, 0x0010, [](const Payload& in, const Endpoint&) -> MethodResult {
+        return {ReturnCode::E_OK, in};
+    });
+    auto router = create_message_router(server, registry);
+    server->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) {
+        router->route(m, s, d, p);
+    });
+    Gateway gateway(0x7F00);
+    gateway.attach(gw_clients);
+    GatewayRule rule;
+    rule.service = 0x1300;
+    rule.to = gw_servers;
+    rule.dest = Endpoint("127.0.0.1", 32701);
+    gateway.add_rule(rule);
+    std::atomic<Uint64> answered{0};
+    client->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+        answered.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    // Keep a window of requests in flight
+    const Uint64 window = 32;
+    Payload request = datagram(MessageType::REQUEST, 0x0042, 64);
+    Endpoint dest("127.0.0.1", 32702);
+    Uint64 t0 = bench::now_ns();
+    Uint64 sent = 0, idle_since = 0;
+    while (answered.load(std::memory_order_relaxed) < count) {
+        Uint64 done = answered.load(std::memory_order_relaxed);
+        if (sent < count && sent - done < window) {
+            client->send_to(request, dest);
+            ++sent;
+            idle_since = 0;
+            continue;
+        }
+        Uint64 now = bench::now_ns();
+        if (!idle_since) idle_since = now;
+        if (now - idle_since > 200000000ULL) {
+            // Lost datagrams: refill the window rather than waiting forever
+            sent = done;
+            idle_since = 0;
+        }
+        std::this_thread::yield();
+    }
+    Uint64 dt = bench::now_ns() - t0;
+    Gateway::Stats stats = gateway.stats();
+    report.add_fields("udp_gateway_roundtrip_64B", {
+        {"round_trips_per_sec", double(count) * 1e9 / double(dt)},
+        {"orphaned", double(stats.orphaned)},
+        {"send_failures", double(stats.send_failures)},
+    });
+    client->stop();
+    gw_servers->stop();
+    gw_clients->stop();
+    server->stop();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("gateway", argc, argv);
+    for (size_t payload : {64, 1400}) in_process(report, payload);
+    over_udp(report, report.quick() ? 2000 : 100000);
+    return 0;
+}
@@ -0,0 +1,249 @@
+// Microbenchmarks for the per-message hot path: header (de)serialization, message
+// round-trip, handler lookup and router dispatch (without socket I/O), and buffer
+// allocation from the slab pool against std::allocator, generated (someip_idlc) record
+// codecs against hand-written SerializationBuffer code, and compile-time (StaticRegistry)
+// routing against the ServiceRegistry.
+#include "bench_common.hpp"
+#include "test_service_someip.hpp"
+#include "someip/buffer_pool.hpp"
+#include "someip/field.hpp"
+#include "someip/message_router.hpp"
+#include "someip/service.hpp"
+#include "someip/someip_message.hpp"
+#include "someip/static_registry.hpp"
+#include <utility>
+
+using namespace someip;
+
+namespace {
+
+ReturnCode reply_one(const Payload&, const Endpoint&, SerializationBuffer& out) {
+    out.write_uint8(0x01);
+    return ReturnCode::E_OK;
+}
+
+// Methods 1..N of service 0x1300, all bound to reply_one
+template <size_t... I>
+StaticService<0x1300, StaticMethod<static_cast<MethodId>(I + 1), &reply_one>...> static_methods(std::index_sequence<I...>);
+using StaticRoutes32 = StaticRegistry<decltype(static_methods(std::make_index_sequence<32>()))>;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("micro", argc, argv);
+
+    SomeIpHeader h{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH + 64, 0x0001, 0x0001, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    Payload header_bytes = h.serialize();
+    SomeIpMessage msg{h, Payload(64, 0x5A)};
+    Payload msg_bytes = msg.serialize();
+
+    report.run("header_serialize", [&] {
+        Payload out = h.serialize();
+        bench::do_not_optimize(out);
+    });
+    report.run("header_parse", [&] {
+        SomeIpHeader parsed = SomeIpHeader::deserialize(header_bytes);
+        bench::do_not_optimize(parsed);
+    });
+    report.run("message_roundtrip_64B", [&] {
+        SomeIpMessage parsed = SomeIpMessage::deserialize(msg.serialize());
+        bench::do_not_optimize(parsed);
+    });
+    report.run("message_parse_64B", [&] {
+        SomeIpMessage parsed = SomeIpMessage::deserialize(msg_bytes);
+        bench::do_not_optimize(parsed);
+    });
+
+    ServiceRegistry registry;
+    for (MethodId m = 1; m <= 32; ++m) {
+        registry.register_method(0x1300, m, [](const Payload&, const Endpoint&) -> MethodResult {
+            return {ReturnCode::E_OK, {0x01}};
+        });
+    }
+    report.run("registry_find_handler", [&] {
+        auto handler = registry.find_handler(0x1300, 0x0010);
+        bench::do_not_optimize(handler);
+    });
+
+    // No endpoint: route() runs lookup, handler and response serialization but skips sendto
+    MessageRouter router(nullptr, registry);
+    Endpoint src("127.0.0.1", 3002), dst("127.0.0.1", 3000);
+    SomeIpMessage req{SomeIpHeader{0x1300, 0x0010, SomeIpHeader::MIN_LENGTH, 0x0001, 0x0001, 1, 1,
+                                   static_cast<uint8_t>(MessageType::REQUEST), 0}, {}};
+    report.run("router_dispatch", [&] {
+        router.route(req, src, dst, TransportProtocol::UDP);
+    });
+
+    // 64-byte response: owned MethodResult payload against in-place serialization
+    registry.register_method(0x1300, 0x0040, [](const Payload&, const Endpoint&) -> MethodResult {
+        return {ReturnCode::E_OK, Payload(64, 0x5A)};
+    });
+    registry.register_method(0x1300, 0x0041, [](const Payload&, const Endpoint&, SerializationBuffer& out) {
+        static const Payload body(64, 0x5A);
+        out.write_bytes(body);
+        return ReturnCode::E_OK;
+    });
+    SomeIpMessage owned_req = req, buffer_req = req;
+    owned_req.header.method_id = 0x0040;
+    buffer_req.header.method_id = 0x0041;
+    report.run("router_dispatch_result_64B", [&] {
+        router.route(owned_req, src, dst, TransportProtocol::UDP);
+    });
+    report.run("router_dispatch_buffer_64B", [&] {
+        router.route(buffer_req, src, dst, TransportProtocol::UDP);
+    });
+
+    // The same 64-byte MethodResult response answered from the response cache
+    MessageRouter cached_router(nullptr, registry);
+    cached_router.enable_cache(0x1300, 0x0040);
+    report.run("router_dispatch_cached_64B", [&] {
+        cached_router.route(owned_req, src, dst, TransportProtocol::UDP);
+    });
+
+    // Duplicate detection: cost of tracking fresh requests, and of answering a retransmission
+    MessageRouter dedup_router(nullptr, registry);
+    dedup_router.enable_duplicate_detection();
+    SomeIpMessage fresh = owned_req;
+    report.run("router_dispatch_dedup_new_64B", [&] {
+        if (++fresh.header.session_id == 0) fresh.header.session_id = 1;
+        dedup_router.route(fresh, src, dst, TransportProtocol::UDP);
+    });
+    SomeIpMessage retry = owned_req;
+    dedup_router.route(retry, src, dst, TransportProtocol::UDP);
+    report.run("router_dispatch_dedup_retry_64B", [&] {
+        dedup_router.route(retry, src, dst, TransportProtocol::UDP);
+    });
+
+    // Getter served from a field's cached bytes
+    FieldOptions field_options;
+    field_options.getter = 0x0050;
+    Field<Uint32> field(0x1300, field_options, 42);
+    field.attach(registry, nullptr);
+    SomeIpMessage getter_req = req;
+    getter_req.header.method_id = 0x0050;
+    report.run("router_dispatch_field_getter", [&] {
+        router.route(getter_req, src, dst, TransportProtocol::UDP);
+    });
+
+    SomeIpMessage unknown = req;
+    unknown.header.method_id = 0x7FFF;
+    report.run("router_dispatch_unknown_method", [&] {
+        router.route(unknown, src, dst, TransportProtocol::UDP);
+    });
+
+    // The same 32 methods with one-byte buffer responses, looked up in the ServiceRegistry
+    // against the compile-time table
+    ServiceRegistry buffer_registry;
+    for (MethodId m = 1; m <= 32; ++m) buffer_registry.register_method(0x1300, m, BufferMethodHandler(&reply_one));
+    MessageRouter dynamic_router(nullptr, buffer_registry);
+    MessageRouter static_router(nullptr, buffer_registry);
+    static_router.set_static_routes(StaticRoutes32::routes());
+    SerializationBuffer static_out;
+    report.run("static_dispatch", [&] {
+        ReturnCode rc = ReturnCode::E_OK;
+        static_out.buf.clear();
+        bool found = StaticRoutes32::dispatch(req.header.service_id, req.header.method_id, req.payload, src, static_out, rc);
+        bench::do_not_optimize(found);
+        bench::do_not_optimize(static_out.buf.data());
+    });
+    report.run("router_dispatch_dynamic_32", [&] {
+        dynamic_router.route(req, src, dst, TransportProtocol::UDP);
+    });
+    report.run("router_dispatch_static_32", [&] {
+        static_router.route(req, src, dst, TransportProtocol::UDP);
+    });
+    // A method missing from the table pays the table probe before the registry lookup
+    SomeIpMessage dynamic_only = req;
+    dynamic_only.header.service_id = 0x1301;
+    buffer_registry.register_method(0x1301, 0x0010, BufferMethodHandler(&reply_one));
+    report.run("router_dispatch_static_fallback", [&] {
+        static_router.route(dynamic_only, src, dst, TransportProtocol::UDP);
+    });
+
+    // 45-byte record with 11 members: generated constexpr layout against the buffer classes
+    test::idl::Sample sample;
+    sample.u16 = 0x1234;
+    sample.u32 = 0x12345678;
+    sample.u64 = 42;
+    sample.f64 = 1.5;
+    sample.where.x = -3;
+    auto hand_write = [&](SerializationBuffer& sb) {
+        sb.buf.clear();
+        auto bits32 = [](float f) { Uint32 v; std::memcpy(&v, &f, 4); return v; };
+        auto bits64 = [](double d) { Uint64 v; std::memcpy(&v, &d, 8); return v; };
+        sb.write_uint8(sample.valid);
+        sb.write_uint8(sample.u8);
+        sb.write_uint16(sample.u16);
+        sb.write_uint32(sample.u32);
+        sb.write_uint32(Uint32(sample.u64 >> 32));
+        sb.write_uint32(Uint32(sample.u64));
+        sb.write_uint8(Uint8(sample.i8));
+        sb.write_uint32(Uint32(sample.i32));
+        sb.write_uint32(Uint32(Uint64(sample.i64) >> 32));
+        sb.write_uint32(Uint32(sample.i64));
+        sb.write_uint32(bits32(sample.f32));
+        sb.write_uint32(Uint32(bits64(sample.f64) >> 32));
+        sb.write_uint32(Uint32(bits64(sample.f64)));
+        sb.write_uint16(Uint16(sample.where.x));
+        sb.write_uint16(Uint16(sample.where.y));
+    };
+    SerializationBuffer sb;
+    report.run("record_encode_hand_45B", [&] {
+        hand_write(sb);
+        bench::do_not_optimize(sb.buf.data());
+    });
+    report.run("record_encode_generated_45B", [&] {
+        sb.buf.clear();
+        wire::append(sb, sample);
+        bench::do_not_optimize(sb.buf.data());
+    });
+    hand_write(sb);
+    const Payload record = sb.buf;
+    // Sink every member: handing over the whole struct measures store forwarding instead
+    auto members = [](const test::idl::Sample& v) {
+        return Uint64(v.valid) + v.u8 + v.u16 + v.u32 + v.u64 + Uint64(v.i8) + Uint64(v.i32) + Uint64(v.i64) +
+               Uint64(v.f32) + Uint64(v.f64) + Uint64(v.where.x) + Uint64(v.where.y);
+    };
+    report.run("record_decode_hand_45B", [&] {
+        DeserializationBuffer db(record);
+        test::idl::Sample out;
+        out.valid = db.read_uint8() != 0;
+        out.u8 = db.read_uint8();
+        out.u16 = db.read_uint16();
+        out.u32 = db.read_uint32();
+        out.u64 = (Uint64(db.read_uint32()) << 32) | db.read_uint32();
+        out.i8 = int8_t(db.read_uint8());
+        out.i32 = int32_t(db.read_uint32());
+        out.i64 = int64_t((Uint64(db.read_uint32()) << 32) | db.read_uint32());
+        Uint32 f32 = db.read_uint32();
+        std::memcpy(&out.f32, &f32, 4);
+        Uint64 f64 = (Uint64(db.read_uint32()) << 32) | db.read_uint32();
+        std::memcpy(&out.f64, &f64, 8);
+        out.where.x = int16_t(db.read_uint16());
+        out.where.y = int16_t(db.read_uint16());
+        bench::do_not_optimize(members(out));
+    });
+    report.run("record_decode_generated_45B", [&] {
+        test::idl::Sample out = test::idl::Sample::View(record.data(), record.size()).value();
+        bench::do_not_optimize(members(out));
+    });
+    // A view reads only what the handler touches
+    report.run("record_view_one_member_45B", [&] {
+        Uint32 v = test::idl::Sample::View(record.data(), record.size()).u32();
+        bench::do_not_optimize(v);
+    });
+
+    for (size_t size : {size_t(64), size_t(1500), size_t(16384)}) {
+        std::string suffix = std::to_string(size) + "B";
+        report.run("alloc_pool_" + suffix, [&] {
+            std::vector<uint8_t, pool::Allocator<uint8_t>> buf(size);
+            bench::do_not_optimize(buf.data());
+        });
+        report.run("alloc_std_" + suffix, [&] {
+            std::vector<uint8_t> buf(size);
+            bench::do_not_optimize(buf.data());
+        });
+    }
+    return 0;
+}
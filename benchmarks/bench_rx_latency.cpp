@@ -0,0 +1,98 @@
+// Receive-path latency on loopback: round trips between two endpoints (one echoing) with
+// blocking receive threads versus busy polling, one request in flight at a time. Reports the
+// round-trip distribution, so the tail shows the wakeup jitter each mode adds twice per trip.
+// Pass --cpu a,b to pin the client and server receive threads.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+namespace {
+
+struct Case {
+    const char* name;
+    ReceiveMode mode;
+    int so_busy_poll_us;
+};
+
+metrics::LatencyHistogram ping_pong(const Case& c, int client_cpu, int server_cpu, size_t samples, uint16_t port) {
+    EndpointOptions server_options;
+    server_options.mode = c.mode;
+    server_options.so_busy_poll_us = c.so_busy_poll_us;
+    server_options.thread.cpu = server_cpu;
+    EndpointOptions client_options = server_options;
+    client_options.thread.cpu = client_cpu;
+
+    metrics::LatencyHistogram rtt;
+    auto server = create_udp_endpoint("127.0.0.1", port, server_options);
+    auto client = create_udp_endpoint("127.0.0.1", static_cast<uint16_t>(port + 1), client_options);
+    if (!server || !client) {
+        std::cerr << "[ERROR] cannot bind ports " << port << "/" << port + 1 << "\n";
+        return rtt;
+    }
+    Endpoint server_ep("127.0.0.1", port);
+    Endpoint client_ep("127.0.0.1", static_cast<uint16_t>(port + 1));
+    server->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        SomeIpHeader h = msg.header;
+        h.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
+        server->send_to(h.serialize(), client_ep);
+    });
+    std::atomic<Uint32> answered{0};
+    client->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        answered.store(msg.header.session_id, std::memory_order_release);
+    });
+
+    SomeIpHeader request{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH, 1, 0, 1, 1,
+                         static_cast<uint8_t>(MessageType::REQUEST), 0};
+    Payload wire;
+    const size_t warmup = samples / 10;
+    for (size_t i = 0; i < warmup + samples; ++i) {
+        request.session_id = static_cast<Uint16>(i % 0xFFFF + 1);
+        wire.clear();
+        request.serialize_to(wire);
+        Uint64 t0 = bench::now_ns();
+        client->send_to(wire, server_ep);
+        Uint64 deadline = t0 + 100000000;  // a lost datagram costs 100 ms, not the whole run
+        while (answered.load(std::memory_order_acquire) != request.session_id && bench::now_ns() < deadline) {
+            // the calling thread waits like an application would: it yields rather than sleeping
+            std::this_thread::yield();
+        }
+        if (i >= warmup) rtt.record(bench::now_ns() - t0);
+    }
+    server->stop();
+    client->stop();
+    return rtt;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("rx_latency", argc, argv);
+    int client_cpu = -1, server_cpu = -1;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--cpu") {
+            client_cpu = std::atoi(argv[i + 1]);
+            const char* comma = std::strchr(argv[i + 1], ',');
+            server_cpu = comma ? std::atoi(comma + 1) : client_cpu;
+        }
+    }
+    const size_t samples = report.quick() ? 2000 : 50000;
+    const Case cases[] = {
+        {"rtt_blocking", ReceiveMode::BLOCKING, 0},
+        {"rtt_busy_poll", ReceiveMode::BUSY_POLL, 0},
+        {"rtt_blocking_so_busy_poll_50us", ReceiveMode::BLOCKING, 50},
+    };
+    uint16_t port = 4040;
+    for (const Case& c : cases) {
+        auto rtt = ping_pong(c, client_cpu, server_cpu, samples, port);
+        port = static_cast<uint16_t>(port + 2);
+        auto fields = bench::latency_fields(rtt);
+        fields.insert(fields.begin(), {"samples", double(rtt.count())});
+        report.add_fields(c.name, std::move(fields));
+    }
+    return 0;
+}
@@ -0,0 +1,112 @@
+// Simulated ECUs on a LoopbackNetwork with a virtual clock. router_*: every ECU runs a router
+// and a client keeping a window of requests outstanding to its neighbour; msgs_per_s counts
+// requests plus responses per wall-clock second. sd_*: every ECU offers one service on the SD
+// multicast group; the wall time until all have found all others.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include "someip/loopback.hpp"
+#include "someip/message_router.hpp"
+#include "someip/service_discovery.hpp"
+#include <iostream>
+
+using namespace someip;
+
+namespace {
+
+std::string ecu_ip(int i) {
+    return "10.0." + std::to_string(i / 250) + "." + std::to_string(i % 250 + 1);
+}
+
+void router_case(bench::Report& report, int ecus, int window, Uint64 total) {
+    LoopbackOptions options;
+    options.latency = std::chrono::microseconds(100);
+    auto net = LoopbackNetwork::create(options);
+    ServiceRegistry registry;
+    registry.register_method(0x1000, 0x0001, [](const Payload& p, const Endpoint&) {
+        return MethodResult{ReturnCode::E_OK, p};
+    });
+
+    struct Ecu {
+        std::shared_ptr<LoopbackEndpoint> server, client;
+        std::unique_ptr<MessageRouter> router;
+        Endpoint peer;
+        Uint16 session = 0;
+    };
+    std::vector<Ecu> nodes(ecus);
+    Uint64 sent = 0, answered = 0;
+    SomeIpHeader h{0x1000, 0x0001, SomeIpHeader::MIN_LENGTH + 16, 0x1, 0, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    auto send_request = [&](Ecu& n) {
+        if (sent >= total) return;
+        ++sent;
+        h.session_id = ++n.session;
+        Payload d;
+        h.serialize_to(d);
+        d.resize(SomeIpHeader::SIZE + 16, 0x5A);
+        n.client->send_to(d, n.peer);
+    };
+    for (int i = 0; i < ecus; ++i) {
+        Ecu& n = nodes[i];
+        n.server = net->create_endpoint(ecu_ip(i), 30501);
+        n.client = net->create_endpoint(ecu_ip(i), 40000);
+        n.router = create_message_router(n.server, registry);
+        n.peer = Endpoint(ecu_ip((i + 1) % ecus), 30501);
+        MessageRouter* router = n.router.get();
+        n.server->set_callback([router](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+            router->route(msg, src, dst, proto);
+        });
+        n.client->set_callback([&, i](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            ++answered;
+            send_request(nodes[i]);
+        });
+        n.server->start();
+        n.client->start();
+    }
+
+    Uint64 t0 = bench::now_ns();
+    for (auto& n : nodes) {
+        for (int w = 0; w < window; ++w) send_request(n);
+    }
+    net->run();
+    double seconds = double(bench::now_ns() - t0) * 1e-9;
+    report.add_fields("router_" + std::to_string(ecus) + "ecus", {
+        {"msgs_per_s", double(sent + answered) / seconds},
+        {"messages", double(sent + answered)},
+        {"virtual_ms", double(net->now_ns()) * 1e-6},
+    });
+}
+
+void sd_case(bench::Report& report, int ecus) {
+    auto net = LoopbackNetwork::create();
+    std::vector<std::unique_ptr<ServiceDiscovery>> sds;
+    Uint64 t0 = bench::now_ns();
+    for (int i = 0; i < ecus; ++i) {
+        auto sd = std::make_unique<ServiceDiscovery>();
+        sd->set_transport(net->create_endpoint(ecu_ip(i), DEFAULT_SD_PORT));
+        sd->set_offer_interval(std::chrono::milliseconds(0));
+        sd->start();
+        sd->offer_service(SdOffer{static_cast<ServiceId>(0x2000 + i), 1, ecu_ip(i), 30501, 3});
+        sds.push_back(std::move(sd));
+    }
+    net->run();
+    double seconds = double(bench::now_ns() - t0) * 1e-9;
+    size_t converged = 0;
+    for (const auto& sd : sds) converged += sd->found().size() == size_t(ecus) ? 1 : 0;
+    if (converged != size_t(ecus)) std::cerr << "[ERROR] sd: " << converged << "/" << ecus << " converged\n";
+    report.add_fields("sd_" + std::to_string(ecus) + "ecus", {
+        {"converge_ms", seconds * 1e3},
+        {"deliveries", double(net->stats().delivered)},
+        {"deliveries_per_s", double(net->stats().delivered) / seconds},
+    });
+    for (auto& sd : sds) sd->stop();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("sim", argc, argv);
+    const Uint64 total = report.quick() ? 100000 : 2000000;
+    for (int ecus : {10, 100, 500}) router_case(report, ecus, 8, total);
+    for (int ecus : {100, 300}) sd_case(report, ecus);
+    return 0;
+}
@@ -0,0 +1,78 @@
+// A port that mostly receives traffic for services it does not host: 9 of every 10 datagrams
+// are notifications of a foreign service. Without a socket filter each is queued, copied out,
+// parsed and dropped by the router; with someip_socket_filter() the kernel drops it before it
+// is queued. cpu_ns_per_datagram is the process CPU time (sender and receiver) per datagram sent.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include <atomic>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+namespace {
+
+constexpr ServiceId HOSTED = 0x1100, FOREIGN = 0x2200;
+
+Uint64 cpu_ns() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return Uint64(ts.tv_sec) * 1000000000ULL + Uint64(ts.tv_nsec);
+}
+
+void run(bench::Report& report, const std::string& name, bool filter, size_t count, uint16_t port) {
+    ServiceRegistry registry;
+    registry.register_method(HOSTED, 0x0001, [](const Payload&, const Endpoint&) { return MethodResult{}; });
+    EndpointOptions options;
+    options.rcvbuf = 4 << 20;
+    if (filter) options.socket_filter = someip_socket_filter(registry.services(), {MessageType::REQUEST});
+    auto receiver = create_udp_endpoint("127.0.0.1", port, options);
+    auto sender = create_udp_endpoint("127.0.0.1", static_cast<uint16_t>(port + 1));
+    if (!receiver || !sender) {
+        std::cerr << "[ERROR] cannot bind ports " << port << "/" << port + 1 << "\n";
+        return;
+    }
+    auto router = create_message_router(receiver, registry);
+    std::atomic<Uint64> hosted{0};
+    receiver->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol p) {
+        if (msg.header.service_id == HOSTED) hosted.fetch_add(1, std::memory_order_relaxed);
+        router->route(msg, src, dst, p);
+    });
+
+    auto datagram = [](ServiceId svc, MessageType type) {
+        SomeIpMessage msg{SomeIpHeader{svc, 0x0001, SomeIpHeader::MIN_LENGTH + 32, 0x0001, 1, 1, 1,
+                                       static_cast<uint8_t>(type), 0},
+                          Payload(32, 0x5A)};
+        return msg.serialize();
+    };
+    const Payload foreign = datagram(FOREIGN, MessageType::NOTIFICATION);
+    const Payload request = datagram(HOSTED, MessageType::REQUEST);
+    Endpoint dest("127.0.0.1", port);
+
+    Uint64 c0 = cpu_ns(), t0 = bench::now_ns();
+    for (size_t i = 0; i < count; ++i) sender->send_to(i % 10 == 9 ? request : foreign, dest);
+    Uint64 last = ~Uint64(0);
+    while (hosted.load() != last) {
+        last = hosted.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    Uint64 cpu = cpu_ns() - c0, dt = bench::now_ns() - t0;
+    report.add_fields(name, {
+        {"cpu_ns_per_datagram", double(cpu) / double(count)},
+        {"sent_pps", double(count) / (double(dt) * 1e-9)},
+        {"hosted_delivered_fraction", double(hosted.load()) / double(count / 10)},
+        {"datagrams_received", double(receiver->datagrams_received())},
+        {"socket_drops", double(receiver->socket_drops())},
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("socket_filter", argc, argv);
+    const size_t count = report.quick() ? 20000 : 400000;
+    run(report, "unfiltered", false, count, 4100);
+    run(report, "kernel_filter", true, count, 4102);
+    return 0;
+}
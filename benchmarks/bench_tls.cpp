@@ -0,0 +1,76 @@
+// TLS reconnect latency on loopback: connect + one request/response + close, with a full
+// handshake (verification cache cold and warm) and with session resumption (stateless
+// tickets and the server's session cache).
+#include "bench_common.hpp"
+#include "someip/tls_transport.hpp"
+#include <fstream>
+#include <sstream>
+
+using namespace someip;
+
+static std::string read_text(const std::string& name) {
+    std::ifstream in(std::string(SOMEIP_TEST_DATA_DIR) + "/" + name);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+int main(int argc, char** argv) {
+    bench::Report report("tls", argc, argv);
+    const int reconnects = report.quick() ? 50 : 1000;
+
+    auto server_certs = std::make_shared<CertificateManager>();
+    server_certs->load_certificate_pem(read_text("server.pem") + read_text("intermediate.pem"));
+    server_certs->load_private_key_pem(read_text("server.key"));
+    auto client_certs = std::make_shared<CertificateManager>();
+    client_certs->add_ca_certificate_pem(read_text("ca.pem"));
+
+    SomeIpHeader h{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    Payload req = SomeIpMessage{h, {}}.serialize();
+
+    struct Case {
+        const char* name;
+        bool tickets, server_cache, resume, clear_cache;
+    };
+    const Case cases[] = {
+        {"tls_reconnect_full_uncached", true, true, false, true},
+        {"tls_reconnect_full_cached", true, true, false, false},
+        {"tls_reconnect_resumed_ticket", true, false, true, false},
+        {"tls_reconnect_resumed_session_cache", false, true, true, false},
+    };
+    for (const Case& c : cases) {
+        TlsOptions opts;
+        opts.session_tickets = c.tickets;
+        opts.session_cache = c.server_cache;
+        opts.resume_sessions = c.resume;
+        opts.server_name = "127.0.0.1";
+        TlsServer server(server_certs, opts);
+        server.set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint&, TransportProtocol) {
+            server.send_to(msg.serialize(), src);
+        });
+        if (!server.start("127.0.0.1", 0)) {
+            fprintf(stderr, "[ERROR] cannot start TLS server\n");
+            return 1;
+        }
+        TlsClient client(client_certs, opts);
+        metrics::LatencyHistogram hist;
+        int failed = 0, resumed = 0;
+        for (int i = 0; i <= reconnects; ++i) {
+            if (c.clear_cache) client_certs->clear_cache();
+            Uint64 t0 = bench::now_ns();
+            bool ok = client.connect("127.0.0.1", server.local_port()) && client.send(req) && client.receive();
+            Uint64 dt = bench::now_ns() - t0;
+            resumed += client.session_resumed();
+            client.disconnect();
+            if (!ok) ++failed;
+            else if (i > 0) hist.record(dt);  // the first connection primes session and cache
+        }
+        auto fields = bench::latency_fields(hist);
+        fields.push_back({"mean_ns", hist.mean()});
+        fields.push_back({"resumed", double(resumed)});
+        fields.push_back({"failed", double(failed)});
+        report.add_fields(c.name, fields);
+    }
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Bulk notification throughput on loopback: one sendto per datagram versus send_batch (UDP
+// segmentation offload), into a receiver with and without UDP_GRO. sent_pps is the sender's
+// rate; delivered_pps counts notifications that reached the receive callback in that time.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+namespace {
+
+struct Case {
+    std::string name;
+    size_t payload;
+    bool batch;  // send_batch instead of send_to per datagram
+    bool gro;    // receiver accepts coalesced buffers
+};
+
+void run(bench::Report& report, const Case& c, size_t count, uint16_t port) {
+    EndpointOptions rx_options;
+    rx_options.gro = c.gro;
+    rx_options.rcvbuf = 4 << 20;
+    auto receiver = create_udp_endpoint("127.0.0.1", port, rx_options);
+    auto sender = create_udp_endpoint("127.0.0.1", static_cast<uint16_t>(port + 1));
+    if (!receiver || !sender) {
+        std::cerr << "[ERROR] cannot bind ports " << port << "/" << port + 1 << "\n";
+        return;
+    }
+    std::atomic<Uint64> delivered{0};
+    receiver->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+        delivered.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    // One batch of notifications of the same event, session ids counting up
+    const size_t batch_size = 64;
+    std::vector<Payload> batch(batch_size);
+    SomeIpHeader h{0x1300, 0x8030, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + c.payload), 0, 0, 1, 1,
+                   static_cast<uint8_t>(MessageType::NOTIFICATION), 0};
+    Endpoint dest("127.0.0.1", port);
+
+    Uint64 t0 = bench::now_ns();
+    size_t sent = 0;
+    for (size_t done = 0; done < count; done += batch_size) {
+        for (size_t i = 0; i < batch_size; ++i) {
+            h.session_id = static_cast<Uint16>(done + i);
+            batch[i].clear();
+            h.serialize_to(batch[i]);
+            batch[i].resize(SomeIpHeader::SIZE + c.payload, 0x5A);
+        }
+        if (c.batch) {
+            sent += sender->send_batch(batch, dest);
+        } else {
+            for (const Payload& d : batch) sent += sender->send_to(d, dest) ? 1 : 0;
+        }
+    }
+    Uint64 dt = bench::now_ns() - t0;
+    // Let the receiver drain what is still queued before counting
+    Uint64 last = ~Uint64(0);
+    while (delivered.load() != last) {
+        last = delivered.load();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    double seconds = double(dt) * 1e-9;
+    report.add_fields(c.name, {
+        {"sent_pps", double(sent) / seconds},
+        {"delivered_pps", double(delivered.load()) / seconds},
+        {"delivered_fraction", double(delivered.load()) / double(count)},
+        {"socket_drops", double(receiver->socket_drops())},
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bench::Report report("udp_batch", argc, argv);
+    const size_t count = report.quick() ? 20000 : 400000;
+    uint16_t port = 4060;
+    for (size_t payload : {48, 1000}) {
+        std::string suffix = std::to_string(payload + SomeIpHeader::SIZE) + "B";
+        for (const Case& c : {Case{"sendto_" + suffix, payload, false, false},
+                              Case{"sendto_gro_" + suffix, payload, false, true},
+                              Case{"gso_" + suffix, payload, true, false},
+                              Case{"gso_gro_" + suffix, payload, true, true}}) {
+            run(report, c, count, port);
+            port = static_cast<uint16_t>(port + 2);
+        }
+    }
+    return 0;
+}
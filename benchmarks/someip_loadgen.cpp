@@ -0,0 +1,164 @@
+// Load generator for a SOME/IP server on loopback (defaults match server_app's brake status
+// method). Open-loop mode sends at a fixed rate and measures latency from each request's
+// scheduled send time, so a stalled server cannot hide queueing delay (no coordinated
+// omission). Closed-loop mode keeps a fixed number of requests in flight.
+#include "bench_common.hpp"
+#include "someip/api.hpp"
+#include <array>
+#include <atomic>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+namespace {
+
+struct Options {
+    std::string mode = "closed";
+    std::string server_ip = "127.0.0.1";
+    uint16_t server_port = 3000;
+    std::string bind_ip = "127.0.0.1";
+    uint16_t bind_port = 3100;
+    ServiceId service = 0x1300;
+    MethodId method = 0x0030;
+    size_t payload = 0;
+    double rate = 10000;     // open loop, msgs/s
+    unsigned window = 16;    // closed loop, requests in flight
+    double duration = 5.0;   // seconds
+    EndpointOptions receive;  // --rx busy: busy-poll the response socket; --cpu: pin its thread
+};
+
+void usage() {
+    std::cerr << "usage: someip_loadgen [--mode open|closed] [--server ip:port] [--bind ip:port]\n"
+                 "                      [--service 0xSSSS] [--method 0xMMMM] [--payload bytes]\n"
+                 "                      [--rate msgs/s] [--window n] [--duration s] [--rx blocking|busy]\n"
+                 "                      [--cpu n] [--json path]\n";
+}
+
+bool split_endpoint(const std::string& s, std::string& ip, uint16_t& port) {
+    auto colon = s.rfind(':');
+    if (colon == std::string::npos) return false;
+    ip = s.substr(0, colon);
+    port = static_cast<uint16_t>(std::strtoul(s.c_str() + colon + 1, nullptr, 0));
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (a == "--mode") o.mode = value();
+        else if (a == "--server") { if (!split_endpoint(value(), o.server_ip, o.server_port)) return false; }
+        else if (a == "--bind") { if (!split_endpoint(value(), o.bind_ip, o.bind_port)) return false; }
+        else if (a == "--service") o.service = static_cast<ServiceId>(std::strtoul(value(), nullptr, 0));
+        else if (a == "--method") o.method = static_cast<MethodId>(std::strtoul(value(), nullptr, 0));
+        else if (a == "--payload") o.payload = std::strtoul(value(), nullptr, 0);
+        else if (a == "--rate") o.rate = std::atof(value());
+        else if (a == "--window") o.window = static_cast<unsigned>(std::atoi(value()));
+        else if (a == "--duration") o.duration = std::atof(value());
+        else if (a == "--rx") {
+            std::string mode = value();
+            if (mode != "blocking" && mode != "busy") return false;
+            o.receive.mode = mode == "busy" ? ReceiveMode::BUSY_POLL : ReceiveMode::BLOCKING;
+        }
+        else if (a == "--cpu") o.receive.thread.cpu = std::atoi(value());
+        else if (a == "--json") ++i;  // handled by bench::Report
+        else if (a == "--quick") o.duration = 0.5;
+        else return false;
+    }
+    return (o.mode == "open" || o.mode == "closed") && o.rate > 0 && o.window > 0 && o.window < 60000;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        usage();
+        return 2;
+    }
+    bench::Report report("loadgen", argc, argv);
+
+    auto ep = create_udp_endpoint(opts.bind_ip, opts.bind_port, opts.receive);
+    if (!ep) {
+        std::cerr << "[ERROR] Failed to create UDP endpoint on " << opts.bind_ip << ":" << opts.bind_port << "\n";
+        return 1;
+    }
+    Endpoint server(opts.server_ip, opts.server_port);
+
+    SomeIpHeader h{opts.service, opts.method, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + opts.payload),
+                   0x0001, 0, 1, 1, static_cast<uint8_t>(MessageType::REQUEST), 0};
+    Payload request = SomeIpMessage{h, Payload(opts.payload, 0x5A)}.serialize();
+
+    // Indexed by session ID (1..0xFFFF): scheduled (open loop) or actual (closed loop) send
+    // time. A request still unanswered when its session comes round again is counted lost,
+    // since a late answer to it would be taken for the new request's.
+    static std::array<std::atomic<Uint64>, 65536> sent_at{};
+    metrics::LatencyHistogram latency;
+    std::atomic<Uint64> sent{0}, received{0};
+    Uint64 overtaken = 0;  // under send_mutex
+    std::atomic<bool> sending{true};
+    uint16_t next_session = 1;
+    std::mutex send_mutex;  // closed loop sends from both the main and the receive thread
+
+    auto send_one = [&](Uint64 scheduled_ns) {
+        std::lock_guard<std::mutex> lk(send_mutex);
+        uint16_t session = next_session++;
+        if (next_session == 0) next_session = 1;
+        request[10] = static_cast<uint8_t>(session >> 8);
+        request[11] = static_cast<uint8_t>(session);
+        if (sent_at[session].exchange(scheduled_ns, std::memory_order_acq_rel)) ++overtaken;
+        ep->send_to(request, server);
+        sent.fetch_add(1, std::memory_order_relaxed);
+    };
+
+    bool closed = opts.mode == "closed";
+    ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        Uint64 t = sent_at[msg.header.session_id].exchange(0, std::memory_order_acq_rel);
+        if (!t) return;
+        latency.record(bench::now_ns() - t);
+        received.fetch_add(1, std::memory_order_relaxed);
+        // Closed loop: every response releases the next request (sent from the receive thread)
+        if (closed && sending.load(std::memory_order_relaxed)) send_one(bench::now_ns());
+    });
+
+    Uint64 start = bench::now_ns();
+    Uint64 end = start + static_cast<Uint64>(opts.duration * 1e9);
+    if (closed) {
+        for (unsigned i = 0; i < opts.window; ++i) send_one(bench::now_ns());
+        while (bench::now_ns() < end) std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        sending = false;
+    } else {
+        double interval = 1e9 / opts.rate;
+        for (Uint64 n = 0;; ++n) {
+            Uint64 due = start + static_cast<Uint64>(double(n) * interval);
+            if (due >= end) break;
+            Uint64 now = bench::now_ns();
+            if (due > now + 200000) std::this_thread::sleep_for(std::chrono::nanoseconds(due - now - 100000));
+            while (bench::now_ns() < due) {}
+            send_one(due);
+        }
+    }
+    Uint64 send_end = bench::now_ns();
+    // Let in-flight responses arrive
+    for (int i = 0; i < 200 && received.load() < sent.load(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    ep->stop();
+    // Nothing sends any more
+    Uint64 lost = sent.load() - received.load();
+
+    double secs = double(send_end - start) / 1e9;
+    auto fields = bench::latency_fields(latency);
+    fields.insert(fields.begin(), {
+        {"sent", double(sent.load())},
+        {"received", double(received.load())},
+        {"lost", double(lost)},
+        {"session_reused_while_waiting", double(overtaken)},
+        {"msgs_per_sec", double(received.load()) / secs},
+        {opts.mode == "open" ? "target_rate" : "window", opts.mode == "open" ? opts.rate : double(opts.window)},
+    });
+    report.add_fields("loadgen_" + opts.mode, fields);
+    return 0;
+}
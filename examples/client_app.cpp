@@ -5,46 +5,25 @@
 #include <string>
 #include <memory>  // For std::shared_ptr
 #include "someip/api.hpp"            // For create_udp_endpoint
-#include "someip/message_router.hpp" // For SomeIpHeader, MessageRouter
-#include "someip/service.hpp"        // For SOME/IP services
+#include "brake_someip.hpp"          // Brake service proxy, generated from brake.sidl
+#ifdef SOMEIP_HAS_CRYPTO
+#include "someip/secoc.hpp"          // For SecOC authentication of brake commands
+#endif
 
 using namespace someip;
+using brake::Brake;
 
-// Sends brake press OR release command to the server
-bool send_brake_request(std::shared_ptr<UdpEndpoint> client, const std::string& server_ip, uint16_t server_port, bool press) {
-    SomeIpHeader h;
-    h.service_id = 0x1300;            // Brake Control Service ID
-    h.method_id = press ? 0x0010 : 0x0020;  // Press (0x0010) or Release (0x0020)
-    h.client_id = 0x01;               // Client ID
-    h.session_id = 0x01;              // Session ID
-    h.length = 8;                     // Header only (payload not needed)
-    h.protocol_version = 1;
-    h.interface_version = 1;
-    h.message_type = static_cast<uint8_t>(MessageType::REQUEST);
-
-    SomeIpMessage req{h, {}};
-    auto server_endpoint = std::make_pair(server_ip, server_port);
-
-    return client->send_to(req.serialize(), server_endpoint);
-}
-
-// Sends brake status query command to the server
-bool request_brake_status(std::shared_ptr<UdpEndpoint> client, const std::string& server_ip, uint16_t server_port) {
-    SomeIpHeader h;
-    h.service_id = 0x1300;           // Brake Control Service ID
-    h.method_id = 0x0030;            // Brake status method ID
-    h.client_id = 0x01;              // Client ID
-    h.session_id = 0x01;             // Session ID
-    h.length = 8;                    // Header only (payload not needed)
-    h.protocol_version = 1;
-    h.interface_version = 1;
-    h.message_type = static_cast<uint8_t>(MessageType::REQUEST);
-
-    SomeIpMessage req{h, {}};
-    auto server_endpoint = std::make_pair(server_ip, server_port);
-
-    return client->send_to(req.serialize(), server_endpoint);
+#ifdef SOMEIP_HAS_CRYPTO
+// Brake commands carry a SecOC freshness value and truncated CMAC; the demo key is shared
+// with server_app (provision real keys per ECU). Freshness is time-based, so either side can
+// restart without the other rejecting it as stale.
+std::shared_ptr<SecOcStage> brake_auth() {
+    SecOcProfile profile;
+    profile.key = Payload(16, 0x5C);
+    profile.freshness = SecOcProfile::Freshness::TIME;
+    return SecOcStage::create(profile);
 }
+#endif
 
 int main() {
     const std::string server_ip = "127.0.0.1";
@@ -58,6 +37,25 @@ int main() {
     }
     std::cout << "[INFO] Client listening on port " << client_port << ".\n";
 
+    brake::BrakeProxy proxy(client, std::make_pair(server_ip, server_port));
+#ifdef SOMEIP_HAS_CRYPTO
+    proxy.add_protection(Brake::PRESS, brake_auth());
+    proxy.add_protection(Brake::RELEASE, brake_auth());
+#endif
+    // Press and release both answer with the resulting brake state
+    auto on_command = [](ReturnCode rc, const auto* res) {
+        if (res) std::cout << "[INFO] Brake is now " << (res->pressed() ? "pressed" : "released") << ".\n";
+        else std::cerr << "[ERROR] Brake command failed (return code " << int(rc) << ").\n";
+    };
+    proxy.on_press(on_command);
+    proxy.on_release(on_command);
+    proxy.on_status([](const Uint8& status) {
+        std::cout << "[INFO] Brake status: " << (status ? "pressed" : "released") << ".\n";
+    });
+    client->set_callback([&proxy](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        proxy.handle(msg);
+    });
+
     bool running = true;
 
     while (running) {
@@ -68,21 +66,21 @@ int main() {
         if (input == "exit") {
             running = false;
         } else if (input == "press") {
-            bool ok = send_brake_request(client, server_ip, server_port, true);
+            bool ok = proxy.press();
             if (ok) {
                 std::cout << "[INFO] Sent brake press request.\n";
             } else {
                 std::cerr << "[ERROR] Failed to send brake press request.\n";
             }
         } else if (input == "release") {
-            bool ok = send_brake_request(client, server_ip, server_port, false);
+            bool ok = proxy.release();
             if (ok) {
                 std::cout << "[INFO] Sent brake release request.\n";
             } else {
                 std::cerr << "[ERROR] Failed to send brake release request.\n";
             }
         } else if (input == "status") {
-            bool ok = request_brake_status(client, server_ip, server_port);
+            bool ok = proxy.get_status();
             if (ok) {
                 std::cout << "[INFO] Sent brake status request.\n";
             } else {
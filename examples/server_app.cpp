@@ -1,45 +1,45 @@
 #include "someip/api.hpp"
 #include "someip/service.hpp"
 #include "someip/message_router.hpp" 
+#include "someip/dispatcher.hpp"
+#include "someip/admission.hpp"
+#include "brake_someip.hpp"  // generated from brake.sidl
 #include <iostream>
+#ifdef SOMEIP_HAS_CRYPTO
+#include "someip/secoc.hpp"
+#endif
 
 using namespace someip;
+using brake::Brake;
 
-// Handler for pressing the brake
-MethodResult press_brake(const Payload&, const Endpoint&) {
-    std::cout << "[INFO] Server: Press Brake request received.\n";
-    MethodResult result;
-    result.return_code = ReturnCode::E_OK;  // Success
-    result.payload = {1}; // Brake pressed
-    return result;
-}
-
-// Handler for releasing the brake
-MethodResult release_brake(const Payload&, const Endpoint&) {
-    std::cout << "[INFO] Server: Release Brake request received.\n";
-    MethodResult result;
-    result.return_code = ReturnCode::E_OK;  // Success
-    result.payload = {0}; // Brake released
-    return result;
-}
-
-// Handler for querying brake status
-MethodResult brake_status(const Payload&, const Endpoint&) {
-    static bool brake_pressed = true; // For simulation, toggling every call
-    brake_pressed = !brake_pressed;
+// Brake control service. The status field (getter 0x0030) is answered from the cached value,
+// and subscribers of event 0x8030 are notified when it changes.
+class BrakeServer : public brake::BrakeSkeleton {
+public:
+    // Handler for pressing the brake
+    ReturnCode press(const brake::PressRequest::View&, brake::PressResponse& out, const Endpoint&) override {
+        std::cout << "[INFO] Server: Press Brake request received.\n";
+        status.set(1);
+        out.pressed = true;  // Brake pressed
+        return ReturnCode::E_OK;
+    }
 
-    std::cout << "[INFO] Server: Brake Status request received.\n";
-    MethodResult result;
-    result.return_code = ReturnCode::E_OK;  // Success
-    result.payload = {brake_pressed ? true : false}; // Return current brake status
-    return result;
-}
+    // Handler for releasing the brake
+    ReturnCode release(const brake::ReleaseRequest::View&, brake::ReleaseResponse& out, const Endpoint&) override {
+        std::cout << "[INFO] Server: Release Brake request received.\n";
+        status.set(0);
+        out.pressed = false;  // Brake released
+        return ReturnCode::E_OK;
+    }
+};
 
 int main() {
     const std::string server_ip = "127.0.0.1";
     const uint16_t server_port = 3000;
 
-    auto server = create_udp_endpoint(server_ip, server_port);
+    EndpointOptions socket_options;
+    socket_options.rcvbuf = 1 << 20;  // absorb bursts; the kernel caps this at net.core.rmem_max
+    auto server = create_udp_endpoint(server_ip, server_port, socket_options);
     if (!server) {
         std::cerr << "[ERROR] Failed to create UDP server endpoint on port " << server_port << ".\n";
         return 1;
@@ -47,15 +47,38 @@ int main() {
     std::cout << "[INFO] Server listening on port " << server_port << ".\n";
 
     ServiceRegistry registry;
-
-    registry.register_method(0x1300, 0x0010, press_brake);  // Press Brake
-    registry.register_method(0x1300, 0x0020, release_brake); // Release Brake
-    registry.register_method(0x1300, 0x0030, brake_status);  // Brake Status
+    BrakeServer brake_service;
+    brake_service.attach(registry, server);  // Press, Release, Brake Status
 
     auto router = create_message_router(server, registry);
+#ifdef SOMEIP_HAS_CRYPTO
+    // Press/release must be authenticated (SecOC, demo key and time-based freshness shared
+    // with client_app); freshness is tracked per client
+    SecOcProfile brake_auth;
+    brake_auth.key = Payload(16, 0x5C);
+    brake_auth.freshness = SecOcProfile::Freshness::TIME;
+    router->add_protection(Brake::SERVICE_ID, Brake::PRESS, SecOcStage::create(brake_auth));
+    router->add_protection(Brake::SERVICE_ID, Brake::RELEASE, SecOcStage::create(brake_auth));
+#endif
+
+    // Brake commands get their own lane ahead of status polls and anything else, and are
+    // answered with E_TIMEOUT rather than applied more than 10 ms late
+    DispatcherOptions lanes;
+    lanes.default_class = 2;
+    Dispatcher dispatcher(*router, lanes);
+    dispatcher.set_class(Brake::SERVICE_ID, Brake::PRESS, 0, std::chrono::milliseconds(10));
+    dispatcher.set_class(Brake::SERVICE_ID, Brake::RELEASE, 0, std::chrono::milliseconds(10));
+    dispatcher.set_class(Brake::SERVICE_ID, Brake::STATUS_GET, 1);
+    dispatcher.start();
+
+    // Under overload, refuse status polls and other traffic before they reach the lanes
+    AdmissionControl admission(FilterVerdict::REJECT);
+    admission.attach(dispatcher);
+    admission.watch_socket_drops(*server);
+    server->set_filter(admission.filter());
 
     server->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dest, TransportProtocol proto) {
-        router->route(msg, src, dest, proto);
+        dispatcher.submit(msg, src, dest, proto);
     });
 
     while (true) {
@@ -0,0 +1,123 @@
+#ifndef SOMEIP_ADMISSION_HPP
+#define SOMEIP_ADMISSION_HPP
+
+#include "types.hpp"
+#include "transport.hpp"
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace someip {
+
+class Dispatcher;
+
+// Token bucket parameters: `rate` messages per second on average, bursts of up to `burst`
+struct RateLimit {
+    double rate = 0;
+    double burst = 0;
+};
+
+// Refills continuously; not thread-safe on its own
+class TokenBucket {
+public:
+    TokenBucket() = default;
+    TokenBucket(const RateLimit& limit, Uint64 now_ns);
+
+    // Take one token; false if the bucket is empty
+    bool take(Uint64 now_ns);
+
+    // True once the bucket has refilled completely (its state is then the same as a new one)
+    bool full(Uint64 now_ns) const;
+
+private:
+    double level(Uint64 now_ns) const;
+
+    RateLimit limit_;
+    double tokens_ = 0;
+    Uint64 stamp_ns_ = 0;
+};
+
+// Per-client and per-source rate limits plus overload shedding, evaluated on the raw datagram
+// before it is parsed. Install with UdpEndpoint::set_filter(admission.filter()).
+// Each kind of limit keeps at most MAX_BUCKETS buckets; a new key beyond that forgets the least
+// recently used one, so spoofed sources cost O(1) per datagram and bounded memory.
+class AdmissionControl {
+public:
+    static constexpr ServiceId ANY_SERVICE = 0xFFFF;
+    static constexpr size_t MAX_BUCKETS = 4096;
+
+    // Verdict for traffic over a limit or shed; REJECT answers requests with E_NOT_OK
+    explicit AdmissionControl(FilterVerdict action = FilterVerdict::DROP);
+
+    // Limit each client_id (per service) or each source address:port (per service).
+    // ANY_SERVICE applies to services without their own limit. Configure before traffic flows.
+    void set_client_limit(ServiceId service, RateLimit limit);
+    void set_source_limit(ServiceId service, RateLimit limit);
+
+    // Shed by priority class once the dispatcher's load passes `shed_start` (fraction of queue
+    // capacity): first the lowest class, more classes as load rises; class 0 is never shed.
+    // The dispatcher must outlive this object.
+    void attach(Dispatcher& dispatcher, double shed_start = 0.5);
+
+    // Report the cumulative socket drop counter; an increase sheds the lowest class for a while
+    void note_socket_drops(Uint64 cumulative);
+
+    // Read `endpoint`'s kernel drop counter (SO_RXQ_OVFL) on every admit(); the endpoint must
+    // outlive this object. Not for endpoints with a socket filter, whose counter includes the
+    // datagrams it refuses.
+    void watch_socket_drops(const UdpEndpoint& endpoint) { watched_ = &endpoint; }
+
+    // Decide on a datagram; reads only its 16-byte header
+    FilterVerdict admit(const uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port);
+
+    PacketFilter filter();
+
+    Uint64 admitted() const { return admitted_.load(std::memory_order_relaxed); }
+    Uint64 rate_limited() const { return rate_limited_.load(std::memory_order_relaxed); }
+    Uint64 shed() const { return shed_.load(std::memory_order_relaxed); }
+
+    // Classes currently shed, counted from the lowest-priority one
+    unsigned shed_level() const;
+
+    // Client and source buckets currently kept
+    size_t buckets() const;
+
+private:
+    // Most recently used first, indexed by key
+    struct Buckets {
+        std::list<std::pair<Uint64, TokenBucket>> order;
+        std::unordered_map<Uint64, std::list<std::pair<Uint64, TokenBucket>>::iterator> index;
+        Uint64 next_sweep_ns = 0;
+
+        void clear() {
+            order.clear();
+            index.clear();
+        }
+    };
+
+    const RateLimit* limit_for(const std::unordered_map<ServiceId, RateLimit>& limits, ServiceId service) const;
+    bool take(Buckets& buckets, Uint64 key, const RateLimit& limit, Uint64 now_ns);
+    unsigned shed_level(Uint64 now_ns) const;
+
+    FilterVerdict action_;
+    std::unordered_map<ServiceId, RateLimit> client_limits_;
+    std::unordered_map<ServiceId, RateLimit> source_limits_;
+    mutable std::mutex mutex_;
+    Buckets client_buckets_;
+    Buckets source_buckets_;
+
+    Dispatcher* dispatcher_ = nullptr;
+    const UdpEndpoint* watched_ = nullptr;
+    double shed_start_ = 0.5;
+    std::atomic<Uint64> socket_drops_{0};
+    std::atomic<Uint64> drop_shed_until_ns_{0};
+
+    std::atomic<Uint64> admitted_{0};
+    std::atomic<Uint64> rate_limited_{0};
+    std::atomic<Uint64> shed_{0};
+};
+
+} // namespace someip
+
+#endif // SOMEIP_ADMISSION_HPP
@@ -14,11 +14,15 @@ namespace someip {
 // Create and start a UDP endpoint bound to ip:port. If multicast_addr is non-empty, join it.
 std::shared_ptr<UdpEndpoint> create_udp_endpoint(const std::string& bind_ip, uint16_t bind_port, const std::string& multicast_addr = "");
 
+// As above with socket and receive thread options (buffer sizes, timestamps, busy polling, CPU pinning)
+std::shared_ptr<UdpEndpoint> create_udp_endpoint(const std::string& bind_ip, uint16_t bind_port,
+                                                 const EndpointOptions& options, const std::string& multicast_addr = "");
+
 // Create a service discovery object (uses a multicast UDP endpoint internally)
 std::unique_ptr<ServiceDiscovery> create_service_discovery(const std::string& multicast = DEFAULT_SD_MULTICAST, uint16_t port = DEFAULT_SD_PORT);
 
-// Create a message router attached to a UDP endpoint and a service registry
-std::unique_ptr<MessageRouter> create_message_router(std::shared_ptr<UdpEndpoint> endpoint, ServiceRegistry& registry);
+// Create a message router attached to a transport (UDP or loopback endpoint) and a service registry
+std::unique_ptr<MessageRouter> create_message_router(std::shared_ptr<Transport> endpoint, ServiceRegistry& registry);
 
 } // namespace someip
 
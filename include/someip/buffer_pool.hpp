@@ -0,0 +1,64 @@
+#ifndef SOMEIP_BUFFER_POOL_HPP
+#define SOMEIP_BUFFER_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace someip {
+namespace pool {
+
+// Slab allocator for message buffers. Requests up to MAX_BLOCK bytes are rounded up to a
+// power-of-two class (64 B .. 64 KB) and served from a per-thread free list; the lists refill
+// from and spill back to a shared per-class list in batches, and that list carves blocks out
+// of 2 MiB chunks that are kept for the life of the process. Blocks may be freed on any
+// thread. Larger requests go to the global operator new.
+constexpr size_t MIN_BLOCK = 64;
+constexpr size_t MAX_BLOCK = 65536;
+constexpr size_t CHUNK_SIZE = size_t(2) << 20;
+
+void* allocate(size_t bytes);
+void deallocate(void* p, size_t bytes) noexcept;
+
+// Back chunks carved after this call with huge pages (MAP_HUGETLB, falling back to a
+// transparent huge page hint). Off by default.
+void set_huge_pages(bool enabled);
+
+struct Stats {
+    uint64_t chunks = 0;              // 2 MiB chunks reserved so far
+    uint64_t huge_page_chunks = 0;    // of which backed by explicit huge pages
+    uint64_t refills = 0;             // thread cache refills from the shared lists
+    uint64_t large_allocations = 0;   // requests above MAX_BLOCK
+};
+Stats stats();
+
+// The same pool as a std::pmr resource, e.g. for std::pmr::vector or monotonic arenas
+std::pmr::memory_resource* resource();
+
+// Stateless allocator over the pool; Payload uses it when SOMEIP_POOLED_PAYLOAD is on
+template <typename T>
+struct Allocator {
+    using value_type = T;
+
+    Allocator() noexcept = default;
+    template <typename U>
+    Allocator(const Allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        static_assert(alignof(T) <= MIN_BLOCK, "over-aligned types are not pooled");
+        if (n > size_t(-1) / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(pool::allocate(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t n) noexcept { pool::deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const Allocator<U>&) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const Allocator<U>&) const noexcept { return false; }
+};
+
+} // namespace pool
+} // namespace someip
+
+#endif // SOMEIP_BUFFER_POOL_HPP
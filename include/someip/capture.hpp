@@ -0,0 +1,93 @@
+#ifndef SOMEIP_CAPTURE_HPP
+#define SOMEIP_CAPTURE_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace someip {
+
+// Options for a pcap capture tap
+struct CaptureOptions {
+    size_t ring_bytes = 8 * 1024 * 1024;  // rounded up to a power of two
+    Uint32 snaplen = 65535;               // bytes of each datagram kept
+    bool huge_pages = false;              // try MAP_HUGETLB for the ring (falls back silently)
+};
+
+// Writes datagrams to a pcap file (nanosecond timestamps, raw IPv4 link type, synthesized
+// IPv4/UDP headers so Wireshark decodes SOME/IP on the recorded ports).
+// Producers copy into a memory-mapped ring and never block; a writer thread drains the
+// ring to disk. When the ring is full the datagram is dropped and counted.
+class PacketCapture {
+public:
+    ~PacketCapture();
+
+    // Create the file and start the writer thread; nullptr if the file cannot be opened
+    static std::shared_ptr<PacketCapture> open(const std::string& path, const CaptureOptions& opts = {});
+
+    // Record one datagram. Addresses are IPv4 in host byte order.
+    void record(const uint8_t* data, size_t len, Uint32 src_ip, uint16_t src_port,
+                Uint32 dst_ip, uint16_t dst_port);
+
+    // Stop the writer after draining everything recorded so far and close the file
+    void close();
+
+    Uint64 captured() const { return captured_.load(std::memory_order_relaxed); }
+    Uint64 dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    PacketCapture() = default;
+    void writer_loop();
+    size_t drain();
+
+    FILE* file_ = nullptr;
+    uint8_t* ring_ = nullptr;
+    size_t ring_size_ = 0;
+    bool ring_huge_ = false;
+    Uint32 snaplen_ = 0;
+    alignas(64) std::atomic<Uint64> head_{0};  // reserved by producers
+    alignas(64) std::atomic<Uint64> tail_{0};  // released by the writer
+    std::atomic<Uint64> captured_{0};
+    std::atomic<Uint64> dropped_{0};
+    std::atomic<bool> running_{false};
+    std::thread writer_;
+};
+
+// A datagram read back from a pcap file
+struct CapturedPacket {
+    Uint64 timestamp_ns;
+    Uint32 src_ip;    // host byte order
+    uint16_t src_port;
+    Uint32 dst_ip;    // host byte order
+    uint16_t dst_port;
+    Payload data;     // UDP payload
+};
+
+// Sequential reader for IPv4/UDP pcap files (ethernet, raw IP, IPv4 and Linux cooked
+// link types; microsecond or nanosecond timestamps; either byte order)
+class PcapReader {
+public:
+    ~PcapReader();
+
+    bool open(const std::string& path);
+
+    // Next UDP datagram; non-UDP records are skipped. Returns false at end of file.
+    bool next(CapturedPacket& pkt);
+
+private:
+    FILE* file_ = nullptr;
+    bool swapped_ = false;
+    bool nanos_ = false;
+    Uint32 linktype_ = 0;
+    Payload record_;
+};
+
+// Dotted-quad form of a host-order IPv4 address
+std::string ipv4_to_string(Uint32 ip);
+
+} // namespace someip
+
+#endif // SOMEIP_CAPTURE_HPP
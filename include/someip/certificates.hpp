@@ -2,6 +2,8 @@
 #define SOMEIP_CERTIFICATES_HPP
 
 #include "types.hpp"
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <vector>
@@ -37,7 +39,8 @@ public:
     // Load certificate from file (PEM or DER format)
     bool load_certificate(const std::string& cert_path);
     
-    // Load certificate from memory (PEM format)
+    // Load certificate from memory (PEM format). A PEM bundle may carry the intermediate
+    // certificates after the leaf; they are sent along by secure transports.
     bool load_certificate_pem(const std::string& pem_data);
     
     // Load private key from file
@@ -57,5 +60,36 @@ public:
     // Get certificate information
     std::optional<CertificateInfo> get_certificate_info() const;
     
-    // Verify a certificate chain
-    VerificationResult verify_certificate(
\ No newline at end of file
+    // Verify a certificate chain: the leaf and any untrusted intermediates (PEM), against the
+    // loaded CA certificates. Successful results are cached, see below.
+    VerificationResult verify_certificate(const std::string& cert_pem,
+                                          const std::vector<std::string>& intermediates_pem = {});
+
+    // Same for DER-encoded certificates, leaf first
+    VerificationResult verify_chain_der(const std::vector<Payload>& chain_der);
+
+    // Verification cache. A successful verification is remembered under the SHA-256 of the
+    // presented chain, the purpose and the verification parameters (flags, depth, expected
+    // host), until the earliest not_after in the verified chain, capped by the TTL; loading CA
+    // certificates clears it. Secure transports consult it during handshakes, so a chain checked
+    // here, or as a client certificate, is verified again as a server certificate.
+    void set_cache_limits(size_t max_entries, std::chrono::seconds ttl);
+    void clear_cache();
+    Uint64 cache_hits() const { return cache_hits_.load(std::memory_order_relaxed); }
+    Uint64 cache_misses() const { return cache_misses_.load(std::memory_order_relaxed); }
+
+    // Lowercase hex SHA-256 of a DER certificate
+    static std::string fingerprint(const Payload& der);
+
+private:
+    struct Impl;
+    friend struct TlsContextAccess;
+
+    std::unique_ptr<Impl> impl_;
+    std::atomic<Uint64> cache_hits_{0};
+    std::atomic<Uint64> cache_misses_{0};
+};
+
+} // namespace someip
+
+#endif // SOMEIP_CERTIFICATES_HPP
@@ -0,0 +1,43 @@
+#ifndef SOMEIP_CRC_HPP
+#define SOMEIP_CRC_HPP
+
+#include "types.hpp"
+#include <cstddef>
+
+namespace someip {
+namespace crc {
+
+// CRC kernels used by E2E protection. Every function continues from a previous result, zlib
+// style: crc(b, crc(a)) == crc(a || b), and the default start value is the result for empty
+// input. Bulk data runs through slice-by-8 tables; CRC-32 uses PCLMUL folding and CRC-32C
+// the SSE4.2 crc32 instruction when the CPU supports them (checked once at startup).
+
+// CRC-8 SAE J1850 (poly 0x1D, init/xorout 0xFF), E2E profile 1
+Uint8 crc8(const uint8_t* data, size_t len, Uint8 crc = 0x00);
+
+// CRC-8H2F (poly 0x2F, init/xorout 0xFF), E2E profile 2
+Uint8 crc8h2f(const uint8_t* data, size_t len, Uint8 crc = 0x00);
+
+// CRC-16 CCITT-FALSE (poly 0x1021, init 0xFFFF), E2E profiles 5 and 6
+Uint16 crc16(const uint8_t* data, size_t len, Uint16 crc = 0xFFFF);
+
+// CRC-32 IEEE 802.3 (reflected poly 0x04C11DB7)
+Uint32 crc32(const uint8_t* data, size_t len, Uint32 crc = 0);
+
+// CRC-32C Castagnoli (reflected poly 0x1EDC6F41)
+Uint32 crc32c(const uint8_t* data, size_t len, Uint32 crc = 0);
+
+// CRC-32P4 (reflected poly 0xF4ACFB13), E2E profile 4
+Uint32 crc32p4(const uint8_t* data, size_t len, Uint32 crc = 0);
+
+// Kernel in use for CRC-32 / CRC-32C ("pclmul", "sse4.2", "armv8" or "slice8")
+const char* crc32_implementation();
+const char* crc32c_implementation();
+
+// Switch the hardware kernels off (or back on if the CPU has them); for tests and benchmarks
+void set_hardware_enabled(bool enabled);
+
+} // namespace crc
+} // namespace someip
+
+#endif // SOMEIP_CRC_HPP
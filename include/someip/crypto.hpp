@@ -2,21 +2,32 @@
 #define SOMEIP_CRYPTO_HPP
 
 #include "types.hpp"
+#include "someip_message.hpp"
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace someip {
 
-// Encryption/Decryption using AES-256-GCM
+// Encryption/Decryption using AES-256-GCM (one instance must not be used by two threads at once)
 class Crypto {
 public:
     // Key sizes
     static constexpr size_t AES_KEY_SIZE = 32;   // 256 bits
     static constexpr size_t AES_IV_SIZE = 12;    // 96 bits (recommended for GCM)
     static constexpr size_t AES_TAG_SIZE = 16;   // 128 bits
+
+    // Space an in-place buffer must reserve around the plaintext
+    static constexpr size_t HEADROOM = AES_IV_SIZE;
+    static constexpr size_t TAILROOM = AES_TAG_SIZE;
+    static constexpr size_t OVERHEAD = HEADROOM + TAILROOM;
     
     Crypto();
     ~Crypto();
+    Crypto(Crypto&&) noexcept;
+    Crypto& operator=(Crypto&&) noexcept;
     
     // Set encryption key (must be AES_KEY_SIZE bytes)
     bool set_key(const Payload& key);
@@ -36,6 +47,41 @@ public:
     // Input: IV (12 bytes) + Ciphertext + Tag (16 bytes)
     std::optional<Payload> decrypt(const Payload& ciphertext,
                                     const Payload& additional_data = {});
+
+    // The cipher context is keyed once by set_key() and reused for every message. IVs count
+    // up from a random 96-bit start drawn by each set_key(), so no RNG call is needed per
+    // message and contexts sharing a key do not collide. After MAX_MESSAGES_PER_KEY messages
+    // encryption fails until set_key() is called again (NIST SP 800-38D limit for random IVs).
+    static constexpr Uint64 MAX_MESSAGES_PER_KEY = Uint64(1) << 32;
+
+    // Append IV + Ciphertext + Tag to `out` (no allocation if `out` has the capacity)
+    bool encrypt_append(const uint8_t* plaintext, size_t len,
+                        const uint8_t* aad, size_t aad_len, Payload& out);
+
+    // As encrypt_append, but with a caller-chosen IV (AES_IV_SIZE bytes) that must never
+    // repeat under the same key
+    bool encrypt_append_iv(const uint8_t* iv, const uint8_t* plaintext, size_t len,
+                           const uint8_t* aad, size_t aad_len, Payload& out);
+
+    // Encrypt in place. `buf` holds HEADROOM spare bytes, `len` bytes of plaintext and
+    // TAILROOM spare bytes; afterwards it holds IV + Ciphertext + Tag (len + OVERHEAD bytes).
+    bool encrypt_in_place(uint8_t* buf, size_t len, const uint8_t* aad = nullptr, size_t aad_len = 0);
+
+    // Decrypt in place. `buf` holds IV + Ciphertext + Tag (`len` bytes); on success the
+    // plaintext starts at buf + HEADROOM and is len - OVERHEAD bytes long.
+    bool decrypt_in_place(uint8_t* buf, size_t len, const uint8_t* aad = nullptr, size_t aad_len = 0);
+
+    // One message of a batch, laid out as for encrypt_in_place/decrypt_in_place
+    struct BufferRef {
+        uint8_t* data;
+        size_t len;    // plaintext length (encrypt) or sealed length (decrypt)
+        bool ok;       // set per message by the batch call
+    };
+
+    // Encrypt/decrypt many messages with one call on the same keyed context.
+    // Returns the number of messages that succeeded.
+    size_t encrypt_batch(BufferRef* msgs, size_t count, const uint8_t* aad = nullptr, size_t aad_len = 0);
+    size_t decrypt_batch(BufferRef* msgs, size_t count, const uint8_t* aad = nullptr, size_t aad_len = 0);
     
     // HMAC-SHA256 for message authentication
     static Payload hmac_sha256(const Payload& key, const Payload& data);
@@ -69,31 +115,67 @@ struct SecureSomeIpMessage {
     static SecureSomeIpMessage deserialize(const Payload& data);
 };
 
-// Secure communication wrapper
+// Lock-free sliding-window anti-replay check (RFC 6479 style).
+// The window is a ring of 64-bit words, each packing a 32-bit block tag with a 32-bit
+// bitmap, so a sequence number is tested and marked with a single CAS.
+class ReplayWindow {
+public:
+    static constexpr size_t SLOTS = 64;
+    static constexpr Uint64 WINDOW = SLOTS * 32 - 32;  // sequence numbers tracked behind the newest
+
+    // True if `seq` is certainly a replay or too old (read-only, used before authentication)
+    bool is_stale(Uint64 seq) const;
+
+    // Mark `seq` as received; false if it was already seen or has fallen out of the window
+    bool check_and_update(Uint64 seq);
+
+    Uint64 highest() const { return highest_.load(std::memory_order_acquire); }
+    void reset();
+
+private:
+    std::atomic<Uint64> slots_[SLOTS] = {};
+    std::atomic<Uint64> highest_{0};
+};
+
+// Secure communication wrapper for one peer stream.
+// Safe to use from many threads: each thread keeps its own cipher context keyed from the
+// shared PSK, sequence numbers come from an atomic counter (and form the GCM IV together with
+// a per-key random 64-bit salt), and received sequence numbers pass a lock-free anti-replay
+// window so reordered datagrams are accepted but duplicates are rejected.
 class SecureCommunication {
 public:
     SecureCommunication();
     ~SecureCommunication();
     
-    // Set pre-shared key
+    // Set pre-shared key (key rotation also restarts the sequence and the replay window)
     bool set_psk(const Payload& key);
     
-    // Encrypt a SOME/IP message
+    // Encrypt a SOME/IP message; nullopt without a key, or once the key's 2^32 - 1 sequence
+    // numbers are used up (rotate it with set_psk before then)
     std:: optional<Payload> encrypt_message(const SomeIpMessage& msg);
     
-    // Decrypt a SOME/IP message
+    // Decrypt a SOME/IP message; nullopt if authentication fails or it is a replay
     std::optional<SomeIpMessage> decrypt_message(const Payload& encrypted_data);
     
     // Get current sequence number
     Uint32 current_sequence() const { return sequence_number_; }
     
-    // Reset sequence number (e.g., after key rotation)
+    // Reset sequence number (only together with a new key, or IVs would repeat)
     void reset_sequence() { sequence_number_ = 0; }
 
+    // Messages rejected by the anti-replay window
+    Uint64 replays_rejected() const { return replays_rejected_.load(std::memory_order_relaxed); }
+
 private:
-    Crypto crypto_;
+    struct KeyState;
+
+    const Uint64 id_;                          // identifies this instance in thread-local caches
+    std::shared_ptr<const KeyState> key_;     // accessed with std::atomic_load/atomic_store
+    Uint64 epoch_ = 0;                         // key generation, guarded by key_mutex_
+    std::mutex key_mutex_;                     // serializes set_psk only
     std::atomic<Uint32> sequence_number_{0};
-    std::mutex mutex_;
+    std::atomic<Uint64> replays_rejected_{0};
+    ReplayWindow replay_;
 };
 
 }  // namespace someip
@@ -0,0 +1,119 @@
+#ifndef SOMEIP_DISPATCHER_HPP
+#define SOMEIP_DISPATCHER_HPP
+
+#include "types.hpp"
+#include "message_router.hpp"
+#include "metrics.hpp"
+#include "thread_options.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace someip {
+
+enum class DispatchPolicy : uint8_t {
+    STRICT_PRIORITY,  // always serve the lowest-numbered non-empty class
+    WEIGHTED_FAIR     // weighted round robin: class i gets weights[i] turns per round
+};
+
+struct DispatcherOptions {
+    DispatchPolicy policy = DispatchPolicy::STRICT_PRIORITY;
+    unsigned classes = 3;          // class 0 is the most important
+    std::vector<Uint32> weights;   // WEIGHTED_FAIR turns per class (missing entries count as 1)
+    size_t queue_capacity = 1024;  // per class; submissions to a full queue are dropped
+    unsigned workers = 1;          // threads calling MessageRouter::route
+    unsigned default_class = 0;    // class of methods without set_class(); clamped to the last class
+    ThreadOptions thread;          // worker scheduling (all workers share it)
+};
+
+// Priority lanes in front of a MessageRouter: the transport callback submits, worker threads
+// dequeue per the policy and route. Requests carry an optional deadline; one that expires while
+// queued is answered with E_TIMEOUT instead of running late, or dropped if its method has
+// protection stages, since its checks never ran.
+class Dispatcher {
+public:
+    Dispatcher(MessageRouter& router, DispatcherOptions options = {});
+    ~Dispatcher();
+
+    bool start();
+    void stop();  // queued requests are discarded
+
+    // Place a method in a class, with a deadline relative to submission (0: none).
+    // Configure before start().
+    void set_class(ServiceId service, MethodId method, unsigned cls,
+                   std::chrono::microseconds deadline = std::chrono::microseconds(0));
+
+    // Queue a message, typically from the transport callback. False if dropped (queue full or
+    // not running).
+    bool submit(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto);
+
+    // As above with an explicit absolute deadline in Dispatcher::now_ns() time (0: method default)
+    bool submit(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto,
+                Uint64 deadline_ns);
+
+    struct ClassStats {
+        Uint64 enqueued = 0;
+        Uint64 dispatched = 0;
+        Uint64 expired = 0;   // answered with E_TIMEOUT, or dropped if protected
+        Uint64 rejected = 0;  // queue full
+        size_t depth = 0;
+        metrics::LatencyHistogram queue_delay;  // submit to dequeue, ns
+    };
+    ClassStats stats(unsigned cls) const;
+
+    // Class a method is queued in, and the number of classes
+    unsigned class_of(ServiceId service, MethodId method) const;
+    unsigned classes() const { return options_.classes; }
+
+    // Queued requests as a fraction of the total queue capacity; lock-free, for overload checks
+    double load() const {
+        return double(queued_.load(std::memory_order_relaxed)) / double(options_.classes * options_.queue_capacity);
+    }
+
+    // steady_clock time in ns, the time base of deadlines
+    static Uint64 now_ns();
+
+private:
+    struct Item {
+        SomeIpMessage msg;
+        Endpoint src, dst;
+        TransportProtocol proto = TransportProtocol::UDP;
+        Uint64 enqueued_ns = 0;
+        Uint64 deadline_ns = 0;
+    };
+
+    // Fixed-capacity ring; slots are reused so steady-state queueing does not allocate
+    struct Lane {
+        std::vector<Item> ring;
+        size_t head = 0, count = 0;
+        Uint32 weight = 1, credits = 1;
+        ClassStats stats;
+    };
+
+    struct Route {
+        unsigned cls;
+        Uint64 deadline_ns;  // relative
+    };
+
+    void worker_loop();
+    int pick_lane();  // with mutex_ held; -1 if all lanes are empty
+
+    MessageRouter& router_;
+    DispatcherOptions options_;
+    std::unordered_map<Uint32, Route> routes_;
+    std::vector<Lane> lanes_;
+    std::atomic<size_t> queued_{0};  // written with mutex_ held
+    unsigned next_lane_ = 0;  // WEIGHTED_FAIR scan position
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<std::thread> workers_;
+    bool running_ = false;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_DISPATCHER_HPP
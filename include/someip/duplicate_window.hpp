@@ -0,0 +1,99 @@
+#ifndef SOMEIP_DUPLICATE_WINDOW_HPP
+#define SOMEIP_DUPLICATE_WINDOW_HPP
+
+#include "types.hpp"
+#include <array>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace someip {
+
+// Memory bound of a DuplicateWindow: about clients * requests_per_client * max_response bytes
+struct DuplicateWindowOptions {
+    size_t clients = 256;            // clients tracked at once; the least recently active is forgotten
+    size_t requests_per_client = 8;  // most recent requests remembered per client
+    size_t max_response = 1500;      // responses above this are not kept, so a retry runs the handler again
+    std::chrono::milliseconds max_age{5000};  // older entries no longer answer retries
+};
+
+// Recently seen requests per client, with the response sent for each. A client is its source
+// address and port plus client_id, so another ECU, or a restarted one on a new port, that
+// reuses the IDs is not mistaken for it. A retransmitted request is recognized by its session
+// plus service, method and payload checksum within max_age, and answered with the stored bytes
+// instead of running the handler again. Thread-safe; clients are spread over independently
+// locked shards.
+class DuplicateWindow {
+public:
+    struct Key {
+        ClientId client;
+        SessionId session;
+        ServiceId service;
+        MethodId method;
+        Uint32 payload_crc;
+        Uint32 source_addr = 0;  // sender, host byte order
+        uint16_t source_port = 0;
+    };
+
+    enum class Verdict : uint8_t {
+        NEW,          // first sighting; the caller must complete() or abandon() it
+        DUPLICATE,    // answered before; the response is in `out`
+        IN_PROGRESS   // the original is still being handled
+    };
+
+    explicit DuplicateWindow(DuplicateWindowOptions options = {});
+
+    Verdict begin(const Key& key, Payload& out);
+
+    // Record the response sent for a request begin() returned NEW for
+    void complete(const Key& key, const Payload& response);
+
+    // Forget a NEW request that got no response (e.g. failed its protection check)
+    void abandon(const Key& key);
+
+    static constexpr size_t SHARDS = 16;
+
+private:
+    struct Slot {
+        bool used = false;
+        bool done = false;
+        SessionId session = 0;
+        ServiceId service = 0;
+        MethodId method = 0;
+        Uint32 payload_crc = 0;
+        Uint64 begun_ns = 0;
+        Payload response;
+    };
+    struct Client {
+        std::vector<Slot> slots;  // ring
+        size_t next = 0;
+        Uint64 last_active = 0;
+    };
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<Uint64, Client> clients;  // by client_key()
+        Uint64 tick = 0;
+    };
+
+    static bool matches(const Slot& s, const Key& key) {
+        return s.used && s.session == key.session && s.service == key.service && s.method == key.method;
+    }
+    static Uint64 client_key(const Key& key) {
+        return (Uint64(key.source_addr) << 32) | (Uint64(key.source_port) << 16) | key.client;
+    }
+    Shard& shard(const Key& key) {
+        return shards_[(key.client ^ key.source_port ^ key.source_addr ^ (key.source_addr >> 16)) % SHARDS];
+    }
+    Slot* find(Shard& shard, const Key& key);
+    static Uint64 now_ns();
+
+    const DuplicateWindowOptions options_;
+    const Uint64 max_age_ns_;
+    const size_t clients_per_shard_;
+    std::array<Shard, SHARDS> shards_;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_DUPLICATE_WINDOW_HPP
@@ -0,0 +1,76 @@
+#ifndef SOMEIP_E2E_HPP
+#define SOMEIP_E2E_HPP
+
+#include "types.hpp"
+#include "message_router.hpp"
+#include "peer_table.hpp"
+#include <atomic>
+#include <memory>
+
+namespace someip {
+
+// AUTOSAR-style end-to-end protection layouts; the E2E header sits at the start of the payload
+enum class E2EProfile : uint8_t {
+    P01,        // crc8 (SAE J1850) | counter (low nibble, 0..14); CRC over data ID + data
+    P05,        // crc16 (CCITT, low byte first) | counter8; CRC over data + data ID
+    P04,        // length16 | counter16 | data ID32 | crc32 (P4 poly); CRC over everything else
+    P04_CRC32C  // P04 layout with CRC-32C, hardware accelerated on most CPUs
+};
+
+enum class E2EStatus : uint8_t {
+    OK = 0,
+    REPEATED,        // same counter as the previous message
+    WRONG_SEQUENCE,  // counter jumped by more than max_delta_counter
+    ERROR            // CRC, length or data ID mismatch
+};
+
+struct E2EConfig {
+    E2EProfile profile = E2EProfile::P04;
+    Uint32 data_id = 0;              // 16 bits for P01/P05
+    Uint16 max_delta_counter = 1;    // largest accepted counter step (steps > 1 mean lost messages)
+    size_t max_peers = 256;          // peers with counter state; the least recently used is forgotten
+};
+
+// E2E protect/check stage for one (service, method). Each peer (address, port and client ID)
+// has its own sending and receiving counter, so several clients of one method do not disturb
+// each other's sequence; the counters are atomic and the stage can be shared by several threads.
+class E2EStage : public ProtectionStage {
+public:
+    static std::shared_ptr<E2EStage> create(const E2EConfig& config);
+
+    bool protect(const SomeIpHeader& header, Payload& payload) override;
+    bool check(const SomeIpHeader& header, Payload& payload) override;
+    bool protect(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) override;
+    bool check(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) override;
+
+    // Check without stripping the E2E header. Without a peer, messages share the counters of
+    // one unknown peer.
+    E2EStatus check_status(const uint8_t* data, size_t len);
+
+    size_t header_size() const;
+    Uint64 count(E2EStatus status) const { return counts_[static_cast<int>(status)].load(std::memory_order_relaxed); }
+    size_t peers() const { return peers_.size(); }
+
+private:
+    static constexpr Uint32 NO_COUNTER = 0xFFFFFFFF;
+
+    struct Peer {
+        std::atomic<Uint32> tx_counter{0};
+        std::atomic<Uint32> rx_counter{NO_COUNTER};
+    };
+
+    explicit E2EStage(const E2EConfig& config) : config_(config), peers_(config.max_peers) {}
+    Uint32 counter_range() const;
+    Uint32 compute_crc(const uint8_t* data, size_t len) const;
+    bool protect(Payload& payload, const PeerKey& peer);
+    bool check(Payload& payload, const PeerKey& peer);
+    E2EStatus check_status(const uint8_t* data, size_t len, const PeerKey& peer);
+
+    E2EConfig config_;
+    PeerTable<Peer> peers_;
+    std::atomic<Uint64> counts_[4] = {};
+};
+
+} // namespace someip
+
+#endif // SOMEIP_E2E_HPP
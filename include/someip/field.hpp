@@ -0,0 +1,191 @@
+#ifndef SOMEIP_FIELD_HPP
+#define SOMEIP_FIELD_HPP
+
+#include "types.hpp"
+#include "serialization.hpp"
+#include "service.hpp"
+#include "transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace someip {
+
+// Wire format of a field value. Integral and floating-point types are big-endian, Payload is
+// raw bytes; specialize for other types.
+template <typename T, typename Enable = void>
+struct FieldCodec;
+
+template <typename T>
+struct FieldCodec<T, std::enable_if_t<std::is_arithmetic<T>::value>> {
+    static void write(SerializationBuffer& out, const T& value) {
+        uint8_t raw[sizeof(T)], be[sizeof(T)];
+        std::memcpy(raw, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) be[i] = raw[is_little() ? sizeof(T) - 1 - i : i];
+        out.write_bytes(be, sizeof(T));
+    }
+    static T read(DeserializationBuffer& in) {
+        uint8_t raw[sizeof(T)];
+        in.ensure(sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) raw[is_little() ? sizeof(T) - 1 - i : i] = in.buf[in.pos + i];
+        in.pos += sizeof(T);
+        T value;
+        std::memcpy(&value, raw, sizeof(T));
+        return value;
+    }
+
+private:
+    static bool is_little() {
+        const Uint16 probe = 1;
+        return *reinterpret_cast<const uint8_t*>(&probe) == 1;
+    }
+};
+
+template <>
+struct FieldCodec<Payload> {
+    static void write(SerializationBuffer& out, const Payload& value) { out.write_bytes(value); }
+    static Payload read(DeserializationBuffer& in) { return in.read_bytes(in.remaining()); }
+};
+
+struct FieldOptions {
+    MethodId getter = 0;    // 0: no getter method
+    MethodId setter = 0;    // 0: no setter method
+    MethodId notifier = 0;  // event ID (0x8000..0xFFFE); 0: no notifications
+    std::chrono::milliseconds cycle{0};  // resend the value this often even if unchanged (0: never)
+};
+
+// Type-independent part of a field: the serialized value cache, the getter/setter methods
+// and notification fan-out
+class FieldBase {
+public:
+    FieldBase(ServiceId service, const FieldOptions& options);
+    virtual ~FieldBase() = default;
+    FieldBase(const FieldBase&) = delete;
+    FieldBase& operator=(const FieldBase&) = delete;
+
+    // Register the getter/setter with `registry` and send notifications through `endpoint`.
+    // The field must outlive the registration.
+    void attach(ServiceRegistry& registry, std::shared_ptr<Transport> endpoint);
+
+    // Notification receivers. A new subscriber gets the current value right away.
+    void subscribe(const Endpoint& subscriber);
+    void unsubscribe(const Endpoint& subscriber);
+
+    // Send the cyclic notification if the cycle has elapsed; call periodically
+    void poll();
+
+    // The serialized value getters answer with
+    Payload serialized() const;
+
+    Uint64 getter_hits() const { return getter_hits_.load(std::memory_order_relaxed); }
+    Uint64 notifications_sent() const { return notifications_.load(std::memory_order_relaxed); }
+    Uint64 notifications_suppressed() const { return suppressed_.load(std::memory_order_relaxed); }
+
+protected:
+    // Replace the cached value; notifies if the bytes differ from the last notification and
+    // `significant` is set (e.g. the change threshold was reached)
+    void publish(const Payload& bytes, bool significant);
+
+    // Cache the initial value without notifying
+    void initialize(const Payload& bytes);
+
+    // Decode, validate and store a setter request; the router answers with the current value
+    virtual ReturnCode apply_set(const Payload& request) = 0;
+
+private:
+    // Send `bytes` as a notification; takes a snapshot of the subscribers
+    void notify(const Payload& bytes, const Endpoint* only);
+
+    ServiceId service_;
+    FieldOptions options_;
+    std::shared_ptr<Transport> endpoint_;
+    mutable std::mutex mutex_;
+    Payload value_;     // current serialized value
+    Payload notified_;  // bytes of the last notification
+    std::chrono::steady_clock::time_point last_notify_;
+    std::vector<Endpoint> subscribers_;
+    std::atomic<Uint64> session_{0};  // wider than SessionId so that the 1..0xFFFF cycle never breaks
+    std::atomic<Uint64> getter_hits_{0};
+    std::atomic<Uint64> notifications_{0};
+    std::atomic<Uint64> suppressed_{0};
+};
+
+// Server-side SOME/IP field. Getters are answered from the cached serialized value without
+// running any user code; setters and set() go through the validator; notifications go out only
+// when the serialized value changes (by at least the change threshold, for arithmetic types)
+// and, if configured, every `cycle`.
+template <typename T>
+class Field : public FieldBase {
+public:
+    using Validator = std::function<bool(const T&)>;
+
+    Field(ServiceId service, const FieldOptions& options, const T& initial = T{}, Validator validator = nullptr)
+        : FieldBase(service, options), current_(initial), notified_value_(initial), validator_(std::move(validator)) {
+        initialize(encode(initial));
+    }
+
+    // Update the value; false (and no change) if the validator rejects it
+    bool set(const T& value) {
+        if (validator_ && !validator_(value)) return false;
+        Payload bytes = encode(value);
+        std::lock_guard<std::mutex> lk(value_mutex_);
+        bool significant = true;
+        if constexpr (std::is_arithmetic<T>::value) {
+            if (threshold_ > T{}) {
+                auto delta = value > notified_value_ ? value - notified_value_ : notified_value_ - value;
+                significant = !(delta < threshold_);
+            }
+        }
+        current_ = value;
+        if (significant) notified_value_ = value;
+        publish(bytes, significant);
+        return true;
+    }
+
+    T get() const {
+        std::lock_guard<std::mutex> lk(value_mutex_);
+        return current_;
+    }
+
+    // Suppress notifications for changes smaller than `threshold` relative to the last
+    // notified value (cyclic notifications still carry the current value)
+    template <typename U = T, typename = std::enable_if_t<std::is_arithmetic<U>::value>>
+    void set_change_threshold(U threshold) {
+        std::lock_guard<std::mutex> lk(value_mutex_);
+        threshold_ = threshold;
+    }
+
+protected:
+    ReturnCode apply_set(const Payload& request) override {
+        T value;
+        try {
+            DeserializationBuffer in(request);
+            value = FieldCodec<T>::read(in);
+            if (in.remaining() != 0) return ReturnCode::E_MALFORMED_MESSAGE;
+        } catch (const std::exception&) {
+            return ReturnCode::E_MALFORMED_MESSAGE;
+        }
+        return set(value) ? ReturnCode::E_OK : ReturnCode::E_NOT_OK;
+    }
+
+private:
+    static Payload encode(const T& value) {
+        SerializationBuffer buf;
+        FieldCodec<T>::write(buf, value);
+        return std::move(buf.buf);
+    }
+
+    mutable std::mutex value_mutex_;
+    T current_;
+    T notified_value_;
+    T threshold_{};
+    Validator validator_;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_FIELD_HPP
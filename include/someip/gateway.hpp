@@ -0,0 +1,101 @@
+#ifndef SOMEIP_GATEWAY_HPP
+#define SOMEIP_GATEWAY_HPP
+
+#include "types.hpp"
+#include "transport.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace someip {
+
+// Where a Gateway forwards matching messages
+struct GatewayRule {
+    static constexpr MethodId ANY_METHOD = 0xFFFF;
+    static constexpr InstanceId ANY_INSTANCE = 0xFFFF;
+
+    ServiceId service = 0;
+    MethodId method = ANY_METHOD;        // method or event ID
+    InstanceId instance = ANY_INSTANCE;  // instance of the ingress transport (Gateway::attach)
+    std::shared_ptr<Transport> from;     // ingress transport (nullptr: any attached one but `to`)
+    std::shared_ptr<Transport> to;       // egress transport
+    Endpoint dest;                       // receiver on the egress side
+};
+
+// Forwards SOME/IP datagrams between transports without parsing them into a SomeIpMessage.
+// Datagrams are matched on their raw header and sent on from the receive buffer; requests get
+// the gateway's client ID and a session of its own, and the response is mapped back to the
+// original client and session through a session table. A response is only accepted from the
+// transport and endpoint the request was sent to, and requests without a response are
+// forgotten after the timeout. Events and REQUEST_NO_RETURN messages go out unchanged.
+// Datagrams no rule matches go on to the transport's callback.
+class Gateway {
+public:
+    // `client_id` marks forwarded requests; it must not be used by another client of the
+    // servers behind the gateway. Pending requests expire after `timeout`.
+    explicit Gateway(ClientId client_id = 0x7F00, std::chrono::milliseconds timeout = std::chrono::seconds(5));
+
+    // Forward matching datagrams received on `transport`, an endpoint serving `instance`.
+    // Installs the transport's datagram hook; call before traffic starts.
+    void attach(std::shared_ptr<Transport> transport, InstanceId instance = GatewayRule::ANY_INSTANCE);
+
+    // Rules are tried in the order added. The egress transport is attached for its responses
+    // if it is not yet. Configure before traffic starts.
+    void add_rule(GatewayRule rule);
+
+    // Forget pending requests older than the timeout; returns how many. Also runs on its own
+    // while requests are forwarded, at most once per timeout period.
+    size_t expire_pending();
+
+    struct Stats {
+        Uint64 requests = 0;   // forwarded with a mapped session
+        Uint64 messages = 0;   // forwarded unchanged (events, REQUEST_NO_RETURN)
+        Uint64 responses = 0;  // mapped back to their client
+        Uint64 orphaned = 0;   // responses without a matching pending request, or from elsewhere (dropped)
+        Uint64 expired = 0;    // pending requests that got no response in time
+        Uint64 send_failures = 0;
+    };
+    Stats stats() const;
+
+private:
+    // A forwarded request awaiting its response, indexed by the gateway session ID
+    struct Pending {
+        bool used = false;
+        ServiceId service = 0;
+        MethodId method = 0;
+        ClientId client = 0;
+        SessionId session = 0;
+        Uint32 addr = 0;  // the original client, host byte order
+        uint16_t port = 0;
+        Transport* back = nullptr;  // transport the request arrived on
+        Transport* out = nullptr;   // transport it was sent on; the response must arrive there
+        Uint32 dest_addr = 0;       // ... from the endpoint it was sent to, host byte order
+        uint16_t dest_port = 0;
+        Uint64 sent_ns = 0;
+    };
+    struct Route {
+        GatewayRule rule;
+        Uint32 dest_addr;  // rule.dest, host byte order
+    };
+
+    bool handle(Transport* ingress, InstanceId instance, uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port);
+    bool forward_response(Transport* ingress, uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port,
+                          ServiceId service, MethodId method);
+    size_t expire_locked(Uint64 now);
+
+    const ClientId client_id_;
+    const Uint64 timeout_ns_;
+    std::vector<std::shared_ptr<Transport>> attached_;
+    std::vector<Route> rules_;
+    std::mutex mutex_;  // pending_, next_session_ and last_sweep_ns_
+    std::vector<Pending> pending_;
+    SessionId next_session_ = 0;
+    Uint64 last_sweep_ns_ = 0;
+    std::atomic<Uint64> requests_{0}, messages_{0}, responses_{0}, orphaned_{0}, expired_{0}, send_failures_{0};
+};
+
+} // namespace someip
+
+#endif // SOMEIP_GATEWAY_HPP
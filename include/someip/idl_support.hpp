@@ -0,0 +1,196 @@
+#ifndef SOMEIP_IDL_SUPPORT_HPP
+#define SOMEIP_IDL_SUPPORT_HPP
+
+// Runtime support for code generated by someip_idlc (tools/someip_idlc.cpp): big-endian wire
+// access for generated layouts and the base classes of generated proxies and skeletons.
+
+#include "types.hpp"
+#include "serialization.hpp"
+#include "field.hpp"
+#include "message_router.hpp"
+#include "transport.hpp"
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace someip {
+namespace wire {
+
+// Trailing variable-length bytes of a received message, pointing into its payload
+struct BytesView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    BytesView() = default;
+    BytesView(const uint8_t* d, size_t n) : data(d), size(n) {}
+    BytesView(const Payload& p) : data(p.data()), size(p.size()) {}
+    Payload to_payload() const { return Payload(data, data + size); }
+};
+
+// Generated records (structs and parameter lists) have a nested View and a fixed SIZE
+template <typename T, typename = void>
+struct is_record : std::false_type {};
+template <typename T>
+struct is_record<T, std::void_t<typename T::View, decltype(T::SIZE)>> : std::true_type {};
+
+template <typename T>
+inline T load(const uint8_t* p) {
+    static_assert(std::is_arithmetic<T>::value, "load() reads scalars");
+    if constexpr (std::is_same<T, bool>::value) {
+        return p[0] != 0;
+    } else if constexpr (sizeof(T) == 1) {
+        return static_cast<T>(p[0]);
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == 2, Uint16, std::conditional_t<sizeof(T) == 4, Uint32, Uint64>>;
+        Bits bits;
+        std::memcpy(&bits, p, sizeof(T));
+        if constexpr (sizeof(T) == 2) bits = endian::ntoh16(bits);
+        else if constexpr (sizeof(T) == 4) bits = endian::ntoh32(bits);
+        else bits = endian::ntoh64(bits);
+        T v;
+        std::memcpy(&v, &bits, sizeof(T));
+        return v;
+    }
+}
+
+template <typename T>
+inline void store(uint8_t* p, T v) {
+    static_assert(std::is_arithmetic<T>::value, "store() writes scalars");
+    if constexpr (std::is_same<T, bool>::value) {
+        p[0] = v ? 1 : 0;
+    } else if constexpr (sizeof(T) == 1) {
+        p[0] = static_cast<uint8_t>(v);
+    } else {
+        using Bits = std::conditional_t<sizeof(T) == 2, Uint16, std::conditional_t<sizeof(T) == 4, Uint32, Uint64>>;
+        Bits bits;
+        std::memcpy(&bits, &v, sizeof(T));
+        if constexpr (sizeof(T) == 2) bits = endian::hton16(bits);
+        else if constexpr (sizeof(T) == 4) bits = endian::hton32(bits);
+        else bits = endian::hton64(bits);
+        std::memcpy(p, &bits, sizeof(T));
+    }
+}
+
+// Write a member at `p`: scalars big-endian, records through their write(), bytes verbatim
+template <typename T>
+inline void put(uint8_t* p, const T& v) {
+    if constexpr (is_record<T>::value) v.write(p);
+    else store<T>(p, v);
+}
+inline void put(uint8_t* p, const BytesView& v) {
+    if (v.size) std::memcpy(p, v.data, v.size);
+}
+inline void put(uint8_t* p, const Payload& v) {
+    if (!v.empty()) std::memcpy(p, v.data(), v.size());
+}
+
+// A datagram with header headroom and `payload_size` bytes behind it, for generated senders
+inline Payload datagram(size_t payload_size) {
+    return Payload(SomeIpHeader::SIZE + payload_size);
+}
+
+// Append a record to a response buffer
+template <typename T>
+inline void append(SerializationBuffer& out, const T& v) {
+    size_t at = out.buf.size();
+    out.buf.resize(at + v.wire_size());
+    v.write(out.buf.data() + at);
+}
+
+// Decode a complete payload holding exactly one value of T; false if the size is wrong
+template <typename T>
+inline bool decode(const Payload& in, T& out) {
+    if constexpr (is_record<T>::value) {
+        if (!T::fits(in.size())) return false;
+        out = typename T::View(in.data(), in.size()).value();
+    } else {
+        if (in.size() != sizeof(T)) return false;
+        out = load<T>(in.data());
+    }
+    return true;
+}
+
+inline bool decode(const Payload& in, Payload& out) {
+    out = in;
+    return true;
+}
+
+// Serialized size of a field value
+template <typename T>
+inline size_t size_of(const T& v) {
+    if constexpr (is_record<T>::value) return v.wire_size();
+    else return sizeof(T);
+}
+
+} // namespace wire
+
+// Generated records are field values too
+template <typename T>
+struct FieldCodec<T, std::enable_if_t<wire::is_record<T>::value>> {
+    static void write(SerializationBuffer& out, const T& value) { wire::append(out, value); }
+    static T read(DeserializationBuffer& in) {
+        size_t n = T::VARIABLE ? in.remaining() : T::SIZE;
+        in.ensure(n);
+        T value = typename T::View(in.buf.data() + in.pos, n).value();
+        in.pos += n;
+        return value;
+    }
+};
+
+// Client side of a generated service: builds requests in place behind header headroom and
+// applies per-method protection stages like MessageRouter::add_protection
+class ProxyBase {
+public:
+    ProxyBase(ServiceId service, Uint8 interface_version, std::shared_ptr<Transport> transport, Endpoint server,
+              ClientId client);
+
+    // Protect requests of `method` and check its responses; configure before sending
+    void add_protection(MethodId method, std::shared_ptr<ProtectionStage> stage);
+
+    const Endpoint& server() const { return server_; }
+    ServiceId service() const { return service_; }
+
+protected:
+    // Fill in the header (and protection) of a wire::datagram() and send it to the server
+    bool send_request(MethodId method, Payload& datagram, MessageType type = MessageType::REQUEST);
+
+    // Payload of a response after its protection is checked and stripped; nullptr if a check
+    // fails. `scratch` holds the stripped copy when the method is protected.
+    const Payload* checked_payload(const SomeIpMessage& msg, Payload& scratch) const;
+
+private:
+    ServiceId service_;
+    Uint8 interface_version_;
+    std::shared_ptr<Transport> transport_;
+    Endpoint server_;
+    ClientId client_;
+    std::atomic<Uint64> session_{0};  // wider than SessionId so that the 1..0xFFFF cycle never breaks
+    std::unordered_map<MethodId, std::vector<std::shared_ptr<ProtectionStage>>> protection_;
+};
+
+// Server side of a generated service: sends its events
+class SkeletonBase {
+public:
+    SkeletonBase(ServiceId service, Uint8 interface_version) : service_(service), interface_version_(interface_version) {}
+    virtual ~SkeletonBase() = default;
+    SkeletonBase(const SkeletonBase&) = delete;
+    SkeletonBase& operator=(const SkeletonBase&) = delete;
+
+protected:
+    void set_transport(std::shared_ptr<Transport> transport) { transport_ = std::move(transport); }
+
+    // Fill in the header of a wire::datagram() and send it to `to` as a notification
+    bool send_event(MethodId event, Payload& datagram, const Endpoint& to);
+
+private:
+    ServiceId service_;
+    Uint8 interface_version_;
+    std::shared_ptr<Transport> transport_;
+    std::atomic<Uint64> session_{0};  // wider than SessionId so that the 1..0xFFFF cycle never breaks
+};
+
+} // namespace someip
+
+#endif // SOMEIP_IDL_SUPPORT_HPP
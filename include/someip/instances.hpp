@@ -0,0 +1,98 @@
+#ifndef SOMEIP_INSTANCES_HPP
+#define SOMEIP_INSTANCES_HPP
+
+#include "types.hpp"
+#include "message_router.hpp"
+#include "service.hpp"
+#include "service_discovery.hpp"
+#include "transport.hpp"
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace someip {
+
+// One hosted instance of a service with its own endpoint, registry and router. SOME/IP requests
+// carry no instance ID; the endpoint they arrive on selects the instance. They are routed on
+// that endpoint's receive thread, so instances share no locks and scale with the threads
+// (and CPUs) their endpoints run on.
+class ServiceInstance {
+public:
+    // Routes everything `endpoint` receives; replace its callback to add a Dispatcher or filter
+    ServiceInstance(ServiceId service, InstanceId instance, std::shared_ptr<Transport> endpoint);
+    // Stops the endpoint and clears its callback, which refers to this instance's router
+    ~ServiceInstance();
+
+    ServiceId service_id() const { return service_; }
+    InstanceId instance_id() const { return instance_; }
+    const std::shared_ptr<Transport>& endpoint() const { return endpoint_; }
+    ServiceRegistry& registry() { return registry_; }
+    MessageRouter& router() { return *router_; }
+
+    // Register a method of this instance
+    void register_method(MethodId method, MethodHandler handler) {
+        registry_.register_method(service_, method, std::move(handler));
+    }
+    void register_method(MethodId method, BufferMethodHandler handler) {
+        registry_.register_method(service_, method, std::move(handler));
+    }
+
+    // SD entry pointing at this instance's endpoint
+    SdOffer offer(uint32_t ttl) const;
+
+private:
+    ServiceId service_;
+    InstanceId instance_;
+    std::shared_ptr<Transport> endpoint_;
+    ServiceRegistry registry_;
+    std::unique_ptr<MessageRouter> router_;
+};
+
+// The service instances of one process, e.g. front-left and front-right brake controllers,
+// each on its own endpoint:
+//
+//   InstanceHost host;
+//   EndpointOptions left;
+//   left.thread.cpu = 2;  // shard: the receive thread that routes this instance
+//   host.add_udp(0x1300, 1, "0.0.0.0", 30501, left)->register_method(0x0010, press_left);
+//   host.add_udp(0x1300, 2, "0.0.0.0", 30502, right)->register_method(0x0010, press_right);
+//   host.start();
+//   host.offer(sd);
+class InstanceHost {
+public:
+    InstanceHost() = default;
+    ~InstanceHost();
+    InstanceHost(const InstanceHost&) = delete;
+    InstanceHost& operator=(const InstanceHost&) = delete;
+
+    // Host `instance` of `service` on `endpoint`. nullptr if that instance is already hosted or
+    // the endpoint is null. Add instances before start().
+    ServiceInstance* add(ServiceId service, InstanceId instance, std::shared_ptr<Transport> endpoint);
+
+    // As above on a new UDP endpoint; `options.thread` places its receive thread
+    ServiceInstance* add_udp(ServiceId service, InstanceId instance, const std::string& bind_ip, uint16_t bind_port,
+                             const EndpointOptions& options = {});
+
+    // nullptr if not hosted
+    ServiceInstance* find(ServiceId service, InstanceId instance) const;
+
+    // All hosted instances of `service`, by instance ID
+    std::vector<ServiceInstance*> instances(ServiceId service) const;
+
+    size_t size() const { return instances_.size(); }
+
+    // Start every endpoint; false (with the started ones stopped again) if one fails
+    bool start();
+    void stop();
+
+    // Offer every instance at its own endpoint, or withdraw the offers
+    void offer(ServiceDiscovery& sd, uint32_t ttl = 3) const;
+    void stop_offer(ServiceDiscovery& sd) const;
+
+private:
+    std::map<std::pair<ServiceId, InstanceId>, std::unique_ptr<ServiceInstance>> instances_;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_INSTANCES_HPP
@@ -0,0 +1,171 @@
+#ifndef SOMEIP_LOGGING_HPP
+#define SOMEIP_LOGGING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+// Compile-time level filter: 0 = debug, 1 = info, 2 = error, 3 = off.
+// Calls below the level expand to nothing, including their argument expressions.
+#ifndef SOMEIP_LOG_LEVEL
+#define SOMEIP_LOG_LEVEL 1
+#endif
+
+namespace someip {
+namespace logging {
+
+enum class Level : uint8_t {
+    DBG = 0,
+    INFO = 1,
+    ERR = 2
+};
+
+constexpr int compiled_level = SOMEIP_LOG_LEVEL;
+
+// Fixed-size binary record written by the calling thread and formatted later by the
+// logger thread. `format` must be a string literal; arguments are copied into `data`.
+struct Record {
+    static constexpr size_t SIZE = 256;
+    static constexpr size_t MAX_ARGS = 8;
+
+    enum ArgKind : uint8_t { SIGNED = 0, UNSIGNED = 1, DOUBLE = 2, STRING = 3 };
+
+    uint64_t timestamp_ns;  // system clock
+    const char* format;
+    uint32_t suppressed;    // repeats dropped by the rate limiter before this record
+    uint16_t used;          // bytes of data in use
+    uint8_t level;
+    uint8_t nargs;
+    uint8_t kinds[MAX_ARGS];
+    uint8_t data[SIZE - 32];
+
+    void add(int64_t v) { put(SIGNED, &v, sizeof(v)); }
+    void add(uint64_t v) { put(UNSIGNED, &v, sizeof(v)); }
+    void add(double v) { put(DOUBLE, &v, sizeof(v)); }
+    void add(const char* s) { add(s ? s : "(null)", s ? std::strlen(s) : 6); }
+    void add(const std::string& s) { add(s.data(), s.size()); }
+    void add(const char* s, size_t n);
+
+private:
+    void put(ArgKind kind, const void* p, size_t n);
+};
+static_assert(sizeof(Record) == Record::SIZE, "log record layout");
+
+// Destination for formatted lines; the default writes INFO/DEBUG to stdout and ERROR to stderr
+using Sink = std::function<void(Level level, const char* line)>;
+void set_sink(Sink sink);
+
+// Block until every record written so far has been formatted and handed to the sink
+void flush();
+
+// Records lost because a thread's ring was full (the logger never blocks the caller)
+uint64_t dropped_records();
+
+namespace detail {
+
+// Claim the next free record in the calling thread's ring, or nullptr if it is full
+Record* begin_record(Level level, const char* format);
+void commit_record(Record* rec);
+
+inline void add_arg(Record& r, bool v) { r.add(uint64_t(v)); }
+inline void add_arg(Record& r, char v) { r.add(int64_t(v)); }
+inline void add_arg(Record& r, const char* v) { r.add(v); }
+inline void add_arg(Record& r, const std::string& v) { r.add(v); }
+template <typename T>
+inline void add_arg(Record& r, const T& v) {
+    if constexpr (std::is_array<T>::value) r.add(static_cast<const char*>(v));
+    else if constexpr (std::is_floating_point<T>::value) r.add(double(v));
+    else if constexpr (std::is_enum<T>::value) r.add(uint64_t(v));
+    else if constexpr (std::is_pointer<T>::value) r.add(uint64_t(reinterpret_cast<uintptr_t>(v)));
+    else if constexpr (std::is_signed<T>::value) r.add(int64_t(v));
+    else r.add(uint64_t(v));
+}
+
+// Per-call-site limiter for repeated messages: `burst` records per one-second window,
+// the rest are counted and reported on the next record that gets through.
+class RateLimiter {
+public:
+    explicit constexpr RateLimiter(uint32_t burst) : burst_(burst) {}
+
+    // Returns false to suppress; `suppressed` receives the count to attach when allowed
+    bool allow(uint32_t& suppressed) {
+        uint64_t now = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        uint64_t window = window_start_.load(std::memory_order_relaxed);
+        if (now - window >= 1000000000ULL &&
+            window_start_.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+            count_.store(0, std::memory_order_relaxed);
+        }
+        if (count_.fetch_add(1, std::memory_order_relaxed) < burst_) {
+            suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+            return true;
+        }
+        suppressed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    uint32_t burst_;
+    std::atomic<uint64_t> window_start_{0};
+    std::atomic<uint32_t> count_{0};
+    std::atomic<uint32_t> suppressed_{0};
+};
+
+} // namespace detail
+
+template <typename... Args>
+inline void write(Level level, const char* format, const Args&... args) {
+    Record* r = detail::begin_record(level, format);
+    if (!r) return;
+    (detail::add_arg(*r, args), ...);
+    detail::commit_record(r);
+}
+
+template <typename... Args>
+inline void write_limited(detail::RateLimiter& limiter, Level level, const char* format, const Args&... args) {
+    uint32_t suppressed = 0;
+    if (!limiter.allow(suppressed)) return;
+    Record* r = detail::begin_record(level, format);
+    if (!r) return;
+    r->suppressed = suppressed;
+    (detail::add_arg(*r, args), ...);
+    detail::commit_record(r);
+}
+
+// Plain-text form used by log_info/log_debug/log_error
+inline void write_text(Level level, const std::string& text) {
+    write(level, "%s", text);
+}
+
+} // namespace logging
+} // namespace someip
+
+// printf-style logging macros. The format must be a string literal; %s arguments are copied.
+#if SOMEIP_LOG_LEVEL <= 0
+#define SOMEIP_LOG_DEBUG(...) ::someip::logging::write(::someip::logging::Level::DBG, __VA_ARGS__)
+#else
+#define SOMEIP_LOG_DEBUG(...) do {} while (0)
+#endif
+
+#if SOMEIP_LOG_LEVEL <= 1
+#define SOMEIP_LOG_INFO(...) ::someip::logging::write(::someip::logging::Level::INFO, __VA_ARGS__)
+#else
+#define SOMEIP_LOG_INFO(...) do {} while (0)
+#endif
+
+// Errors are rate-limited per call site (10 per second) so a flood cannot swamp the logger
+#if SOMEIP_LOG_LEVEL <= 2
+#define SOMEIP_LOG_ERROR(...)                                                              \
+    do {                                                                                   \
+        static ::someip::logging::detail::RateLimiter someip_log_limiter_(10);             \
+        ::someip::logging::write_limited(someip_log_limiter_, ::someip::logging::Level::ERR, __VA_ARGS__); \
+    } while (0)
+#else
+#define SOMEIP_LOG_ERROR(...) do {} while (0)
+#endif
+
+#endif // SOMEIP_LOGGING_HPP
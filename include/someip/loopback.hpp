@@ -0,0 +1,147 @@
+#ifndef SOMEIP_LOOPBACK_HPP
+#define SOMEIP_LOOPBACK_HPP
+
+#include "types.hpp"
+#include "transport.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace someip {
+
+class LoopbackEndpoint;
+
+struct LoopbackOptions {
+    // Virtual clock: time only moves as run_until()/run_for() process events, on the calling
+    // thread, so a simulation replays identically. Otherwise a network thread delivers in real time.
+    bool virtual_clock = true;
+    std::chrono::nanoseconds latency{0};  // one-way delivery delay
+    double loss = 0;                      // fraction of datagrams lost, drawn from a seeded PRNG
+    Uint64 seed = 1;
+};
+
+// In-memory IPv4/UDP network for simulating many ECUs in one process. Endpoints bind any
+// address and port (no real interfaces involved); multicast groups reach every member bound to
+// the destination port, the sender included. Delivery is FIFO per delivery time.
+class LoopbackNetwork : public std::enable_shared_from_this<LoopbackNetwork> {
+public:
+    static std::shared_ptr<LoopbackNetwork> create(LoopbackOptions options = {});
+    ~LoopbackNetwork();
+    LoopbackNetwork(const LoopbackNetwork&) = delete;
+    LoopbackNetwork& operator=(const LoopbackNetwork&) = delete;
+
+    // An endpoint on this network; start() binds it like UdpEndpoint::start()
+    std::shared_ptr<LoopbackEndpoint> create_endpoint(const std::string& ip, uint16_t port);
+
+    // Network time in ns: virtual time since creation, or steady_clock time
+    Uint64 now_ns() const;
+
+    // Run `fn` on the network's clock, once at `at_ns` or every `period` from now
+    void at(Uint64 at_ns, std::function<void()> fn);
+    void every(std::chrono::nanoseconds period, std::function<void()> fn);
+
+    // Virtual clock: process events in time order up to `until_ns` (then set the clock there)
+    // or until none are left. Returns the number of events processed. Real clock: no-op.
+    size_t run_until(Uint64 until_ns);
+    size_t run_for(std::chrono::nanoseconds duration) { return run_until(now_ns() + Uint64(duration.count())); }
+    size_t run();  // until the queue is empty; never returns while every() timers exist
+
+    struct Stats {
+        Uint64 sent = 0;
+        Uint64 delivered = 0;     // datagrams handed to an endpoint (per member for multicast)
+        Uint64 lost = 0;          // dropped by the loss model
+        Uint64 unreachable = 0;   // no endpoint bound at the destination
+    };
+    Stats stats() const;
+
+private:
+    friend class LoopbackEndpoint;
+
+    struct Event {
+        Uint64 due_ns = 0;
+        Uint64 seq = 0;
+        Uint32 src_addr = 0, dst_addr = 0;
+        uint16_t src_port = 0, dst_port = 0;
+        Payload data;
+        std::function<void()> fn;  // timer events
+        Uint64 period_ns = 0;      // repeating timers
+    };
+
+    explicit LoopbackNetwork(LoopbackOptions options);
+
+    static Uint64 key(Uint32 addr, uint16_t port) { return (Uint64(addr) << 16) | port; }
+
+    bool bind(LoopbackEndpoint* endpoint);
+    void unbind(LoopbackEndpoint* endpoint);
+    void join(LoopbackEndpoint* endpoint, Uint32 group);
+    void leave(LoopbackEndpoint* endpoint, Uint32 group);
+    void send(Uint32 src_addr, uint16_t src_port, Payload data, const Endpoint& dest);
+
+    void push(Event&& event);              // with mutex_ held
+    bool pop_due(Uint64 until_ns, Event& event);  // with mutex_ held
+    void dispatch(Event& event);           // without the lock
+    void deliver_loop(std::weak_ptr<LoopbackNetwork> weak);  // real-clock network thread
+    bool lose();                           // with mutex_ held
+
+    LoopbackOptions options_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::vector<Event> queue_;  // min-heap on (due_ns, seq)
+    Uint64 seq_ = 0;
+    Uint64 virtual_now_ = 0;
+    Uint64 rng_;
+    Stats stats_;
+    std::unordered_map<Uint64, std::weak_ptr<LoopbackEndpoint>> bound_;
+    std::unordered_map<Uint32, std::vector<std::weak_ptr<LoopbackEndpoint>>> groups_;
+    std::thread thread_;
+    bool stopping_ = false;
+};
+
+// Transport on a LoopbackNetwork: a drop-in for UdpEndpoint in routers, fields and SD.
+// Callbacks run on the thread delivering the network's events. stop() returns once no callback
+// runs any more, except one that called it.
+class LoopbackEndpoint : public Transport, public std::enable_shared_from_this<LoopbackEndpoint> {
+public:
+    ~LoopbackEndpoint() override;
+
+    bool start() override;
+    void stop() override;
+    bool send_to(const Payload& data, const Endpoint& dest) override;
+    bool send_bytes(const uint8_t* data, size_t len, const Endpoint& dest) override;
+    bool join_multicast(const std::string& mcast_addr) override;
+    bool leave_multicast(const std::string& mcast_addr) override;
+    std::string local_ip() const override { return ip_; }
+    uint16_t local_port() const override { return port_; }
+
+    Uint64 datagrams_received() const { return received_.load(std::memory_order_relaxed); }
+    // Datagrams dropped because they are not a valid SOME/IP message
+    Uint64 parse_errors() const { return parse_errors_.load(std::memory_order_relaxed); }
+
+private:
+    friend class LoopbackNetwork;
+
+    LoopbackEndpoint(std::shared_ptr<LoopbackNetwork> network, const std::string& ip, uint16_t port);
+    // `shared`: the datagram goes to several endpoints (multicast), so a hook works on a copy
+    void receive(Payload& data, Uint32 src_addr, uint16_t src_port, Uint64 now_ns, bool shared);
+    void deliver(Payload& data, Uint32 src_addr, uint16_t src_port, Uint64 now_ns, bool shared);
+    void reject(const Payload& data, Uint32 src_addr, uint16_t src_port);
+
+    std::shared_ptr<LoopbackNetwork> network_;
+    std::string ip_;
+    uint16_t port_;
+    Uint32 addr_ = 0;  // host byte order
+    std::atomic<bool> running_{false};  // cleared under delivery_mutex_
+    std::atomic<Uint64> received_{0};
+    std::atomic<Uint64> parse_errors_{0};
+    std::mutex delivery_mutex_;
+    std::condition_variable delivery_cv_;
+    size_t deliveries_ = 0;  // receive() calls in progress, under delivery_mutex_
+};
+
+} // namespace someip
+
+#endif // SOMEIP_LOOPBACK_HPP
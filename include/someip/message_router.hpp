@@ -2,29 +2,116 @@
 #define SOMEIP_MESSAGE_ROUTER_HPP
 
 #include "types.hpp"
+#include "duplicate_window.hpp"
+#include "response_cache.hpp"
 #include "service.hpp"
 #include "someip_message.hpp"
+#include "static_registry.hpp"
 #include "transport.hpp"
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace someip {
 
+// Payload protection applied per (service, method) around the handlers, e.g. SecOC
+// authentication or E2E checksums. Stages must be safe to call from several threads.
+class ProtectionStage {
+public:
+    virtual ~ProtectionStage() = default;
+
+    // Verify and strip the protection of a received payload; false drops the message
+    virtual bool check(const SomeIpHeader& header, Payload& payload) = 0;
+
+    // Add protection to an outgoing payload (the header length is fixed up afterwards)
+    virtual bool protect(const SomeIpHeader& header, Payload& payload) = 0;
+
+    // The same for a message from or to `peer`; the router and proxies call these. Stages
+    // that keep state per peer, like SecOC freshness, override them; by default the peer
+    // is ignored.
+    virtual bool check(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+        (void)peer;
+        return check(header, payload);
+    }
+    virtual bool protect(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+        (void)peer;
+        return protect(header, payload);
+    }
+};
+
 class MessageRouter {
 public:
-    MessageRouter(std::shared_ptr<UdpEndpoint> endpoint, ServiceRegistry& registry);
+    MessageRouter(std::shared_ptr<Transport> endpoint, ServiceRegistry& registry);
 
     // Route an incoming message (called by transport callback)
     void route(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto);
 
+    // The request whose handler is running on this thread, or nullptr. Lets handlers read the
+    // header and receive timestamps (msg.rx) beyond the payload and source they are passed.
+    static const SomeIpMessage* current_request();
+
     // Helper to construct and send a response
     void send_response(const SomeIpMessage& request, const MethodResult& result, const Endpoint& dest);
 
-    // Helper to send errors
+    // Helper to send errors; protected methods protect them like any response
     void send_error(const SomeIpMessage& request, ReturnCode rc, const Endpoint& dest);
 
+    // Attach a protection stage to a method. Requests are checked before the handler runs and
+    // responses are protected before sending; several stages are protected in the order added
+    // and checked in reverse. Configure before routing starts.
+    void add_protection(ServiceId service, MethodId method, std::shared_ptr<ProtectionStage> stage);
+    bool is_protected(ServiceId service, MethodId method) const { return protection_for(service, method) != nullptr; }
+
+    // Route requests through a compile-time table (StaticRegistry::routes()) first; methods it
+    // does not contain fall back to the ServiceRegistry. Configure before routing starts.
+    void set_static_routes(StaticRoutes routes) { static_routes_ = routes; }
+
+    // Cache the E_OK responses of a method that only reads state, keyed by request payload.
+    // Hits are answered from the stored response bytes, with the requester's client and session
+    // IDs patched in, without running the handler. Configure before routing starts.
+    void enable_cache(ServiceId service, MethodId method, ResponseCacheOptions options = {});
+
+    // Drop the cached responses of a method, e.g. when the state it reads changed; safe while
+    // routing. Handlers already running when it is called do not store their responses.
+    void invalidate_cache(ServiceId service, MethodId method);
+
+    // Responses currently cached for a method (0 without a cache)
+    size_t cached_responses(ServiceId service, MethodId method) const {
+        ResponseCache* cache = cache_for(service, method);
+        return cache ? cache->size() : 0;
+    }
+
+    // Remember recent requests per client with the responses sent. A retransmitted request
+    // (same client, session, method and payload) is answered with the stored response instead
+    // of running the handler again, and dropped while the original is still being handled.
+    // Requests with session ID 0 are not tracked. Configure before routing starts.
+    void enable_duplicate_detection(DuplicateWindowOptions options = {});
+
 private:
-    std::shared_ptr<UdpEndpoint> endpoint_;
+    // Send a response a BufferMethodHandler wrote behind the header headroom of `out`
+    void send_buffer_response(const SomeIpMessage& request, ReturnCode rc, Payload& out, const Endpoint& dest);
+
+    // Answer from `cache`; false on a miss
+    bool send_cached(ResponseCache& cache, const SomeIpMessage& request, const Payload& payload, const Endpoint& dest);
+
+    // send_buffer_response, storing an E_OK response in `cache` (if any) on the way unless the
+    // cache was invalidated after `generation` was taken
+    void send_and_cache(const SomeIpMessage& request, ReturnCode rc, Payload& out, const Endpoint& dest,
+                        ResponseCache* cache, const Payload& payload, Uint64 generation);
+    ResponseCache* cache_for(ServiceId service, MethodId method) const;
+
+    // Send a response datagram, recording it in the duplicate window for `request`
+    void transmit(const SomeIpMessage& request, const Payload& datagram, const Endpoint& dest);
+
+    using Stages = std::vector<std::shared_ptr<ProtectionStage>>;
+    const Stages* protection_for(ServiceId service, MethodId method) const;
+
+    std::shared_ptr<Transport> endpoint_;
     ServiceRegistry& registry_;
+    StaticRoutes static_routes_;
+    std::unordered_map<Uint32, Stages> protection_;
+    std::unordered_map<Uint32, std::unique_ptr<ResponseCache>> caches_;
+    std::unique_ptr<DuplicateWindow> duplicates_;
 };
 
 } // namespace someip
@@ -0,0 +1,222 @@
+#ifndef SOMEIP_METRICS_HPP
+#define SOMEIP_METRICS_HPP
+
+#include "types.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Built-in hot path instrumentation. Define SOMEIP_ENABLE_METRICS=0 (CMake option
+// SOMEIP_ENABLE_METRICS=OFF) to compile every recording call down to nothing.
+#ifndef SOMEIP_ENABLE_METRICS
+#define SOMEIP_ENABLE_METRICS 1
+#endif
+
+namespace someip {
+namespace metrics {
+
+constexpr bool enabled = SOMEIP_ENABLE_METRICS != 0;
+
+// Index of the most significant set bit (v != 0)
+inline unsigned msb_index(Uint64 v) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanReverse64(&idx, v);
+    return static_cast<unsigned>(idx);
+#else
+    return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#endif
+}
+
+namespace detail { struct AtomicHistogram; }
+
+// Log-linear (HDR-style) histogram of nanosecond values.
+// Values below 8 are exact, above that every power of two is split into 8 sub-buckets,
+// so the relative error of any reported value is below 12.5%.
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static unsigned bucket_index(Uint64 v) {
+        if (v < SUB_BUCKETS) return static_cast<unsigned>(v);
+        unsigned e = msb_index(v);
+        unsigned sub = static_cast<unsigned>(v >> (e - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (e - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub;
+    }
+    static Uint64 bucket_lower_bound(unsigned idx) {
+        if (idx < SUB_BUCKETS) return idx;
+        unsigned e = idx / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        Uint64 sub = idx % SUB_BUCKETS;
+        return (SUB_BUCKETS + sub) << (e - SUB_BUCKET_BITS);
+    }
+    static Uint64 bucket_upper_bound(unsigned idx) {
+        if (idx < SUB_BUCKETS) return idx;
+        unsigned e = idx / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        return bucket_lower_bound(idx) + ((Uint64(1) << (e - SUB_BUCKET_BITS)) - 1);
+    }
+
+    void record(Uint64 v, Uint64 n = 1);
+    void merge(const LatencyHistogram& other);
+
+    Uint64 count() const { return count_; }
+    Uint64 sum() const { return sum_; }
+    Uint64 min() const { return count_ ? min_ : 0; }
+    Uint64 max() const { return max_; }
+    double mean() const { return count_ ? double(sum_) / double(count_) : 0.0; }
+
+    // Value at quantile q in [0,1] (upper bound of the containing bucket, clamped to max)
+    Uint64 percentile(double q) const;
+
+    const std::array<Uint64, BUCKETS>& buckets() const { return counts_; }
+
+private:
+    friend struct detail::AtomicHistogram;
+
+    std::array<Uint64, BUCKETS> counts_{};
+    Uint64 count_ = 0;
+    Uint64 sum_ = 0;
+    Uint64 min_ = ~Uint64(0);
+    Uint64 max_ = 0;
+};
+
+// Per-(service, method) totals merged from every recording thread
+struct MethodSnapshot {
+    ServiceId service_id;
+    MethodId method_id;
+    Uint64 received = 0;
+    Uint64 dispatched = 0;
+    Uint64 errored = 0;
+    Uint64 dropped = 0;
+    Uint64 cache_hits = 0;       // requests answered from the response cache
+    Uint64 cache_misses = 0;     // requests of a cached method that ran the handler
+    Uint64 cache_evictions = 0;  // cached responses expired, displaced or invalidated
+    Uint64 duplicates = 0;       // retransmitted requests caught by duplicate detection
+    LatencyHistogram handler_time;     // handler execution time, ns
+    LatencyHistogram receive_to_send;  // request receipt until response sent, ns
+    LatencyHistogram queue_delay;      // time spent in a dispatcher queue, ns
+    LatencyHistogram socket_delay;     // kernel receive timestamp until read from the socket, ns
+};
+
+struct Snapshot {
+    std::vector<MethodSnapshot> methods;  // sorted by (service, method)
+
+    const MethodSnapshot* find(ServiceId svc, MethodId mth) const;
+};
+
+// Merge all per-thread recorders into one consistent-enough view (counters are read
+// with relaxed loads, so a snapshot taken under traffic may be off by in-flight messages)
+Snapshot snapshot();
+
+// Prometheus text exposition format (version 0.0.4)
+std::string to_prometheus(const Snapshot& snap);
+
+namespace detail {
+
+// Single-writer histogram owned by one thread; readers merge with relaxed loads
+struct AtomicHistogram {
+    std::array<std::atomic<Uint64>, LatencyHistogram::BUCKETS> counts{};
+    std::atomic<Uint64> sum{0};
+    std::atomic<Uint64> max{0};
+
+    void record(Uint64 v) {
+        bump(counts[LatencyHistogram::bucket_index(v)], 1);
+        bump(sum, v);
+        if (v > max.load(std::memory_order_relaxed)) max.store(v, std::memory_order_relaxed);
+    }
+    void merge_into(LatencyHistogram& out) const;
+
+    // Only the owning thread writes, so a plain load/store pair is enough and avoids a locked RMW
+    static void bump(std::atomic<Uint64>& c, Uint64 n) {
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+struct MethodCell {
+    std::atomic<Uint64> received{0};
+    std::atomic<Uint64> dispatched{0};
+    std::atomic<Uint64> errored{0};
+    std::atomic<Uint64> dropped{0};
+    std::atomic<Uint64> cache_hits{0};
+    std::atomic<Uint64> cache_misses{0};
+    std::atomic<Uint64> cache_evictions{0};
+    std::atomic<Uint64> duplicates{0};
+    AtomicHistogram handler_time;
+    AtomicHistogram receive_to_send;
+    AtomicHistogram queue_delay;
+    AtomicHistogram socket_delay;
+};
+
+// Thread-local cell for (svc, mth); allocated on first use by the calling thread.
+// Returns nullptr if the thread's table is full.
+MethodCell* cell(ServiceId svc, MethodId mth);
+
+} // namespace detail
+
+// Monotonic nanosecond clock used for all latency measurements (0 when metrics are compiled out)
+inline Uint64 now_ns() {
+    if constexpr (!enabled) {
+        return 0;
+    } else {
+        return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+}
+
+// Cheap handle to the calling thread's counters for one (service, method).
+// Construct once per message and record through it; everything is a no-op when disabled.
+class MethodRecorder {
+public:
+    MethodRecorder(ServiceId svc, MethodId mth) {
+        if constexpr (enabled) cell_ = detail::cell(svc, mth);
+        (void)svc; (void)mth;
+    }
+
+    void received() { add(&detail::MethodCell::received); }
+    void dispatched() { add(&detail::MethodCell::dispatched); }
+    void errored() { add(&detail::MethodCell::errored); }
+    void dropped() { add(&detail::MethodCell::dropped); }
+    void cache_hit() { add(&detail::MethodCell::cache_hits); }
+    void cache_miss() { add(&detail::MethodCell::cache_misses); }
+    void duplicate() { add(&detail::MethodCell::duplicates); }
+    void cache_evicted(Uint64 n) {
+        if constexpr (enabled) { if (cell_ && n) detail::AtomicHistogram::bump(cell_->cache_evictions, n); }
+        (void)n;
+    }
+
+    void handler_time(Uint64 ns) {
+        if constexpr (enabled) { if (cell_) cell_->handler_time.record(ns); }
+        (void)ns;
+    }
+    void receive_to_send(Uint64 ns) {
+        if constexpr (enabled) { if (cell_) cell_->receive_to_send.record(ns); }
+        (void)ns;
+    }
+    void queue_delay(Uint64 ns) {
+        if constexpr (enabled) { if (cell_) cell_->queue_delay.record(ns); }
+        (void)ns;
+    }
+    void socket_delay(Uint64 ns) {
+        if constexpr (enabled) { if (cell_) cell_->socket_delay.record(ns); }
+        (void)ns;
+    }
+
+private:
+    void add(std::atomic<Uint64> detail::MethodCell::* counter) {
+        if constexpr (enabled) { if (cell_) detail::AtomicHistogram::bump(cell_->*counter, 1); }
+        (void)counter;
+    }
+
+    detail::MethodCell* cell_ = nullptr;
+};
+
+} // namespace metrics
+} // namespace someip
+
+#endif // SOMEIP_METRICS_HPP
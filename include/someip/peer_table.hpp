@@ -0,0 +1,91 @@
+#ifndef SOMEIP_PEER_TABLE_HPP
+#define SOMEIP_PEER_TABLE_HPP
+
+#include "types.hpp"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace someip {
+
+// The other side of a protected message: its address and port, plus the client ID of the
+// message, so several clients behind one socket are still told apart
+struct PeerKey {
+    std::string address;
+    uint16_t port = 0;
+    ClientId client = 0;
+
+    PeerKey(const Endpoint& peer, ClientId client_id)
+        : address(std::get<0>(peer)), port(std::get<1>(peer)), client(client_id) {}
+    bool operator==(const PeerKey& o) const { return port == o.port && client == o.client && address == o.address; }
+};
+
+struct PeerKeyHash {
+    size_t operator()(const PeerKey& p) const {
+        return std::hash<std::string>()(p.address) ^ (size_t(p.port) << 16 | p.client);
+    }
+};
+
+// Per-peer state of a protection stage (counters, replay windows), for at most `capacity`
+// peers; adding one more forgets the least recently used. Thread-safe; a State stays valid
+// for whoever holds it after it is forgotten.
+template <typename State>
+class PeerTable {
+public:
+    explicit PeerTable(size_t capacity) : capacity_(capacity ? capacity : 1) {}
+
+    std::shared_ptr<State> find(const PeerKey& key) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto it = entries_.find(key);
+        if (it == entries_.end()) return nullptr;
+        it->second.last_used = ++tick_;
+        return it->second.state;
+    }
+
+    // The peer's state, created and passed to `init` first if it is new; `init` runs before
+    // any other thread can see it
+    template <typename Init>
+    std::shared_ptr<State> add(const PeerKey& key, Init init) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            it->second.last_used = ++tick_;
+            return it->second.state;
+        }
+        if (entries_.size() >= capacity_) {
+            auto oldest = entries_.begin();
+            for (auto e = entries_.begin(); e != entries_.end(); ++e) {
+                if (e->second.last_used < oldest->second.last_used) oldest = e;
+            }
+            entries_.erase(oldest);
+        }
+        auto state = std::make_shared<State>();
+        init(*state);
+        entries_.emplace(key, Entry{state, ++tick_});
+        return state;
+    }
+    std::shared_ptr<State> add(const PeerKey& key) {
+        return add(key, [](State&) {});
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lk(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry {
+        std::shared_ptr<State> state;
+        Uint64 last_used;
+    };
+
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<PeerKey, Entry, PeerKeyHash> entries_;
+    Uint64 tick_ = 0;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_PEER_TABLE_HPP
@@ -0,0 +1,64 @@
+#ifndef SOMEIP_RESPONSE_CACHE_HPP
+#define SOMEIP_RESPONSE_CACHE_HPP
+
+#include "types.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace someip {
+
+struct ResponseCacheOptions {
+    std::chrono::milliseconds ttl{1000};  // age at which an entry expires (0: only on invalidation)
+    size_t capacity = 64;                 // entries per method; the least recently used is evicted
+};
+
+// Serialized responses of one method, keyed by the crc32c of the request payload. The request
+// bytes are kept alongside, so a hash collision is a miss and never a wrong answer.
+// Thread-safe.
+class ResponseCache {
+public:
+    explicit ResponseCache(ResponseCacheOptions options = {});
+
+    // Copy the response stored for `request` into `out`; false on a miss. Adds expired entries
+    // removed on the way to `evicted`.
+    bool lookup(const Payload& request, Payload& out, Uint64& evicted);
+
+    static constexpr Uint64 ANY_GENERATION = ~Uint64(0);
+
+    // Store the response to `request`; returns the number of entries evicted to make room.
+    // With a `generation` from generation(), taken before the handler ran, nothing is stored
+    // if the cache was cleared since: the response may reflect the state before the change.
+    Uint64 store(const Payload& request, const Payload& response, Uint64 generation = ANY_GENERATION);
+
+    // Drop every entry; returns how many there were
+    Uint64 clear();
+
+    // Bumped by every clear()
+    Uint64 generation() const { return generation_.load(std::memory_order_acquire); }
+
+    size_t size() const;
+
+    static Uint64 now_ns();
+
+private:
+    struct Entry {
+        Payload request;
+        Payload response;
+        Uint64 stored_ns = 0;
+        Uint64 used_ns = 0;
+    };
+
+    bool expired(const Entry& e, Uint64 now) const { return ttl_ns_ && now - e.stored_ns >= ttl_ns_; }
+
+    const Uint64 ttl_ns_;
+    const size_t capacity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<Uint32, Entry> entries_;
+    std::atomic<Uint64> generation_{0};  // written under mutex_
+};
+
+} // namespace someip
+
+#endif // SOMEIP_RESPONSE_CACHE_HPP
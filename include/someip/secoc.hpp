@@ -0,0 +1,90 @@
+#ifndef SOMEIP_SECOC_HPP
+#define SOMEIP_SECOC_HPP
+
+#include "types.hpp"
+#include "someip_header.hpp"
+#include "message_router.hpp"
+#include "crypto.hpp"
+#include "peer_table.hpp"
+#include <atomic>
+#include <memory>
+
+namespace someip {
+
+// Authentication-only protection for one (service, method), modelled on AUTOSAR SecOC
+struct SecOcProfile {
+    enum class Algorithm : uint8_t {
+        CMAC_AES128,  // 16-byte key
+        HMAC_SHA256   // any key length
+    };
+
+    Algorithm algorithm = Algorithm::CMAC_AES128;
+    Payload key;
+    uint8_t mac_bytes = 4;        // truncated MAC sent on the wire (1..16 for CMAC, 1..32 for HMAC)
+    uint8_t freshness_bytes = 2;  // low-order freshness counter bytes sent (1..4)
+
+    // Where freshness values come from. COUNTER counts messages per peer from 1; a peer that
+    // restarts on the same address, port and client ID starts over and is rejected as stale
+    // until the other side forgets it. TIME uses the milliseconds of a clock both sides share
+    // (CLOCK_REALTIME, kept in sync e.g. by gPTP or NTP), stepped forward where messages come
+    // faster, so a restarted peer simply continues. TIME thus allows one message per
+    // millisecond per peer on average: a burst may run ahead of the clock by up to
+    // time_tolerance_ms, after which protect() fails until the clock catches up.
+    enum class Freshness : uint8_t { COUNTER, TIME };
+    Freshness freshness = Freshness::COUNTER;
+    Uint32 time_tolerance_ms = 2000;  // TIME: accepted clock offset plus transit time, < half the wire span
+    size_t max_peers = 256;           // peers with freshness state; the least recently used is forgotten
+};
+
+// Appends `freshness (truncated) | MAC (truncated)` to the payload. The MAC covers the
+// message ID, request ID, versions, message type, return code, payload and the full 32-bit
+// freshness value, which the receiver reconstructs from the truncated one and checks
+// against an anti-replay window. Freshness is kept per peer, its address and port plus the
+// client ID of the message, so clients sharing a stage do not make each other stale; a peer
+// gets its state once a message from it authenticates. The key schedule is expanded once at
+// creation; each thread then works on its own copy of the keyed MAC context.
+class SecOcStage : public ProtectionStage {
+public:
+    ~SecOcStage() override;
+
+    // nullptr if the profile is invalid
+    static std::shared_ptr<SecOcStage> create(const SecOcProfile& profile);
+
+    // Without an endpoint, all messages of a client ID share one peer
+    bool protect(const SomeIpHeader& header, Payload& payload) override;
+    bool check(const SomeIpHeader& header, Payload& payload) override;
+    bool protect(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) override;
+    bool check(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) override;
+
+    // Bytes added to each payload
+    size_t overhead() const { return profile_.freshness_bytes + profile_.mac_bytes; }
+
+    // Full (untruncated) MAC of a message into `mac` (at least 32 bytes); returns its length
+    size_t compute_mac(const SomeIpHeader& header, const uint8_t* data, size_t len, Uint32 freshness,
+                       uint8_t* mac);
+
+    Uint64 rejected() const { return rejected_.load(std::memory_order_relaxed); }
+    size_t peers() const { return peers_->size(); }
+
+private:
+    struct Key;
+    struct Peer {
+        std::atomic<Uint64> tx_freshness{0};  // last value sent
+        ReplayWindow rx_window;               // TIME: milliseconds since rx_base
+        Uint64 rx_base = 0;                   // TIME: set when the peer is added
+    };
+
+    SecOcStage() = default;
+    Uint64 next_freshness(Peer& peer) const;
+    Uint32 reconstruct_freshness(Uint32 truncated, Uint64 latest) const;
+
+    SecOcProfile profile_;
+    Uint64 id_ = 0;                        // identifies this stage in thread-local context caches
+    std::unique_ptr<Key> key_;
+    std::atomic<Uint64> rejected_{0};
+    std::unique_ptr<PeerTable<Peer>> peers_;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_SECOC_HPP
@@ -2,17 +2,27 @@
 #define SOMEIP_SERVICE_HPP
 
 #include "types.hpp"
+#include "someip_header.hpp"
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
 
 namespace someip {
 
+// Handler that serializes its response in place. `out` already holds SomeIpHeader::SIZE bytes
+// of headroom for the header (filled in by the router) and has room reserved behind it; append
+// the response payload with the write_* methods. The buffer is reused between calls.
+using BufferMethodHandler = std::function<ReturnCode(const Payload&, const Endpoint&, SerializationBuffer& out)>;
+
+// A registered method; exactly one of the two handler forms is set
 struct Method {
     MethodId id;
     MethodHandler handler;
+    BufferMethodHandler buffer_handler;
     Method() = default;
     Method(MethodId i, MethodHandler h) : id(i), handler(std::move(h)) {}
+    Method(MethodId i, BufferMethodHandler h) : id(i), buffer_handler(std::move(h)) {}
 };
 
 class ServiceRegistry {
@@ -20,7 +30,13 @@ public:
     // Register a method
     void register_method(ServiceId svc, MethodId mth, MethodHandler handler) {
         std::lock_guard<std::mutex> lk(mutex_);
-        registry_[std::make_pair(svc, mth)] = std::move(handler);
+        registry_[std::make_pair(svc, mth)] = std::make_shared<const Method>(mth, std::move(handler));
+    }
+
+    // Register a method that writes its response into a router-provided buffer
+    void register_method(ServiceId svc, MethodId mth, BufferMethodHandler handler) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        registry_[std::make_pair(svc, mth)] = std::make_shared<const Method>(mth, std::move(handler));
     }
 
     // Unregister
@@ -29,18 +45,42 @@ public:
         registry_.erase(std::make_pair(svc, mth));
     }
 
-    // Find handler; returns nullopt if not found
+    // Find handler; returns nullopt if not found. Buffer handlers are wrapped so the
+    // result carries the payload they wrote.
     std::optional<MethodHandler> find_handler(ServiceId svc, MethodId mth) {
+        auto method = lookup(svc, mth);
+        if (!method) return std::nullopt;
+        if (method->handler) return method->handler;
+        return MethodHandler([method](const Payload& in, const Endpoint& src) {
+            SerializationBuffer out;
+            out.buf.resize(SomeIpHeader::SIZE);
+            ReturnCode rc = method->buffer_handler(in, src, out);
+            return MethodResult{rc, Payload(out.buf.begin() + SomeIpHeader::SIZE, out.buf.end())};
+        });
+    }
+
+    // Find a method without copying its handler (copying a std::function may allocate);
+    // nullptr if not found
+    std::shared_ptr<const Method> lookup(ServiceId svc, MethodId mth) {
         std::lock_guard<std::mutex> lk(mutex_);
         auto it = registry_.find(std::make_pair(svc, mth));
-        if (it == registry_.end()) return std::nullopt;
-        return it->second;
+        return it == registry_.end() ? nullptr : it->second;
+    }
+
+    // Services with at least one registered method, ascending; e.g. for someip_socket_filter()
+    std::vector<ServiceId> services() {
+        std::lock_guard<std::mutex> lk(mutex_);
+        std::vector<ServiceId> out;
+        for (const auto& kv : registry_) {
+            if (out.empty() || out.back() != kv.first.first) out.push_back(kv.first.first);
+        }
+        return out;
     }
 private:
-    std::map<std::pair<ServiceId, MethodId>, MethodHandler> registry_;
+    std::map<std::pair<ServiceId, MethodId>, std::shared_ptr<const Method>> registry_;
     std::mutex mutex_;
 };
 
 } // namespace someip
 
-#endif // SOMEIP_SERVICE_HPP
\ No newline at end of file
+#endif // SOMEIP_SERVICE_HPP
@@ -9,6 +9,9 @@
 #include <mutex>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <vector>
 
 namespace someip {
 
@@ -29,6 +32,26 @@ public:
     bool start();
     void stop();
 
+    // Scheduling of the offer thread and the multicast receive thread; call before start()
+    void set_thread_options(const ThreadOptions& options) { thread_options_ = options; }
+
+    // Send and receive through `transport` instead of a UDP socket on the SD port, e.g. a
+    // LoopbackEndpoint in a simulation; call before start()
+    void set_transport(std::shared_ptr<Transport> transport) { transport_ = std::move(transport); }
+
+    // How often offers are repeated (default 2 s). 0 starts no offer thread: call send_offers()
+    // from your own timer, e.g. LoopbackNetwork::every(). Call before start().
+    void set_offer_interval(std::chrono::milliseconds interval) { offer_interval_ = interval; }
+
+    // Send every current offer once
+    void send_offers();
+
+    // Offers received so far, one per offered endpoint
+    std::vector<SdOffer> found() const;
+
+    // An offer received for `instance` of `service`, if any
+    std::optional<SdOffer> find(ServiceId svc, InstanceId inst) const;
+
     // Offer a service (sends initial offer and then periodically)
     void offer_service(const SdOffer& offer);
 
@@ -41,15 +64,19 @@ public:
 
 private:
     void periodic_offer_loop();
+    void send_offer(const SdOffer& offer);
     void handle_incoming(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto);
 
     std::string mcast_addr_;
     uint16_t mcast_port_;
-    std::unique_ptr<UdpEndpoint> mcast_endpoint_;
+    std::shared_ptr<Transport> transport_;
     std::map<std::pair<ServiceId, InstanceId>, SdOffer> offered_;
     std::map<std::pair<std::string, uint16_t>, SdOffer> found_;
     FoundCallback found_cb_;
-    std::mutex mutex_;
+    ThreadOptions thread_options_;
+    std::chrono::milliseconds offer_interval_{2000};
+    mutable std::mutex mutex_;
+    std::condition_variable stop_cv_;
     std::thread offer_thread_;
     std::atomic<bool> running_{false};
 };
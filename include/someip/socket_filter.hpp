@@ -0,0 +1,38 @@
+#ifndef SOMEIP_SOCKET_FILTER_HPP
+#define SOMEIP_SOCKET_FILTER_HPP
+
+#include "types.hpp"
+#include <vector>
+
+namespace someip {
+
+// One classic BPF instruction, laid out like Linux's struct sock_filter
+struct BpfInstruction {
+    uint16_t code;
+    uint8_t jt;
+    uint8_t jf;
+    uint32_t k;
+};
+
+using BpfProgram = std::vector<BpfInstruction>;
+
+// Services matched one by one; beyond this the filter checks the range min..max instead
+// (a jump reaches at most 255 instructions), so the router still drops the ones in between
+constexpr size_t MAX_EXACT_SERVICES = 200;
+
+// Socket filter (EndpointOptions::socket_filter, SO_ATTACH_FILTER) passing only SOME/IP
+// messages for one of `services` with one of `types`; an empty list accepts any. Datagrams
+// shorter than a SOME/IP header are dropped. Everything else dies in the kernel, before it is
+// queued on the socket, copied out and parsed. With GRO the first datagram of a coalesced
+// buffer decides for all of them.
+BpfProgram someip_socket_filter(const std::vector<ServiceId>& services,
+                                const std::vector<MessageType>& types = {});
+
+// SO_REUSEPORT steering (EndpointOptions::reuseport_program, SO_ATTACH_REUSEPORT_CBPF):
+// a request goes to socket client_id % sockets of the group, in bind order, so one client's
+// messages are always handled by the same socket and receive thread, in order
+BpfProgram client_steering_program(unsigned sockets);
+
+} // namespace someip
+
+#endif // SOMEIP_SOCKET_FILTER_HPP
@@ -23,32 +23,45 @@ struct SomeIpHeader {
     static constexpr Uint32 MIN_LENGTH = 8;
 
     Payload serialize() const {
-        SerializationBuffer buf;
-        buf.write_uint16(service_id);
-        buf.write_uint16(method_id);
-        buf.write_uint32(length);
-        buf.write_uint16(client_id);
-        buf.write_uint16(session_id);
-        buf.write_uint8(protocol_version);
-        buf.write_uint8(interface_version);
-        buf.write_uint8(message_type);
-        buf.write_uint8(return_code);
-        return std::move(buf.buf);
+        Payload out;
+        out.reserve(SIZE);
+        serialize_to(out);
+        return out;
+    }
+
+    // Append the 16 header bytes to `out`
+    void serialize_to(Payload& out) const {
+        uint8_t b[SIZE];
+        serialize_to(b);
+        out.insert(out.end(), b, b + SIZE);
+    }
+
+    // Write the 16 header bytes to `out`, e.g. into headroom left in front of a payload
+    void serialize_to(uint8_t* out) const {
+        const uint8_t b[SIZE] = {
+            uint8_t(service_id >> 8), uint8_t(service_id), uint8_t(method_id >> 8), uint8_t(method_id),
+            uint8_t(length >> 24), uint8_t(length >> 16), uint8_t(length >> 8), uint8_t(length),
+            uint8_t(client_id >> 8), uint8_t(client_id), uint8_t(session_id >> 8), uint8_t(session_id),
+            protocol_version, interface_version, message_type, return_code};
+        std::memcpy(out, b, SIZE);
     }
 
     static SomeIpHeader deserialize(const Payload& data) {
-        if (data.size() < SIZE) throw std::runtime_error("header: too small");
-        DeserializationBuffer db(data);
+        return deserialize(data.data(), data.size());
+    }
+
+    static SomeIpHeader deserialize(const uint8_t* data, size_t len) {
+        if (len < SIZE) throw std::runtime_error("header: too small");
         SomeIpHeader h;
-        h.service_id = db.read_uint16();
-        h.method_id  = db.read_uint16();
-        h.length     = db.read_uint32();
-        h.client_id  = db.read_uint16();
-        h.session_id = db.read_uint16();
-        h.protocol_version = db.read_uint8();
-        h.interface_version = db.read_uint8();
-        h.message_type = db.read_uint8();
-        h.return_code = db.read_uint8();
+        h.service_id = Uint16(data[0] << 8 | data[1]);
+        h.method_id  = Uint16(data[2] << 8 | data[3]);
+        h.length     = Uint32(data[4]) << 24 | Uint32(data[5]) << 16 | Uint32(data[6]) << 8 | data[7];
+        h.client_id  = Uint16(data[8] << 8 | data[9]);
+        h.session_id = Uint16(data[10] << 8 | data[11]);
+        h.protocol_version = data[12];
+        h.interface_version = data[13];
+        h.message_type = data[14];
+        h.return_code = data[15];
         if (h.length < MIN_LENGTH) throw std::runtime_error("header: length < 8");
         return h;
     }
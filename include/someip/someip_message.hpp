@@ -5,27 +5,37 @@
 
 namespace someip {
 
+// When a received message arrived; zero fields are unknown
+struct RxTimestamp {
+    Uint64 kernel_ns = 0;   // kernel (or NIC) receive time, CLOCK_REALTIME (the NIC clock for hardware stamps)
+    Uint64 user_ns = 0;     // when the receive thread got it, metrics::now_ns() time base
+    bool hardware = false;  // kernel_ns came from the NIC
+};
+
 struct SomeIpMessage {
     SomeIpHeader header;
     Payload payload;
+    RxTimestamp rx{};  // set by the transport on received messages
 
     Payload serialize() const {
-        Payload out = header.serialize();
+        Payload out;
+        out.reserve(SomeIpHeader::SIZE + payload.size());
+        header.serialize_to(out);
         out.insert(out.end(), payload.begin(), payload.end());
         return out;
     }
 
     static SomeIpMessage deserialize(const Payload& data) {
-        if (data.size() < SomeIpHeader::SIZE) throw std::runtime_error("message: too small");
-        Payload header_bytes(data.begin(), data.begin() + SomeIpHeader::SIZE);
-        SomeIpHeader h = SomeIpHeader::deserialize(header_bytes);
-
-        size_t p_len = h.length - SomeIpHeader::MIN_LENGTH;
-        if (data.size() < SomeIpHeader::SIZE + p_len) throw std::runtime_error("message: payload short");
+        return deserialize(data.data(), data.size());
+    }
 
+    static SomeIpMessage deserialize(const uint8_t* data, size_t len) {
+        if (len < SomeIpHeader::SIZE) throw std::runtime_error("message: too small");
         SomeIpMessage msg;
-        msg.header = h;
-        msg.payload = Payload(data.begin() + SomeIpHeader::SIZE, data.begin() + SomeIpHeader::SIZE + p_len);
+        msg.header = SomeIpHeader::deserialize(data, len);
+        size_t p_len = msg.header.length - SomeIpHeader::MIN_LENGTH;
+        if (len - SomeIpHeader::SIZE < p_len) throw std::runtime_error("message: payload short");
+        msg.payload.assign(data + SomeIpHeader::SIZE, data + SomeIpHeader::SIZE + p_len);
         return msg;
     }
 };
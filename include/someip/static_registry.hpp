@@ -0,0 +1,100 @@
+#ifndef SOMEIP_STATIC_REGISTRY_HPP
+#define SOMEIP_STATIC_REGISTRY_HPP
+
+#include "types.hpp"
+#include "serialization.hpp"
+#include <type_traits>
+
+namespace someip {
+
+// Entry point of a compile-time routing table, as handed to MessageRouter::set_static_routes().
+// dispatch() runs the handler of (service, method) and returns true, or returns false if the
+// table has no such method.
+struct StaticRoutes {
+    using Dispatch = bool (*)(ServiceId service, MethodId method, const Payload& in, const Endpoint& src,
+                              SerializationBuffer& out, ReturnCode& rc);
+    Dispatch dispatch = nullptr;
+};
+
+// A method bound to a function at compile time. `Handler` is a function pointer of either
+// handler form: `MethodResult(const Payload&, const Endpoint&)` or, writing the response in
+// place like a BufferMethodHandler, `ReturnCode(const Payload&, const Endpoint&, SerializationBuffer&)`.
+template <MethodId Id, auto Handler>
+struct StaticMethod {
+    static constexpr MethodId id = Id;
+
+    static ReturnCode call(const Payload& in, const Endpoint& src, SerializationBuffer& out) {
+        using H = decltype(Handler);
+        if constexpr (std::is_invocable_r<ReturnCode, H, const Payload&, const Endpoint&, SerializationBuffer&>::value) {
+            return Handler(in, src, out);
+        } else {
+            static_assert(std::is_invocable_r<MethodResult, H, const Payload&, const Endpoint&>::value,
+                          "StaticMethod handler must be a MethodHandler or BufferMethodHandler function");
+            MethodResult result = Handler(in, src);
+            out.write_bytes(result.payload);
+            return result.return_code;
+        }
+    }
+};
+
+namespace detail {
+
+template <typename T, size_t N>
+constexpr bool all_distinct(const T (&ids)[N]) {
+    for (size_t i = 0; i < N; ++i) {
+        for (size_t j = i + 1; j < N; ++j) {
+            if (ids[i] == ids[j]) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace detail
+
+// The methods of one service
+template <ServiceId Id, typename... Methods>
+struct StaticService {
+    static_assert(sizeof...(Methods) > 0, "StaticService needs at least one method");
+    static constexpr ServiceId id = Id;
+    static constexpr MethodId method_ids[] = {Methods::id...};
+    static_assert(detail::all_distinct(method_ids), "duplicate method ID in StaticService");
+
+    static constexpr bool contains(MethodId method) { return ((method == Methods::id) || ...); }
+
+    // A chain of constant comparisons that the compiler turns into a switch, with the handlers
+    // inlined into their cases
+    static bool dispatch(MethodId method, const Payload& in, const Endpoint& src, SerializationBuffer& out, ReturnCode& rc) {
+        return ((method == Methods::id && (rc = Methods::call(in, src, out), true)) || ...);
+    }
+};
+
+// Routing table of a fixed service set, resolved at compile time: no locking, no map lookup
+// and no std::function call per request.
+//
+//   using Routes = StaticRegistry<StaticService<0x1300, StaticMethod<0x0010, &press>,
+//                                                       StaticMethod<0x0020, &release>>>;
+//   router->set_static_routes(Routes::routes());
+template <typename... Services>
+class StaticRegistry {
+    static_assert(sizeof...(Services) > 0, "StaticRegistry needs at least one service");
+    static constexpr ServiceId service_ids[] = {Services::id...};
+    static_assert(detail::all_distinct(service_ids), "duplicate service ID in StaticRegistry");
+
+public:
+    static constexpr size_t method_count() { return (std::extent<decltype(Services::method_ids)>::value + ...); }
+
+    static constexpr bool contains(ServiceId service, MethodId method) {
+        return ((service == Services::id && Services::contains(method)) || ...);
+    }
+
+    static bool dispatch(ServiceId service, MethodId method, const Payload& in, const Endpoint& src,
+                         SerializationBuffer& out, ReturnCode& rc) {
+        return ((service == Services::id && Services::dispatch(method, in, src, out, rc)) || ...);
+    }
+
+    static constexpr StaticRoutes routes() { return StaticRoutes{&dispatch}; }
+};
+
+} // namespace someip
+
+#endif // SOMEIP_STATIC_REGISTRY_HPP
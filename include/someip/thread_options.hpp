@@ -0,0 +1,18 @@
+#ifndef SOMEIP_THREAD_OPTIONS_HPP
+#define SOMEIP_THREAD_OPTIONS_HPP
+
+namespace someip {
+
+// Scheduling of a thread the library owns (receive, SD offer, dispatcher workers)
+struct ThreadOptions {
+    int cpu = -1;         // pin to this CPU (-1: no affinity)
+    int rt_priority = 0;  // SCHED_FIFO priority 1..99 (0: keep the default policy)
+};
+
+// Apply `options` to the calling thread. Settings the OS refuses (e.g. SCHED_FIFO without
+// CAP_SYS_NICE, or a CPU outside the allowed set) are logged and skipped; returns false if any was.
+bool apply_thread_options(const ThreadOptions& options);
+
+} // namespace someip
+
+#endif // SOMEIP_THREAD_OPTIONS_HPP
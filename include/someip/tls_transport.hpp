@@ -0,0 +1,108 @@
+#ifndef SOMEIP_TLS_TRANSPORT_HPP
+#define SOMEIP_TLS_TRANSPORT_HPP
+
+#include "types.hpp"
+#include "someip_message.hpp"
+#include "transport.hpp"
+#include "certificates.hpp"
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+struct ssl_ctx_st;
+struct ssl_st;
+struct ssl_session_st;
+
+namespace someip {
+
+// Options for SOME/IP over TLS (TCP)
+struct TlsOptions {
+    bool session_tickets = true;        // server: issue stateless session tickets
+    bool session_cache = true;          // server: remember sessions for ticketless resumption
+    bool resume_sessions = true;        // client: offer the previous session when reconnecting
+    std::chrono::seconds session_lifetime{300};
+    bool verify_peer = true;            // client: verify the server's chain against the CA store (connect fails without one)
+    bool require_client_certificate = false;  // server: mutual TLS
+    std::string server_name;            // client: SNI and host name / IP check (empty: none)
+};
+
+// TLS server carrying SOME/IP messages (framed by the header length field). One I/O thread
+// multiplexes the listener and all connections; handshakes and reads are non-blocking.
+// Resumed handshakes skip certificate verification entirely, and full handshakes verify the
+// peer chain through the CertificateManager's verification cache.
+// Creating a TLS endpoint ignores SIGPIPE unless the application has its own handler.
+class TlsServer {
+public:
+    TlsServer(std::shared_ptr<CertificateManager> certs, const TlsOptions& opts = {});
+    ~TlsServer();
+
+    // Listen on ip:port (port 0 picks a free port, see local_port())
+    bool start(const std::string& bind_ip, uint16_t bind_port);
+    void stop();
+
+    void set_callback(TransportCallback cb) { callback_ = std::move(cb); }
+
+    // Send a serialized message to a connected peer
+    bool send_to(const Payload& data, const Endpoint& dest);
+
+    uint16_t local_port() const { return bind_port_; }
+    Uint64 handshakes() const { return handshakes_.load(std::memory_order_relaxed); }
+    Uint64 resumed_handshakes() const { return resumed_.load(std::memory_order_relaxed); }
+
+private:
+    struct Connection;
+    void io_loop();
+    void close_connection(const std::shared_ptr<Connection>& conn);
+
+    std::shared_ptr<CertificateManager> certs_;
+    TlsOptions opts_;
+    ssl_ctx_st* ctx_ = nullptr;
+    std::string bind_ip_;
+    uint16_t bind_port_ = 0;
+    socket_t sock_ = INVALID_SOCKET_VAL;
+    TransportCallback callback_;
+    std::mutex conn_mutex_;
+    std::map<Endpoint, std::shared_ptr<Connection>> connections_;
+    std::atomic<Uint64> handshakes_{0};
+    std::atomic<Uint64> resumed_{0};
+    std::thread io_thread_;
+    std::atomic<bool> running_{false};
+};
+
+// TLS client connection (one thread at a time). The session of the last connection is kept
+// and offered on the next connect() so reconnects resume instead of doing a full handshake.
+class TlsClient {
+public:
+    TlsClient(std::shared_ptr<CertificateManager> certs, const TlsOptions& opts = {});
+    ~TlsClient();
+
+    bool connect(const std::string& ip, uint16_t port, int timeout_ms = 2000);
+    void disconnect();
+
+    bool send(const Payload& data);
+
+    // Next complete message, or nullopt on timeout/close
+    std::optional<SomeIpMessage> receive(int timeout_ms = 2000);
+
+    bool connected() const { return ssl_ != nullptr; }
+    bool session_resumed() const { return resumed_; }
+
+private:
+    bool wait(int ssl_result, int timeout_ms);
+    static int on_new_session(ssl_st* ssl, ssl_session_st* session);
+
+    std::shared_ptr<CertificateManager> certs_;
+    TlsOptions opts_;
+    ssl_ctx_st* ctx_ = nullptr;
+    ssl_st* ssl_ = nullptr;
+    ssl_session_st* session_ = nullptr;  // offered on the next connect()
+    socket_t sock_ = INVALID_SOCKET_VAL;
+    bool resumed_ = false;
+    Payload rx_;
+};
+
+} // namespace someip
+
+#endif // SOMEIP_TLS_TRANSPORT_HPP
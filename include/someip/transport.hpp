@@ -3,7 +3,11 @@
 
 #include "types.hpp"
 #include "someip_message.hpp"
+#include "thread_options.hpp"
+#include "socket_filter.hpp"
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <thread>
 #include <atomic>
 #include <mutex>
@@ -29,44 +33,171 @@
 
 namespace someip {
 
+class PacketCapture;
+
 // Callback invoked when a full SOME/IP message is received
 using TransportCallback = std::function<void(const SomeIpMessage&, const Endpoint& src, const Endpoint& dst, TransportProtocol proto)>;
 
-// Simple UDP endpoint supporting multicast listening and sendto
-class UdpEndpoint {
+// Verdict of a PacketFilter on a raw datagram
+enum class FilterVerdict : uint8_t {
+    ACCEPT,
+    DROP,    // discard silently
+    REJECT   // discard; requests are answered with an E_NOT_OK error built from the raw header
+};
+
+// Runs on the receive thread for every datagram before it is parsed. src_addr is the IPv4
+// source address in host byte order.
+using PacketFilter = std::function<FilterVerdict(const uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port)>;
+
+// Runs on the receive thread for every datagram the filter accepted, before it is parsed.
+// Returning true consumes the datagram (e.g. forwarded by a Gateway); only then may the hook
+// have rewritten it in place.
+using DatagramHook = std::function<bool(uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port)>;
+
+enum class ReceiveMode : uint8_t {
+    BLOCKING,  // the receive thread sleeps in recvfrom until a datagram arrives
+    BUSY_POLL  // the receive thread polls the socket, backing off to yields and short sleeps when idle
+};
+
+// Socket and receive thread settings of a UdpEndpoint
+struct EndpointOptions {
+    int rcvbuf = 0;                   // SO_RCVBUF bytes (0: system default; capped by net.core.rmem_max)
+    int sndbuf = 0;                   // SO_SNDBUF bytes (0: system default; capped by net.core.wmem_max)
+    bool timestamps = true;           // kernel receive timestamps, SO_TIMESTAMPNS (Linux)
+    bool hardware_timestamps = false; // NIC timestamps via SO_TIMESTAMPING where the device has them enabled
+    bool gro = true;                  // accept UDP_GRO-coalesced buffers (split before dispatch; Linux)
+    size_t path_mtu = 1500;           // IP MTU toward peers; send_batch segments only datagrams that fit one packet
+    ReceiveMode mode = ReceiveMode::BLOCKING;
+    ThreadOptions thread;             // receive thread scheduling
+    int so_busy_poll_us = 0;          // SO_BUSY_POLL: let the kernel poll the device on empty reads (Linux; 0: off)
+    Uint32 spin_iterations = 20000;   // BUSY_POLL: empty polls before yielding (no spinning on a single CPU)
+    std::chrono::microseconds max_backoff{50};  // BUSY_POLL: longest sleep between polls when idle
+    bool reuse_port = false;          // SO_REUSEPORT: several endpoints share the port, the kernel spreads datagrams
+    BpfProgram socket_filter;         // kernel-side filter attached before bind (socket_filter.hpp; Linux; empty: none)
+    BpfProgram reuseport_program;     // picks the socket of the reuse_port group, e.g. client_steering_program (Linux)
+};
+
+// Datagram transport the router, fields and service discovery send through: UdpEndpoint, or
+// LoopbackEndpoint (loopback.hpp) for in-process simulation
+class Transport {
 public:
-    UdpEndpoint(const std::string& bind_ip, uint16_t bind_port);
-    ~UdpEndpoint();
+    virtual ~Transport() = default;
 
-    // Start listening (spawn receive thread)
-    bool start();
+    // Start receiving; false if the address is unavailable
+    virtual bool start() = 0;
 
-    // Stop listening
-    void stop();
+    // Stop receiving
+    virtual void stop() = 0;
 
     // Send raw bytes to dest (ip,port)
-    bool send_to(const Payload& data, const Endpoint& dest);
+    virtual bool send_to(const Payload& data, const Endpoint& dest) = 0;
+
+    // Send bytes that are not held in a Payload, e.g. a received datagram being forwarded
+    virtual bool send_bytes(const uint8_t* data, size_t len, const Endpoint& dest) {
+        return send_to(Payload(data, data + len), dest);
+    }
+
+    // Send several datagrams to one destination; returns the number sent
+    virtual size_t send_batch(const Payload* datagrams, size_t count, const Endpoint& dest);
+    size_t send_batch(const std::vector<Payload>& datagrams, const Endpoint& dest) {
+        return send_batch(datagrams.data(), datagrams.size(), dest);
+    }
 
     // Join multicast group
-    bool join_multicast(const std::string& mcast_addr);
+    virtual bool join_multicast(const std::string& mcast_addr) = 0;
 
     // Leave multicast group
-    bool leave_multicast(const std::string& mcast_addr);
+    virtual bool leave_multicast(const std::string& mcast_addr) = 0;
+
+    virtual std::string local_ip() const = 0;
+    virtual uint16_t local_port() const = 0;
 
     void set_callback(TransportCallback cb) { callback_ = std::move(cb); }
 
-    std::string local_ip() const { return bind_ip_; }
-    uint16_t local_port() const { return bind_port_; }
+    // Screen datagrams before parsing (e.g. AdmissionControl). Like set_callback, call before
+    // traffic starts.
+    void set_filter(PacketFilter filter) { filter_ = std::move(filter); }
+
+    // Consume datagrams before parsing (see DatagramHook). Like set_callback, call before
+    // traffic starts.
+    void set_datagram_hook(DatagramHook hook) { hook_ = std::move(hook); }
+
+protected:
+    TransportCallback callback_;
+    PacketFilter filter_;
+    DatagramHook hook_;
+};
+
+// Simple UDP endpoint supporting multicast listening and sendto
+class UdpEndpoint : public Transport {
+public:
+    UdpEndpoint(const std::string& bind_ip, uint16_t bind_port, EndpointOptions options = {});
+    ~UdpEndpoint() override;
+
+    // Start listening (spawn receive thread)
+    bool start() override;
+
+    // Stop listening
+    void stop() override;
+
+    bool send_to(const Payload& data, const Endpoint& dest) override;
+    bool send_bytes(const uint8_t* data, size_t len, const Endpoint& dest) override;
+
+    // Runs of equally sized datagrams go out with one syscall via UDP segmentation offload
+    // (UDP_SEGMENT, Linux), e.g. a burst of notifications of one event. Datagrams larger than
+    // EndpointOptions::path_mtu allows, runs the route refuses to segment, and everything
+    // elsewhere or without GSO support in the kernel go out with one sendto each.
+    size_t send_batch(const Payload* datagrams, size_t count, const Endpoint& dest) override;
+    using Transport::send_batch;
+
+    bool join_multicast(const std::string& mcast_addr) override;
+    bool leave_multicast(const std::string& mcast_addr) override;
+
+    // Mirror every received and sent datagram into a pcap capture (nullptr to disable).
+    // Like set_callback, call before traffic starts.
+    void set_capture(std::shared_ptr<PacketCapture> capture) { capture_ = std::move(capture); }
+
+    // Datagrams the kernel dropped because the receive buffer was full (SO_RXQ_OVFL, Linux),
+    // plus those refused by a socket filter. The kernel reports the count on the next datagram
+    // queued after a drop.
+    Uint64 socket_drops() const { return socket_drops_.load(std::memory_order_relaxed); }
+    Uint64 datagrams_received() const { return received_.load(std::memory_order_relaxed); }
+    // Datagrams dropped because they are not a valid SOME/IP message
+    Uint64 parse_errors() const { return parse_errors_.load(std::memory_order_relaxed); }
+
+    // Replace the kernel-side filter of a running endpoint, e.g. after registering more
+    // services; an empty program removes it. False if the kernel refuses it (or not Linux).
+    bool set_socket_filter(const BpfProgram& program);
+
+    std::string local_ip() const override { return bind_ip_; }
+    uint16_t local_port() const override { return bind_port_; }
 
 private:
+    // Per-sendmsg limits of UDP_SEGMENT: segment count, and the payload of one IPv4 datagram
+    static constexpr size_t GSO_MAX_SEGMENTS = 64;
+    static constexpr size_t GSO_MAX_BYTES = 65507;
+    static constexpr size_t UDP_IPV4_OVERHEAD = 28;  // IPv4 and UDP headers within the path MTU
+
     void receive_loop();
+    void handle_datagram(uint8_t* data, size_t len, const sockaddr_in& src, const RxTimestamp& rx,
+                         Uint64 socket_delay);
+    bool send_raw(const uint8_t* data, size_t len, const sockaddr_in& addr);
+    bool send_segmented(const Payload* datagrams, size_t count, const sockaddr_in& addr);
+    void reject(const uint8_t* data, size_t len, const sockaddr_in& src);
 
     std::string bind_ip_;
     uint16_t bind_port_;
+    EndpointOptions options_;
     socket_t sock_ = INVALID_SOCKET_VAL;
-    TransportCallback callback_;
+    Uint32 local_addr_ = 0;  // bind address, host byte order
+    std::shared_ptr<PacketCapture> capture_;
     std::thread recv_thread_;
     std::atomic<bool> running_{false};
+    std::atomic<Uint64> socket_drops_{0};
+    std::atomic<Uint64> received_{0};
+    std::atomic<Uint64> parse_errors_{0};
+    std::atomic<bool> gso_{true};  // cleared when the kernel does not know UDP_SEGMENT
+    std::atomic<Uint64> gso_refused_{0};
 };
 
 } // namespace someip
@@ -8,6 +8,8 @@
 #include <tuple>
 #include <chrono>
 #include <optional>
+#include "logging.hpp"
+#include "buffer_pool.hpp"
 
 namespace someip {
 
@@ -24,7 +26,14 @@ using Float32 = float;
 using Float64 = double;
 using Boolean = bool;
 
+// Byte buffers are plain std::vector<uint8_t>. Built with -DSOMEIP_POOLED_PAYLOAD=ON they come
+// from the slab pool (buffer_pool.hpp) instead; code that names std::vector<uint8_t> where it
+// means Payload then no longer compiles, so the option is opt-in.
+#if SOMEIP_POOLED_PAYLOAD
+using Payload = std::vector<uint8_t, pool::Allocator<uint8_t>>;
+#else
 using Payload = std::vector<uint8_t>;
+#endif
 using Endpoint = std::tuple<std::string, uint16_t>; // (ip, port)
 
 // SOME/IP identifiers
@@ -52,6 +61,8 @@ enum class MessageType : uint8_t {
 enum class ReturnCode : uint8_t {
     E_OK = 0x00,
     E_NOT_OK = 0x01,
+    E_TIMEOUT = 0x06,
+    E_MALFORMED_MESSAGE = 0x09,
     E_UNKNOWN = 0xFF
 };
 
@@ -64,10 +75,16 @@ struct MethodResult {
 // Method handler
 using MethodHandler = std::function<MethodResult(const Payload&, const Endpoint&)>;
 
-// Simple logging helper
-inline void log_info(const std::string& s) { fprintf(stdout, "[INFO] %s\n", s.c_str()); }
-inline void log_debug(const std::string& s) { fprintf(stdout, "[DEBUG] %s\n", s.c_str()); }
-inline void log_error(const std::string& s) { fprintf(stderr, "[ERROR] %s\n", s.c_str()); }
+// Simple logging helpers (asynchronous, see logging.hpp; prefer the SOMEIP_LOG_* macros on hot paths)
+inline void log_info(const std::string& s) {
+    if constexpr (logging::compiled_level <= 1) logging::write_text(logging::Level::INFO, s);
+}
+inline void log_debug(const std::string& s) {
+    if constexpr (logging::compiled_level <= 0) logging::write_text(logging::Level::DBG, s);
+}
+inline void log_error(const std::string& s) {
+    if constexpr (logging::compiled_level <= 2) logging::write_text(logging::Level::ERR, s);
+}
 
 // SOME/IP SD defaults
 constexpr const char* DEFAULT_SD_MULTICAST = "224.224.224.245";
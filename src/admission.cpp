@@ -0,0 +1,179 @@
+#include "someip/admission.hpp"
+#include "someip/dispatcher.hpp"
+#include "someip/metrics.hpp"
+#include "someip/someip_header.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace someip {
+
+namespace {
+
+// A bucket table at its cap sweeps out idle (full) buckets at most this often
+constexpr Uint64 SWEEP_INTERVAL_NS = 1000000000;
+
+// How long a rise in socket drops keeps the lowest class shed
+constexpr Uint64 DROP_SHED_NS = 100000000;
+
+Uint16 read16(const uint8_t* p) {
+    return static_cast<Uint16>((p[0] << 8) | p[1]);
+}
+
+} // namespace
+
+TokenBucket::TokenBucket(const RateLimit& limit, Uint64 now_ns)
+    : limit_(limit), tokens_(limit.burst), stamp_ns_(now_ns) {}
+
+double TokenBucket::level(Uint64 now_ns) const {
+    double elapsed = now_ns > stamp_ns_ ? double(now_ns - stamp_ns_) * 1e-9 : 0.0;
+    return std::min(limit_.burst, tokens_ + elapsed * limit_.rate);
+}
+
+bool TokenBucket::take(Uint64 now_ns) {
+    tokens_ = level(now_ns);
+    stamp_ns_ = std::max(stamp_ns_, now_ns);
+    if (tokens_ < 1.0) return false;
+    tokens_ -= 1.0;
+    return true;
+}
+
+bool TokenBucket::full(Uint64 now_ns) const {
+    return level(now_ns) >= limit_.burst;
+}
+
+AdmissionControl::AdmissionControl(FilterVerdict action) : action_(action) {
+    if (action_ == FilterVerdict::ACCEPT) action_ = FilterVerdict::DROP;
+}
+
+void AdmissionControl::set_client_limit(ServiceId service, RateLimit limit) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    client_limits_[service] = limit;
+    client_buckets_.clear();
+}
+
+void AdmissionControl::set_source_limit(ServiceId service, RateLimit limit) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    source_limits_[service] = limit;
+    source_buckets_.clear();
+}
+
+void AdmissionControl::attach(Dispatcher& dispatcher, double shed_start) {
+    dispatcher_ = &dispatcher;
+    shed_start_ = std::min(std::max(shed_start, 0.0), 0.99);
+}
+
+void AdmissionControl::note_socket_drops(Uint64 cumulative) {
+    if (cumulative <= socket_drops_.load(std::memory_order_relaxed)) return;
+    Uint64 previous = socket_drops_.exchange(cumulative, std::memory_order_relaxed);
+    if (cumulative > previous) {
+        drop_shed_until_ns_.store(Dispatcher::now_ns() + DROP_SHED_NS, std::memory_order_relaxed);
+    }
+}
+
+unsigned AdmissionControl::shed_level() const {
+    return shed_level(Dispatcher::now_ns());
+}
+
+unsigned AdmissionControl::shed_level(Uint64 now_ns) const {
+    if (!dispatcher_ || dispatcher_->classes() < 2) return 0;
+    unsigned sheddable = dispatcher_->classes() - 1;  // class 0 always gets through
+    unsigned level = 0;
+    double load = dispatcher_->load();
+    if (load > shed_start_) {
+        double over = (load - shed_start_) / (1.0 - shed_start_);
+        level = 1 + static_cast<unsigned>(std::floor(over * sheddable));
+    }
+    if (now_ns < drop_shed_until_ns_.load(std::memory_order_relaxed)) level = std::max(level, 1u);
+    return std::min(level, sheddable);
+}
+
+const RateLimit* AdmissionControl::limit_for(const std::unordered_map<ServiceId, RateLimit>& limits,
+                                             ServiceId service) const {
+    auto it = limits.find(service);
+    if (it == limits.end()) it = limits.find(ANY_SERVICE);
+    return it == limits.end() ? nullptr : &it->second;
+}
+
+bool AdmissionControl::take(Buckets& buckets, Uint64 key, const RateLimit& limit, Uint64 now_ns) {
+    auto it = buckets.index.find(key);
+    if (it != buckets.index.end()) {
+        buckets.order.splice(buckets.order.begin(), buckets.order, it->second);
+        return it->second->second.take(now_ns);
+    }
+    if (buckets.index.size() >= MAX_BUCKETS) {
+        if (now_ns >= buckets.next_sweep_ns) {
+            // A full bucket behaves like a fresh one, so forgetting it loses nothing
+            for (auto b = buckets.order.begin(); b != buckets.order.end();) {
+                if (b->second.full(now_ns)) {
+                    buckets.index.erase(b->first);
+                    b = buckets.order.erase(b);
+                } else {
+                    ++b;
+                }
+            }
+            buckets.next_sweep_ns = now_ns + SWEEP_INTERVAL_NS;
+        }
+        if (buckets.index.size() >= MAX_BUCKETS) {
+            buckets.index.erase(buckets.order.back().first);
+            buckets.order.pop_back();
+        }
+    }
+    buckets.order.emplace_front(key, TokenBucket(limit, now_ns));
+    buckets.index.emplace(key, buckets.order.begin());
+    return buckets.order.front().second.take(now_ns);
+}
+
+size_t AdmissionControl::buckets() const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return client_buckets_.index.size() + source_buckets_.index.size();
+}
+
+FilterVerdict AdmissionControl::admit(const uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port) {
+    if (len < SomeIpHeader::SIZE) return FilterVerdict::ACCEPT;  // the parser reports it
+    ServiceId service = read16(data);
+    MethodId method = read16(data + 2);
+    ClientId client = read16(data + 8);
+    Uint64 now = Dispatcher::now_ns();
+    if (watched_) note_socket_drops(watched_->socket_drops());
+
+    if (dispatcher_) {
+        unsigned level = shed_level(now);
+        if (level > 0 && dispatcher_->class_of(service, method) >= dispatcher_->classes() - level) {
+            shed_.fetch_add(1, std::memory_order_relaxed);
+            metrics::MethodRecorder(service, method).dropped();
+            return action_;
+        }
+    }
+
+    const RateLimit* client_limit = limit_for(client_limits_, service);
+    const RateLimit* source_limit = limit_for(source_limits_, service);
+    if (client_limit || source_limit) {
+        bool ok = true;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (client_limit) {
+                ok = take(client_buckets_, (Uint64(service) << 16) | client, *client_limit, now);
+            }
+            if (ok && source_limit) {
+                Uint64 key = (Uint64(service) << 48) | (Uint64(src_addr) << 16) | src_port;
+                ok = take(source_buckets_, key, *source_limit, now);
+            }
+        }
+        if (!ok) {
+            rate_limited_.fetch_add(1, std::memory_order_relaxed);
+            metrics::MethodRecorder(service, method).dropped();
+            return action_;
+        }
+    }
+
+    admitted_.fetch_add(1, std::memory_order_relaxed);
+    return FilterVerdict::ACCEPT;
+}
+
+PacketFilter AdmissionControl::filter() {
+    return [this](const uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port) {
+        return admit(data, len, src_addr, src_port);
+    };
+}
+
+} // namespace someip
@@ -5,7 +5,12 @@
 namespace someip {
 
 std::shared_ptr<UdpEndpoint> create_udp_endpoint(const std::string& bind_ip, uint16_t bind_port, const std::string& multicast_addr) {
-    auto ep = std::make_shared<UdpEndpoint>(bind_ip, bind_port);
+    return create_udp_endpoint(bind_ip, bind_port, EndpointOptions{}, multicast_addr);
+}
+
+std::shared_ptr<UdpEndpoint> create_udp_endpoint(const std::string& bind_ip, uint16_t bind_port,
+                                                 const EndpointOptions& options, const std::string& multicast_addr) {
+    auto ep = std::make_shared<UdpEndpoint>(bind_ip, bind_port, options);
     if (!ep->start()) return nullptr;
     if (!multicast_addr.empty()) ep->join_multicast(multicast_addr);
     return ep;
@@ -17,7 +22,7 @@ std::unique_ptr<ServiceDiscovery> create_service_discovery(const std::string& mu
     return sd;
 }
 
-std::unique_ptr<MessageRouter> create_message_router(std::shared_ptr<UdpEndpoint> endpoint, ServiceRegistry& registry) {
+std::unique_ptr<MessageRouter> create_message_router(std::shared_ptr<Transport> endpoint, ServiceRegistry& registry) {
     return std::make_unique<MessageRouter>(endpoint, registry);
 }
 
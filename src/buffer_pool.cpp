@@ -0,0 +1,238 @@
+#include "someip/buffer_pool.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
+
+namespace someip {
+namespace pool {
+
+namespace {
+
+constexpr unsigned MIN_SHIFT = 6;  // 64 B
+constexpr unsigned CLASSES = 11;   // 64 B .. 64 KB
+static_assert(MIN_BLOCK == size_t(1) << MIN_SHIFT, "class 0 is MIN_BLOCK");
+static_assert(MAX_BLOCK == MIN_BLOCK << (CLASSES - 1), "last class is MAX_BLOCK");
+
+constexpr size_t CACHE_BYTES = 256 * 1024;  // per class and thread
+
+struct Block {
+    Block* next;
+};
+
+inline unsigned class_of(size_t bytes) {
+    if (bytes <= MIN_BLOCK) return 0;
+#if defined(__GNUC__) || defined(__clang__)
+    return unsigned(64 - __builtin_clzll((unsigned long long)(bytes - 1))) - MIN_SHIFT;
+#else
+    unsigned c = 0;
+    while ((MIN_BLOCK << c) < bytes) ++c;
+    return c;
+#endif
+}
+
+inline size_t block_size(unsigned cls) { return MIN_BLOCK << cls; }
+
+// Blocks a thread keeps before spilling, and the number moved per refill or spill
+inline uint32_t cache_limit(unsigned cls) {
+    size_t n = CACHE_BYTES / block_size(cls);
+    return uint32_t(n < 4 ? 4 : n);
+}
+inline uint32_t batch_size(unsigned cls) { return cache_limit(cls) / 2; }
+
+struct Central {
+    std::mutex mutex;
+    Block* free = nullptr;
+    char* bump = nullptr;  // uncarved rest of the current chunk
+    char* end = nullptr;
+};
+
+struct Shared {
+    Central classes[CLASSES];
+    std::atomic<bool> huge_pages{false};
+    std::atomic<uint64_t> chunks{0};
+    std::atomic<uint64_t> huge_page_chunks{0};
+    std::atomic<uint64_t> refills{0};
+    std::atomic<uint64_t> large_allocations{0};
+};
+
+// Intentionally leaked: blocks may be freed during static destruction
+Shared& shared() {
+    static Shared* s = new Shared();
+    return *s;
+}
+
+void* map_chunk(Shared& s) {
+    bool huge = s.huge_pages.load(std::memory_order_relaxed);
+#ifdef _WIN32
+    (void)huge;
+    void* p = _aligned_malloc(CHUNK_SIZE, 4096);
+    if (!p) throw std::bad_alloc();
+#else
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge) {
+        p = mmap(nullptr, CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) s.huge_page_chunks.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, CHUNK_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+#ifdef MADV_HUGEPAGE
+        if (huge) madvise(p, CHUNK_SIZE, MADV_HUGEPAGE);
+#endif
+    }
+#endif
+    s.chunks.fetch_add(1, std::memory_order_relaxed);
+    return p;
+}
+
+// Take up to `n` blocks of a class from the shared list, carving new ones as needed.
+// Returns the number taken (always >= 1) as a linked list in `head`.
+uint32_t take(unsigned cls, uint32_t n, Block*& head) {
+    Shared& s = shared();
+    Central& c = s.classes[cls];
+    size_t size = block_size(cls);
+    std::lock_guard<std::mutex> lk(c.mutex);
+    uint32_t got = 0;
+    while (got < n && c.free) {
+        Block* b = c.free;
+        c.free = b->next;
+        b->next = head;
+        head = b;
+        ++got;
+    }
+    while (got < n) {
+        if (c.bump == c.end) {
+            c.bump = static_cast<char*>(map_chunk(s));
+            c.end = c.bump + CHUNK_SIZE;
+        }
+        Block* b = reinterpret_cast<Block*>(c.bump);
+        c.bump += size;
+        b->next = head;
+        head = b;
+        ++got;
+    }
+    return got;
+}
+
+// Return a linked list of `first`..`last` to the shared list of a class
+void give(unsigned cls, Block* first, Block* last) {
+    Central& c = shared().classes[cls];
+    std::lock_guard<std::mutex> lk(c.mutex);
+    last->next = c.free;
+    c.free = first;
+}
+
+struct ThreadCache {
+    Block* head[CLASSES] = {};
+    uint32_t count[CLASSES] = {};
+
+    ~ThreadCache();
+};
+
+thread_local ThreadCache cache;
+thread_local bool cache_gone = false;  // trivially destructible, so valid after ~ThreadCache
+
+ThreadCache::~ThreadCache() {
+    for (unsigned cls = 0; cls < CLASSES; ++cls) {
+        Block* first = head[cls];
+        if (!first) continue;
+        Block* last = first;
+        while (last->next) last = last->next;
+        give(cls, first, last);
+        head[cls] = nullptr;
+        count[cls] = 0;
+    }
+    cache_gone = true;
+}
+
+class PoolResource : public std::pmr::memory_resource {
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        if (alignment > MIN_BLOCK) return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        return pool::allocate(bytes);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        if (alignment > MIN_BLOCK) return std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+        pool::deallocate(p, bytes);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+} // namespace
+
+void* allocate(size_t bytes) {
+    if (bytes > MAX_BLOCK) {
+        shared().large_allocations.fetch_add(1, std::memory_order_relaxed);
+        return ::operator new(bytes);
+    }
+    unsigned cls = class_of(bytes);
+    Block* b = nullptr;
+    if (cache_gone) {
+        take(cls, 1, b);
+        return b;
+    }
+    ThreadCache& tc = cache;
+    if (!tc.head[cls]) {
+        tc.count[cls] += take(cls, batch_size(cls), tc.head[cls]);
+        shared().refills.fetch_add(1, std::memory_order_relaxed);
+    }
+    b = tc.head[cls];
+    tc.head[cls] = b->next;
+    --tc.count[cls];
+    return b;
+}
+
+void deallocate(void* p, size_t bytes) noexcept {
+    if (!p) return;
+    if (bytes > MAX_BLOCK) {
+        ::operator delete(p);
+        return;
+    }
+    unsigned cls = class_of(bytes);
+    Block* b = static_cast<Block*>(p);
+    if (cache_gone) {
+        give(cls, b, b);
+        return;
+    }
+    ThreadCache& tc = cache;
+    b->next = tc.head[cls];
+    tc.head[cls] = b;
+    if (++tc.count[cls] <= cache_limit(cls)) return;
+    // Spill half of the list so a producer/consumer thread pair does not ping-pong
+    uint32_t n = batch_size(cls);
+    Block* last = tc.head[cls];
+    for (uint32_t i = 1; i < n; ++i) last = last->next;
+    Block* first = tc.head[cls];
+    tc.head[cls] = last->next;
+    tc.count[cls] -= n;
+    give(cls, first, last);
+}
+
+void set_huge_pages(bool enabled) {
+    shared().huge_pages.store(enabled, std::memory_order_relaxed);
+}
+
+Stats stats() {
+    Shared& s = shared();
+    Stats st;
+    st.chunks = s.chunks.load(std::memory_order_relaxed);
+    st.huge_page_chunks = s.huge_page_chunks.load(std::memory_order_relaxed);
+    st.refills = s.refills.load(std::memory_order_relaxed);
+    st.large_allocations = s.large_allocations.load(std::memory_order_relaxed);
+    return st;
+}
+
+std::pmr::memory_resource* resource() {
+    static PoolResource r;
+    return &r;
+}
+
+} // namespace pool
+} // namespace someip
@@ -0,0 +1,334 @@
+#include "someip/capture.hpp"
+#include <chrono>
+#include <cstring>
+
+#ifdef _WIN32
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+#else
+  #include <sys/mman.h>
+#endif
+
+namespace someip {
+
+namespace {
+
+constexpr Uint32 PCAP_MAGIC_USEC = 0xA1B2C3D4;
+constexpr Uint32 PCAP_MAGIC_NSEC = 0xA1B23C4D;
+constexpr Uint32 LINKTYPE_ETHERNET = 1;
+constexpr Uint32 LINKTYPE_RAW = 101;
+constexpr Uint32 LINKTYPE_LINUX_SLL = 113;
+constexpr Uint32 LINKTYPE_IPV4 = 228;
+constexpr size_t IP_UDP_HEADERS = 28;
+
+// Ring entry header; `state` turns non-zero once the producer has finished copying
+struct RingRecord {
+    Uint32 state;
+    Uint32 size;      // whole entry including this header, 8-byte aligned
+    Uint64 timestamp_ns;
+    Uint32 src_ip;
+    Uint32 dst_ip;
+    uint16_t src_port;
+    uint16_t dst_port;
+    Uint32 orig_len;
+    Uint32 cap_len;
+    Uint32 reserved;
+};
+static_assert(sizeof(RingRecord) % 8 == 0, "ring entries must stay 8-byte aligned");
+
+constexpr Uint32 STATE_RECORD = 1;
+constexpr Uint32 STATE_PADDING = 2;
+
+inline std::atomic<Uint32>& state_of(uint8_t* p) {
+    return *reinterpret_cast<std::atomic<Uint32>*>(p);
+}
+
+inline void put16(uint8_t* p, uint16_t v) { p[0] = uint8_t(v >> 8); p[1] = uint8_t(v); }
+inline void put32(uint8_t* p, Uint32 v) { put16(p, uint16_t(v >> 16)); put16(p + 2, uint16_t(v)); }
+inline uint16_t get16(const uint8_t* p) { return uint16_t((p[0] << 8) | p[1]); }
+inline Uint32 get32(const uint8_t* p) { return (Uint32(get16(p)) << 16) | get16(p + 2); }
+
+inline Uint32 swap32(Uint32 v) {
+    return ((v & 0xFFu) << 24) | ((v & 0xFF00u) << 8) | ((v >> 8) & 0xFF00u) | (v >> 24);
+}
+
+Uint64 realtime_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+uint8_t* map_ring(size_t size, bool huge, bool& got_huge) {
+    got_huge = false;
+#ifdef _WIN32
+    (void)huge;
+    return static_cast<uint8_t*>(VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge) {
+        p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        got_huge = p != MAP_FAILED;
+    }
+#else
+    (void)huge;
+#endif
+    if (p == MAP_FAILED) p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    return p == MAP_FAILED ? nullptr : static_cast<uint8_t*>(p);
+#endif
+}
+
+void unmap_ring(uint8_t* p, size_t size) {
+    if (!p) return;
+#ifdef _WIN32
+    (void)size;
+    VirtualFree(p, 0, MEM_RELEASE);
+#else
+    munmap(p, size);
+#endif
+}
+
+} // namespace
+
+std::string ipv4_to_string(Uint32 ip) {
+    char tmp[16];
+    snprintf(tmp, sizeof(tmp), "%u.%u.%u.%u", ip >> 24, (ip >> 16) & 0xFF, (ip >> 8) & 0xFF, ip & 0xFF);
+    return std::string(tmp);
+}
+
+std::shared_ptr<PacketCapture> PacketCapture::open(const std::string& path, const CaptureOptions& opts) {
+    std::shared_ptr<PacketCapture> cap(new PacketCapture());
+    cap->file_ = fopen(path.c_str(), "wb");
+    if (!cap->file_) {
+        log_error("capture: cannot open " + path);
+        return nullptr;
+    }
+    setvbuf(cap->file_, nullptr, _IOFBF, 1 << 20);
+
+    size_t size = 4096;
+    while (size < opts.ring_bytes) size <<= 1;
+    cap->ring_size_ = size;
+    cap->ring_ = map_ring(size, opts.huge_pages, cap->ring_huge_);
+    if (!cap->ring_) {
+        log_error("capture: cannot map ring buffer");
+        fclose(cap->file_);
+        cap->file_ = nullptr;
+        return nullptr;
+    }
+    cap->snaplen_ = opts.snaplen ? opts.snaplen : 65535;
+
+    uint8_t hdr[24];
+    Uint32 magic = PCAP_MAGIC_NSEC;
+    uint16_t major = 2, minor = 4;
+    Uint32 zero = 0, snap = cap->snaplen_ + IP_UDP_HEADERS, link = LINKTYPE_RAW;
+    std::memcpy(hdr, &magic, 4);
+    std::memcpy(hdr + 4, &major, 2);
+    std::memcpy(hdr + 6, &minor, 2);
+    std::memcpy(hdr + 8, &zero, 4);
+    std::memcpy(hdr + 12, &zero, 4);
+    std::memcpy(hdr + 16, &snap, 4);
+    std::memcpy(hdr + 20, &link, 4);
+    fwrite(hdr, 1, sizeof(hdr), cap->file_);
+
+    cap->running_ = true;
+    cap->writer_ = std::thread(&PacketCapture::writer_loop, cap.get());
+    return cap;
+}
+
+PacketCapture::~PacketCapture() {
+    close();
+    unmap_ring(ring_, ring_size_);
+}
+
+void PacketCapture::close() {
+    if (running_.exchange(false) && writer_.joinable()) writer_.join();
+    if (file_) {
+        drain();
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+void PacketCapture::record(const uint8_t* data, size_t len, Uint32 src_ip, uint16_t src_port,
+                           Uint32 dst_ip, uint16_t dst_port) {
+    Uint32 cap_len = static_cast<Uint32>(len < snaplen_ ? len : snaplen_);
+    size_t need = (sizeof(RingRecord) + cap_len + 7) & ~size_t(7);
+    if (need > ring_size_ / 2) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Reserve space; an entry never wraps, the remainder of the ring is padded instead
+    Uint64 head = head_.load(std::memory_order_relaxed);
+    size_t pos, total;
+    do {
+        pos = static_cast<size_t>(head & (ring_size_ - 1));
+        total = (pos + need > ring_size_) ? need + (ring_size_ - pos) : need;
+        if (head + total - tail_.load(std::memory_order_acquire) > ring_size_) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!head_.compare_exchange_weak(head, head + total, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed));
+
+    if (total != need) {
+        RingRecord* pad = reinterpret_cast<RingRecord*>(ring_ + pos);
+        pad->size = static_cast<Uint32>(ring_size_ - pos);
+        state_of(ring_ + pos).store(STATE_PADDING, std::memory_order_release);
+        pos = 0;
+    }
+    RingRecord* rec = reinterpret_cast<RingRecord*>(ring_ + pos);
+    rec->size = static_cast<Uint32>(need);
+    rec->timestamp_ns = realtime_ns();
+    rec->src_ip = src_ip;
+    rec->dst_ip = dst_ip;
+    rec->src_port = src_port;
+    rec->dst_port = dst_port;
+    rec->orig_len = static_cast<Uint32>(len);
+    rec->cap_len = cap_len;
+    std::memcpy(ring_ + pos + sizeof(RingRecord), data, cap_len);
+    state_of(ring_ + pos).store(STATE_RECORD, std::memory_order_release);
+    captured_.fetch_add(1, std::memory_order_relaxed);
+}
+
+size_t PacketCapture::drain() {
+    size_t written = 0;
+    Uint64 tail = tail_.load(std::memory_order_relaxed);
+    Uint64 head = head_.load(std::memory_order_acquire);
+    while (tail != head) {
+        size_t pos = static_cast<size_t>(tail & (ring_size_ - 1));
+        Uint32 state = state_of(ring_ + pos).load(std::memory_order_acquire);
+        if (state == 0) break;  // producer still copying
+        const RingRecord* rec = reinterpret_cast<const RingRecord*>(ring_ + pos);
+        Uint32 size = rec->size;
+        if (state == STATE_RECORD) {
+            uint8_t hdr[16 + IP_UDP_HEADERS];
+            Uint32 ts_sec = static_cast<Uint32>(rec->timestamp_ns / 1000000000ULL);
+            Uint32 ts_nsec = static_cast<Uint32>(rec->timestamp_ns % 1000000000ULL);
+            Uint32 incl = rec->cap_len + IP_UDP_HEADERS;
+            Uint32 orig = rec->orig_len + IP_UDP_HEADERS;
+            std::memcpy(hdr, &ts_sec, 4);
+            std::memcpy(hdr + 4, &ts_nsec, 4);
+            std::memcpy(hdr + 8, &incl, 4);
+            std::memcpy(hdr + 12, &orig, 4);
+
+            uint8_t* ip = hdr + 16;
+            ip[0] = 0x45;
+            ip[1] = 0;
+            put16(ip + 2, static_cast<uint16_t>(orig > 0xFFFF ? 0xFFFF : orig));
+            put16(ip + 4, 0);
+            put16(ip + 6, 0x4000);
+            ip[8] = 64;
+            ip[9] = 17;
+            put16(ip + 10, 0);
+            put32(ip + 12, rec->src_ip);
+            put32(ip + 16, rec->dst_ip);
+            Uint32 sum = 0;
+            for (int i = 0; i < 20; i += 2) sum += get16(ip + i);
+            while (sum >> 16) sum = (sum & 0xFFFF) + (sum >> 16);
+            put16(ip + 10, static_cast<uint16_t>(~sum));
+
+            uint8_t* udp = ip + 20;
+            put16(udp, rec->src_port);
+            put16(udp + 2, rec->dst_port);
+            put16(udp + 4, static_cast<uint16_t>(rec->orig_len + 8 > 0xFFFF ? 0xFFFF : rec->orig_len + 8));
+            put16(udp + 6, 0);
+
+            fwrite(hdr, 1, sizeof(hdr), file_);
+            fwrite(ring_ + pos + sizeof(RingRecord), 1, rec->cap_len, file_);
+            ++written;
+        }
+        // Zero the entry before releasing it so a stale state word is never mistaken for a commit
+        std::memset(ring_ + pos, 0, size);
+        tail += size;
+        tail_.store(tail, std::memory_order_release);
+    }
+    return written;
+}
+
+void PacketCapture::writer_loop() {
+    while (running_) {
+        if (drain() == 0) {
+            fflush(file_);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+PcapReader::~PcapReader() {
+    if (file_) fclose(file_);
+}
+
+bool PcapReader::open(const std::string& path) {
+    file_ = fopen(path.c_str(), "rb");
+    if (!file_) return false;
+    uint8_t hdr[24];
+    if (fread(hdr, 1, sizeof(hdr), file_) != sizeof(hdr)) return false;
+    Uint32 magic;
+    std::memcpy(&magic, hdr, 4);
+    if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC) {
+        swapped_ = false;
+    } else if (swap32(magic) == PCAP_MAGIC_USEC || swap32(magic) == PCAP_MAGIC_NSEC) {
+        swapped_ = true;
+        magic = swap32(magic);
+    } else {
+        return false;
+    }
+    nanos_ = magic == PCAP_MAGIC_NSEC;
+    std::memcpy(&linktype_, hdr + 20, 4);
+    if (swapped_) linktype_ = swap32(linktype_);
+    linktype_ &= 0x0FFFFFFF;
+    return linktype_ == LINKTYPE_ETHERNET || linktype_ == LINKTYPE_RAW ||
+           linktype_ == LINKTYPE_LINUX_SLL || linktype_ == LINKTYPE_IPV4;
+}
+
+bool PcapReader::next(CapturedPacket& pkt) {
+    if (!file_) return false;
+    for (;;) {
+        uint8_t rh[16];
+        if (fread(rh, 1, sizeof(rh), file_) != sizeof(rh)) return false;
+        Uint32 f[4];
+        std::memcpy(f, rh, sizeof(f));
+        if (swapped_) for (auto& v : f) v = swap32(v);
+        if (f[2] > (1u << 24)) return false;  // corrupt record
+        record_.resize(f[2]);
+        if (f[2] && fread(record_.data(), 1, f[2], file_) != f[2]) return false;
+
+        const uint8_t* p = record_.data();
+        size_t n = record_.size();
+        size_t off = 0;
+        if (linktype_ == LINKTYPE_ETHERNET) {
+            if (n < 14) continue;
+            uint16_t ethertype = get16(p + 12);
+            off = 14;
+            if (ethertype == 0x8100 && n >= 18) {
+                ethertype = get16(p + 16);
+                off = 18;
+            }
+            if (ethertype != 0x0800) continue;
+        } else if (linktype_ == LINKTYPE_LINUX_SLL) {
+            if (n < 16 || get16(p + 14) != 0x0800) continue;
+            off = 16;
+        }
+        if (n < off + 20 || (p[off] >> 4) != 4 || p[off + 9] != 17) continue;
+        if (get16(p + off + 6) & 0x1FFF) continue;  // non-first fragment
+        size_t ihl = size_t(p[off] & 0x0F) * 4;
+        if (n < off + ihl + 8) continue;
+        const uint8_t* udp = p + off + ihl;
+        size_t udp_len = get16(udp + 4);
+        size_t avail = n - off - ihl;
+        if (udp_len < 8) continue;
+        size_t payload_len = (udp_len < avail ? udp_len : avail) - 8;
+
+        pkt.timestamp_ns = Uint64(f[0]) * 1000000000ULL + (nanos_ ? f[1] : Uint64(f[1]) * 1000ULL);
+        pkt.src_ip = get32(p + off + 12);
+        pkt.dst_ip = get32(p + off + 16);
+        pkt.src_port = get16(udp);
+        pkt.dst_port = get16(udp + 2);
+        pkt.data.assign(udp + 8, udp + 8 + payload_len);
+        return true;
+    }
+}
+
+} // namespace someip
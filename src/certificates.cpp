@@ -0,0 +1,371 @@
+#include "certificates_impl.hpp"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iterator>
+#include <sys/stat.h>
+#include <openssl/bio.h>
+#include <openssl/err.h>
+#include <openssl/pem.h>
+#include <openssl/x509v3.h>
+
+namespace someip {
+
+namespace {
+
+using TimePoint = std::chrono::system_clock::time_point;
+
+TimePoint to_time_point(const ASN1_TIME* t) {
+    struct tm tm = {};
+    if (!t || ASN1_TIME_to_tm(t, &tm) != 1) return TimePoint{};
+#ifdef _WIN32
+    return std::chrono::system_clock::from_time_t(_mkgmtime(&tm));
+#else
+    return std::chrono::system_clock::from_time_t(timegm(&tm));
+#endif
+}
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+X509* parse_pem_cert(const std::string& pem) {
+    BIO* bio = BIO_new_mem_buf(pem.data(), (int)pem.size());
+    X509* cert = bio ? PEM_read_bio_X509(bio, nullptr, nullptr, nullptr) : nullptr;
+    BIO_free(bio);
+    return cert;
+}
+
+// Leaf followed by any further certificates of a PEM bundle (the intermediates)
+X509* parse_pem_bundle(const std::string& pem, STACK_OF(X509)* rest) {
+    BIO* bio = BIO_new_mem_buf(pem.data(), (int)pem.size());
+    X509* leaf = bio ? PEM_read_bio_X509(bio, nullptr, nullptr, nullptr) : nullptr;
+    while (leaf) {
+        X509* c = PEM_read_bio_X509(bio, nullptr, nullptr, nullptr);
+        if (!c) break;
+        if (sk_X509_push(rest, c) <= 0) X509_free(c);
+    }
+    BIO_free(bio);
+    ERR_clear_error();
+    return leaf;
+}
+
+X509* parse_der_cert(const uint8_t* data, size_t len) {
+    const unsigned char* p = data;
+    return d2i_X509(nullptr, &p, (long)len);
+}
+
+int password_cb(char* buf, int size, int, void* u) {
+    const std::string* pw = static_cast<const std::string*>(u);
+    int n = (int)pw->size() < size ? (int)pw->size() : size;
+    std::memcpy(buf, pw->data(), n);
+    return n;
+}
+
+EVP_PKEY* parse_private_key(const std::string& data, const std::string& password) {
+    BIO* bio = BIO_new_mem_buf(data.data(), (int)data.size());
+    EVP_PKEY* key = bio ? PEM_read_bio_PrivateKey(bio, nullptr, password_cb,
+                                                  const_cast<std::string*>(&password)) : nullptr;
+    BIO_free(bio);
+    if (!key) {
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+        key = d2i_AutoPrivateKey(nullptr, &p, (long)data.size());
+    }
+    ERR_clear_error();
+    return key;
+}
+
+std::string to_hex(const uint8_t* p, size_t n) {
+    static const char digits[] = "0123456789abcdef";
+    std::string out;
+    out.reserve(n * 2);
+    for (size_t i = 0; i < n; ++i) {
+        out += digits[p[i] >> 4];
+        out += digits[p[i] & 0xF];
+    }
+    return out;
+}
+
+std::string name_to_string(X509_NAME* name) {
+    BIO* bio = BIO_new(BIO_s_mem());
+    if (!bio) return {};
+    X509_NAME_print_ex(bio, name, 0, XN_FLAG_RFC2253);
+    char* data = nullptr;
+    long len = BIO_get_mem_data(bio, &data);
+    std::string out(data, len > 0 ? size_t(len) : 0);
+    BIO_free(bio);
+    return out;
+}
+
+VerificationResult verify_with_store(CertificateManager& owner, X509_STORE* store, X509* leaf,
+                                     STACK_OF(X509)* untrusted) {
+    X509_STORE_CTX* ctx = X509_STORE_CTX_new();
+    if (!ctx || X509_STORE_CTX_init(ctx, store, leaf, untrusted) != 1) {
+        X509_STORE_CTX_free(ctx);
+        return {false, "cannot initialize verification", -1};
+    }
+    VerificationResult result{true, "", 0};
+    if (!TlsContextAccess::verify(owner, ctx)) {
+        int err = X509_STORE_CTX_get_error(ctx);
+        result = {false, X509_verify_cert_error_string(err), err};
+    }
+    X509_STORE_CTX_free(ctx);
+    return result;
+}
+
+} // namespace
+
+CertificateManager::Impl::~Impl() {
+    X509_free(cert);
+    sk_X509_pop_free(chain, X509_free);
+    EVP_PKEY_free(key);
+    X509_STORE_free(store);
+}
+
+void CertificateManager::Impl::set_certificate(X509* leaf, STACK_OF(X509)* intermediates) {
+    X509_free(cert);
+    sk_X509_pop_free(chain, X509_free);
+    cert = leaf;
+    chain = intermediates;
+}
+
+std::string CertificateManager::Impl::chain_key(X509* leaf, STACK_OF(X509)* untrusted, int purpose,
+                                                X509_VERIFY_PARAM* param) {
+    EVP_MD_CTX* md = EVP_MD_CTX_new();
+    if (!md || EVP_DigestInit_ex(md, EVP_sha256(), nullptr) != 1) {
+        EVP_MD_CTX_free(md);
+        return {};
+    }
+    auto add = [&](X509* c) {
+        unsigned char* der = nullptr;
+        int len = i2d_X509(c, &der);
+        if (len > 0) EVP_DigestUpdate(md, der, len);
+        OPENSSL_free(der);
+    };
+    add(leaf);
+    for (int i = 0; untrusted && i < sk_X509_num(untrusted); ++i) add(sk_X509_value(untrusted, i));
+    // A chain verified for one purpose or set of checks is not thereby valid for another
+    auto add_value = [&](long long v) { EVP_DigestUpdate(md, &v, sizeof(v)); };
+    auto add_string = [&](const char* str) {
+        add_value(str ? (long long)std::strlen(str) : -1);
+        if (str) EVP_DigestUpdate(md, str, std::strlen(str));
+    };
+    add_value(purpose);
+    if (param) {
+        add_value((long long)X509_VERIFY_PARAM_get_flags(param));
+        add_value(X509_VERIFY_PARAM_get_depth(param));
+        add_value(X509_VERIFY_PARAM_get_auth_level(param));
+        add_value(X509_VERIFY_PARAM_get_hostflags(param));
+        for (int i = 0; const char* host = X509_VERIFY_PARAM_get0_host(param, i); ++i) add_string(host);
+        add_string(nullptr);
+        char* ip = X509_VERIFY_PARAM_get1_ip_asc(param);
+        add_string(ip);
+        OPENSSL_free(ip);
+        add_string(X509_VERIFY_PARAM_get0_email(param));
+    }
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    EVP_DigestFinal_ex(md, digest, &len);
+    EVP_MD_CTX_free(md);
+    return std::string(reinterpret_cast<const char*>(digest), len);
+}
+
+bool CertificateManager::Impl::cache_lookup(const std::string& k) {
+    std::lock_guard<std::mutex> lk(cache_mutex);
+    auto it = cache.find(k);
+    if (it == cache.end()) return false;
+    if (it->second <= std::chrono::system_clock::now()) {
+        cache.erase(it);
+        return false;
+    }
+    return true;
+}
+
+void CertificateManager::Impl::cache_store(const std::string& k, X509_STORE_CTX* verified) {
+    TimePoint now = std::chrono::system_clock::now();
+    TimePoint until = now + ttl;
+    STACK_OF(X509)* chain = X509_STORE_CTX_get0_chain(verified);
+    for (int i = 0; chain && i < sk_X509_num(chain); ++i) {
+        TimePoint na = to_time_point(X509_get0_notAfter(sk_X509_value(chain, i)));
+        if (na < until) until = na;
+    }
+    if (until <= now || max_entries == 0) return;
+    std::lock_guard<std::mutex> lk(cache_mutex);
+    if (cache.size() >= max_entries) {
+        for (auto it = cache.begin(); it != cache.end();) {
+            it = it->second <= now ? cache.erase(it) : std::next(it);
+        }
+        if (cache.size() >= max_entries) cache.erase(cache.begin());
+    }
+    cache[k] = until;
+}
+
+bool TlsContextAccess::verify(CertificateManager& m, X509_STORE_CTX* ctx, int purpose) {
+    CertificateManager::Impl& impl = *m.impl_;
+    if (purpose != 0 && X509_STORE_CTX_set_purpose(ctx, purpose) != 1) return false;
+    std::string k = CertificateManager::Impl::chain_key(X509_STORE_CTX_get0_cert(ctx),
+                                                        X509_STORE_CTX_get0_untrusted(ctx), purpose,
+                                                        X509_STORE_CTX_get0_param(ctx));
+    if (!k.empty() && impl.cache_lookup(k)) {
+        m.cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    m.cache_misses_.fetch_add(1, std::memory_order_relaxed);
+    if (X509_verify_cert(ctx) != 1) return false;
+    if (!k.empty()) impl.cache_store(k, ctx);
+    return true;
+}
+
+CertificateManager::CertificateManager() : impl_(new Impl()) {
+    impl_->store = X509_STORE_new();
+}
+
+CertificateManager::~CertificateManager() = default;
+
+bool CertificateManager::load_certificate(const std::string& cert_path) {
+    std::string data;
+    if (!read_file(cert_path, data)) return false;
+    if (load_certificate_pem(data)) return true;
+    X509* cert = parse_der_cert(reinterpret_cast<const uint8_t*>(data.data()), data.size());
+    ERR_clear_error();
+    if (!cert) return false;
+    impl_->set_certificate(cert, sk_X509_new_null());
+    return true;
+}
+
+bool CertificateManager::load_certificate_pem(const std::string& pem_data) {
+    STACK_OF(X509)* rest = sk_X509_new_null();
+    X509* cert = rest ? parse_pem_bundle(pem_data, rest) : nullptr;
+    if (!cert) {
+        sk_X509_free(rest);
+        return false;
+    }
+    impl_->set_certificate(cert, rest);
+    return true;
+}
+
+bool CertificateManager::load_private_key(const std::string& key_path, const std::string& password) {
+    std::string data;
+    return read_file(key_path, data) && load_private_key_pem(data, password);
+}
+
+bool CertificateManager::load_private_key_pem(const std::string& pem_data, const std::string& password) {
+    EVP_PKEY* key = parse_private_key(pem_data, password);
+    if (!key) return false;
+    EVP_PKEY_free(impl_->key);
+    impl_->key = key;
+    return true;
+}
+
+bool CertificateManager::load_ca_certificates(const std::string& ca_path) {
+    struct stat st;
+    if (stat(ca_path.c_str(), &st) != 0) return false;
+    bool is_dir = (st.st_mode & S_IFMT) == S_IFDIR;
+    bool ok = X509_STORE_load_locations(impl_->store, is_dir ? nullptr : ca_path.c_str(),
+                                        is_dir ? ca_path.c_str() : nullptr) == 1;
+    ERR_clear_error();
+    clear_cache();
+    return ok;
+}
+
+bool CertificateManager::add_ca_certificate_pem(const std::string& pem_data) {
+    X509* cert = parse_pem_cert(pem_data);
+    if (!cert) return false;
+    bool ok = X509_STORE_add_cert(impl_->store, cert) == 1;
+    X509_free(cert);
+    ERR_clear_error();
+    clear_cache();
+    return ok;
+}
+
+std::optional<CertificateInfo> CertificateManager::get_certificate_info() const {
+    X509* cert = impl_->cert;
+    if (!cert) return std::nullopt;
+    CertificateInfo info;
+    info.subject = name_to_string(X509_get_subject_name(cert));
+    info.issuer = name_to_string(X509_get_issuer_name(cert));
+    const ASN1_INTEGER* serial = X509_get0_serialNumber(cert);
+    info.serial_number = to_hex(serial->data, serial->length);
+    info.not_before = to_time_point(X509_get0_notBefore(cert));
+    info.not_after = to_time_point(X509_get0_notAfter(cert));
+
+    auto* names = static_cast<GENERAL_NAMES*>(X509_get_ext_d2i(cert, NID_subject_alt_name, nullptr, nullptr));
+    for (int i = 0; names && i < sk_GENERAL_NAME_num(names); ++i) {
+        const GENERAL_NAME* gn = sk_GENERAL_NAME_value(names, i);
+        if (gn->type == GEN_DNS) {
+            const ASN1_STRING* s = gn->d.dNSName;
+            info.subject_alt_names.emplace_back(reinterpret_cast<const char*>(ASN1_STRING_get0_data(s)),
+                                                ASN1_STRING_length(s));
+        } else if (gn->type == GEN_IPADD && ASN1_STRING_length(gn->d.iPAddress) == 4) {
+            const unsigned char* ip = ASN1_STRING_get0_data(gn->d.iPAddress);
+            char buf[16];
+            snprintf(buf, sizeof(buf), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+            info.subject_alt_names.emplace_back(buf);
+        }
+    }
+    GENERAL_NAMES_free(names);
+
+    EVP_PKEY* pub = X509_get0_pubkey(cert);
+    info.public_key_algorithm = pub ? OBJ_nid2sn(EVP_PKEY_base_id(pub)) : "";
+    info.key_size_bits = pub ? EVP_PKEY_bits(pub) : 0;
+    info.is_ca = X509_check_ca(cert) != 0;
+    return info;
+}
+
+VerificationResult CertificateManager::verify_certificate(const std::string& cert_pem,
+                                                          const std::vector<std::string>& intermediates_pem) {
+    std::vector<Payload> chain;
+    for (size_t i = 0; i <= intermediates_pem.size(); ++i) {
+        X509* cert = parse_pem_cert(i == 0 ? cert_pem : intermediates_pem[i - 1]);
+        if (!cert) return {false, "cannot parse certificate", -1};
+        unsigned char* der = nullptr;
+        int len = i2d_X509(cert, &der);
+        if (len > 0) chain.emplace_back(der, der + len);
+        OPENSSL_free(der);
+        X509_free(cert);
+    }
+    return verify_chain_der(chain);
+}
+
+VerificationResult CertificateManager::verify_chain_der(const std::vector<Payload>& chain_der) {
+    if (chain_der.empty()) return {false, "empty chain", -1};
+    X509* leaf = parse_der_cert(chain_der[0].data(), chain_der[0].size());
+    STACK_OF(X509)* untrusted = sk_X509_new_null();
+    bool parsed = leaf && untrusted;
+    for (size_t i = 1; parsed && i < chain_der.size(); ++i) {
+        X509* c = parse_der_cert(chain_der[i].data(), chain_der[i].size());
+        parsed = c && sk_X509_push(untrusted, c) > 0;
+        if (!parsed) X509_free(c);
+    }
+    VerificationResult result = parsed ? verify_with_store(*this, impl_->store, leaf, untrusted)
+                                       : VerificationResult{false, "cannot parse certificate", -1};
+    sk_X509_pop_free(untrusted, X509_free);
+    X509_free(leaf);
+    ERR_clear_error();
+    return result;
+}
+
+void CertificateManager::set_cache_limits(size_t max_entries, std::chrono::seconds ttl) {
+    std::lock_guard<std::mutex> lk(impl_->cache_mutex);
+    impl_->max_entries = max_entries;
+    impl_->ttl = ttl;
+    impl_->cache.clear();
+}
+
+void CertificateManager::clear_cache() {
+    std::lock_guard<std::mutex> lk(impl_->cache_mutex);
+    impl_->cache.clear();
+}
+
+std::string CertificateManager::fingerprint(const Payload& der) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int len = 0;
+    if (EVP_Digest(der.data(), der.size(), digest, &len, EVP_sha256(), nullptr) != 1) return {};
+    return to_hex(digest, len);
+}
+
+} // namespace someip
@@ -0,0 +1,49 @@
+#ifndef SOMEIP_CERTIFICATES_IMPL_HPP
+#define SOMEIP_CERTIFICATES_IMPL_HPP
+
+// OpenSSL state behind CertificateManager, shared with the TLS transport (not installed)
+
+#include "someip/certificates.hpp"
+#include <mutex>
+#include <unordered_map>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+namespace someip {
+
+struct CertificateManager::Impl {
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    X509* cert = nullptr;
+    STACK_OF(X509)* chain = nullptr;  // intermediates sent after `cert`
+    EVP_PKEY* key = nullptr;
+    X509_STORE* store = nullptr;
+
+    std::mutex cache_mutex;
+    std::unordered_map<std::string, TimePoint> cache;  // chain digest -> valid until
+    size_t max_entries = 1024;
+    std::chrono::seconds ttl{3600};
+
+    ~Impl();
+    void set_certificate(X509* leaf, STACK_OF(X509)* intermediates);
+
+    // Cache key: digest of the presented leaf and untrusted certificates together with the
+    // purpose and the verification parameters (flags, depth, expected host/IP/email)
+    static std::string chain_key(X509* leaf, STACK_OF(X509)* untrusted, int purpose, X509_VERIFY_PARAM* param);
+    bool cache_lookup(const std::string& key);
+    void cache_store(const std::string& key, X509_STORE_CTX* verified);
+};
+
+// Access for the TLS transport: certificate, key and trust store, and the cached chain
+// verification used as the handshake's certificate verify callback
+struct TlsContextAccess {
+    static CertificateManager::Impl& impl(CertificateManager& m) { return *m.impl_; }
+
+    // Verify an initialized X509_STORE_CTX for `purpose` (X509_PURPOSE_*, 0: any), answering
+    // from the cache when the same chain was verified for the same purpose and parameters
+    static bool verify(CertificateManager& m, X509_STORE_CTX* ctx, int purpose = 0);
+};
+
+} // namespace someip
+
+#endif // SOMEIP_CERTIFICATES_IMPL_HPP
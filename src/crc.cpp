@@ -0,0 +1,332 @@
+#include "someip/crc.hpp"
+#include <array>
+#include <atomic>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+  #define SOMEIP_CRC_X86 1
+  #include <nmmintrin.h>
+  #include <smmintrin.h>
+  #include <wmmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+  #define SOMEIP_CRC_ARM 1
+  #include <arm_acle.h>
+#endif
+
+namespace someip {
+namespace crc {
+
+namespace {
+
+// Slice-by-8 tables: t[0] is the classic byte table, t[k] advances a byte through k more
+// zero bytes, so eight input bytes are folded with eight independent lookups.
+template <typename T>
+using Tables = std::array<std::array<T, 256>, 8>;
+
+constexpr Tables<Uint32> make_reflected32(Uint32 poly) {
+    Tables<Uint32> t{};
+    for (Uint32 b = 0; b < 256; ++b) {
+        Uint32 c = b;
+        for (int i = 0; i < 8; ++i) c = (c >> 1) ^ ((c & 1) ? poly : 0);
+        t[0][b] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int b = 0; b < 256; ++b) t[k][b] = (t[k - 1][b] >> 8) ^ t[0][t[k - 1][b] & 0xFF];
+    }
+    return t;
+}
+
+constexpr Tables<Uint16> make_msb16(Uint16 poly) {
+    Tables<Uint16> t{};
+    for (unsigned b = 0; b < 256; ++b) {
+        Uint16 c = Uint16(b << 8);
+        for (int i = 0; i < 8; ++i) c = Uint16((c & 0x8000) ? (c << 1) ^ poly : c << 1);
+        t[0][b] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int b = 0; b < 256; ++b) t[k][b] = Uint16((t[k - 1][b] << 8) ^ t[0][t[k - 1][b] >> 8]);
+    }
+    return t;
+}
+
+constexpr Tables<Uint8> make_msb8(Uint8 poly) {
+    Tables<Uint8> t{};
+    for (unsigned b = 0; b < 256; ++b) {
+        Uint8 c = Uint8(b);
+        for (int i = 0; i < 8; ++i) c = Uint8((c & 0x80) ? (c << 1) ^ poly : c << 1);
+        t[0][b] = c;
+    }
+    for (int k = 1; k < 8; ++k) {
+        for (int b = 0; b < 256; ++b) t[k][b] = t[0][t[k - 1][b]];
+    }
+    return t;
+}
+
+constexpr Tables<Uint32> CRC32_TABLES = make_reflected32(0xEDB88320u);
+constexpr Tables<Uint32> CRC32C_TABLES = make_reflected32(0x82F63B78u);
+constexpr Tables<Uint32> CRC32P4_TABLES = make_reflected32(0xC8DF352Fu);
+constexpr Tables<Uint16> CRC16_TABLES = make_msb16(0x1021);
+constexpr Tables<Uint8> CRC8_TABLES = make_msb8(0x1D);
+constexpr Tables<Uint8> CRC8H2F_TABLES = make_msb8(0x2F);
+
+// Raw register updates (no initial/final XOR)
+
+Uint32 slice8_reflected32(const Tables<Uint32>& t, Uint32 crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        Uint32 lo = (Uint32(p[0]) | Uint32(p[1]) << 8 | Uint32(p[2]) << 16 | Uint32(p[3]) << 24) ^ crc;
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^
+              t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return crc;
+}
+
+Uint16 slice8_msb16(const Tables<Uint16>& t, Uint16 crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        Uint16 c = Uint16(crc ^ (p[0] << 8 | p[1]));
+        crc = Uint16(t[7][c >> 8] ^ t[6][c & 0xFF] ^ t[5][p[2]] ^ t[4][p[3]] ^ t[3][p[4]] ^ t[2][p[5]] ^
+                     t[1][p[6]] ^ t[0][p[7]]);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = Uint16((crc << 8) ^ t[0][(crc >> 8) ^ *p++]);
+    return crc;
+}
+
+Uint8 slice8_msb8(const Tables<Uint8>& t, Uint8 crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        crc = t[7][p[0] ^ crc] ^ t[6][p[1]] ^ t[5][p[2]] ^ t[4][p[3]] ^ t[3][p[4]] ^ t[2][p[5]] ^
+              t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = t[0][crc ^ *p++];
+    return crc;
+}
+
+using Kernel32 = Uint32 (*)(Uint32, const uint8_t*, size_t);
+
+Uint32 crc32_slice8(Uint32 crc, const uint8_t* p, size_t len) {
+    return slice8_reflected32(CRC32_TABLES, crc, p, len);
+}
+
+Uint32 crc32c_slice8(Uint32 crc, const uint8_t* p, size_t len) {
+    return slice8_reflected32(CRC32C_TABLES, crc, p, len);
+}
+
+#if defined(SOMEIP_CRC_X86)
+
+__attribute__((target("sse4.2")))
+Uint32 crc32c_sse42(Uint32 crc, const uint8_t* p, size_t len) {
+    Uint64 c = crc;
+    while (len >= 8) {
+        Uint64 v;
+        std::memcpy(&v, p, 8);
+        c = _mm_crc32_u64(c, v);
+        p += 8;
+        len -= 8;
+    }
+    crc = Uint32(c);
+    while (len--) crc = _mm_crc32_u8(crc, *p++);
+    return crc;
+}
+
+// Fold 64-byte blocks with carry-less multiplication, then Barrett-reduce to 32 bits
+// (Gopal et al., "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ").
+// Requires len >= 64 and a multiple of 16.
+__attribute__((target("pclmul,sse4.1")))
+Uint32 crc32_pclmul_blocks(Uint32 crc, const uint8_t* buf, size_t len) {
+    alignas(16) static const Uint64 k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const Uint64 k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const Uint64 k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const Uint64 poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0, x1, x2, x3, x4, x5, x6, x7, x8, y5, y6, y7, y8;
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(int(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    // Four parallel 128-bit lanes
+    while (len >= 64) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        y5 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+        y6 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+        y7 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+        y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), y5);
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), y6);
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), y7);
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), y8);
+        buf += 64;
+        len -= 64;
+    }
+
+    // Fold the lanes into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    for (__m128i next : {x2, x3, x4}) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, next), x5);
+    }
+
+    // Remaining 16-byte blocks
+    while (len >= 16) {
+        x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x2), x5);
+        buf += 16;
+        len -= 16;
+    }
+
+    // 128 -> 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+    return Uint32(_mm_extract_epi32(x1, 1));
+}
+
+Uint32 crc32_pclmul(Uint32 crc, const uint8_t* p, size_t len) {
+    if (len >= 64) {
+        size_t blocks = len & ~size_t(15);
+        crc = crc32_pclmul_blocks(crc, p, blocks);
+        p += blocks;
+        len -= blocks;
+    }
+    return crc32_slice8(crc, p, len);
+}
+
+#elif defined(SOMEIP_CRC_ARM)
+
+Uint32 crc32_armv8(Uint32 crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        Uint64 v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32d(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32b(crc, *p++);
+    return crc;
+}
+
+Uint32 crc32c_armv8(Uint32 crc, const uint8_t* p, size_t len) {
+    while (len >= 8) {
+        Uint64 v;
+        std::memcpy(&v, p, 8);
+        crc = __crc32cd(crc, v);
+        p += 8;
+        len -= 8;
+    }
+    while (len--) crc = __crc32cb(crc, *p++);
+    return crc;
+}
+
+#endif
+
+struct Dispatch {
+    std::atomic<Kernel32> crc32{crc32_slice8};
+    std::atomic<Kernel32> crc32c{crc32c_slice8};
+    const char* crc32_name = "slice8";
+    const char* crc32c_name = "slice8";
+
+    Dispatch() { select(true); }
+
+    void select(bool hardware) {
+        Kernel32 k32 = crc32_slice8, k32c = crc32c_slice8;
+        crc32_name = crc32c_name = "slice8";
+#if defined(SOMEIP_CRC_X86)
+        __builtin_cpu_init();
+        if (hardware && __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1")) {
+            k32 = crc32_pclmul;
+            crc32_name = "pclmul";
+        }
+        if (hardware && __builtin_cpu_supports("sse4.2")) {
+            k32c = crc32c_sse42;
+            crc32c_name = "sse4.2";
+        }
+#elif defined(SOMEIP_CRC_ARM)
+        if (hardware) {
+            k32 = crc32_armv8;
+            k32c = crc32c_armv8;
+            crc32_name = crc32c_name = "armv8";
+        }
+#endif
+        crc32.store(k32, std::memory_order_relaxed);
+        crc32c.store(k32c, std::memory_order_relaxed);
+    }
+};
+
+Dispatch& dispatch() {
+    static Dispatch d;
+    return d;
+}
+
+} // namespace
+
+Uint8 crc8(const uint8_t* data, size_t len, Uint8 crc) {
+    return slice8_msb8(CRC8_TABLES, Uint8(crc ^ 0xFF), data, len) ^ 0xFF;
+}
+
+Uint8 crc8h2f(const uint8_t* data, size_t len, Uint8 crc) {
+    return slice8_msb8(CRC8H2F_TABLES, Uint8(crc ^ 0xFF), data, len) ^ 0xFF;
+}
+
+Uint16 crc16(const uint8_t* data, size_t len, Uint16 crc) {
+    return slice8_msb16(CRC16_TABLES, crc, data, len);
+}
+
+Uint32 crc32(const uint8_t* data, size_t len, Uint32 crc) {
+    return ~dispatch().crc32.load(std::memory_order_relaxed)(~crc, data, len);
+}
+
+Uint32 crc32c(const uint8_t* data, size_t len, Uint32 crc) {
+    return ~dispatch().crc32c.load(std::memory_order_relaxed)(~crc, data, len);
+}
+
+Uint32 crc32p4(const uint8_t* data, size_t len, Uint32 crc) {
+    return ~slice8_reflected32(CRC32P4_TABLES, ~crc, data, len);
+}
+
+const char* crc32_implementation() {
+    return dispatch().crc32_name;
+}
+
+const char* crc32c_implementation() {
+    return dispatch().crc32c_name;
+}
+
+void set_hardware_enabled(bool enabled) {
+    dispatch().select(enabled);
+}
+
+} // namespace crc
+} // namespace someip
@@ -0,0 +1,419 @@
+#include "someip/crypto.hpp"
+#include "someip/serialization.hpp"
+#include <climits>
+#include <cstring>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <openssl/rand.h>
+
+namespace someip {
+
+struct Crypto::Impl {
+    EVP_CIPHER_CTX* enc = nullptr;
+    EVP_CIPHER_CTX* dec = nullptr;
+    bool keyed = false;
+    uint8_t iv_base[AES_IV_SIZE] = {};  // random 96-bit start, drawn by every set_key()
+    Uint64 counter = 0;
+
+    ~Impl() {
+        EVP_CIPHER_CTX_free(enc);
+        EVP_CIPHER_CTX_free(dec);
+    }
+
+    // iv_base + counter as one 96-bit big-endian number. Contexts sharing a key (or one context
+    // keyed twice with it) start at independent random points, so their IV ranges overlap
+    // only with probability about messages / 2^96.
+    bool next_iv(uint8_t* iv) {
+        if (counter >= MAX_MESSAGES_PER_KEY) return false;
+        Uint64 c = counter++;
+        unsigned carry = 0;
+        for (int i = AES_IV_SIZE - 1; i >= 0; --i) {
+            unsigned sum = iv_base[i] + static_cast<unsigned>(c & 0xFF) + carry;
+            iv[i] = static_cast<uint8_t>(sum);
+            carry = sum >> 8;
+            c >>= 8;
+        }
+        return true;
+    }
+
+    // Encrypt `len` bytes from `in` to `out` (may alias) under a fresh IV written to `iv`
+    bool seal(uint8_t* iv, const uint8_t* in, size_t len, uint8_t* out, uint8_t* tag,
+              const uint8_t* aad, size_t aad_len) {
+        if (!keyed || !next_iv(iv)) return false;
+        return seal_iv(iv, in, len, out, tag, aad, aad_len);
+    }
+
+    bool seal_iv(const uint8_t* iv, const uint8_t* in, size_t len, uint8_t* out, uint8_t* tag,
+                 const uint8_t* aad, size_t aad_len) {
+        if (!keyed || len > INT_MAX || aad_len > INT_MAX) return false;
+        int outl = 0, finl = 0;
+        if (EVP_EncryptInit_ex(enc, nullptr, nullptr, nullptr, iv) != 1) return false;
+        if (aad_len && EVP_EncryptUpdate(enc, nullptr, &outl, aad, (int)aad_len) != 1) return false;
+        if (len && EVP_EncryptUpdate(enc, out, &outl, in, (int)len) != 1) return false;
+        if (EVP_EncryptFinal_ex(enc, out + outl, &finl) != 1) return false;
+        return EVP_CIPHER_CTX_ctrl(enc, EVP_CTRL_GCM_GET_TAG, (int)AES_TAG_SIZE, tag) == 1;
+    }
+
+    bool open(const uint8_t* iv, const uint8_t* in, size_t len, uint8_t* out, const uint8_t* tag,
+              const uint8_t* aad, size_t aad_len) {
+        if (!keyed || len > INT_MAX || aad_len > INT_MAX) return false;
+        int outl = 0, finl = 0;
+        if (EVP_DecryptInit_ex(dec, nullptr, nullptr, nullptr, iv) != 1) return false;
+        if (aad_len && EVP_DecryptUpdate(dec, nullptr, &outl, aad, (int)aad_len) != 1) return false;
+        if (len && EVP_DecryptUpdate(dec, out, &outl, in, (int)len) != 1) return false;
+        if (EVP_CIPHER_CTX_ctrl(dec, EVP_CTRL_GCM_SET_TAG, (int)AES_TAG_SIZE,
+                                const_cast<uint8_t*>(tag)) != 1) return false;
+        return EVP_DecryptFinal_ex(dec, out + outl, &finl) == 1;
+    }
+};
+
+Crypto::Crypto() : impl_(new Impl()) {}
+Crypto::~Crypto() = default;
+Crypto::Crypto(Crypto&&) noexcept = default;
+Crypto& Crypto::operator=(Crypto&&) noexcept = default;
+
+bool Crypto::set_key(const Payload& key) {
+    if (key.size() != AES_KEY_SIZE) return false;
+    if (!impl_->enc) impl_->enc = EVP_CIPHER_CTX_new();
+    if (!impl_->dec) impl_->dec = EVP_CIPHER_CTX_new();
+    if (!impl_->enc || !impl_->dec) return false;
+    // Expand the key schedule once; per message only the IV is reset
+    if (EVP_EncryptInit_ex(impl_->enc, EVP_aes_256_gcm(), nullptr, key.data(), nullptr) != 1 ||
+        EVP_DecryptInit_ex(impl_->dec, EVP_aes_256_gcm(), nullptr, key.data(), nullptr) != 1) {
+        impl_->keyed = false;
+        return false;
+    }
+    // A fresh random start rather than a reset counter: the key may have been used before
+    if (RAND_bytes(impl_->iv_base, sizeof(impl_->iv_base)) != 1) {
+        impl_->keyed = false;
+        return false;
+    }
+    impl_->counter = 0;
+    impl_->keyed = true;
+    return true;
+}
+
+Payload Crypto::generate_key() {
+    return random_bytes(AES_KEY_SIZE);
+}
+
+Payload Crypto::generate_iv() {
+    return random_bytes(AES_IV_SIZE);
+}
+
+std::optional<Payload> Crypto::encrypt(const Payload& plaintext, const Payload& additional_data) {
+    Payload out;
+    out.reserve(plaintext.size() + OVERHEAD);
+    if (!encrypt_append(plaintext.data(), plaintext.size(), additional_data.data(), additional_data.size(), out)) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+std::optional<Payload> Crypto::decrypt(const Payload& ciphertext, const Payload& additional_data) {
+    if (ciphertext.size() < OVERHEAD) return std::nullopt;
+    Payload buf(ciphertext);
+    if (!decrypt_in_place(buf.data(), buf.size(), additional_data.data(), additional_data.size())) {
+        return std::nullopt;
+    }
+    return Payload(buf.begin() + HEADROOM, buf.end() - TAILROOM);
+}
+
+bool Crypto::encrypt_append(const uint8_t* plaintext, size_t len,
+                            const uint8_t* aad, size_t aad_len, Payload& out) {
+    size_t base = out.size();
+    out.resize(base + len + OVERHEAD);
+    uint8_t* p = out.data() + base;
+    if (!impl_->seal(p, plaintext, len, p + HEADROOM, p + HEADROOM + len, aad, aad_len)) {
+        out.resize(base);
+        return false;
+    }
+    return true;
+}
+
+bool Crypto::encrypt_append_iv(const uint8_t* iv, const uint8_t* plaintext, size_t len,
+                               const uint8_t* aad, size_t aad_len, Payload& out) {
+    size_t base = out.size();
+    out.resize(base + len + OVERHEAD);
+    uint8_t* p = out.data() + base;
+    std::memcpy(p, iv, HEADROOM);
+    if (!impl_->seal_iv(p, plaintext, len, p + HEADROOM, p + HEADROOM + len, aad, aad_len)) {
+        out.resize(base);
+        return false;
+    }
+    return true;
+}
+
+bool Crypto::encrypt_in_place(uint8_t* buf, size_t len, const uint8_t* aad, size_t aad_len) {
+    uint8_t* pt = buf + HEADROOM;
+    return impl_->seal(buf, pt, len, pt, pt + len, aad, aad_len);
+}
+
+bool Crypto::decrypt_in_place(uint8_t* buf, size_t len, const uint8_t* aad, size_t aad_len) {
+    if (len < OVERHEAD) return false;
+    size_t ct_len = len - OVERHEAD;
+    uint8_t* ct = buf + HEADROOM;
+    return impl_->open(buf, ct, ct_len, ct, ct + ct_len, aad, aad_len);
+}
+
+size_t Crypto::encrypt_batch(BufferRef* msgs, size_t count, const uint8_t* aad, size_t aad_len) {
+    size_t ok = 0;
+    for (size_t i = 0; i < count; ++i) {
+        msgs[i].ok = encrypt_in_place(msgs[i].data, msgs[i].len, aad, aad_len);
+        ok += msgs[i].ok;
+    }
+    return ok;
+}
+
+size_t Crypto::decrypt_batch(BufferRef* msgs, size_t count, const uint8_t* aad, size_t aad_len) {
+    size_t ok = 0;
+    for (size_t i = 0; i < count; ++i) {
+        msgs[i].ok = decrypt_in_place(msgs[i].data, msgs[i].len, aad, aad_len);
+        ok += msgs[i].ok;
+    }
+    return ok;
+}
+
+Payload Crypto::hmac_sha256(const Payload& key, const Payload& data) {
+    Payload out(32);
+    unsigned int len = 0;
+    if (!HMAC(EVP_sha256(), key.data(), (int)key.size(), data.data(), data.size(), out.data(), &len)) {
+        return {};
+    }
+    out.resize(len);
+    return out;
+}
+
+Payload Crypto::sha256(const Payload& data) {
+    Payload out(32);
+    unsigned int len = 0;
+    if (EVP_Digest(data.data(), data.size(), out.data(), &len, EVP_sha256(), nullptr) != 1) return {};
+    out.resize(len);
+    return out;
+}
+
+Payload Crypto::random_bytes(size_t length) {
+    Payload out(length);
+    if (length && RAND_bytes(out.data(), (int)length) != 1) return {};
+    return out;
+}
+
+Payload Crypto::derive_key(const std::string& password, const Payload& salt, int iterations) {
+    Payload out(AES_KEY_SIZE);
+    if (PKCS5_PBKDF2_HMAC(password.data(), (int)password.size(), salt.data(), (int)salt.size(),
+                          iterations, EVP_sha256(), (int)out.size(), out.data()) != 1) {
+        return {};
+    }
+    return out;
+}
+
+bool Crypto::is_available() {
+    return OpenSSL_version_num() != 0;
+}
+
+// Wire format: sequence(4) | aad_len(2) | aad | IV + Ciphertext + Tag
+Payload SecureSomeIpMessage::serialize() const {
+    SerializationBuffer sb;
+    sb.buf.reserve(6 + additional_auth_data.size() + encrypted_payload.size());
+    sb.write_uint32(sequence_number);
+    sb.write_uint16(static_cast<Uint16>(additional_auth_data.size()));
+    sb.write_bytes(additional_auth_data);
+    sb.write_bytes(encrypted_payload);
+    return std::move(sb.buf);
+}
+
+SecureSomeIpMessage SecureSomeIpMessage::deserialize(const Payload& data) {
+    DeserializationBuffer db(data);
+    SecureSomeIpMessage m;
+    m.sequence_number = db.read_uint32();
+    Uint16 aad_len = db.read_uint16();
+    m.additional_auth_data = db.read_bytes(aad_len);
+    m.encrypted_payload = db.read_bytes(db.remaining());
+    if (m.encrypted_payload.size() < Crypto::OVERHEAD) throw std::runtime_error("secure message: too short");
+    return m;
+}
+
+bool ReplayWindow::is_stale(Uint64 seq) const {
+    if (seq == 0) return true;
+    if (seq + WINDOW <= highest_.load(std::memory_order_acquire)) return true;
+    Uint64 block = seq >> 5;
+    Uint64 cur = slots_[block % SLOTS].load(std::memory_order_acquire);
+    Uint64 tag = cur >> 32;
+    if (tag > block) return true;
+    return tag == block && (cur & (Uint64(1) << (seq & 31)));
+}
+
+bool ReplayWindow::check_and_update(Uint64 seq) {
+    if (seq == 0 || (seq >> 5) > 0xFFFFFFFFULL) return false;
+    if (seq + WINDOW <= highest_.load(std::memory_order_acquire)) return false;
+    Uint64 block = seq >> 5;
+    Uint64 bit = Uint64(1) << (seq & 31);
+    std::atomic<Uint64>& slot = slots_[block % SLOTS];
+    Uint64 cur = slot.load(std::memory_order_acquire);
+    for (;;) {
+        Uint64 tag = cur >> 32;
+        Uint64 desired;
+        if (tag == block) {
+            if (cur & bit) return false;  // duplicate
+            desired = cur | bit;
+        } else if (tag < block) {
+            desired = (block << 32) | bit;  // slot recycled for a newer block
+        } else {
+            return false;  // slot already holds a newer block: seq left the window
+        }
+        if (slot.compare_exchange_weak(cur, desired, std::memory_order_acq_rel, std::memory_order_acquire)) break;
+    }
+    Uint64 hi = highest_.load(std::memory_order_relaxed);
+    while (seq > hi && !highest_.compare_exchange_weak(hi, seq, std::memory_order_acq_rel, std::memory_order_relaxed)) {}
+    return true;
+}
+
+void ReplayWindow::reset() {
+    for (auto& s : slots_) s.store(0, std::memory_order_relaxed);
+    highest_.store(0, std::memory_order_release);
+}
+
+struct SecureCommunication::KeyState {
+    Payload key;
+    Uint64 epoch;
+    uint8_t salt[8];  // IV prefix; peers sharing the PSK collide only with probability 2^-64
+
+    ~KeyState() { OPENSSL_cleanse(key.data(), key.size()); }
+};
+
+namespace {
+
+std::atomic<Uint64> next_secure_id{1};
+
+// GCM associated data: the clear SOME/IP header followed by the sequence number
+void secure_aad(const uint8_t* header, Uint32 seq, uint8_t* aad) {
+    std::memcpy(aad, header, SomeIpHeader::SIZE);
+    aad[16] = static_cast<uint8_t>(seq >> 24);
+    aad[17] = static_cast<uint8_t>(seq >> 16);
+    aad[18] = static_cast<uint8_t>(seq >> 8);
+    aad[19] = static_cast<uint8_t>(seq);
+}
+constexpr size_t SECURE_AAD_SIZE = SomeIpHeader::SIZE + 4;
+
+// Per-thread cipher contexts, one per SecureCommunication instance in use on this thread.
+// A context is re-keyed only when the owner's key epoch changes.
+struct LocalCipher {
+    Uint64 owner;
+    Uint64 epoch;
+    Crypto crypto;
+};
+
+Crypto* local_cipher(Uint64 owner, const Payload& key, Uint64 epoch) {
+    thread_local std::vector<LocalCipher> cache;
+    for (auto& c : cache) {
+        if (c.owner != owner) continue;
+        if (c.epoch != epoch) {
+            if (!c.crypto.set_key(key)) return nullptr;
+            c.epoch = epoch;
+        }
+        return &c.crypto;
+    }
+    if (cache.size() >= 16) cache.erase(cache.begin());
+    cache.push_back(LocalCipher{owner, epoch, Crypto()});
+    if (!cache.back().crypto.set_key(key)) {
+        cache.pop_back();
+        return nullptr;
+    }
+    return &cache.back().crypto;
+}
+
+} // namespace
+
+SecureCommunication::SecureCommunication() : id_(next_secure_id.fetch_add(1)) {}
+SecureCommunication::~SecureCommunication() = default;
+
+bool SecureCommunication::set_psk(const Payload& key) {
+    if (key.size() != Crypto::AES_KEY_SIZE) return false;
+    std::lock_guard<std::mutex> lk(key_mutex_);
+    auto state = std::make_shared<KeyState>();
+    state->key = key;
+    state->epoch = ++epoch_;
+    Payload salt = Crypto::random_bytes(sizeof(state->salt));
+    if (salt.size() != sizeof(state->salt)) return false;
+    std::memcpy(state->salt, salt.data(), sizeof(state->salt));
+    sequence_number_ = 0;
+    replay_.reset();
+    // The previous key is freed (and wiped) once the last in-flight message lets go of it
+    std::atomic_store_explicit(&key_, std::shared_ptr<const KeyState>(std::move(state)), std::memory_order_release);
+    return true;
+}
+
+std::optional<Payload> SecureCommunication::encrypt_message(const SomeIpMessage& msg) {
+    std::shared_ptr<const KeyState> ks = std::atomic_load_explicit(&key_, std::memory_order_acquire);
+    if (!ks) return std::nullopt;
+    Crypto* crypto = local_cipher(id_, ks->key, ks->epoch);
+    if (!crypto) return std::nullopt;
+
+    // The atomically allocated sequence number makes the IV unique across threads. It never
+    // wraps: once all 2^32 - 1 numbers are used, nothing is sent until set_psk() installs a new key.
+    Uint32 prev = sequence_number_.load(std::memory_order_relaxed);
+    do {
+        if (prev == UINT32_MAX) return std::nullopt;
+    } while (!sequence_number_.compare_exchange_weak(prev, prev + 1, std::memory_order_relaxed));
+    Uint32 seq = prev + 1;
+    uint8_t iv[Crypto::AES_IV_SIZE] = {};
+    std::memcpy(iv, ks->salt, sizeof(ks->salt));
+    iv[8] = static_cast<uint8_t>(seq >> 24);
+    iv[9] = static_cast<uint8_t>(seq >> 16);
+    iv[10] = static_cast<uint8_t>(seq >> 8);
+    iv[11] = static_cast<uint8_t>(seq);
+
+    // sequence(4) | aad_len(2) | header(16) | IV + Ciphertext + Tag, built in one buffer
+    Payload out;
+    out.reserve(6 + SomeIpHeader::SIZE + msg.payload.size() + Crypto::OVERHEAD);
+    SerializationBuffer sb;
+    sb.buf.swap(out);
+    sb.write_uint32(seq);
+    sb.write_uint16(static_cast<Uint16>(SomeIpHeader::SIZE));
+    sb.write_bytes(msg.header.serialize());
+    out.swap(sb.buf);
+    uint8_t aad[SECURE_AAD_SIZE];
+    secure_aad(out.data() + 6, seq, aad);
+    if (!crypto->encrypt_append_iv(iv, msg.payload.data(), msg.payload.size(), aad, sizeof(aad), out)) {
+        return std::nullopt;
+    }
+    return out;
+}
+
+std::optional<SomeIpMessage> SecureCommunication::decrypt_message(const Payload& encrypted_data) {
+    std::shared_ptr<const KeyState> ks = std::atomic_load_explicit(&key_, std::memory_order_acquire);
+    if (!ks) return std::nullopt;
+    try {
+        SecureSomeIpMessage sec = SecureSomeIpMessage::deserialize(encrypted_data);
+        if (sec.additional_auth_data.size() != SomeIpHeader::SIZE) return std::nullopt;
+        // Cheap pre-check; the authoritative check happens only after the tag verified, so
+        // forged packets cannot consume sequence numbers
+        if (replay_.is_stale(sec.sequence_number)) {
+            replays_rejected_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        Crypto* crypto = local_cipher(id_, ks->key, ks->epoch);
+        if (!crypto) return std::nullopt;
+        uint8_t aad[SECURE_AAD_SIZE];
+        secure_aad(sec.additional_auth_data.data(), sec.sequence_number, aad);
+        if (!crypto->decrypt_in_place(sec.encrypted_payload.data(), sec.encrypted_payload.size(),
+                                      aad, sizeof(aad))) {
+            return std::nullopt;
+        }
+        if (!replay_.check_and_update(sec.sequence_number)) {
+            replays_rejected_.fetch_add(1, std::memory_order_relaxed);
+            return std::nullopt;
+        }
+        SomeIpMessage msg;
+        msg.header = SomeIpHeader::deserialize(sec.additional_auth_data);
+        msg.payload.assign(sec.encrypted_payload.begin() + Crypto::HEADROOM,
+                           sec.encrypted_payload.end() - Crypto::TAILROOM);
+        msg.header.length = static_cast<Uint32>(msg.payload.size() + SomeIpHeader::MIN_LENGTH);
+        return msg;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+} // namespace someip
@@ -0,0 +1,178 @@
+#include "someip/dispatcher.hpp"
+
+namespace someip {
+
+Dispatcher::Dispatcher(MessageRouter& router, DispatcherOptions options)
+    : router_(router), options_(std::move(options)) {
+    if (options_.classes == 0) options_.classes = 1;
+    if (options_.queue_capacity == 0) options_.queue_capacity = 1;
+    if (options_.workers == 0) options_.workers = 1;
+    if (options_.default_class >= options_.classes) options_.default_class = options_.classes - 1;
+    lanes_.resize(options_.classes);
+    for (unsigned i = 0; i < options_.classes; ++i) {
+        Lane& lane = lanes_[i];
+        lane.ring.resize(options_.queue_capacity);
+        if (i < options_.weights.size() && options_.weights[i] > 0) lane.weight = options_.weights[i];
+        lane.credits = lane.weight;
+    }
+}
+
+Dispatcher::~Dispatcher() {
+    stop();
+}
+
+Uint64 Dispatcher::now_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool Dispatcher::start() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (running_) return true;
+    running_ = true;
+    for (unsigned i = 0; i < options_.workers; ++i) workers_.emplace_back(&Dispatcher::worker_loop, this);
+    return true;
+}
+
+void Dispatcher::stop() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (!running_) return;
+        running_ = false;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+    std::lock_guard<std::mutex> lk(mutex_);
+    for (auto& lane : lanes_) lane.head = lane.count = 0;
+    queued_ = 0;
+}
+
+void Dispatcher::set_class(ServiceId service, MethodId method, unsigned cls, std::chrono::microseconds deadline) {
+    if (cls >= options_.classes) cls = options_.classes - 1;
+    Uint64 ns = deadline.count() > 0 ? Uint64(deadline.count()) * 1000 : 0;
+    routes_[(Uint32(service) << 16) | method] = Route{cls, ns};
+}
+
+bool Dispatcher::submit(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+    return submit(msg, src, dst, proto, 0);
+}
+
+bool Dispatcher::submit(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto,
+                        Uint64 deadline_ns) {
+    Uint64 now = now_ns();
+    unsigned cls = options_.default_class;
+    auto it = routes_.find((Uint32(msg.header.service_id) << 16) | msg.header.method_id);
+    if (it != routes_.end()) {
+        cls = it->second.cls;
+        if (deadline_ns == 0 && it->second.deadline_ns) deadline_ns = now + it->second.deadline_ns;
+    }
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        Lane& lane = lanes_[cls];
+        if (running_ && lane.count < lane.ring.size()) {
+            // Assigning into the slot reuses the payload capacity left by earlier requests
+            Item& slot = lane.ring[(lane.head + lane.count) % lane.ring.size()];
+            slot.msg.header = msg.header;
+            slot.msg.payload.assign(msg.payload.begin(), msg.payload.end());
+            slot.msg.rx = msg.rx;  // receive timestamps, for latency metrics and handlers
+            slot.src = src;
+            slot.dst = dst;
+            slot.proto = proto;
+            slot.enqueued_ns = now;
+            slot.deadline_ns = deadline_ns;
+            ++lane.count;
+            ++queued_;
+            ++lane.stats.enqueued;
+        } else {
+            ++lane.stats.rejected;
+            cls = options_.classes;  // marks the drop
+        }
+    }
+    if (cls == options_.classes) {
+        metrics::MethodRecorder(msg.header.service_id, msg.header.method_id).dropped();
+        SOMEIP_LOG_ERROR("Dispatcher queue full, dropping 0x%04x.0x%04x", msg.header.service_id,
+                         msg.header.method_id);
+        return false;
+    }
+    cv_.notify_one();
+    return true;
+}
+
+int Dispatcher::pick_lane() {
+    if (queued_ == 0) return -1;
+    unsigned n = static_cast<unsigned>(lanes_.size());
+    if (options_.policy == DispatchPolicy::STRICT_PRIORITY) {
+        for (unsigned i = 0; i < n; ++i) {
+            if (lanes_[i].count) return static_cast<int>(i);
+        }
+        return -1;
+    }
+    for (int pass = 0; pass < 2; ++pass) {
+        for (unsigned k = 0; k < n; ++k) {
+            unsigned i = (next_lane_ + k) % n;
+            Lane& lane = lanes_[i];
+            if (!lane.count || !lane.credits) continue;
+            next_lane_ = --lane.credits ? i : (i + 1) % n;
+            return static_cast<int>(i);
+        }
+        // Every backlogged class used its turns: start a new round
+        for (auto& lane : lanes_) lane.credits = lane.weight;
+    }
+    return -1;
+}
+
+void Dispatcher::worker_loop() {
+    apply_thread_options(options_.thread);
+    Item item;  // swapped with queue slots so both keep their payload capacity
+    for (;;) {
+        Uint64 delay;
+        bool expired;
+        {
+            std::unique_lock<std::mutex> lk(mutex_);
+            cv_.wait(lk, [this] { return !running_ || queued_ > 0; });
+            if (!running_) return;
+            Lane& lane = lanes_[pick_lane()];
+            std::swap(item, lane.ring[lane.head]);
+            lane.head = (lane.head + 1) % lane.ring.size();
+            --lane.count;
+            --queued_;
+            Uint64 now = now_ns();
+            delay = now - item.enqueued_ns;
+            expired = item.deadline_ns && now > item.deadline_ns;
+            lane.stats.queue_delay.record(delay);
+            ++(expired ? lane.stats.expired : lane.stats.dispatched);
+        }
+        const SomeIpHeader& h = item.msg.header;
+        metrics::MethodRecorder rec(h.service_id, h.method_id);
+        rec.queue_delay(delay);
+        if (!expired) {
+            router_.route(item.msg, item.src, item.dst, item.proto);
+            continue;
+        }
+        rec.received();
+        // Protected requests are dropped: their checks have not run, and an authenticated
+        // E_TIMEOUT must not answer a forged or replayed request
+        if (h.message_type == static_cast<uint8_t>(MessageType::REQUEST) && !router_.is_protected(h.service_id, h.method_id)) {
+            rec.errored();
+            router_.send_error(item.msg, ReturnCode::E_TIMEOUT, item.src);
+        } else {
+            rec.dropped();
+        }
+    }
+}
+
+unsigned Dispatcher::class_of(ServiceId service, MethodId method) const {
+    auto it = routes_.find((Uint32(service) << 16) | method);
+    return it == routes_.end() ? options_.default_class : it->second.cls;
+}
+
+Dispatcher::ClassStats Dispatcher::stats(unsigned cls) const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (cls >= lanes_.size()) return {};
+    ClassStats s = lanes_[cls].stats;
+    s.depth = lanes_[cls].count;
+    return s;
+}
+
+} // namespace someip
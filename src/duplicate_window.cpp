@@ -0,0 +1,97 @@
+#include "someip/duplicate_window.hpp"
+#include <ctime>
+
+namespace someip {
+
+DuplicateWindow::DuplicateWindow(DuplicateWindowOptions options)
+    : options_(options),
+      max_age_ns_(static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(options.max_age).count())),
+      clients_per_shard_(options.clients / SHARDS + (options.clients % SHARDS ? 1 : 0)) {}
+
+// Entry age only needs to be right to a few milliseconds, so the coarse clock will do
+Uint64 DuplicateWindow::now_ns() {
+#ifdef CLOCK_MONOTONIC_COARSE
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return Uint64(ts.tv_sec) * 1000000000ULL + Uint64(ts.tv_nsec);
+#else
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+DuplicateWindow::Verdict DuplicateWindow::begin(const Key& key, Payload& out) {
+    const Uint64 now = now_ns();
+    Shard& sh = shard(key);
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    auto it = sh.clients.find(client_key(key));
+    if (it == sh.clients.end()) {
+        if (sh.clients.size() >= clients_per_shard_ && !sh.clients.empty()) {
+            auto idle = sh.clients.begin();
+            for (auto c = sh.clients.begin(); c != sh.clients.end(); ++c) {
+                if (c->second.last_active < idle->second.last_active) idle = c;
+            }
+            sh.clients.erase(idle);
+        }
+        it = sh.clients.emplace(client_key(key), Client()).first;
+        it->second.slots.resize(options_.requests_per_client ? options_.requests_per_client : 1);
+    }
+    Client& client = it->second;
+    client.last_active = ++sh.tick;
+
+    Slot* slot = nullptr;
+    for (Slot& s : client.slots) {
+        if (matches(s, key)) {
+            if (s.payload_crc == key.payload_crc && now - s.begun_ns < max_age_ns_) {
+                if (!s.done) return Verdict::IN_PROGRESS;
+                out.assign(s.response.begin(), s.response.end());
+                return Verdict::DUPLICATE;
+            }
+            slot = &s;  // session reused for another request, or the entry is too old to trust
+            break;
+        }
+    }
+    if (!slot) {
+        slot = &client.slots[client.next];
+        client.next = (client.next + 1) % client.slots.size();
+    }
+    slot->used = true;
+    slot->done = false;
+    slot->session = key.session;
+    slot->service = key.service;
+    slot->method = key.method;
+    slot->payload_crc = key.payload_crc;
+    slot->begun_ns = now;
+    slot->response.clear();
+    return Verdict::NEW;
+}
+
+DuplicateWindow::Slot* DuplicateWindow::find(Shard& sh, const Key& key) {
+    auto it = sh.clients.find(client_key(key));
+    if (it == sh.clients.end()) return nullptr;
+    for (Slot& s : it->second.slots) {
+        if (matches(s, key) && s.payload_crc == key.payload_crc && !s.done) return &s;
+    }
+    return nullptr;
+}
+
+void DuplicateWindow::complete(const Key& key, const Payload& response) {
+    Shard& sh = shard(key);
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    Slot* s = find(sh, key);
+    if (!s) return;
+    if (response.size() > options_.max_response) {
+        s->used = false;
+        return;
+    }
+    s->response.assign(response.begin(), response.end());
+    s->done = true;
+}
+
+void DuplicateWindow::abandon(const Key& key) {
+    Shard& sh = shard(key);
+    std::lock_guard<std::mutex> lk(sh.mutex);
+    if (Slot* s = find(sh, key)) s->used = false;
+}
+
+} // namespace someip
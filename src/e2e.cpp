@@ -0,0 +1,171 @@
+#include "someip/e2e.hpp"
+#include "someip/crc.hpp"
+
+namespace someip {
+
+namespace {
+
+void put16(uint8_t* p, Uint16 v) {
+    p[0] = uint8_t(v >> 8);
+    p[1] = uint8_t(v);
+}
+
+void put32(uint8_t* p, Uint32 v) {
+    p[0] = uint8_t(v >> 24);
+    p[1] = uint8_t(v >> 16);
+    p[2] = uint8_t(v >> 8);
+    p[3] = uint8_t(v);
+}
+
+Uint16 get16(const uint8_t* p) {
+    return Uint16(p[0] << 8 | p[1]);
+}
+
+Uint32 get32(const uint8_t* p) {
+    return Uint32(p[0]) << 24 | Uint32(p[1]) << 16 | Uint32(p[2]) << 8 | p[3];
+}
+
+const Endpoint no_endpoint;
+
+} // namespace
+
+std::shared_ptr<E2EStage> E2EStage::create(const E2EConfig& config) {
+    bool short_id = config.profile == E2EProfile::P01 || config.profile == E2EProfile::P05;
+    if (short_id && config.data_id > 0xFFFF) return nullptr;
+    if (config.max_delta_counter == 0 || config.max_peers == 0) return nullptr;
+    return std::shared_ptr<E2EStage>(new E2EStage(config));
+}
+
+size_t E2EStage::header_size() const {
+    switch (config_.profile) {
+    case E2EProfile::P01: return 2;
+    case E2EProfile::P05: return 3;
+    case E2EProfile::P04:
+    case E2EProfile::P04_CRC32C: return 12;
+    }
+    return 0;
+}
+
+Uint32 E2EStage::counter_range() const {
+    switch (config_.profile) {
+    case E2EProfile::P01: return 15;
+    case E2EProfile::P05: return 256;
+    default: return 65536;
+    }
+}
+
+// CRC of a protected buffer, skipping the CRC field itself
+Uint32 E2EStage::compute_crc(const uint8_t* data, size_t len) const {
+    uint8_t id[2] = {uint8_t(config_.data_id), uint8_t(config_.data_id >> 8)};
+    switch (config_.profile) {
+    case E2EProfile::P01:
+        return crc::crc8(data + 1, len - 1, crc::crc8(id, 2));
+    case E2EProfile::P05:
+        return crc::crc16(id, 2, crc::crc16(data + 2, len - 2));
+    case E2EProfile::P04:
+        return crc::crc32p4(data + 12, len - 12, crc::crc32p4(data, 8));
+    case E2EProfile::P04_CRC32C:
+        return crc::crc32c(data + 12, len - 12, crc::crc32c(data, 8));
+    }
+    return 0;
+}
+
+bool E2EStage::protect(const SomeIpHeader&, Payload& payload) {
+    return protect(payload, PeerKey(no_endpoint, 0));
+}
+
+bool E2EStage::check(const SomeIpHeader&, Payload& payload) {
+    return check(payload, PeerKey(no_endpoint, 0));
+}
+
+bool E2EStage::protect(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+    return protect(payload, PeerKey(peer, header.client_id));
+}
+
+bool E2EStage::check(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+    return check(payload, PeerKey(peer, header.client_id));
+}
+
+bool E2EStage::protect(Payload& payload, const PeerKey& peer) {
+    size_t hs = header_size();
+    if (payload.size() + hs > 0xFFFF && config_.profile >= E2EProfile::P04) return false;
+    std::shared_ptr<Peer> state = peers_.add(peer);
+    Uint32 counter = state->tx_counter.fetch_add(1, std::memory_order_relaxed) % counter_range();
+    payload.insert(payload.begin(), hs, 0);
+    uint8_t* p = payload.data();
+    switch (config_.profile) {
+    case E2EProfile::P01:
+        p[1] = uint8_t(counter & 0x0F);
+        p[0] = uint8_t(compute_crc(p, payload.size()));
+        break;
+    case E2EProfile::P05: {
+        p[2] = uint8_t(counter);
+        Uint16 c = Uint16(compute_crc(p, payload.size()));
+        p[0] = uint8_t(c);
+        p[1] = uint8_t(c >> 8);
+        break;
+    }
+    case E2EProfile::P04:
+    case E2EProfile::P04_CRC32C:
+        put16(p, Uint16(payload.size()));
+        put16(p + 2, Uint16(counter));
+        put32(p + 4, config_.data_id);
+        put32(p + 8, compute_crc(p, payload.size()));
+        break;
+    }
+    return true;
+}
+
+E2EStatus E2EStage::check_status(const uint8_t* data, size_t len) {
+    return check_status(data, len, PeerKey(no_endpoint, 0));
+}
+
+E2EStatus E2EStage::check_status(const uint8_t* p, size_t len, const PeerKey& peer) {
+    E2EStatus status = E2EStatus::ERROR;
+    Uint32 counter = 0;
+    if (len >= header_size()) {
+        bool valid = false;
+        switch (config_.profile) {
+        case E2EProfile::P01:
+            counter = p[1] & 0x0F;
+            valid = (p[1] & 0xF0) == 0 && counter < 15 && p[0] == uint8_t(compute_crc(p, len));
+            break;
+        case E2EProfile::P05:
+            counter = p[2];
+            valid = Uint16(p[0] | p[1] << 8) == Uint16(compute_crc(p, len));
+            break;
+        case E2EProfile::P04:
+        case E2EProfile::P04_CRC32C:
+            counter = get16(p + 2);
+            valid = get16(p) == len && get32(p + 4) == config_.data_id && get32(p + 8) == compute_crc(p, len);
+            break;
+        }
+        if (valid) {
+            // Delta against the peer's last accepted counter; a wrong sequence resynchronizes
+            std::shared_ptr<Peer> state = peers_.add(peer);
+            Uint32 range = counter_range();
+            Uint32 last = state->rx_counter.load(std::memory_order_relaxed);
+            for (;;) {
+                Uint32 delta = last == NO_COUNTER ? 1 : (counter + range - last) % range;
+                if (delta == 0) {
+                    status = E2EStatus::REPEATED;
+                    break;
+                }
+                if (state->rx_counter.compare_exchange_weak(last, counter, std::memory_order_relaxed)) {
+                    status = delta <= config_.max_delta_counter ? E2EStatus::OK : E2EStatus::WRONG_SEQUENCE;
+                    break;
+                }
+            }
+        }
+    }
+    counts_[static_cast<int>(status)].fetch_add(1, std::memory_order_relaxed);
+    return status;
+}
+
+bool E2EStage::check(Payload& payload, const PeerKey& peer) {
+    if (check_status(payload.data(), payload.size(), peer) != E2EStatus::OK) return false;
+    payload.erase(payload.begin(), payload.begin() + header_size());
+    return true;
+}
+
+} // namespace someip
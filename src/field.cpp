@@ -0,0 +1,125 @@
+#include "someip/field.hpp"
+#include "someip/someip_message.hpp"
+#include <algorithm>
+
+namespace someip {
+
+FieldBase::FieldBase(ServiceId service, const FieldOptions& options)
+    : service_(service), options_(options), last_notify_(std::chrono::steady_clock::now()) {}
+
+void FieldBase::attach(ServiceRegistry& registry, std::shared_ptr<Transport> endpoint) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        endpoint_ = std::move(endpoint);
+    }
+    auto answer = [this](SerializationBuffer& out) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        out.write_bytes(value_);
+    };
+    if (options_.getter) {
+        registry.register_method(service_, options_.getter,
+                                 [this, answer](const Payload&, const Endpoint&, SerializationBuffer& out) {
+            getter_hits_.fetch_add(1, std::memory_order_relaxed);
+            answer(out);
+            return ReturnCode::E_OK;
+        });
+    }
+    if (options_.setter) {
+        registry.register_method(service_, options_.setter,
+                                 [this, answer](const Payload& in, const Endpoint&, SerializationBuffer& out) {
+            ReturnCode rc = apply_set(in);
+            answer(out);
+            return rc;
+        });
+    }
+}
+
+void FieldBase::subscribe(const Endpoint& subscriber) {
+    Payload current;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (std::find(subscribers_.begin(), subscribers_.end(), subscriber) == subscribers_.end()) {
+            subscribers_.push_back(subscriber);
+        }
+        current = value_;
+    }
+    notify(current, &subscriber);
+}
+
+void FieldBase::unsubscribe(const Endpoint& subscriber) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    subscribers_.erase(std::remove(subscribers_.begin(), subscribers_.end(), subscriber), subscribers_.end());
+}
+
+void FieldBase::poll() {
+    if (!options_.notifier || options_.cycle.count() <= 0) return;
+    Payload current;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        auto now = std::chrono::steady_clock::now();
+        if (now - last_notify_ < options_.cycle) return;
+        last_notify_ = now;
+        notified_ = value_;
+        current = value_;
+    }
+    notify(current, nullptr);
+}
+
+Payload FieldBase::serialized() const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return value_;
+}
+
+void FieldBase::initialize(const Payload& bytes) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    value_ = bytes;
+    notified_ = bytes;
+}
+
+void FieldBase::publish(const Payload& bytes, bool significant) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        value_ = bytes;
+        if (!options_.notifier) return;
+        if (!significant || bytes == notified_) {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        notified_ = bytes;
+        last_notify_ = std::chrono::steady_clock::now();
+    }
+    notify(bytes, nullptr);
+}
+
+void FieldBase::notify(const Payload& bytes, const Endpoint* only) {
+    if (!options_.notifier) return;
+    std::shared_ptr<Transport> endpoint;
+    std::vector<Endpoint> targets;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        endpoint = endpoint_;
+        if (only) targets.push_back(*only);
+        else targets = subscribers_;
+    }
+    if (!endpoint || targets.empty()) return;
+
+    SomeIpHeader h;
+    h.service_id = service_;
+    h.method_id = options_.notifier;
+    h.length = static_cast<Uint32>(bytes.size() + SomeIpHeader::MIN_LENGTH);
+    h.client_id = 0;
+    h.session_id = static_cast<Uint16>(session_.fetch_add(1, std::memory_order_relaxed) % 0xFFFF + 1);
+    h.protocol_version = 1;
+    h.interface_version = 1;
+    h.message_type = static_cast<uint8_t>(MessageType::NOTIFICATION);
+    h.return_code = static_cast<uint8_t>(ReturnCode::E_OK);
+    Payload out;
+    out.reserve(SomeIpHeader::SIZE + bytes.size());
+    h.serialize_to(out);
+    out.insert(out.end(), bytes.begin(), bytes.end());
+    for (const auto& target : targets) {
+        if (endpoint->send_to(out, target)) notifications_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+} // namespace someip
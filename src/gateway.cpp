@@ -0,0 +1,189 @@
+#include "someip/gateway.hpp"
+#include "someip/someip_header.hpp"
+#include <ctime>
+
+namespace someip {
+
+namespace {
+
+Uint16 load16(const uint8_t* p) { return static_cast<Uint16>((p[0] << 8) | p[1]); }
+
+Uint32 load32(const uint8_t* p) {
+    return (Uint32(p[0]) << 24) | (Uint32(p[1]) << 16) | (Uint32(p[2]) << 8) | Uint32(p[3]);
+}
+
+void store16(uint8_t* p, Uint16 v) {
+    p[0] = static_cast<uint8_t>(v >> 8);
+    p[1] = static_cast<uint8_t>(v);
+}
+
+// Header offsets of the fields the gateway reads or rewrites
+constexpr size_t LENGTH_AT = 4;
+constexpr size_t CLIENT_AT = 8;
+constexpr size_t SESSION_AT = 10;
+constexpr size_t TYPE_AT = 14;
+
+Endpoint to_endpoint(Uint32 addr, uint16_t port) {
+    in_addr a;
+    a.s_addr = htonl(addr);
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &a, ip, sizeof(ip));
+    return Endpoint(std::string(ip), port);
+}
+
+// Timestamp for session expiry, taken once per forwarded request. Millisecond resolution is
+// plenty for timeouts of seconds; on Linux the coarse clock costs a fraction of a precise read.
+Uint64 now_ns() {
+#ifdef CLOCK_MONOTONIC_COARSE
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return Uint64(ts.tv_sec) * 1000000000ULL + Uint64(ts.tv_nsec);
+#else
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+} // namespace
+
+Gateway::Gateway(ClientId client_id, std::chrono::milliseconds timeout)
+    : client_id_(client_id),
+      timeout_ns_(static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout).count())),
+      pending_(Uint32(1) << 16) {}
+
+void Gateway::attach(std::shared_ptr<Transport> transport, InstanceId instance) {
+    if (!transport) return;
+    for (const auto& t : attached_) {
+        if (t == transport) return;
+    }
+    Transport* raw = transport.get();
+    transport->set_datagram_hook([this, raw, instance](uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port) {
+        return handle(raw, instance, data, len, src_addr, src_port);
+    });
+    attached_.push_back(std::move(transport));
+}
+
+void Gateway::add_rule(GatewayRule rule) {
+    if (!rule.to) return;
+    attach(rule.to);
+    in_addr a{};
+    inet_pton(AF_INET, std::get<0>(rule.dest).c_str(), &a);
+    rules_.push_back(Route{std::move(rule), ntohl(a.s_addr)});
+}
+
+size_t Gateway::expire_pending() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return expire_locked(now_ns());
+}
+
+size_t Gateway::expire_locked(Uint64 now) {
+    last_sweep_ns_ = now;
+    size_t n = 0;
+    for (Pending& p : pending_) {
+        if (p.used && now - p.sent_ns >= timeout_ns_) {
+            p.used = false;
+            ++n;
+        }
+    }
+    expired_.fetch_add(n, std::memory_order_relaxed);
+    return n;
+}
+
+Gateway::Stats Gateway::stats() const {
+    Stats s;
+    s.requests = requests_.load(std::memory_order_relaxed);
+    s.messages = messages_.load(std::memory_order_relaxed);
+    s.responses = responses_.load(std::memory_order_relaxed);
+    s.orphaned = orphaned_.load(std::memory_order_relaxed);
+    s.expired = expired_.load(std::memory_order_relaxed);
+    s.send_failures = send_failures_.load(std::memory_order_relaxed);
+    return s;
+}
+
+bool Gateway::handle(Transport* ingress, InstanceId instance, uint8_t* data, size_t len, Uint32 src_addr,
+                     uint16_t src_port) {
+    // Anything that is not exactly one well-formed message is left to the parser
+    if (len < SomeIpHeader::SIZE) return false;
+    const Uint32 length = load32(data + LENGTH_AT);
+    if (length < SomeIpHeader::MIN_LENGTH || size_t(length) + 8 != len) return false;
+
+    const ServiceId service = load16(data);
+    const MethodId method = load16(data + 2);
+    const uint8_t type = data[TYPE_AT];
+    if (type == static_cast<uint8_t>(MessageType::RESPONSE) || type == static_cast<uint8_t>(MessageType::ERR)) {
+        if (load16(data + CLIENT_AT) != client_id_) return false;
+        return forward_response(ingress, data, len, src_addr, src_port, service, method);
+    }
+
+    for (const Route& route : rules_) {
+        const GatewayRule& rule = route.rule;
+        if (rule.service != service || rule.to.get() == ingress) continue;
+        if (rule.method != GatewayRule::ANY_METHOD && rule.method != method) continue;
+        if (rule.instance != GatewayRule::ANY_INSTANCE && rule.instance != instance) continue;
+        if (rule.from && rule.from.get() != ingress) continue;
+
+        if (type != static_cast<uint8_t>(MessageType::REQUEST)) {
+            if (rule.to->send_bytes(data, len, rule.dest)) messages_.fetch_add(1, std::memory_order_relaxed);
+            else send_failures_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        SessionId session;
+        {
+            const Uint64 now = now_ns();
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (now - last_sweep_ns_ >= timeout_ns_) expire_locked(now);
+            session = ++next_session_;
+            if (session == 0) session = ++next_session_;  // 0 means "no session"
+            Pending& p = pending_[session];
+            if (p.used) expired_.fetch_add(1, std::memory_order_relaxed);  // 65535 later, still unanswered
+            p.used = true;
+            p.service = service;
+            p.method = method;
+            p.client = load16(data + CLIENT_AT);
+            p.session = load16(data + SESSION_AT);
+            p.addr = src_addr;
+            p.port = src_port;
+            p.back = ingress;
+            p.out = rule.to.get();
+            p.dest_addr = route.dest_addr;
+            p.dest_port = std::get<1>(rule.dest);
+            p.sent_ns = now;
+        }
+        store16(data + CLIENT_AT, client_id_);
+        store16(data + SESSION_AT, session);
+        if (rule.to->send_bytes(data, len, rule.dest)) {
+            requests_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            std::lock_guard<std::mutex> lk(mutex_);
+            pending_[session].used = false;
+            send_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+    return false;
+}
+
+bool Gateway::forward_response(Transport* ingress, uint8_t* data, size_t len, Uint32 src_addr, uint16_t src_port,
+                               ServiceId service, MethodId method) {
+    Pending p;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        Pending& slot = pending_[load16(data + SESSION_AT)];
+        // Only the server the request went to can answer it; sessions are easy to guess
+        if (!slot.used || slot.service != service || slot.method != method || slot.out != ingress ||
+            slot.dest_addr != src_addr || slot.dest_port != src_port) {
+            orphaned_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        p = slot;
+        slot.used = false;
+    }
+    store16(data + CLIENT_AT, p.client);
+    store16(data + SESSION_AT, p.session);
+    if (p.back->send_bytes(data, len, to_endpoint(p.addr, p.port))) responses_.fetch_add(1, std::memory_order_relaxed);
+    else send_failures_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace someip
@@ -0,0 +1,67 @@
+#include "someip/idl_support.hpp"
+
+namespace someip {
+
+ProxyBase::ProxyBase(ServiceId service, Uint8 interface_version, std::shared_ptr<Transport> transport,
+                     Endpoint server, ClientId client)
+    : service_(service), interface_version_(interface_version), transport_(std::move(transport)),
+      server_(std::move(server)), client_(client) {}
+
+void ProxyBase::add_protection(MethodId method, std::shared_ptr<ProtectionStage> stage) {
+    if (stage) protection_[method].push_back(std::move(stage));
+}
+
+bool ProxyBase::send_request(MethodId method, Payload& datagram, MessageType type) {
+    if (!transport_) return false;
+    SomeIpHeader h;
+    h.service_id = service_;
+    h.method_id = method;
+    h.client_id = client_;
+    h.session_id = static_cast<Uint16>(session_.fetch_add(1, std::memory_order_relaxed) % 0xFFFF + 1);
+    h.protocol_version = 1;
+    h.interface_version = interface_version_;
+    h.message_type = static_cast<uint8_t>(type);
+    h.return_code = 0;
+    auto it = protection_.find(method);
+    if (it != protection_.end()) {
+        // Stages work on a bare payload, so protected methods pay for one copy
+        Payload body(datagram.begin() + SomeIpHeader::SIZE, datagram.end());
+        for (const auto& stage : it->second) {
+            if (!stage->protect(h, body, server_)) return false;
+        }
+        datagram.resize(SomeIpHeader::SIZE);
+        datagram.insert(datagram.end(), body.begin(), body.end());
+    }
+    h.length = static_cast<Uint32>(datagram.size() - SomeIpHeader::SIZE + SomeIpHeader::MIN_LENGTH);
+    h.serialize_to(datagram.data());
+    return transport_->send_to(datagram, server_);
+}
+
+const Payload* ProxyBase::checked_payload(const SomeIpMessage& msg, Payload& scratch) const {
+    auto it = protection_.find(msg.header.method_id);
+    if (it == protection_.end()) return &msg.payload;
+    // Errors are protected like responses
+    scratch = msg.payload;
+    for (auto stage = it->second.rbegin(); stage != it->second.rend(); ++stage) {
+        if (!(*stage)->check(msg.header, scratch, server_)) return nullptr;
+    }
+    return &scratch;
+}
+
+bool SkeletonBase::send_event(MethodId event, Payload& datagram, const Endpoint& to) {
+    if (!transport_) return false;
+    SomeIpHeader h;
+    h.service_id = service_;
+    h.method_id = event;
+    h.length = static_cast<Uint32>(datagram.size() - SomeIpHeader::SIZE + SomeIpHeader::MIN_LENGTH);
+    h.client_id = 0;
+    h.session_id = static_cast<Uint16>(session_.fetch_add(1, std::memory_order_relaxed) % 0xFFFF + 1);
+    h.protocol_version = 1;
+    h.interface_version = interface_version_;
+    h.message_type = static_cast<uint8_t>(MessageType::NOTIFICATION);
+    h.return_code = static_cast<uint8_t>(ReturnCode::E_OK);
+    h.serialize_to(datagram.data());
+    return transport_->send_to(datagram, to);
+}
+
+} // namespace someip
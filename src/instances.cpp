@@ -0,0 +1,79 @@
+#include "someip/instances.hpp"
+
+namespace someip {
+
+ServiceInstance::ServiceInstance(ServiceId service, InstanceId instance, std::shared_ptr<Transport> endpoint)
+    : service_(service), instance_(instance), endpoint_(std::move(endpoint)),
+      router_(std::make_unique<MessageRouter>(endpoint_, registry_)) {
+    MessageRouter* router = router_.get();
+    endpoint_->set_callback([router](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+        router->route(msg, src, dst, proto);
+    });
+}
+
+ServiceInstance::~ServiceInstance() {
+    // The endpoint may outlive us; no datagram may reach the router once it is gone
+    endpoint_->stop();
+    endpoint_->set_callback(nullptr);
+}
+
+SdOffer ServiceInstance::offer(uint32_t ttl) const {
+    return SdOffer{service_, instance_, endpoint_->local_ip(), endpoint_->local_port(), ttl};
+}
+
+InstanceHost::~InstanceHost() {
+    stop();
+}
+
+ServiceInstance* InstanceHost::add(ServiceId service, InstanceId instance, std::shared_ptr<Transport> endpoint) {
+    if (!endpoint) return nullptr;
+    auto key = std::make_pair(service, instance);
+    if (instances_.count(key)) return nullptr;
+    auto& slot = instances_[key];
+    slot = std::make_unique<ServiceInstance>(service, instance, std::move(endpoint));
+    return slot.get();
+}
+
+ServiceInstance* InstanceHost::add_udp(ServiceId service, InstanceId instance, const std::string& bind_ip,
+                                       uint16_t bind_port, const EndpointOptions& options) {
+    if (find(service, instance)) return nullptr;
+    return add(service, instance, std::make_shared<UdpEndpoint>(bind_ip, bind_port, options));
+}
+
+ServiceInstance* InstanceHost::find(ServiceId service, InstanceId instance) const {
+    auto it = instances_.find(std::make_pair(service, instance));
+    return it == instances_.end() ? nullptr : it->second.get();
+}
+
+std::vector<ServiceInstance*> InstanceHost::instances(ServiceId service) const {
+    std::vector<ServiceInstance*> out;
+    for (auto it = instances_.lower_bound(std::make_pair(service, InstanceId(0)));
+         it != instances_.end() && it->first.first == service; ++it) {
+        out.push_back(it->second.get());
+    }
+    return out;
+}
+
+bool InstanceHost::start() {
+    for (const auto& kv : instances_) {
+        if (!kv.second->endpoint()->start()) {
+            stop();
+            return false;
+        }
+    }
+    return true;
+}
+
+void InstanceHost::stop() {
+    for (const auto& kv : instances_) kv.second->endpoint()->stop();
+}
+
+void InstanceHost::offer(ServiceDiscovery& sd, uint32_t ttl) const {
+    for (const auto& kv : instances_) sd.offer_service(kv.second->offer(ttl));
+}
+
+void InstanceHost::stop_offer(ServiceDiscovery& sd) const {
+    for (const auto& kv : instances_) sd.stop_offer(kv.first.first, kv.first.second);
+}
+
+} // namespace someip
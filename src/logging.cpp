@@ -0,0 +1,262 @@
+#include "someip/logging.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace someip {
+namespace logging {
+
+void Record::put(ArgKind kind, const void* p, size_t n) {
+    if (nargs >= MAX_ARGS || used + n > sizeof(data)) return;
+    kinds[nargs++] = kind;
+    std::memcpy(data + used, p, n);
+    used = static_cast<uint16_t>(used + n);
+}
+
+void Record::add(const char* s, size_t n) {
+    if (nargs >= MAX_ARGS || used + sizeof(uint16_t) > sizeof(data)) return;
+    size_t room = sizeof(data) - used - sizeof(uint16_t);
+    if (n > room) n = room;
+    uint16_t len = static_cast<uint16_t>(n);
+    kinds[nargs++] = STRING;
+    std::memcpy(data + used, &len, sizeof(len));
+    std::memcpy(data + used + sizeof(len), s, n);
+    used = static_cast<uint16_t>(used + sizeof(len) + n);
+}
+
+namespace {
+
+constexpr size_t RING_CAPACITY = 1024;  // records per thread
+
+// Single-producer (owning thread) / single-consumer (logger thread) ring
+struct Ring {
+    std::array<Record, RING_CAPACITY> slots;
+    alignas(64) std::atomic<uint64_t> head{0};  // next slot to write
+    alignas(64) std::atomic<uint64_t> tail{0};  // next slot to format
+    std::atomic<bool> orphaned{false};          // owning thread has exited
+};
+
+void default_sink(Level level, const char* line) {
+    FILE* out = level == Level::ERR ? stderr : stdout;
+    fputs(line, out);
+    fputc('\n', out);
+}
+
+const char* level_prefix(Level level) {
+    switch (level) {
+    case Level::DBG: return "[DEBUG] ";
+    case Level::INFO: return "[INFO] ";
+    case Level::ERR: return "[ERROR] ";
+    }
+    return "";
+}
+
+// Render one argument according to the printf conversion that consumes it
+void format_arg(std::string& out, const std::string& spec, char conv, const Record& rec,
+                uint8_t kind, size_t& off) {
+    char tmp[128];
+    switch (kind) {
+    case Record::SIGNED:
+    case Record::UNSIGNED: {
+        uint64_t bits;
+        std::memcpy(&bits, rec.data + off, sizeof(bits));
+        off += sizeof(bits);
+        if (conv == 'p') {
+            snprintf(tmp, sizeof(tmp), (spec + "p").c_str(), reinterpret_cast<void*>(static_cast<uintptr_t>(bits)));
+        } else if (conv == 'c') {
+            snprintf(tmp, sizeof(tmp), (spec + "c").c_str(), static_cast<int>(bits));
+        } else if (conv == 'd' || conv == 'i' || (kind == Record::SIGNED && !std::strchr("ouxX", conv))) {
+            snprintf(tmp, sizeof(tmp), (spec + "lld").c_str(), static_cast<long long>(bits));
+        } else {
+            char c = std::strchr("ouxX", conv) ? conv : 'u';
+            snprintf(tmp, sizeof(tmp), (spec + "ll" + c).c_str(), static_cast<unsigned long long>(bits));
+        }
+        out += tmp;
+        break;
+    }
+    case Record::DOUBLE: {
+        double v;
+        std::memcpy(&v, rec.data + off, sizeof(v));
+        off += sizeof(v);
+        char c = std::strchr("eEfFgGaA", conv) ? conv : 'g';
+        snprintf(tmp, sizeof(tmp), (spec + c).c_str(), v);
+        out += tmp;
+        break;
+    }
+    case Record::STRING: {
+        uint16_t len;
+        std::memcpy(&len, rec.data + off, sizeof(len));
+        out.append(reinterpret_cast<const char*>(rec.data + off + sizeof(len)), len);
+        off += sizeof(len) + len;
+        break;
+    }
+    }
+}
+
+void format_record(const Record& rec, std::string& out) {
+    out.assign(level_prefix(static_cast<Level>(rec.level)));
+    size_t arg = 0, off = 0;
+    for (const char* f = rec.format; *f;) {
+        if (*f != '%') { out += *f++; continue; }
+        if (f[1] == '%') { out += '%'; f += 2; continue; }
+        const char* start = f++;
+        while (*f && std::strchr("-+ #0", *f)) ++f;
+        while (*f && (std::isdigit(static_cast<unsigned char>(*f)) || *f == '.')) ++f;
+        std::string spec(start, f);
+        while (*f && std::strchr("hlLqjzt", *f)) ++f;
+        char conv = *f ? *f++ : 's';
+        if (arg >= rec.nargs) { out += "<?>"; continue; }
+        format_arg(out, spec, conv, rec, rec.kinds[arg++], off);
+    }
+    if (rec.suppressed) {
+        char tmp[64];
+        snprintf(tmp, sizeof(tmp), " (%u similar messages suppressed)", rec.suppressed);
+        out += tmp;
+    }
+}
+
+class Logger {
+public:
+    Logger() : sink_(default_sink) {
+        thread_ = std::thread(&Logger::run, this);
+        std::atexit([] { instance().shutdown(); });
+    }
+
+    static Logger& instance();
+
+    void add(const std::shared_ptr<Ring>& ring) {
+        std::lock_guard<std::mutex> lk(rings_mutex_);
+        rings_.push_back(ring);
+    }
+
+    void set_sink(Sink sink) {
+        std::lock_guard<std::mutex> lk(drain_mutex_);
+        sink_ = sink ? std::move(sink) : Sink(default_sink);
+    }
+
+    void flush() {
+        while (drain() > 0) {}
+    }
+
+    void shutdown() {
+        stopping_ = true;
+        if (thread_.joinable()) thread_.join();
+        flush();
+        fflush(stdout);
+        fflush(stderr);
+    }
+
+    void count_dropped() { dropped_.fetch_add(1, std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    void run() {
+        while (!stopping_) {
+            if (drain() == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    // Format everything currently queued; returns the number of records handled
+    size_t drain() {
+        std::lock_guard<std::mutex> lk(drain_mutex_);
+        std::vector<std::shared_ptr<Ring>> rings;
+        {
+            std::lock_guard<std::mutex> rl(rings_mutex_);
+            rings = rings_;
+        }
+        size_t handled = 0;
+        for (const auto& ring : rings) {
+            bool orphaned = ring->orphaned.load(std::memory_order_acquire);
+            uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+            uint64_t head = ring->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                const Record& rec = ring->slots[tail % RING_CAPACITY];
+                format_record(rec, line_);
+                sink_(static_cast<Level>(rec.level), line_.c_str());
+                ++handled;
+            }
+            ring->tail.store(tail, std::memory_order_release);
+            if (orphaned) {
+                std::lock_guard<std::mutex> rl(rings_mutex_);
+                rings_.erase(std::remove(rings_.begin(), rings_.end(), ring), rings_.end());
+            }
+        }
+        return handled;
+    }
+
+    Sink sink_;
+    std::string line_;
+    std::mutex drain_mutex_;
+    std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<bool> stopping_{false};
+    std::thread thread_;
+};
+
+// Intentionally leaked so threads that outlive main() can still log safely
+Logger& Logger::instance() {
+    static Logger* logger = new Logger();
+    return *logger;
+}
+
+struct ThreadRing {
+    std::shared_ptr<Ring> ring = std::make_shared<Ring>();
+    ThreadRing() { Logger::instance().add(ring); }
+    ~ThreadRing() { ring->orphaned.store(true, std::memory_order_release); }
+};
+
+Ring& local_ring() {
+    thread_local ThreadRing local;
+    return *local.ring;
+}
+
+} // namespace
+
+namespace detail {
+
+Record* begin_record(Level level, const char* format) {
+    Ring& ring = local_ring();
+    uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        Logger::instance().count_dropped();
+        return nullptr;
+    }
+    Record* rec = &ring.slots[head % RING_CAPACITY];
+    rec->timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+    rec->format = format;
+    rec->suppressed = 0;
+    rec->used = 0;
+    rec->level = static_cast<uint8_t>(level);
+    rec->nargs = 0;
+    return rec;
+}
+
+void commit_record(Record*) {
+    Ring& ring = local_ring();
+    ring.head.store(ring.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+} // namespace detail
+
+void set_sink(Sink sink) {
+    Logger::instance().set_sink(std::move(sink));
+}
+
+void flush() {
+    Logger::instance().flush();
+}
+
+uint64_t dropped_records() {
+    return Logger::instance().dropped();
+}
+
+} // namespace logging
+} // namespace someip
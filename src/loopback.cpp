@@ -0,0 +1,390 @@
+#include "someip/loopback.hpp"
+#include "someip/someip_message.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace someip {
+
+namespace {
+
+bool parse_addr(const std::string& ip, Uint32& addr) {
+    in_addr a{};
+    if (inet_pton(AF_INET, ip.c_str(), &a) != 1) return false;
+    addr = ntohl(a.s_addr);
+    return true;
+}
+
+std::string to_ip(Uint32 addr) {
+    in_addr a{};
+    a.s_addr = htonl(addr);
+    char ip[INET_ADDRSTRLEN];
+    inet_ntop(AF_INET, &a, ip, INET_ADDRSTRLEN);
+    return ip;
+}
+
+bool is_multicast(Uint32 addr) {
+    return (addr >> 28) == 0xE;
+}
+
+Uint64 steady_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Endpoints whose callbacks run on this thread, innermost last
+thread_local std::vector<const LoopbackEndpoint*> delivering;
+
+// Heap order: earliest due first, then first sent
+struct Later {
+    template <typename E>
+    bool operator()(const E& a, const E& b) const {
+        return a.due_ns != b.due_ns ? a.due_ns > b.due_ns : a.seq > b.seq;
+    }
+};
+
+} // namespace
+
+std::shared_ptr<LoopbackNetwork> LoopbackNetwork::create(LoopbackOptions options) {
+    std::shared_ptr<LoopbackNetwork> net(new LoopbackNetwork(std::move(options)));
+    // Started once owned, so the thread can tell when the last reference is gone
+    if (!net->options_.virtual_clock) {
+        net->thread_ = std::thread(&LoopbackNetwork::deliver_loop, net.get(), std::weak_ptr<LoopbackNetwork>(net));
+    }
+    return net;
+}
+
+LoopbackNetwork::LoopbackNetwork(LoopbackOptions options)
+    : options_(std::move(options)), rng_(options_.seed ? options_.seed : 1) {}
+
+LoopbackNetwork::~LoopbackNetwork() {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        // Dropping the last reference on the network thread itself: deliver_loop notices and
+        // returns without touching the network again
+        if (thread_.get_id() == std::this_thread::get_id()) thread_.detach();
+        else thread_.join();
+    }
+}
+
+std::shared_ptr<LoopbackEndpoint> LoopbackNetwork::create_endpoint(const std::string& ip, uint16_t port) {
+    return std::shared_ptr<LoopbackEndpoint>(new LoopbackEndpoint(shared_from_this(), ip, port));
+}
+
+Uint64 LoopbackNetwork::now_ns() const {
+    if (!options_.virtual_clock) return steady_ns();
+    std::lock_guard<std::mutex> lk(mutex_);
+    return virtual_now_;
+}
+
+void LoopbackNetwork::at(Uint64 at_ns, std::function<void()> fn) {
+    Event e;
+    e.due_ns = at_ns;
+    e.fn = std::move(fn);
+    std::lock_guard<std::mutex> lk(mutex_);
+    push(std::move(e));
+}
+
+void LoopbackNetwork::every(std::chrono::nanoseconds period, std::function<void()> fn) {
+    Event e;
+    e.period_ns = std::max<Uint64>(1, Uint64(period.count()));
+    e.fn = std::move(fn);
+    std::lock_guard<std::mutex> lk(mutex_);
+    e.due_ns = (options_.virtual_clock ? virtual_now_ : steady_ns()) + e.period_ns;
+    push(std::move(e));
+}
+
+size_t LoopbackNetwork::run_until(Uint64 until_ns) {
+    if (!options_.virtual_clock) return 0;
+    size_t processed = 0;
+    Event e;
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            if (!pop_due(until_ns, e)) {
+                if (until_ns != std::numeric_limits<Uint64>::max()) virtual_now_ = std::max(virtual_now_, until_ns);
+                return processed;
+            }
+            virtual_now_ = std::max(virtual_now_, e.due_ns);
+        }
+        dispatch(e);
+        ++processed;
+    }
+}
+
+size_t LoopbackNetwork::run() {
+    return run_until(std::numeric_limits<Uint64>::max());
+}
+
+LoopbackNetwork::Stats LoopbackNetwork::stats() const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return stats_;
+}
+
+bool LoopbackNetwork::bind(LoopbackEndpoint* endpoint) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto& slot = bound_[key(endpoint->addr_, endpoint->port_)];
+    if (!slot.expired()) return false;
+    slot = endpoint->weak_from_this();
+    return true;
+}
+
+void LoopbackNetwork::unbind(LoopbackEndpoint* endpoint) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = bound_.find(key(endpoint->addr_, endpoint->port_));
+    if (it != bound_.end()) {
+        auto current = it->second.lock();
+        if (!current || current.get() == endpoint) bound_.erase(it);
+    }
+    for (auto& group : groups_) {
+        auto& members = group.second;
+        members.erase(std::remove_if(members.begin(), members.end(), [endpoint](const std::weak_ptr<LoopbackEndpoint>& m) {
+            auto sp = m.lock();
+            return !sp || sp.get() == endpoint;
+        }), members.end());
+    }
+}
+
+void LoopbackNetwork::join(LoopbackEndpoint* endpoint, Uint32 group) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    groups_[group].push_back(endpoint->weak_from_this());
+}
+
+void LoopbackNetwork::leave(LoopbackEndpoint* endpoint, Uint32 group) {
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = groups_.find(group);
+    if (it == groups_.end()) return;
+    auto& members = it->second;
+    members.erase(std::remove_if(members.begin(), members.end(), [endpoint](const std::weak_ptr<LoopbackEndpoint>& m) {
+        auto sp = m.lock();
+        return !sp || sp.get() == endpoint;
+    }), members.end());
+}
+
+void LoopbackNetwork::send(Uint32 src_addr, uint16_t src_port, Payload data, const Endpoint& dest) {
+    Event e;
+    if (!parse_addr(std::get<0>(dest), e.dst_addr)) return;
+    e.dst_port = std::get<1>(dest);
+    e.src_addr = src_addr;
+    e.src_port = src_port;
+    e.data = std::move(data);
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        ++stats_.sent;
+        if (lose()) {
+            ++stats_.lost;
+            return;
+        }
+        e.due_ns = (options_.virtual_clock ? virtual_now_ : steady_ns()) + Uint64(options_.latency.count());
+        push(std::move(e));
+    }
+    if (!options_.virtual_clock) cv_.notify_one();
+}
+
+void LoopbackNetwork::push(Event&& event) {
+    event.seq = seq_++;
+    queue_.push_back(std::move(event));
+    std::push_heap(queue_.begin(), queue_.end(), Later());
+}
+
+bool LoopbackNetwork::pop_due(Uint64 until_ns, Event& event) {
+    if (queue_.empty() || queue_.front().due_ns > until_ns) return false;
+    std::pop_heap(queue_.begin(), queue_.end(), Later());
+    event = std::move(queue_.back());
+    queue_.pop_back();
+    return true;
+}
+
+void LoopbackNetwork::dispatch(Event& event) {
+    if (event.fn) {
+        event.fn();
+        if (event.period_ns) {
+            event.due_ns += event.period_ns;
+            std::lock_guard<std::mutex> lk(mutex_);
+            push(std::move(event));
+        }
+        return;
+    }
+
+    // Resolve receivers under the lock, deliver without it so callbacks can send
+    thread_local std::vector<std::shared_ptr<LoopbackEndpoint>> targets;
+    targets.clear();
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        if (is_multicast(event.dst_addr)) {
+            auto it = groups_.find(event.dst_addr);
+            if (it != groups_.end()) {
+                for (const auto& member : it->second) {
+                    auto sp = member.lock();
+                    if (sp && sp->port_ == event.dst_port) targets.push_back(std::move(sp));
+                }
+            }
+        } else {
+            auto it = bound_.find(key(event.dst_addr, event.dst_port));
+            if (it == bound_.end()) it = bound_.find(key(0, event.dst_port));  // bound to 0.0.0.0
+            if (it != bound_.end()) {
+                if (auto sp = it->second.lock()) targets.push_back(std::move(sp));
+            }
+        }
+        if (targets.empty()) ++stats_.unreachable;
+        stats_.delivered += targets.size();
+    }
+    Uint64 now = options_.virtual_clock ? event.due_ns : steady_ns();
+    const bool shared = targets.size() > 1;
+    for (auto& target : targets) target->receive(event.data, event.src_addr, event.src_port, now, shared);
+    targets.clear();
+}
+
+void LoopbackNetwork::deliver_loop(std::weak_ptr<LoopbackNetwork> weak) {
+    std::unique_lock<std::mutex> lk(mutex_);
+    Event e;
+    while (!stopping_) {
+        if (queue_.empty()) {
+            cv_.wait(lk);
+            continue;
+        }
+        Uint64 now = steady_ns();
+        if (queue_.front().due_ns > now) {
+            cv_.wait_for(lk, std::chrono::nanoseconds(queue_.front().due_ns - now));
+            continue;
+        }
+        pop_due(now, e);
+        lk.unlock();
+        {
+            // Pinned while callbacks run; if this pin turns out to be the last reference, the
+            // network is destroyed right here, on its own thread
+            std::shared_ptr<LoopbackNetwork> self = weak.lock();
+            if (!self) return;  // being destroyed elsewhere; the destructor joins this thread
+            dispatch(e);
+            e = Event();  // release payload and captured state outside the lock
+        }
+        if (weak.expired()) return;  // `this` may be gone: touch nothing
+        lk.lock();
+    }
+}
+
+bool LoopbackNetwork::lose() {
+    if (options_.loss <= 0) return false;
+    // xorshift64*: cheap, and the same seed gives the same losses
+    rng_ ^= rng_ >> 12;
+    rng_ ^= rng_ << 25;
+    rng_ ^= rng_ >> 27;
+    Uint64 r = rng_ * 0x2545F4914F6CDD1DULL;
+    return double(r >> 11) * (1.0 / 9007199254740992.0) < options_.loss;
+}
+
+LoopbackEndpoint::LoopbackEndpoint(std::shared_ptr<LoopbackNetwork> network, const std::string& ip, uint16_t port)
+    : network_(std::move(network)), ip_(ip), port_(port) {
+    parse_addr(ip_, addr_);
+}
+
+LoopbackEndpoint::~LoopbackEndpoint() {
+    stop();
+}
+
+bool LoopbackEndpoint::start() {
+    if (running_) return true;
+    Uint32 check;
+    if (!parse_addr(ip_, check) || !network_->bind(this)) {
+        log_error("loopback bind " + ip_ + ":" + std::to_string(port_) + " failed");
+        return false;
+    }
+    running_ = true;
+    return true;
+}
+
+void LoopbackEndpoint::stop() {
+    {
+        std::lock_guard<std::mutex> lk(delivery_mutex_);
+        if (!running_.exchange(false)) return;
+    }
+    network_->unbind(this);
+    // Deliveries already past the running_ check finish first; one this thread is inside
+    // (stop() from a callback) cannot
+    size_t own = size_t(std::count(delivering.begin(), delivering.end(), this));
+    std::unique_lock<std::mutex> lk(delivery_mutex_);
+    delivery_cv_.wait(lk, [&] { return deliveries_ <= own; });
+}
+
+bool LoopbackEndpoint::send_to(const Payload& data, const Endpoint& dest) {
+    if (!running_) return false;
+    network_->send(addr_, port_, data, dest);
+    return true;
+}
+
+bool LoopbackEndpoint::send_bytes(const uint8_t* data, size_t len, const Endpoint& dest) {
+    if (!running_) return false;
+    network_->send(addr_, port_, Payload(data, data + len), dest);
+    return true;
+}
+
+bool LoopbackEndpoint::join_multicast(const std::string& mcast_addr) {
+    Uint32 group;
+    if (!parse_addr(mcast_addr, group) || !is_multicast(group)) return false;
+    network_->join(this, group);
+    return true;
+}
+
+bool LoopbackEndpoint::leave_multicast(const std::string& mcast_addr) {
+    Uint32 group;
+    if (!parse_addr(mcast_addr, group)) return false;
+    network_->leave(this, group);
+    return true;
+}
+
+void LoopbackEndpoint::receive(Payload& data, Uint32 src_addr, uint16_t src_port, Uint64 now_ns, bool shared) {
+    {
+        std::lock_guard<std::mutex> lk(delivery_mutex_);
+        if (!running_) return;
+        ++deliveries_;
+    }
+    delivering.push_back(this);
+    deliver(data, src_addr, src_port, now_ns, shared);
+    delivering.pop_back();
+    std::lock_guard<std::mutex> lk(delivery_mutex_);
+    if (--deliveries_ == 0) delivery_cv_.notify_all();
+}
+
+void LoopbackEndpoint::deliver(Payload& data, Uint32 src_addr, uint16_t src_port, Uint64 now_ns, bool shared) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    if (filter_) {
+        FilterVerdict verdict = filter_(data.data(), data.size(), src_addr, src_port);
+        if (verdict != FilterVerdict::ACCEPT) {
+            if (verdict == FilterVerdict::REJECT) reject(data, src_addr, src_port);
+            return;
+        }
+    }
+    if (hook_) {
+        if (!shared) {
+            if (hook_(data.data(), data.size(), src_addr, src_port)) return;
+        } else {
+            Payload copy(data);
+            if (hook_(copy.data(), copy.size(), src_addr, src_port)) return;
+        }
+    }
+    try {
+        SomeIpMessage msg = SomeIpMessage::deserialize(data.data(), data.size());
+        // Only a real clock shares the time base of RxTimestamp::user_ns
+        if (!network_->options_.virtual_clock) msg.rx.user_ns = now_ns;
+        if (callback_) callback_(msg, Endpoint(to_ip(src_addr), src_port), Endpoint(ip_, port_), TransportProtocol::UDP);
+    } catch (const std::exception& e) {
+        parse_errors_.fetch_add(1, std::memory_order_relaxed);
+        SOMEIP_LOG_ERROR("Failed to parse SOME/IP message: %s", e.what());
+    }
+}
+
+void LoopbackEndpoint::reject(const Payload& data, Uint32 src_addr, uint16_t src_port) {
+    // Same rule as UdpEndpoint: only requests get an answer
+    if (data.size() < SomeIpHeader::SIZE || data[14] != static_cast<uint8_t>(MessageType::REQUEST)) return;
+    Payload err(data.begin(), data.begin() + SomeIpHeader::SIZE);
+    err[4] = err[5] = err[6] = 0;
+    err[7] = SomeIpHeader::MIN_LENGTH;
+    err[14] = static_cast<uint8_t>(MessageType::ERR);
+    err[15] = static_cast<uint8_t>(ReturnCode::E_NOT_OK);
+    network_->send(addr_, port_, std::move(err), Endpoint(to_ip(src_addr), src_port));
+}
+
+} // namespace someip
@@ -1,56 +1,348 @@
 #include "someip/message_router.hpp"
+#include "someip/crc.hpp"
 #include "someip/serialization.hpp"
+#include "someip/metrics.hpp"
 
 namespace someip {
 
-MessageRouter::MessageRouter(std::shared_ptr<UdpEndpoint> endpoint, ServiceRegistry& registry)
+namespace {
+
+SomeIpHeader reply_header(const SomeIpHeader& request, MessageType type, ReturnCode rc) {
+    SomeIpHeader h;
+    h.service_id = request.service_id;
+    h.method_id  = request.method_id;
+    h.length = SomeIpHeader::MIN_LENGTH;
+    h.client_id  = request.client_id;
+    h.session_id = request.session_id;
+    h.protocol_version = request.protocol_version;
+    h.interface_version = request.interface_version;
+    h.message_type = static_cast<uint8_t>(type);
+    h.return_code = static_cast<uint8_t>(rc);
+    return h;
+}
+
+// Per-thread response buffer for buffer handlers; keeps its capacity between messages
+constexpr size_t RESPONSE_RESERVE = 1500;
+
+thread_local const SomeIpMessage* current = nullptr;
+
+// Publishes the request to MessageRouter::current_request() while its handler runs
+struct CurrentRequest {
+    explicit CurrentRequest(const SomeIpMessage& msg) { current = &msg; }
+    ~CurrentRequest() { current = nullptr; }
+};
+
+// The duplicate window entry of the request being routed on this thread. The first response
+// sent for the request completes it; without one it is abandoned when routing returns.
+struct DuplicateClaim;
+thread_local DuplicateClaim* active_claim = nullptr;
+
+struct DuplicateClaim {
+    DuplicateWindow* window = nullptr;
+    const SomeIpMessage* request = nullptr;
+    DuplicateWindow::Key key{};
+
+    void start(DuplicateWindow* w, const SomeIpMessage& msg, const DuplicateWindow::Key& k) {
+        window = w;
+        request = &msg;
+        key = k;
+        active_claim = this;
+    }
+    ~DuplicateClaim() {
+        if (window) window->abandon(key);
+        if (active_claim == this) active_claim = nullptr;
+    }
+};
+
+// Sender address for the duplicate window, host byte order. Parsed by hand: inet_pton costs
+// as much as the rest of the lookup. Anything but a dotted quad is hashed instead.
+Uint32 source_address(const std::string& ip) {
+    Uint32 addr = 0, part = 0;
+    int dots = 0, digits = 0;
+    for (char c : ip) {
+        if (c >= '0' && c <= '9' && digits < 3) {
+            part = part * 10 + Uint32(c - '0');
+            ++digits;
+        } else if (c == '.' && digits && dots < 3 && part <= 255) {
+            addr = (addr << 8) | part;
+            part = 0;
+            digits = 0;
+            ++dots;
+        } else {
+            dots = -1;
+            break;
+        }
+    }
+    if (dots == 3 && digits && part <= 255) return (addr << 8) | part;
+    return crc::crc32c(reinterpret_cast<const uint8_t*>(ip.data()), ip.size());
+}
+
+SerializationBuffer& response_buffer() {
+    thread_local SerializationBuffer out;
+    out.buf.clear();
+    out.buf.reserve(SomeIpHeader::SIZE + RESPONSE_RESERVE);
+    out.buf.resize(SomeIpHeader::SIZE);
+    return out;
+}
+
+} // namespace
+
+MessageRouter::MessageRouter(std::shared_ptr<Transport> endpoint, ServiceRegistry& registry)
     : endpoint_(std::move(endpoint)), registry_(registry) {}
 
 void MessageRouter::route(const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+    // Measure from the socket read when the transport stamped it, so dispatcher queueing counts
+    Uint64 received_at = msg.rx.user_ns ? msg.rx.user_ns : metrics::now_ns();
+    metrics::MethodRecorder rec(msg.header.service_id, msg.header.method_id);
+    rec.received();
+
+    // Retransmissions are caught before protection checks, which would reject a replayed
+    // freshness value
+    DuplicateClaim claim;
+    if (duplicates_ && msg.header.message_type == static_cast<uint8_t>(MessageType::REQUEST) && msg.header.session_id != 0) {
+        DuplicateWindow::Key key{msg.header.client_id, msg.header.session_id, msg.header.service_id, msg.header.method_id,
+                                 crc::crc32c(msg.payload.data(), msg.payload.size()),
+                                 source_address(std::get<0>(src)), std::get<1>(src)};
+        SerializationBuffer& out = response_buffer();
+        switch (duplicates_->begin(key, out.buf)) {
+        case DuplicateWindow::Verdict::DUPLICATE:
+            rec.duplicate();
+            if (endpoint_) endpoint_->send_to(out.buf, src);
+            rec.receive_to_send(metrics::now_ns() - received_at);
+            return;
+        case DuplicateWindow::Verdict::IN_PROGRESS:
+            rec.duplicate();  // the original's response answers it
+            return;
+        case DuplicateWindow::Verdict::NEW:
+            claim.start(duplicates_.get(), msg, key);
+            break;
+        }
+    }
+
+    const Payload* payload = &msg.payload;
+    Payload checked;
+    if (const Stages* stages = protection_for(msg.header.service_id, msg.header.method_id)) {
+        checked = msg.payload;
+        for (auto it = stages->rbegin(); it != stages->rend(); ++it) {
+            if (!(*it)->check(msg.header, checked, src)) {
+                rec.dropped();
+                SOMEIP_LOG_ERROR("Protection check failed for 0x%04x.0x%04x", msg.header.service_id,
+                                 msg.header.method_id);
+                return;
+            }
+        }
+        payload = &checked;
+    }
+
     // Only handle REQUEST types for this minimal implementation
     if (msg.header.message_type == static_cast<uint8_t>(MessageType::REQUEST)) {
-        auto handler_opt = registry_.find_handler(msg.header.service_id, msg.header.method_id);
-        if (!handler_opt) {
+        ResponseCache* cache = cache_for(msg.header.service_id, msg.header.method_id);
+        Uint64 generation = ResponseCache::ANY_GENERATION;
+        if (cache) {
+            // Taken before the handler reads any state: an invalidation from here on means
+            // its response may be stale and must not be stored
+            generation = cache->generation();
+            if (send_cached(*cache, msg, *payload, src)) {
+                rec.cache_hit();
+                rec.receive_to_send(metrics::now_ns() - received_at);
+                return;
+            }
+            rec.cache_miss();
+        }
+        if (static_routes_.dispatch) {
+            SerializationBuffer& out = response_buffer();
+            ReturnCode rc = ReturnCode::E_OK;
+            CurrentRequest scope(msg);
+            Uint64 handler_start = metrics::now_ns();
+            if (static_routes_.dispatch(msg.header.service_id, msg.header.method_id, *payload, src, out, rc)) {
+                rec.dispatched();
+                rec.handler_time(metrics::now_ns() - handler_start);
+                if (rc != ReturnCode::E_OK) rec.errored();
+                send_and_cache(msg, rc, out.buf, src, cache, *payload, generation);
+                rec.receive_to_send(metrics::now_ns() - received_at);
+                return;
+            }
+        }
+        auto method = registry_.lookup(msg.header.service_id, msg.header.method_id);
+        if (!method) {
+            rec.errored();
             send_error(msg, ReturnCode::E_UNKNOWN, src);
+            rec.receive_to_send(metrics::now_ns() - received_at);
             return;
         }
-        MethodResult res = (*handler_opt)(msg.payload, src);
-        send_response(msg, res, src);
+        rec.dispatched();
+        CurrentRequest scope(msg);
+        Uint64 handler_start = metrics::now_ns();
+        if (method->buffer_handler) {
+            SerializationBuffer& out = response_buffer();
+            ReturnCode rc = method->buffer_handler(*payload, src, out);
+            rec.handler_time(metrics::now_ns() - handler_start);
+            if (rc != ReturnCode::E_OK) rec.errored();
+            send_and_cache(msg, rc, out.buf, src, cache, *payload, generation);
+        } else {
+            MethodResult res = method->handler(*payload, src);
+            rec.handler_time(metrics::now_ns() - handler_start);
+            if (res.return_code != ReturnCode::E_OK) rec.errored();
+            if (cache) {
+                SerializationBuffer& out = response_buffer();
+                out.write_bytes(res.payload);
+                send_and_cache(msg, res.return_code, out.buf, src, cache, *payload, generation);
+            } else {
+                send_response(msg, res, src);
+            }
+        }
+        rec.receive_to_send(metrics::now_ns() - received_at);
     } else {
         // ignore other types for brevity
+        rec.dropped();
     }
 }
 
+const SomeIpMessage* MessageRouter::current_request() {
+    return current;
+}
+
 void MessageRouter::send_response(const SomeIpMessage& request, const MethodResult& result, const Endpoint& dest) {
-    SomeIpHeader h;
-    h.service_id = request.header.service_id;
-    h.method_id  = request.header.method_id;
-    h.client_id  = request.header.client_id;
-    h.session_id = request.header.session_id;
-    h.protocol_version = request.header.protocol_version;
-    h.interface_version = request.header.interface_version;
-    h.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
-    h.return_code = static_cast<uint8_t>(result.return_code);
-    h.length = static_cast<Uint32>(result.payload.size() + SomeIpHeader::MIN_LENGTH);
-    SomeIpMessage resp{h, result.payload};
-    Payload out = resp.serialize();
-    if (endpoint_) endpoint_->send_to(out, dest);
+    SomeIpHeader h = reply_header(request.header, MessageType::RESPONSE, result.return_code);
+    const Payload* body = &result.payload;
+    Payload protected_body;
+    if (const Stages* stages = protection_for(h.service_id, h.method_id)) {
+        protected_body = result.payload;
+        for (const auto& stage : *stages) {
+            if (!stage->protect(h, protected_body, dest)) {
+                SOMEIP_LOG_ERROR("Protection failed for 0x%04x.0x%04x", h.service_id, h.method_id);
+                return;
+            }
+        }
+        body = &protected_body;
+    }
+    // Serialize straight into one buffer, without an intermediate message copy
+    h.length = static_cast<Uint32>(body->size() + SomeIpHeader::MIN_LENGTH);
+    Payload out;
+    out.reserve(SomeIpHeader::SIZE + body->size());
+    h.serialize_to(out);
+    out.insert(out.end(), body->begin(), body->end());
+    transmit(request, out, dest);
+}
+
+void MessageRouter::send_buffer_response(const SomeIpMessage& request, ReturnCode rc, Payload& out, const Endpoint& dest) {
+    SomeIpHeader h = reply_header(request.header, MessageType::RESPONSE, rc);
+    if (const Stages* stages = protection_for(h.service_id, h.method_id)) {
+        // Stages work on a bare payload, so protected methods pay for one copy
+        Payload body(out.begin() + SomeIpHeader::SIZE, out.end());
+        for (const auto& stage : *stages) {
+            if (!stage->protect(h, body, dest)) {
+                SOMEIP_LOG_ERROR("Protection failed for 0x%04x.0x%04x", h.service_id, h.method_id);
+                return;
+            }
+        }
+        out.resize(SomeIpHeader::SIZE);
+        out.insert(out.end(), body.begin(), body.end());
+    }
+    h.length = static_cast<Uint32>(out.size() - SomeIpHeader::SIZE + SomeIpHeader::MIN_LENGTH);
+    h.serialize_to(out.data());
+    transmit(request, out, dest);
+}
+
+bool MessageRouter::send_cached(ResponseCache& cache, const SomeIpMessage& request, const Payload& payload,
+                                const Endpoint& dest) {
+    SerializationBuffer& out = response_buffer();
+    Uint64 expired = 0;
+    bool hit = cache.lookup(payload, out.buf, expired);
+    if (expired) metrics::MethodRecorder(request.header.service_id, request.header.method_id).cache_evicted(expired);
+    if (!hit) return false;
+    if (protection_for(request.header.service_id, request.header.method_id)) {
+        // Stored unprotected: freshness values and counters must be new for every response
+        send_buffer_response(request, ReturnCode::E_OK, out.buf, dest);
+        return true;
+    }
+    // Only the IDs that differ between requesters change
+    uint8_t* h = out.buf.data();
+    h[8] = static_cast<uint8_t>(request.header.client_id >> 8);
+    h[9] = static_cast<uint8_t>(request.header.client_id);
+    h[10] = static_cast<uint8_t>(request.header.session_id >> 8);
+    h[11] = static_cast<uint8_t>(request.header.session_id);
+    h[12] = request.header.protocol_version;
+    h[13] = request.header.interface_version;
+    transmit(request, out.buf, dest);
+    return true;
+}
+
+void MessageRouter::send_and_cache(const SomeIpMessage& request, ReturnCode rc, Payload& out, const Endpoint& dest,
+                                   ResponseCache* cache, const Payload& payload, Uint64 generation) {
+    if (!cache || rc != ReturnCode::E_OK) {
+        send_buffer_response(request, rc, out, dest);
+        return;
+    }
+    Uint64 evicted;
+    if (protection_for(request.header.service_id, request.header.method_id)) {
+        evicted = cache->store(payload, out, generation);
+        send_buffer_response(request, rc, out, dest);
+    } else {
+        // The buffer holds the complete datagram once sent
+        send_buffer_response(request, rc, out, dest);
+        evicted = cache->store(payload, out, generation);
+    }
+    metrics::MethodRecorder(request.header.service_id, request.header.method_id).cache_evicted(evicted);
 }
 
 void MessageRouter::send_error(const SomeIpMessage& request, ReturnCode rc, const Endpoint& dest) {
-    SomeIpHeader h;
-    h.service_id = request.header.service_id;
-    h.method_id  = request.header.method_id;
-    h.client_id  = request.header.client_id;
-    h.session_id = request.header.session_id;
-    h.protocol_version = request.header.protocol_version;
-    h.interface_version = request.header.interface_version;
-    h.message_type = static_cast<uint8_t>(MessageType::ERR);
-    h.return_code = static_cast<uint8_t>(rc);
-    h.length = SomeIpHeader::MIN_LENGTH;
-    SomeIpMessage err{h, {}};
-    Payload out = err.serialize();
-    if (endpoint_) endpoint_->send_to(out, dest);
+    SomeIpHeader h = reply_header(request.header, MessageType::ERR, rc);
+    Payload out;
+    h.serialize_to(out);
+    if (const Stages* stages = protection_for(h.service_id, h.method_id)) {
+        // Authenticated like responses, so a forged error cannot pass for the server's answer
+        Payload body;
+        for (const auto& stage : *stages) {
+            if (!stage->protect(h, body, dest)) {
+                SOMEIP_LOG_ERROR("Protection failed for 0x%04x.0x%04x", h.service_id, h.method_id);
+                return;
+            }
+        }
+        out.insert(out.end(), body.begin(), body.end());
+        h.length = static_cast<Uint32>(body.size() + SomeIpHeader::MIN_LENGTH);
+        h.serialize_to(out.data());
+    }
+    transmit(request, out, dest);
+}
+
+void MessageRouter::transmit(const SomeIpMessage& request, const Payload& datagram, const Endpoint& dest) {
+    if (endpoint_) endpoint_->send_to(datagram, dest);
+    DuplicateClaim* claim = active_claim;
+    if (claim && claim->request == &request && claim->window) {
+        claim->window->complete(claim->key, datagram);
+        claim->window = nullptr;
+    }
+}
+
+void MessageRouter::enable_duplicate_detection(DuplicateWindowOptions options) {
+    duplicates_ = std::make_unique<DuplicateWindow>(options);
+}
+
+void MessageRouter::add_protection(ServiceId service, MethodId method, std::shared_ptr<ProtectionStage> stage) {
+    if (stage) protection_[(Uint32(service) << 16) | method].push_back(std::move(stage));
+}
+
+void MessageRouter::enable_cache(ServiceId service, MethodId method, ResponseCacheOptions options) {
+    caches_[(Uint32(service) << 16) | method] = std::make_unique<ResponseCache>(options);
+}
+
+void MessageRouter::invalidate_cache(ServiceId service, MethodId method) {
+    if (ResponseCache* cache = cache_for(service, method)) {
+        metrics::MethodRecorder(service, method).cache_evicted(cache->clear());
+    }
+}
+
+ResponseCache* MessageRouter::cache_for(ServiceId service, MethodId method) const {
+    if (caches_.empty()) return nullptr;
+    auto it = caches_.find((Uint32(service) << 16) | method);
+    return it == caches_.end() ? nullptr : it->second.get();
+}
+
+const MessageRouter::Stages* MessageRouter::protection_for(ServiceId service, MethodId method) const {
+    if (protection_.empty()) return nullptr;
+    auto it = protection_.find((Uint32(service) << 16) | method);
+    return it == protection_.end() ? nullptr : &it->second;
 }
 
 } // namespace someip
\ No newline at end of file
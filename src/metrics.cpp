@@ -0,0 +1,266 @@
+#include "someip/metrics.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace someip {
+namespace metrics {
+
+void LatencyHistogram::record(Uint64 v, Uint64 n) {
+    if (n == 0) return;
+    counts_[bucket_index(v)] += n;
+    count_ += n;
+    sum_ += v * n;
+    if (v < min_) min_ = v;
+    if (v > max_) max_ = v;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.count_ == 0) return;
+    for (unsigned i = 0; i < BUCKETS; ++i) counts_[i] += other.counts_[i];
+    count_ += other.count_;
+    sum_ += other.sum_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+Uint64 LatencyHistogram::percentile(double q) const {
+    if (count_ == 0) return 0;
+    q = std::min(std::max(q, 0.0), 1.0);
+    Uint64 rank = static_cast<Uint64>(q * double(count_) + 0.5);
+    if (rank == 0) rank = 1;
+    Uint64 seen = 0;
+    for (unsigned i = 0; i < BUCKETS; ++i) {
+        seen += counts_[i];
+        if (seen >= rank) return std::min(bucket_upper_bound(i), max_);
+    }
+    return max_;
+}
+
+const MethodSnapshot* Snapshot::find(ServiceId svc, MethodId mth) const {
+    for (const auto& m : methods) {
+        if (m.service_id == svc && m.method_id == mth) return &m;
+    }
+    return nullptr;
+}
+
+namespace detail {
+
+void AtomicHistogram::merge_into(LatencyHistogram& out) const {
+    Uint64 n = 0;
+    for (unsigned i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+        Uint64 c = counts[i].load(std::memory_order_relaxed);
+        if (c == 0) continue;
+        out.counts_[i] += c;
+        out.min_ = std::min(out.min_, LatencyHistogram::bucket_lower_bound(i));
+        n += c;
+    }
+    if (n == 0) return;
+    out.count_ += n;
+    out.sum_ += sum.load(std::memory_order_relaxed);
+    out.max_ = std::max(out.max_, max.load(std::memory_order_relaxed));
+}
+
+} // namespace detail
+
+namespace {
+
+using detail::MethodCell;
+
+inline Uint32 make_key(ServiceId svc, MethodId mth) {
+    return (Uint32(svc) << 16) | mth;
+}
+
+// Per-thread open-addressing table. Only the owning thread inserts; a cell pointer is
+// published with release after its key is written, so readers never see a half-built slot.
+struct Shard {
+    static constexpr size_t CAPACITY = 512;  // power of two
+
+    std::array<Uint32, CAPACITY> keys{};
+    std::array<std::atomic<MethodCell*>, CAPACITY> cells{};
+
+    ~Shard() {
+        for (auto& c : cells) delete c.load(std::memory_order_relaxed);
+    }
+
+    MethodCell* find_or_insert(Uint32 key) {
+        size_t i = (key * 0x9E3779B1u) >> (32 - 9);
+        for (size_t probe = 0; probe < CAPACITY; ++probe, i = (i + 1) & (CAPACITY - 1)) {
+            MethodCell* c = cells[i].load(std::memory_order_relaxed);
+            if (!c) {
+                keys[i] = key;
+                c = new MethodCell();
+                cells[i].store(c, std::memory_order_release);
+                return c;
+            }
+            if (keys[i] == key) return c;
+        }
+        return nullptr;
+    }
+};
+static_assert(Shard::CAPACITY == (size_t(1) << 9), "hash shift assumes 512 slots");
+
+void merge_cell(const MethodCell& c, MethodSnapshot& out) {
+    out.received += c.received.load(std::memory_order_relaxed);
+    out.dispatched += c.dispatched.load(std::memory_order_relaxed);
+    out.errored += c.errored.load(std::memory_order_relaxed);
+    out.dropped += c.dropped.load(std::memory_order_relaxed);
+    out.cache_hits += c.cache_hits.load(std::memory_order_relaxed);
+    out.cache_misses += c.cache_misses.load(std::memory_order_relaxed);
+    out.cache_evictions += c.cache_evictions.load(std::memory_order_relaxed);
+    out.duplicates += c.duplicates.load(std::memory_order_relaxed);
+    c.handler_time.merge_into(out.handler_time);
+    c.receive_to_send.merge_into(out.receive_to_send);
+    c.queue_delay.merge_into(out.queue_delay);
+    c.socket_delay.merge_into(out.socket_delay);
+}
+
+class Registry {
+public:
+    void add(const std::shared_ptr<Shard>& shard) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        live_.push_back(shard);
+    }
+
+    // Fold an exiting thread's counts into the retired totals
+    void retire(const std::shared_ptr<Shard>& shard) {
+        std::lock_guard<std::mutex> lk(mutex_);
+        merge_shard(*shard, retired_);
+        live_.erase(std::remove(live_.begin(), live_.end(), shard), live_.end());
+    }
+
+    Snapshot snapshot() {
+        std::map<Uint32, MethodSnapshot> merged;
+        {
+            std::lock_guard<std::mutex> lk(mutex_);
+            merged = retired_;
+            for (const auto& s : live_) merge_shard(*s, merged);
+        }
+        Snapshot snap;
+        snap.methods.reserve(merged.size());
+        for (auto& kv : merged) snap.methods.push_back(std::move(kv.second));
+        return snap;
+    }
+
+private:
+    static void merge_shard(const Shard& shard, std::map<Uint32, MethodSnapshot>& out) {
+        for (size_t i = 0; i < Shard::CAPACITY; ++i) {
+            const MethodCell* c = shard.cells[i].load(std::memory_order_acquire);
+            if (!c) continue;
+            Uint32 key = shard.keys[i];
+            auto it = out.find(key);
+            if (it == out.end()) {
+                MethodSnapshot m;
+                m.service_id = static_cast<ServiceId>(key >> 16);
+                m.method_id = static_cast<MethodId>(key & 0xFFFF);
+                it = out.emplace(key, std::move(m)).first;
+            }
+            merge_cell(*c, it->second);
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Shard>> live_;
+    std::map<Uint32, MethodSnapshot> retired_;
+};
+
+// Intentionally leaked: thread_local shards may retire during static destruction
+Registry& registry() {
+    static Registry* r = new Registry();
+    return *r;
+}
+
+struct ThreadShard {
+    std::shared_ptr<Shard> shard = std::make_shared<Shard>();
+    ThreadShard() { registry().add(shard); }
+    ~ThreadShard() { registry().retire(shard); }
+};
+
+void append_counter(std::string& out, const char* name, const char* help, const Snapshot& snap,
+                    Uint64 MethodSnapshot::* field) {
+    char line[160];
+    snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s counter\n", name, help, name);
+    out += line;
+    for (const auto& m : snap.methods) {
+        snprintf(line, sizeof(line), "%s{service=\"0x%04X\",method=\"0x%04X\"} %llu\n",
+                 name, m.service_id, m.method_id, (unsigned long long)(m.*field));
+        out += line;
+    }
+}
+
+void append_histogram(std::string& out, const char* name, const char* help, const Snapshot& snap,
+                      LatencyHistogram MethodSnapshot::* field) {
+    char line[512];
+    snprintf(line, sizeof(line), "# HELP %s %s\n# TYPE %s histogram\n", name, help, name);
+    out += line;
+    for (const auto& m : snap.methods) {
+        const LatencyHistogram& h = m.*field;
+        Uint64 cumulative = 0;
+        for (unsigned i = 0; i < LatencyHistogram::BUCKETS; ++i) {
+            if (h.buckets()[i] == 0) continue;
+            cumulative += h.buckets()[i];
+            snprintf(line, sizeof(line), "%s_bucket{service=\"0x%04X\",method=\"0x%04X\",le=\"%.9g\"} %llu\n",
+                     name, m.service_id, m.method_id,
+                     double(LatencyHistogram::bucket_upper_bound(i)) * 1e-9,
+                     (unsigned long long)cumulative);
+            out += line;
+        }
+        snprintf(line, sizeof(line),
+                 "%s_bucket{service=\"0x%04X\",method=\"0x%04X\",le=\"+Inf\"} %llu\n"
+                 "%s_sum{service=\"0x%04X\",method=\"0x%04X\"} %.9g\n"
+                 "%s_count{service=\"0x%04X\",method=\"0x%04X\"} %llu\n",
+                 name, m.service_id, m.method_id, (unsigned long long)h.count(),
+                 name, m.service_id, m.method_id, double(h.sum()) * 1e-9,
+                 name, m.service_id, m.method_id, (unsigned long long)h.count());
+        out += line;
+    }
+}
+
+} // namespace
+
+namespace detail {
+
+MethodCell* cell(ServiceId svc, MethodId mth) {
+    thread_local ThreadShard local;
+    return local.shard->find_or_insert(make_key(svc, mth));
+}
+
+} // namespace detail
+
+Snapshot snapshot() {
+    return registry().snapshot();
+}
+
+std::string to_prometheus(const Snapshot& snap) {
+    std::string out;
+    append_counter(out, "someip_messages_received_total", "Requests received per method.", snap,
+                   &MethodSnapshot::received);
+    append_counter(out, "someip_messages_dispatched_total", "Requests handed to a handler.", snap,
+                   &MethodSnapshot::dispatched);
+    append_counter(out, "someip_messages_errored_total", "Requests answered with an error.", snap,
+                   &MethodSnapshot::errored);
+    append_counter(out, "someip_messages_dropped_total", "Messages discarded without a response.", snap,
+                   &MethodSnapshot::dropped);
+    append_counter(out, "someip_response_cache_hits_total", "Requests answered from the response cache.", snap,
+                   &MethodSnapshot::cache_hits);
+    append_counter(out, "someip_response_cache_misses_total", "Requests of cached methods that ran the handler.",
+                   snap, &MethodSnapshot::cache_misses);
+    append_counter(out, "someip_response_cache_evictions_total", "Cached responses expired, evicted or invalidated.",
+                   snap, &MethodSnapshot::cache_evictions);
+    append_counter(out, "someip_duplicate_requests_total", "Retransmitted requests not run again.", snap,
+                   &MethodSnapshot::duplicates);
+    append_histogram(out, "someip_handler_duration_seconds", "Handler execution time.", snap,
+                     &MethodSnapshot::handler_time);
+    append_histogram(out, "someip_receive_to_send_seconds", "Time from request receipt to response send.", snap,
+                     &MethodSnapshot::receive_to_send);
+    append_histogram(out, "someip_queue_delay_seconds", "Time requests wait in a dispatcher queue.", snap,
+                     &MethodSnapshot::queue_delay);
+    append_histogram(out, "someip_socket_delay_seconds", "Time datagrams wait in the socket receive queue.", snap,
+                     &MethodSnapshot::socket_delay);
+    return out;
+}
+
+} // namespace metrics
+} // namespace someip
@@ -0,0 +1,76 @@
+#include "someip/response_cache.hpp"
+#include "someip/crc.hpp"
+
+namespace someip {
+
+ResponseCache::ResponseCache(ResponseCacheOptions options)
+    : ttl_ns_(static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(options.ttl).count())),
+      capacity_(options.capacity ? options.capacity : 1) {}
+
+Uint64 ResponseCache::now_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+bool ResponseCache::lookup(const Payload& request, Payload& out, Uint64& evicted) {
+    const Uint32 key = crc::crc32c(request.data(), request.size());
+    const Uint64 now = now_ns();
+    std::lock_guard<std::mutex> lk(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    if (expired(it->second, now)) {
+        entries_.erase(it);
+        ++evicted;
+        return false;
+    }
+    if (it->second.request != request) return false;
+    it->second.used_ns = now;
+    out.assign(it->second.response.begin(), it->second.response.end());
+    return true;
+}
+
+Uint64 ResponseCache::store(const Payload& request, const Payload& response, Uint64 generation) {
+    const Uint32 key = crc::crc32c(request.data(), request.size());
+    const Uint64 now = now_ns();
+    Uint64 evicted = 0;
+    std::lock_guard<std::mutex> lk(mutex_);
+    if (generation != ANY_GENERATION && generation != generation_.load(std::memory_order_relaxed)) return 0;
+    if (!entries_.count(key) && entries_.size() >= capacity_) {
+        // Expired entries go first; otherwise the least recently used one
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (expired(it->second, now)) {
+                it = entries_.erase(it);
+                ++evicted;
+                continue;
+            }
+            if (victim == entries_.end() || it->second.used_ns < victim->second.used_ns) victim = it;
+            ++it;
+        }
+        if (entries_.size() >= capacity_ && victim != entries_.end()) {
+            entries_.erase(victim);
+            ++evicted;
+        }
+    }
+    Entry& e = entries_[key];
+    e.request = request;
+    e.response = response;
+    e.stored_ns = now;
+    e.used_ns = now;
+    return evicted;
+}
+
+Uint64 ResponseCache::clear() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    Uint64 n = entries_.size();
+    entries_.clear();
+    generation_.fetch_add(1, std::memory_order_release);
+    return n;
+}
+
+size_t ResponseCache::size() const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return entries_.size();
+}
+
+} // namespace someip
@@ -0,0 +1,331 @@
+#include "someip/secoc.hpp"
+#include <chrono>
+#include <cstring>
+#include <openssl/crypto.h>
+#include <openssl/evp.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#else
+#include <openssl/hmac.h>
+#endif
+#include <vector>
+
+namespace someip {
+
+namespace {
+
+constexpr size_t MAX_MAC = 32;
+
+// AES-CMAC (RFC 4493) on a keyed ECB context: the AES round keys and the K1/K2 subkeys are
+// derived once, so a message costs one block encryption per 16 bytes and nothing else
+struct Cmac {
+    EVP_CIPHER_CTX* ecb = nullptr;
+    uint8_t k1[16], k2[16];
+    uint8_t x[16], buf[16];
+    size_t buf_len = 0;
+
+    ~Cmac() { EVP_CIPHER_CTX_free(ecb); }
+
+    bool encrypt_block(uint8_t* block) {
+        int outl = 0;
+        return EVP_EncryptUpdate(ecb, block, &outl, block, 16) == 1;
+    }
+    static void dbl(const uint8_t* in, uint8_t* out) {
+        uint8_t carry = in[0] >> 7;
+        for (int i = 0; i < 15; ++i) out[i] = uint8_t((in[i] << 1) | (in[i + 1] >> 7));
+        out[15] = uint8_t((in[15] << 1) ^ (carry ? 0x87 : 0));
+    }
+    bool init(const Payload& key) {
+        ecb = EVP_CIPHER_CTX_new();
+        if (!ecb || EVP_EncryptInit_ex(ecb, EVP_aes_128_ecb(), nullptr, key.data(), nullptr) != 1) return false;
+        EVP_CIPHER_CTX_set_padding(ecb, 0);
+        uint8_t l[16] = {};
+        if (!encrypt_block(l)) return false;
+        dbl(l, k1);
+        dbl(k1, k2);
+        return true;
+    }
+    bool copy_from(const Cmac& other) {
+        std::memcpy(k1, other.k1, 16);
+        std::memcpy(k2, other.k2, 16);
+        return (ecb = EVP_CIPHER_CTX_new()) && EVP_CIPHER_CTX_copy(ecb, other.ecb) == 1;
+    }
+    void restart() {
+        std::memset(x, 0, 16);
+        buf_len = 0;
+    }
+    // The last block is held back until final() knows whether it is complete
+    bool update(const uint8_t* p, size_t n) {
+        while (n) {
+            if (buf_len == 16) {
+                for (int i = 0; i < 16; ++i) x[i] ^= buf[i];
+                if (!encrypt_block(x)) return false;
+                buf_len = 0;
+            }
+            size_t take = n < 16 - buf_len ? n : 16 - buf_len;
+            std::memcpy(buf + buf_len, p, take);
+            buf_len += take;
+            p += take;
+            n -= take;
+        }
+        return true;
+    }
+    size_t final(uint8_t* out) {
+        const uint8_t* k = k1;
+        if (buf_len < 16) {
+            buf[buf_len] = 0x80;
+            std::memset(buf + buf_len + 1, 0, 15 - buf_len);
+            k = k2;
+        }
+        for (int i = 0; i < 16; ++i) x[i] ^= buf[i] ^ k[i];
+        if (!encrypt_block(x)) return 0;
+        std::memcpy(out, x, 16);
+        return 16;
+    }
+};
+
+// HMAC-SHA256 with the inner and outer padded-key states hashed once at creation;
+// restarting reuses them instead of rehashing the key
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+struct Hmac {
+    EVP_MAC_CTX* ctx = nullptr;
+
+    ~Hmac() { EVP_MAC_CTX_free(ctx); }
+
+    bool init(const Payload& key) {
+        EVP_MAC* mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+        if (!mac) return false;
+        ctx = EVP_MAC_CTX_new(mac);
+        EVP_MAC_free(mac);
+        OSSL_PARAM params[2] = {
+            OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+            OSSL_PARAM_construct_end()};
+        return ctx && EVP_MAC_init(ctx, key.data(), key.size(), params) == 1;
+    }
+    bool copy_from(const Hmac& other) { return (ctx = EVP_MAC_CTX_dup(other.ctx)) != nullptr; }
+    bool restart() { return EVP_MAC_init(ctx, nullptr, 0, nullptr) == 1; }
+    bool update(const uint8_t* p, size_t n) { return EVP_MAC_update(ctx, p, n) == 1; }
+    size_t final(uint8_t* out) {
+        size_t len = 0;
+        return EVP_MAC_final(ctx, out, &len, MAX_MAC) == 1 ? len : 0;
+    }
+};
+#else
+struct Hmac {
+    HMAC_CTX* ctx = nullptr;
+
+    ~Hmac() { HMAC_CTX_free(ctx); }
+
+    bool init(const Payload& key) {
+        ctx = HMAC_CTX_new();
+        return ctx && HMAC_Init_ex(ctx, key.data(), (int)key.size(), EVP_sha256(), nullptr) == 1;
+    }
+    bool copy_from(const Hmac& other) { return (ctx = HMAC_CTX_new()) && HMAC_CTX_copy(ctx, other.ctx) == 1; }
+    bool restart() { return HMAC_Init_ex(ctx, nullptr, 0, nullptr, nullptr) == 1; }
+    bool update(const uint8_t* p, size_t n) { return HMAC_Update(ctx, p, n) == 1; }
+    size_t final(uint8_t* out) {
+        unsigned int len = 0;
+        return HMAC_Final(ctx, out, &len) == 1 ? len : 0;
+    }
+};
+#endif
+
+// Keyed MAC context of either algorithm
+struct MacCtx {
+    bool is_cmac = true;
+    Cmac cmac;
+    Hmac hmac;
+
+    bool init(SecOcProfile::Algorithm alg, const Payload& key) {
+        is_cmac = alg == SecOcProfile::Algorithm::CMAC_AES128;
+        return is_cmac ? cmac.init(key) : hmac.init(key);
+    }
+    bool copy_from(const MacCtx& other) {
+        is_cmac = other.is_cmac;
+        return is_cmac ? cmac.copy_from(other.cmac) : hmac.copy_from(other.hmac);
+    }
+    bool restart() {
+        if (!is_cmac) return hmac.restart();
+        cmac.restart();
+        return true;
+    }
+    bool update(const uint8_t* p, size_t n) { return is_cmac ? cmac.update(p, n) : hmac.update(p, n); }
+    size_t final(uint8_t* out) { return is_cmac ? cmac.final(out) : hmac.final(out); }
+};
+
+std::atomic<Uint64> next_stage_id{1};
+
+// Time-based freshness: milliseconds of the clock shared with the peers
+Uint64 shared_clock_ms() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+const Endpoint no_endpoint;
+
+// Per-thread copies of the keyed contexts, one per stage used on this thread
+struct LocalMac {
+    Uint64 owner;
+    std::unique_ptr<MacCtx> ctx;
+};
+
+} // namespace
+
+struct SecOcStage::Key {
+    MacCtx keyed;
+};
+
+SecOcStage::~SecOcStage() = default;
+
+std::shared_ptr<SecOcStage> SecOcStage::create(const SecOcProfile& profile) {
+    bool cmac = profile.algorithm == SecOcProfile::Algorithm::CMAC_AES128;
+    size_t max_mac = cmac ? 16 : 32;
+    if ((cmac && profile.key.size() != 16) || profile.key.empty()) return nullptr;
+    if (profile.mac_bytes < 1 || profile.mac_bytes > max_mac) return nullptr;
+    if (profile.freshness_bytes < 1 || profile.freshness_bytes > 4) return nullptr;
+    if (profile.max_peers == 0) return nullptr;
+    // A time value must be recognizable from its low bytes anywhere in the tolerance
+    Uint64 span = Uint64(1) << (8 * profile.freshness_bytes);
+    if (profile.freshness == SecOcProfile::Freshness::TIME && profile.time_tolerance_ms >= span / 2) return nullptr;
+
+    std::shared_ptr<SecOcStage> stage(new SecOcStage());
+    stage->profile_ = profile;
+    stage->id_ = next_stage_id.fetch_add(1);
+    stage->key_.reset(new Key());
+    stage->peers_.reset(new PeerTable<Peer>(profile.max_peers));
+    if (!stage->key_->keyed.init(profile.algorithm, profile.key)) return nullptr;
+    return stage;
+}
+
+size_t SecOcStage::compute_mac(const SomeIpHeader& header, const uint8_t* data, size_t len,
+                               Uint32 freshness, uint8_t* mac) {
+    thread_local std::vector<LocalMac> cache;
+    MacCtx* ctx = nullptr;
+    for (auto& c : cache) {
+        if (c.owner == id_) {
+            ctx = c.ctx.get();
+            break;
+        }
+    }
+    if (!ctx) {
+        std::unique_ptr<MacCtx> fresh(new MacCtx());
+        if (!fresh->copy_from(key_->keyed)) return 0;
+        if (cache.size() >= 16) cache.erase(cache.begin());
+        cache.push_back(LocalMac{id_, std::move(fresh)});
+        ctx = cache.back().ctx.get();
+    }
+
+    // Message ID | Request ID | versions | type | return code (the length field is excluded)
+    uint8_t ids[12] = {
+        uint8_t(header.service_id >> 8), uint8_t(header.service_id), uint8_t(header.method_id >> 8),
+        uint8_t(header.method_id), uint8_t(header.client_id >> 8), uint8_t(header.client_id),
+        uint8_t(header.session_id >> 8), uint8_t(header.session_id), header.protocol_version,
+        header.interface_version, header.message_type, header.return_code};
+    uint8_t fv[4] = {uint8_t(freshness >> 24), uint8_t(freshness >> 16), uint8_t(freshness >> 8),
+                     uint8_t(freshness)};
+    if (!ctx->restart() || !ctx->update(ids, sizeof(ids)) || (len && !ctx->update(data, len)) ||
+        !ctx->update(fv, sizeof(fv))) {
+        return 0;
+    }
+    return ctx->final(mac);
+}
+
+// 0 once a counter has used up its 32 bits, or a time value would run further ahead of the
+// clock than the receiver tolerates
+Uint64 SecOcStage::next_freshness(Peer& peer) const {
+    if (profile_.freshness == SecOcProfile::Freshness::COUNTER) {
+        Uint64 next = peer.tx_freshness.fetch_add(1, std::memory_order_relaxed) + 1;
+        return next <= 0xFFFFFFFFULL ? next : 0;
+    }
+    // The clock, or one past the last value where messages come faster than milliseconds
+    Uint64 now = shared_clock_ms();
+    Uint64 last = peer.tx_freshness.load(std::memory_order_relaxed);
+    Uint64 next;
+    do {
+        next = now > last ? now : last + 1;
+        if (next > now + profile_.time_tolerance_ms) return 0;
+    } while (!peer.tx_freshness.compare_exchange_weak(last, next, std::memory_order_relaxed));
+    return next;
+}
+
+bool SecOcStage::protect(const SomeIpHeader& header, Payload& payload) {
+    return protect(header, payload, no_endpoint);
+}
+
+bool SecOcStage::check(const SomeIpHeader& header, Payload& payload) {
+    return check(header, payload, no_endpoint);
+}
+
+bool SecOcStage::protect(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+    std::shared_ptr<Peer> state = peers_->add(PeerKey(peer, header.client_id));
+    Uint64 full = next_freshness(*state);
+    if (!full) return false;
+    Uint32 freshness = static_cast<Uint32>(full);
+    uint8_t mac[MAX_MAC];
+    if (!compute_mac(header, payload.data(), payload.size(), freshness, mac)) return false;
+    for (int i = profile_.freshness_bytes - 1; i >= 0; --i) {
+        payload.push_back(static_cast<uint8_t>(freshness >> (8 * i)));
+    }
+    payload.insert(payload.end(), mac, mac + profile_.mac_bytes);
+    return true;
+}
+
+// Pick the full value closest to the newest accepted one whose low bytes match
+Uint32 SecOcStage::reconstruct_freshness(Uint32 truncated, Uint64 latest) const {
+    if (profile_.freshness_bytes >= 4) return truncated;
+    Uint64 span = Uint64(1) << (8 * profile_.freshness_bytes);
+    Uint64 candidate = (latest & ~(span - 1)) | truncated;
+    if (candidate + span / 2 <= latest) candidate += span;
+    else if (candidate > latest + span / 2 && candidate >= span) candidate -= span;
+    return static_cast<Uint32>(candidate);
+}
+
+bool SecOcStage::check(const SomeIpHeader& header, Payload& payload, const Endpoint& peer) {
+    size_t trailer = overhead();
+    if (payload.size() < trailer) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    size_t len = payload.size() - trailer;
+    const uint8_t* fv = payload.data() + len;
+    Uint32 truncated = 0;
+    for (size_t i = 0; i < profile_.freshness_bytes; ++i) truncated = (truncated << 8) | fv[i];
+
+    PeerKey id(peer, header.client_id);
+    std::shared_ptr<Peer> state = peers_->find(id);
+    const bool timed = profile_.freshness == SecOcProfile::Freshness::TIME;
+    Uint64 full;
+    if (timed) {
+        // The value nearest to our own clock with these low bytes, which must lie within the tolerance
+        Uint64 now = shared_clock_ms(), span = Uint64(1) << (8 * profile_.freshness_bytes);
+        full = (now & ~(span - 1)) | truncated;
+        if (full + span / 2 <= now) full += span;
+        else if (full > now + span / 2 && full >= span) full -= span;
+        if (full + profile_.time_tolerance_ms < now || full > now + profile_.time_tolerance_ms) full = 0;
+    } else {
+        full = reconstruct_freshness(truncated, state ? state->rx_window.highest() : 0);
+    }
+    auto window_seq = [&](const Peer& p) { return timed ? (full > p.rx_base ? full - p.rx_base : 0) : full; };
+
+    uint8_t mac[MAX_MAC];
+    bool ok = full && (!state || !state->rx_window.is_stale(window_seq(*state))) &&
+              compute_mac(header, payload.data(), len, static_cast<Uint32>(full), mac) &&
+              CRYPTO_memcmp(mac, fv + profile_.freshness_bytes, profile_.mac_bytes) == 0;
+    if (ok) {
+        // Only authenticated peers get state, so forged traffic cannot push real peers out.
+        // A new peer's time window starts far enough back for everything still in tolerance.
+        if (!state) {
+            state = peers_->add(id, [&](Peer& p) { p.rx_base = timed ? full - ReplayWindow::WINDOW : 0; });
+        }
+        ok = state->rx_window.check_and_update(window_seq(*state));
+    }
+    if (!ok) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    payload.resize(len);
+    return true;
+}
+
+} // namespace someip
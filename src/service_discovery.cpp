@@ -15,16 +15,22 @@ ServiceDiscovery::~ServiceDiscovery() {
 bool ServiceDiscovery::start() {
     std::lock_guard<std::mutex> lk(mutex_);
     if (running_) return true;
-    mcast_endpoint_.reset(new UdpEndpoint("0.0.0.0", mcast_port_));
-    mcast_endpoint_->set_callback([this](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto){
+    if (!transport_) {
+        EndpointOptions receive;
+        receive.thread = thread_options_;
+        // Only SD messages (service 0xFFFF) get past the kernel on the shared multicast port
+        receive.socket_filter = someip_socket_filter({0xFFFF}, {MessageType::NOTIFICATION});
+        transport_ = std::make_shared<UdpEndpoint>("0.0.0.0", mcast_port_, receive);
+    }
+    transport_->set_callback([this](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto){
         this->handle_incoming(msg, src, dst, proto);
     });
-    if (!mcast_endpoint_->start()) return false;
-    if (!mcast_endpoint_->join_multicast(mcast_addr_)) {
+    if (!transport_->start()) return false;
+    if (!transport_->join_multicast(mcast_addr_)) {
         log_error("Failed to join multicast group");
     }
     running_ = true;
-    offer_thread_ = std::thread(&ServiceDiscovery::periodic_offer_loop, this);
+    if (offer_interval_.count() > 0) offer_thread_ = std::thread(&ServiceDiscovery::periodic_offer_loop, this);
     return true;
 }
 
@@ -34,14 +40,45 @@ void ServiceDiscovery::stop() {
         if (!running_) return;
         running_ = false;
     }
-    if (mcast_endpoint_) mcast_endpoint_->stop();
+    stop_cv_.notify_all();
+    if (transport_) transport_->stop();
     if (offer_thread_.joinable()) offer_thread_.join();
 }
 
 void ServiceDiscovery::offer_service(const SdOffer& offer) {
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        offered_[std::make_pair(offer.service_id, offer.instance_id)] = offer;
+    }
+    send_offer(offer);
+}
+
+void ServiceDiscovery::send_offers() {
+    std::vector<SdOffer> offers;
+    {
+        std::lock_guard<std::mutex> lk(mutex_);
+        for (const auto& kv : offered_) offers.push_back(kv.second);
+    }
+    for (const SdOffer& offer : offers) send_offer(offer);
+}
+
+std::vector<SdOffer> ServiceDiscovery::found() const {
     std::lock_guard<std::mutex> lk(mutex_);
-    offered_[std::make_pair(offer.service_id, offer.instance_id)] = offer;
-    // send immediate offer: create VERY simple SD-like SOME/IP message (not spec-complete)
+    std::vector<SdOffer> out;
+    for (const auto& kv : found_) out.push_back(kv.second);
+    return out;
+}
+
+std::optional<SdOffer> ServiceDiscovery::find(ServiceId svc, InstanceId inst) const {
+    std::lock_guard<std::mutex> lk(mutex_);
+    for (const auto& kv : found_) {
+        if (kv.second.service_id == svc && kv.second.instance_id == inst) return kv.second;
+    }
+    return std::nullopt;
+}
+
+void ServiceDiscovery::send_offer(const SdOffer& offer) {
+    // create VERY simple SD-like SOME/IP message (not spec-complete)
     SomeIpHeader h;
     h.service_id = 0xFFFF; // SD service
     h.method_id = 0x8100;
@@ -63,9 +100,9 @@ void ServiceDiscovery::offer_service(const SdOffer& offer) {
     h.message_type = static_cast<uint8_t>(MessageType::NOTIFICATION);
     h.return_code = 0;
     SomeIpMessage msg{h, body};
-    if (mcast_endpoint_) {
+    if (transport_) {
         Payload out = msg.serialize();
-        mcast_endpoint_->send_to(out, std::make_pair(mcast_addr_, mcast_port_));
+        transport_->send_to(out, std::make_pair(mcast_addr_, mcast_port_));
     }
 }
 
@@ -100,14 +137,13 @@ void ServiceDiscovery::handle_incoming(const SomeIpMessage& msg, const Endpoint&
 }
 
 void ServiceDiscovery::periodic_offer_loop() {
+    apply_thread_options(thread_options_);
+    std::unique_lock<std::mutex> lk(mutex_);
     while (running_) {
-        {
-            std::lock_guard<std::mutex> lk(mutex_);
-            for (auto& kv : offered_) {
-                offer_service(kv.second);
-            }
-        }
-        std::this_thread::sleep_for(std::chrono::seconds(2));
+        lk.unlock();
+        send_offers();
+        lk.lock();
+        stop_cv_.wait_for(lk, offer_interval_, [this] { return !running_; });
     }
 }
 
@@ -0,0 +1,79 @@
+#include "someip/socket_filter.hpp"
+#include "someip/someip_header.hpp"
+#include <algorithm>
+
+namespace someip {
+
+namespace {
+
+// Classic BPF opcodes (linux/filter.h), spelled out so programs can be built on any platform
+constexpr uint16_t LD_LEN = 0x80;   // BPF_LD | BPF_W | BPF_LEN
+constexpr uint16_t LDH_ABS = 0x28;  // BPF_LD | BPF_H | BPF_ABS, big-endian load
+constexpr uint16_t LDB_ABS = 0x30;  // BPF_LD | BPF_B | BPF_ABS
+constexpr uint16_t JEQ_K = 0x15;    // BPF_JMP | BPF_JEQ | BPF_K
+constexpr uint16_t JGT_K = 0x25;    // BPF_JMP | BPF_JGT | BPF_K
+constexpr uint16_t JGE_K = 0x35;    // BPF_JMP | BPF_JGE | BPF_K
+constexpr uint16_t MOD_K = 0x94;    // BPF_ALU | BPF_MOD | BPF_K
+constexpr uint16_t RET_K = 0x06;    // BPF_RET | BPF_K
+constexpr uint16_t RET_A = 0x16;    // BPF_RET | BPF_A
+
+// A socket filter on a UDP socket sees the UDP header first; a reuseport program does not
+constexpr Uint32 UDP_HEADER = 8;
+constexpr Uint32 MESSAGE_TYPE_OFFSET = 14;
+
+BpfInstruction op(uint16_t code, Uint32 k = 0) { return BpfInstruction{code, 0, 0, k}; }
+
+// Conditional jump from instruction `at` to `if_true`/`if_false` (absolute indices)
+BpfInstruction jump(uint16_t code, Uint32 k, size_t at, size_t if_true, size_t if_false) {
+    return BpfInstruction{code, static_cast<uint8_t>(if_true - at - 1), static_cast<uint8_t>(if_false - at - 1), k};
+}
+
+} // namespace
+
+BpfProgram someip_socket_filter(const std::vector<ServiceId>& services, const std::vector<MessageType>& types) {
+    std::vector<ServiceId> svc(services);
+    std::sort(svc.begin(), svc.end());
+    svc.erase(std::unique(svc.begin(), svc.end()), svc.end());
+    std::vector<MessageType> mt(types);
+    std::sort(mt.begin(), mt.end());
+    mt.erase(std::unique(mt.begin(), mt.end()), mt.end());
+
+    const bool exact = svc.size() <= MAX_EXACT_SERVICES;
+    const size_t svc_begin = 2;
+    const size_t type_begin = svc_begin + (svc.empty() ? 0 : exact ? 1 + svc.size() : 3);
+    const size_t accept = type_begin + (mt.empty() ? 0 : 1 + mt.size());
+    const size_t drop = accept + 1;
+
+    BpfProgram p;
+    p.push_back(op(LD_LEN));
+    p.push_back(jump(JGE_K, UDP_HEADER + SomeIpHeader::SIZE, p.size(), p.size() + 1, drop));
+    if (!svc.empty()) {
+        p.push_back(op(LDH_ABS, UDP_HEADER));
+        if (exact) {
+            for (size_t i = 0; i < svc.size(); ++i) {
+                const bool last = i + 1 == svc.size();
+                p.push_back(jump(JEQ_K, svc[i], p.size(), type_begin, last ? drop : p.size() + 1));
+            }
+        } else {
+            p.push_back(jump(JGE_K, svc.front(), p.size(), p.size() + 1, drop));
+            p.push_back(jump(JGT_K, svc.back(), p.size(), drop, type_begin));
+        }
+    }
+    if (!mt.empty()) {
+        p.push_back(op(LDB_ABS, UDP_HEADER + MESSAGE_TYPE_OFFSET));
+        for (size_t i = 0; i < mt.size(); ++i) {
+            const bool last = i + 1 == mt.size();
+            p.push_back(jump(JEQ_K, static_cast<Uint32>(mt[i]), p.size(), accept, last ? drop : p.size() + 1));
+        }
+    }
+    p.push_back(op(RET_K, 0xFFFFFFFFu));  // keep the whole datagram
+    p.push_back(op(RET_K, 0));
+    return p;
+}
+
+BpfProgram client_steering_program(unsigned sockets) {
+    constexpr Uint32 CLIENT_ID_OFFSET = 8;
+    return BpfProgram{op(LDH_ABS, CLIENT_ID_OFFSET), op(MOD_K, sockets ? sockets : 1), op(RET_A)};
+}
+
+} // namespace someip
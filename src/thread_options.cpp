@@ -0,0 +1,40 @@
+#include "someip/thread_options.hpp"
+#include "someip/types.hpp"
+#include <string>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace someip {
+
+bool apply_thread_options(const ThreadOptions& options) {
+    bool ok = true;
+#ifdef __linux__
+    if (options.cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (options.cpu < CPU_SETSIZE) CPU_SET(options.cpu, &set);
+        if (options.cpu >= CPU_SETSIZE || pthread_setaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+            log_error("cannot pin thread to CPU " + std::to_string(options.cpu));
+            ok = false;
+        }
+    }
+    if (options.rt_priority > 0) {
+        sched_param param{};
+        param.sched_priority = options.rt_priority;
+        if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+            log_error("cannot set SCHED_FIFO priority " + std::to_string(options.rt_priority));
+            ok = false;
+        }
+    }
+#else
+    if (options.cpu >= 0 || options.rt_priority > 0) {
+        log_error("thread affinity and realtime priority are only supported on Linux");
+        ok = false;
+    }
+#endif
+    return ok;
+}
+
+} // namespace someip
@@ -0,0 +1,467 @@
+#include "someip/tls_transport.hpp"
+#include "certificates_impl.hpp"
+#include <cstring>
+#include <vector>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <openssl/x509v3.h>
+#if OPENSSL_VERSION_NUMBER < 0x30000000L
+  #define SSL_get1_peer_certificate SSL_get_peer_certificate
+#endif
+#ifdef _WIN32
+  #define poll WSAPoll
+  #define close closesocket
+  #define SHUT_RDWR SD_BOTH
+  using nfds_t = ULONG;
+#else
+  #include <fcntl.h>
+  #include <netinet/in.h>
+  #include <netinet/tcp.h>
+  #include <poll.h>
+  #include <signal.h>
+#endif
+
+namespace someip {
+
+namespace {
+
+constexpr size_t MAX_MESSAGE = 16 * 1024 * 1024;
+constexpr int IO_TIMEOUT_MS = 1000;
+
+// OpenSSL writes with plain send(), so a peer that already closed would raise SIGPIPE.
+// Ignore it unless the application installed its own handler.
+void ignore_sigpipe() {
+#ifndef _WIN32
+    static bool once = [] {
+        struct sigaction sa {};
+        if (sigaction(SIGPIPE, nullptr, &sa) == 0 && sa.sa_handler == SIG_DFL) signal(SIGPIPE, SIG_IGN);
+        return true;
+    }();
+    (void)once;
+#endif
+}
+
+void set_nonblocking(socket_t s) {
+#ifdef _WIN32
+    u_long on = 1;
+    ioctlsocket(s, FIONBIO, &on);
+#else
+    fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK);
+#endif
+    int one = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&one), sizeof(one));
+}
+
+bool wait_socket(socket_t s, bool for_write, int timeout_ms) {
+    pollfd pfd{};
+    pfd.fd = s;
+    pfd.events = for_write ? POLLOUT : POLLIN;
+    return poll(&pfd, 1, timeout_ms) > 0;
+}
+
+// Certificate verification through the CertificateManager (and its cache). A server verifies
+// client certificates, a client server certificates; the cache keeps the two apart.
+int verify_chain(X509_STORE_CTX* ctx, void* arg) {
+    auto* ssl = static_cast<SSL*>(X509_STORE_CTX_get_ex_data(ctx, SSL_get_ex_data_X509_STORE_CTX_idx()));
+    int purpose = ssl && SSL_is_server(ssl) ? X509_PURPOSE_SSL_CLIENT : X509_PURPOSE_SSL_SERVER;
+    return TlsContextAccess::verify(*static_cast<CertificateManager*>(arg), ctx, purpose) ? 1 : 0;
+}
+
+void use_trust_store(SSL_CTX* ctx, CertificateManager& certs) {
+    X509_STORE* store = TlsContextAccess::impl(certs).store;
+    X509_STORE_up_ref(store);
+    SSL_CTX_set_cert_store(ctx, store);
+    SSL_CTX_set_cert_verify_callback(ctx, verify_chain, &certs);
+}
+
+// Size of the first complete message in `buf`, 0 if incomplete, SIZE_MAX if invalid
+size_t framed_size(const uint8_t* buf, size_t len) {
+    if (len < 8) return 0;
+    Uint32 length = (Uint32(buf[4]) << 24) | (Uint32(buf[5]) << 16) | (Uint32(buf[6]) << 8) | buf[7];
+    size_t total = size_t(length) + 8;
+    if (length < SomeIpHeader::MIN_LENGTH || total > MAX_MESSAGE) return SIZE_MAX;
+    return len >= total ? total : 0;
+}
+
+// Write all of `data`, waiting while the non-blocking socket is full
+bool write_all(SSL* ssl, socket_t s, const Payload& data) {
+    size_t off = 0;
+    while (off < data.size()) {
+        int n = SSL_write(ssl, data.data() + off, (int)(data.size() - off));
+        if (n > 0) {
+            off += size_t(n);
+            continue;
+        }
+        int err = SSL_get_error(ssl, n);
+        if ((err != SSL_ERROR_WANT_WRITE && err != SSL_ERROR_WANT_READ) ||
+            !wait_socket(s, err == SSL_ERROR_WANT_WRITE, IO_TIMEOUT_MS)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Endpoint peer_of(const sockaddr_in& addr) {
+    char ip[INET_ADDRSTRLEN] = {};
+    inet_ntop(AF_INET, &addr.sin_addr, ip, sizeof(ip));
+    return Endpoint{ip, ntohs(addr.sin_port)};
+}
+
+} // namespace
+
+struct TlsServer::Connection {
+    socket_t sock;
+    SSL* ssl;
+    Endpoint peer;
+    bool established = false;
+    bool closed = false;
+    short events = POLLIN;  // POLLOUT added while the handshake waits to write
+    std::mutex mutex;  // guards `ssl` between the I/O thread and send_to()
+    Payload rx;
+};
+
+TlsServer::TlsServer(std::shared_ptr<CertificateManager> certs, const TlsOptions& opts)
+    : certs_(std::move(certs)), opts_(opts) {
+    ignore_sigpipe();
+}
+
+TlsServer::~TlsServer() {
+    stop();
+    SSL_CTX_free(ctx_);
+}
+
+bool TlsServer::start(const std::string& bind_ip, uint16_t bind_port) {
+    if (running_) return true;
+    if (!certs_) return false;
+    auto& impl = TlsContextAccess::impl(*certs_);
+    if (!impl.cert || !impl.key) {
+        log_error("TLS server needs a certificate and private key");
+        return false;
+    }
+
+    if (!ctx_) {
+        ctx_ = SSL_CTX_new(TLS_server_method());
+        if (!ctx_) return false;
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+        if (SSL_CTX_use_certificate(ctx_, impl.cert) != 1 || SSL_CTX_use_PrivateKey(ctx_, impl.key) != 1) {
+            log_error("TLS certificate/key mismatch");
+            return false;
+        }
+        for (int i = 0; impl.chain && i < sk_X509_num(impl.chain); ++i) {
+            SSL_CTX_add1_chain_cert(ctx_, sk_X509_value(impl.chain, i));
+        }
+        static const unsigned char sid_ctx[] = "someip";
+        SSL_CTX_set_session_id_context(ctx_, sid_ctx, sizeof(sid_ctx) - 1);
+        SSL_CTX_set_session_cache_mode(ctx_, opts_.session_cache ? SSL_SESS_CACHE_SERVER : SSL_SESS_CACHE_OFF);
+        SSL_CTX_set_timeout(ctx_, (long)opts_.session_lifetime.count());
+        if (!opts_.session_tickets) SSL_CTX_set_options(ctx_, SSL_OP_NO_TICKET);
+        if (opts_.require_client_certificate) {
+            use_trust_store(ctx_, *certs_);
+            SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT, nullptr);
+        }
+    }
+
+    sock_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock_ == INVALID_SOCKET_VAL) return false;
+    int reuse = 1;
+    setsockopt(sock_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(bind_port);
+    inet_pton(AF_INET, bind_ip.c_str(), &addr.sin_addr);
+    socklen_t len = sizeof(addr);
+    if (bind(sock_, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(sock_, 64) < 0 ||
+        getsockname(sock_, (sockaddr*)&addr, &len) < 0) {
+        log_error("TLS listen failed");
+        close(sock_);
+        sock_ = INVALID_SOCKET_VAL;
+        return false;
+    }
+    set_nonblocking(sock_);
+    bind_ip_ = bind_ip;
+    bind_port_ = ntohs(addr.sin_port);
+
+    running_ = true;
+    io_thread_ = std::thread(&TlsServer::io_loop, this);
+    return true;
+}
+
+void TlsServer::stop() {
+    if (!running_) return;
+    running_ = false;
+    ::shutdown(sock_, SHUT_RDWR);
+    if (io_thread_.joinable()) io_thread_.join();
+    close(sock_);
+    sock_ = INVALID_SOCKET_VAL;
+    std::map<Endpoint, std::shared_ptr<Connection>> conns;
+    {
+        std::lock_guard<std::mutex> lk(conn_mutex_);
+        conns.swap(connections_);
+    }
+    for (auto& kv : conns) close_connection(kv.second);
+}
+
+void TlsServer::close_connection(const std::shared_ptr<Connection>& conn) {
+    {
+        std::lock_guard<std::mutex> lk(conn_mutex_);
+        auto it = connections_.find(conn->peer);
+        if (it != connections_.end() && it->second == conn) connections_.erase(it);
+    }
+    std::lock_guard<std::mutex> lk(conn->mutex);
+    if (conn->closed) return;
+    conn->closed = true;
+    if (conn->established) SSL_shutdown(conn->ssl);
+    SSL_free(conn->ssl);
+    close(conn->sock);
+}
+
+bool TlsServer::send_to(const Payload& data, const Endpoint& dest) {
+    std::shared_ptr<Connection> conn;
+    {
+        std::lock_guard<std::mutex> lk(conn_mutex_);
+        auto it = connections_.find(dest);
+        if (it == connections_.end()) return false;
+        conn = it->second;
+    }
+    std::lock_guard<std::mutex> lk(conn->mutex);
+    return !conn->closed && conn->established && write_all(conn->ssl, conn->sock, data);
+}
+
+void TlsServer::io_loop() {
+    std::vector<pollfd> fds;
+    std::vector<std::shared_ptr<Connection>> conns;
+    uint8_t chunk[16384];
+    Endpoint local{bind_ip_, bind_port_};
+
+    while (running_) {
+        fds.assign(1, pollfd{sock_, POLLIN, 0});
+        conns.clear();
+        {
+            std::lock_guard<std::mutex> lk(conn_mutex_);
+            for (auto& kv : connections_) {
+                fds.push_back(pollfd{kv.second->sock, kv.second->events, 0});
+                conns.push_back(kv.second);
+            }
+        }
+        if (poll(fds.data(), (nfds_t)fds.size(), 100) <= 0) continue;
+        if (!running_) break;
+
+        if (fds[0].revents) {
+            for (;;) {
+                sockaddr_in peer{};
+                socklen_t len = sizeof(peer);
+                socket_t s = accept(sock_, (sockaddr*)&peer, &len);
+                if (s == INVALID_SOCKET_VAL) break;
+                set_nonblocking(s);
+                auto conn = std::make_shared<Connection>();
+                conn->sock = s;
+                conn->ssl = SSL_new(ctx_);
+                conn->peer = peer_of(peer);
+                SSL_set_fd(conn->ssl, (int)s);
+                SSL_set_accept_state(conn->ssl);
+                std::lock_guard<std::mutex> lk(conn_mutex_);
+                connections_[conn->peer] = conn;
+            }
+        }
+
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (!fds[i].revents) continue;
+            const auto& conn = conns[i - 1];
+            bool failed = false;
+            {
+                std::lock_guard<std::mutex> lk(conn->mutex);
+                if (conn->closed) continue;
+                if (!conn->established) {
+                    int r = SSL_do_handshake(conn->ssl);
+                    if (r == 1) {
+                        conn->established = true;
+                        conn->events = POLLIN;
+                        handshakes_.fetch_add(1, std::memory_order_relaxed);
+                        if (SSL_session_reused(conn->ssl)) resumed_.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        int err = SSL_get_error(conn->ssl, r);
+                        failed = err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE;
+                        conn->events = err == SSL_ERROR_WANT_WRITE ? POLLIN | POLLOUT : POLLIN;
+                    }
+                }
+                while (conn->established && !failed) {
+                    int n = SSL_read(conn->ssl, chunk, sizeof(chunk));
+                    if (n > 0) {
+                        conn->rx.insert(conn->rx.end(), chunk, chunk + n);
+                        continue;
+                    }
+                    int err = SSL_get_error(conn->ssl, n);
+                    failed = err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE;
+                    break;
+                }
+            }
+            ERR_clear_error();
+
+            // Dispatch complete messages outside the connection lock so handlers can reply
+            size_t off = 0;
+            while (!failed) {
+                size_t size = framed_size(conn->rx.data() + off, conn->rx.size() - off);
+                if (size == SIZE_MAX) failed = true;
+                if (size == 0 || size == SIZE_MAX) break;
+                Payload data(conn->rx.begin() + off, conn->rx.begin() + off + size);
+                off += size;
+                try {
+                    SomeIpMessage msg = SomeIpMessage::deserialize(data);
+                    if (callback_) callback_(msg, conn->peer, local, TransportProtocol::TCP);
+                } catch (const std::exception& e) {
+                    SOMEIP_LOG_ERROR("Failed to parse SOME/IP message: %s", e.what());
+                }
+            }
+            conn->rx.erase(conn->rx.begin(), conn->rx.begin() + off);
+            if (failed) close_connection(conn);
+        }
+    }
+}
+
+TlsClient::TlsClient(std::shared_ptr<CertificateManager> certs, const TlsOptions& opts)
+    : certs_(std::move(certs)), opts_(opts) {
+    ignore_sigpipe();
+}
+
+TlsClient::~TlsClient() {
+    disconnect();
+    SSL_SESSION_free(session_);
+    SSL_CTX_free(ctx_);
+}
+
+int TlsClient::on_new_session(SSL* ssl, SSL_SESSION* session) {
+    auto* self = static_cast<TlsClient*>(SSL_get_app_data(ssl));
+    if (!self || !self->opts_.resume_sessions) return 0;
+    SSL_SESSION_free(self->session_);
+    self->session_ = session;
+    return 1;  // we keep the reference
+}
+
+bool TlsClient::wait(int ssl_result, int timeout_ms) {
+    int err = SSL_get_error(ssl_, ssl_result);
+    if (err != SSL_ERROR_WANT_READ && err != SSL_ERROR_WANT_WRITE) return false;
+    return wait_socket(sock_, err == SSL_ERROR_WANT_WRITE, timeout_ms);
+}
+
+bool TlsClient::connect(const std::string& ip, uint16_t port, int timeout_ms) {
+    disconnect();
+    if (opts_.verify_peer && !certs_) {
+        log_error("TLS client cannot verify the peer without a CertificateManager");
+        return false;
+    }
+    if (!ctx_) {
+        ctx_ = SSL_CTX_new(TLS_client_method());
+        if (!ctx_) return false;
+        SSL_CTX_set_min_proto_version(ctx_, TLS1_2_VERSION);
+        SSL_CTX_set_session_cache_mode(ctx_, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+        SSL_CTX_sess_set_new_cb(ctx_, &TlsClient::on_new_session);
+        if (certs_) {
+            auto& impl = TlsContextAccess::impl(*certs_);
+            if (impl.cert && impl.key) {
+                SSL_CTX_use_certificate(ctx_, impl.cert);
+                SSL_CTX_use_PrivateKey(ctx_, impl.key);
+            }
+            if (opts_.verify_peer) {
+                use_trust_store(ctx_, *certs_);
+                SSL_CTX_set_verify(ctx_, SSL_VERIFY_PEER, nullptr);
+            }
+        }
+    }
+
+    sock_ = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock_ == INVALID_SOCKET_VAL) return false;
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+    if (::connect(sock_, (sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(sock_);
+        sock_ = INVALID_SOCKET_VAL;
+        return false;
+    }
+    set_nonblocking(sock_);
+
+    ssl_ = SSL_new(ctx_);
+    SSL_set_app_data(ssl_, this);
+    SSL_set_fd(ssl_, (int)sock_);
+    if (!opts_.server_name.empty()) SSL_set_tlsext_host_name(ssl_, opts_.server_name.c_str());
+    if (opts_.resume_sessions && session_) SSL_set_session(ssl_, session_);
+
+    for (;;) {
+        int r = SSL_connect(ssl_);
+        if (r == 1) break;
+        if (!wait(r, timeout_ms)) {
+            ERR_clear_error();
+            disconnect();
+            return false;
+        }
+    }
+    resumed_ = SSL_session_reused(ssl_) == 1;
+
+    // The name is checked on every connection, also when the chain came from the cache
+    if (!opts_.server_name.empty()) {
+        X509* peer = SSL_get1_peer_certificate(ssl_);
+        bool match = peer && (X509_check_ip_asc(peer, opts_.server_name.c_str(), 0) == 1 ||
+                              X509_check_host(peer, opts_.server_name.c_str(), 0, 0, nullptr) == 1);
+        X509_free(peer);
+        if (!match) {
+            log_error("TLS peer certificate does not match " + opts_.server_name);
+            disconnect();
+            return false;
+        }
+    }
+    return true;
+}
+
+void TlsClient::disconnect() {
+    if (ssl_) {
+        SSL_shutdown(ssl_);
+        SSL_free(ssl_);
+        ssl_ = nullptr;
+    }
+    if (sock_ != INVALID_SOCKET_VAL) {
+        close(sock_);
+        sock_ = INVALID_SOCKET_VAL;
+    }
+    rx_.clear();
+    ERR_clear_error();
+}
+
+bool TlsClient::send(const Payload& data) {
+    return ssl_ && write_all(ssl_, sock_, data);
+}
+
+std::optional<SomeIpMessage> TlsClient::receive(int timeout_ms) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    uint8_t chunk[16384];
+    while (ssl_) {
+        size_t size = framed_size(rx_.data(), rx_.size());
+        if (size == SIZE_MAX) {
+            disconnect();
+            return std::nullopt;
+        }
+        if (size) {
+            Payload data(rx_.begin(), rx_.begin() + size);
+            rx_.erase(rx_.begin(), rx_.begin() + size);
+            try {
+                return SomeIpMessage::deserialize(data);
+            } catch (const std::exception&) {
+                return std::nullopt;
+            }
+        }
+        int n = SSL_read(ssl_, chunk, sizeof(chunk));
+        if (n > 0) {
+            rx_.insert(rx_.end(), chunk, chunk + n);
+            continue;
+        }
+        int left = (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0 || !wait(n, left)) {
+            ERR_clear_error();
+            return std::nullopt;
+        }
+    }
+    return std::nullopt;
+}
+
+} // namespace someip
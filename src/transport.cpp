@@ -1,17 +1,159 @@
 #include "someip/transport.hpp"
 #include "someip/someip_message.hpp"
+#include "someip/metrics.hpp"
+#include "someip/capture.hpp"
+#include <algorithm>
 #include <iostream>
+#include <cerrno>
 #include <cstring>
 #include <vector>
+#ifdef __linux__
+#include <linux/filter.h>
+#include <linux/net_tstamp.h>
+#include <netinet/udp.h>
+#include <sys/prctl.h>
+#include <time.h>
+#endif
 
 namespace someip {
 
+namespace {
+
+// Idle strategy of ReceiveMode::BUSY_POLL: spin, then yield the CPU, then sleep for doubling
+// intervals up to the configured maximum. Any received datagram starts over at spinning.
+// With a single CPU, spinning only keeps the sender off it, so polling starts at yielding.
+class IdleBackoff {
+public:
+    explicit IdleBackoff(const EndpointOptions& options)
+        : spins_(std::thread::hardware_concurrency() > 1 ? options.spin_iterations : 0), max_sleep_(std::max(options.max_backoff, std::chrono::microseconds(1))) {}
+
+    void idle() {
+        if (idle_ < spins_) {
+            ++idle_;
+            cpu_relax();
+        } else if (idle_ < spins_ + YIELDS) {
+            ++idle_;
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(sleep_);
+            sleep_ = std::min(sleep_ * 2, max_sleep_);
+        }
+    }
+
+    void reset() {
+        idle_ = 0;
+        sleep_ = std::chrono::microseconds(1);
+    }
+
+private:
+    static constexpr Uint32 YIELDS = 64;
+
+    static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    Uint32 spins_;
+    std::chrono::microseconds max_sleep_;
+    Uint32 idle_ = 0;
+    std::chrono::microseconds sleep_{1};
+};
+
+// Apply SO_RCVBUF/SO_SNDBUF and warn when the kernel caps the size (rmem_max/wmem_max)
+void set_buffer_size(socket_t sock, int option, int bytes, const char* name) {
+    if (bytes <= 0) return;
+    setsockopt(sock, SOL_SOCKET, option, (const char*)&bytes, sizeof(bytes));
+    int actual = 0;
+#ifdef _WIN32
+    int len = sizeof(actual);
+#else
+    socklen_t len = sizeof(actual);
+#endif
+    getsockopt(sock, SOL_SOCKET, option, (char*)&actual, &len);
+    if (actual < bytes) {
+        log_error(std::string(name) + " capped at " + std::to_string(actual) + " bytes (requested " +
+                  std::to_string(bytes) + ")");
+    }
+}
+
+sockaddr_in to_sockaddr(const Endpoint& ep) {
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(std::get<1>(ep));
+    inet_pton(AF_INET, std::get<0>(ep).c_str(), &addr.sin_addr);
+    return addr;
+}
+
+Uint64 steady_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+#ifdef __linux__
+Uint64 timespec_ns(const timespec& ts) {
+    return Uint64(ts.tv_sec) * 1000000000ULL + Uint64(ts.tv_nsec);
+}
+
+// What the control messages of one recvmsg() carried
+struct ControlInfo {
+    RxTimestamp rx;
+    Uint64 software_ns = 0;  // kernel software stamp (CLOCK_REALTIME), even when rx has a NIC stamp
+    Uint32 drops = 0;        // cumulative socket drops, valid if have_drops
+    bool have_drops = false;
+    size_t gro_size = 0;     // segment size of a GRO-coalesced buffer (0: a single datagram)
+};
+
+static_assert(sizeof(BpfInstruction) == sizeof(sock_filter), "BpfInstruction must match struct sock_filter");
+
+bool attach_program(socket_t sock, int option, const BpfProgram& program, const char* name) {
+    sock_fprog prog{static_cast<unsigned short>(program.size()),
+                    reinterpret_cast<sock_filter*>(const_cast<BpfInstruction*>(program.data()))};
+    if (setsockopt(sock, SOL_SOCKET, option, &prog, sizeof(prog)) < 0) {
+        log_error(std::string("setsockopt ") + name + " failed: " + std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void read_control(msghdr& mh, ControlInfo& info) {
+    for (cmsghdr* c = CMSG_FIRSTHDR(&mh); c; c = CMSG_NXTHDR(&mh, c)) {
+        if (c->cmsg_level == SOL_UDP && c->cmsg_type == UDP_GRO) {
+            int size;
+            std::memcpy(&size, CMSG_DATA(c), sizeof(size));
+            if (size > 0) info.gro_size = static_cast<size_t>(size);
+            continue;
+        }
+        if (c->cmsg_level != SOL_SOCKET) continue;
+        if (c->cmsg_type == SCM_TIMESTAMPNS) {
+            timespec ts;
+            std::memcpy(&ts, CMSG_DATA(c), sizeof(ts));
+            info.software_ns = info.rx.kernel_ns = timespec_ns(ts);
+        } else if (c->cmsg_type == SCM_TIMESTAMPING) {
+            timespec ts[3];  // software, (legacy), raw hardware
+            std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+            info.software_ns = timespec_ns(ts[0]);
+            Uint64 hw = timespec_ns(ts[2]);
+            info.rx.hardware = hw != 0;
+            info.rx.kernel_ns = hw ? hw : info.software_ns;
+        } else if (c->cmsg_type == SO_RXQ_OVFL) {
+            std::memcpy(&info.drops, CMSG_DATA(c), sizeof(info.drops));
+            info.have_drops = true;
+        }
+    }
+}
+#endif
+
+} // namespace
+
 #ifdef _WIN32
 static bool winsock_initialized = false;
 #endif
 
-UdpEndpoint::UdpEndpoint(const std::string& bind_ip, uint16_t bind_port)
-    : bind_ip_(bind_ip), bind_port_(bind_port) {}
+UdpEndpoint::UdpEndpoint(const std::string& bind_ip, uint16_t bind_port, EndpointOptions options)
+    : bind_ip_(bind_ip), bind_port_(bind_port), options_(std::move(options)) {}
 
 UdpEndpoint::~UdpEndpoint() {
     stop();
@@ -43,11 +185,47 @@ bool UdpEndpoint::start() {
 #else
     setsockopt(sock_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
 #endif
+#ifdef SO_REUSEPORT
+    if (options_.reuse_port && setsockopt(sock_, SOL_SOCKET, SO_REUSEPORT, &reuse, sizeof(reuse)) < 0) {
+        log_error("setsockopt SO_REUSEPORT failed");
+    }
+#endif
+#ifdef SO_BUSY_POLL
+    if (options_.so_busy_poll_us > 0 &&
+        setsockopt(sock_, SOL_SOCKET, SO_BUSY_POLL, &options_.so_busy_poll_us, sizeof(options_.so_busy_poll_us)) < 0) {
+        log_error("setsockopt SO_BUSY_POLL failed (raising it needs CAP_NET_ADMIN)");
+    }
+#endif
+    set_buffer_size(sock_, SO_RCVBUF, options_.rcvbuf, "SO_RCVBUF");
+    set_buffer_size(sock_, SO_SNDBUF, options_.sndbuf, "SO_SNDBUF");
+#ifdef __linux__
+    int on = 1;
+    setsockopt(sock_, SOL_SOCKET, SO_RXQ_OVFL, &on, sizeof(on));
+    if (options_.hardware_timestamps) {
+        int flags = SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE |
+                    SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+        if (setsockopt(sock_, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags)) < 0) {
+            log_error("setsockopt SO_TIMESTAMPING failed");
+        }
+    } else if (options_.timestamps) {
+        setsockopt(sock_, SOL_SOCKET, SO_TIMESTAMPNS, &on, sizeof(on));
+    }
+    if (options_.gro) setsockopt(sock_, SOL_UDP, UDP_GRO, &on, sizeof(on));
+    // Before bind, so no unfiltered datagram is queued in between
+    if (!options_.socket_filter.empty()) attach_program(sock_, SO_ATTACH_FILTER, options_.socket_filter, "SO_ATTACH_FILTER");
+#endif
+#ifdef _WIN32
+    if (options_.mode == ReceiveMode::BUSY_POLL) {
+        u_long nonblocking = 1;
+        ioctlsocket(sock_, FIONBIO, &nonblocking);
+    }
+#endif
 
     sockaddr_in addr{};
     addr.sin_family = AF_INET;
     addr.sin_port = htons(bind_port_);
     inet_pton(AF_INET, bind_ip_.c_str(), &addr.sin_addr);
+    local_addr_ = ntohl(addr.sin_addr.s_addr);
 
     if (bind(sock_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
         log_error("bind() failed");
@@ -60,6 +238,12 @@ bool UdpEndpoint::start() {
 #endif
         return false;
     }
+#ifdef __linux__
+    // The program belongs to the whole reuseport group, which exists once the socket is bound
+    if (options_.reuse_port && !options_.reuseport_program.empty()) {
+        attach_program(sock_, SO_ATTACH_REUSEPORT_CBPF, options_.reuseport_program, "SO_ATTACH_REUSEPORT_CBPF");
+    }
+#endif
 
     running_ = true;
     recv_thread_ = std::thread(&UdpEndpoint::receive_loop, this);
@@ -76,6 +260,8 @@ void UdpEndpoint::stop() {
     }
 #else
     if (sock_ >= 0) {
+        // close() alone does not wake a thread blocked in recvfrom() on Linux
+        ::shutdown(sock_, SHUT_RDWR);
         ::close(sock_);
         sock_ = -1;
     }
@@ -83,6 +269,20 @@ void UdpEndpoint::stop() {
     if (recv_thread_.joinable()) recv_thread_.join();
 }
 
+bool UdpEndpoint::set_socket_filter(const BpfProgram& program) {
+    options_.socket_filter = program;
+#ifdef __linux__
+    if (sock_ == INVALID_SOCKET_VAL) return true;
+    if (program.empty()) {
+        int none = 0;
+        return setsockopt(sock_, SOL_SOCKET, SO_DETACH_FILTER, &none, sizeof(none)) == 0 || errno == ENOENT;
+    }
+    return attach_program(sock_, SO_ATTACH_FILTER, program, "SO_ATTACH_FILTER");
+#else
+    return program.empty();
+#endif
+}
+
 bool UdpEndpoint::join_multicast(const std::string& mcast_addr) {
     struct ip_mreq mreq{};
     inet_pton(AF_INET, mcast_addr.c_str(), &mreq.imr_multiaddr);
@@ -102,50 +302,213 @@ bool UdpEndpoint::leave_multicast(const std::string& mcast_addr) {
     return true;
 }
 
+size_t Transport::send_batch(const Payload* datagrams, size_t count, const Endpoint& dest) {
+    size_t sent = 0;
+    for (size_t i = 0; i < count; ++i) sent += send_to(datagrams[i], dest) ? 1 : 0;
+    return sent;
+}
+
 bool UdpEndpoint::send_to(const Payload& data, const Endpoint& dest) {
-    std::string ip; uint16_t port;
-    std::tie(ip, port) = dest;
-    sockaddr_in addr{};
-    addr.sin_family = AF_INET;
-    addr.sin_port = htons(port);
-    inet_pton(AF_INET, ip.c_str(), &addr.sin_addr);
+    return send_raw(data.data(), data.size(), to_sockaddr(dest));
+}
 
+bool UdpEndpoint::send_bytes(const uint8_t* data, size_t len, const Endpoint& dest) {
+    return send_raw(data, len, to_sockaddr(dest));
+}
+
+bool UdpEndpoint::send_raw(const uint8_t* data, size_t len, const sockaddr_in& addr) {
     int sent;
 #ifdef _WIN32
-    sent = sendto(sock_, (const char*)data.data(), (int)data.size(), 0, (struct sockaddr*)&addr, sizeof(addr));
+    sent = sendto(sock_, (const char*)data, (int)len, 0, (const struct sockaddr*)&addr, sizeof(addr));
 #else
-    sent = sendto(sock_, (const char*)data.data(), data.size(), 0, (struct sockaddr*)&addr, sizeof(addr));
+    sent = sendto(sock_, data, len, 0, (const struct sockaddr*)&addr, sizeof(addr));
+#endif
+    if (capture_ && sent > 0) {
+        capture_->record(data, len, local_addr_, bind_port_, ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+    }
+    return sent == (int)len;
+}
+
+size_t UdpEndpoint::send_batch(const Payload* datagrams, size_t count, const Endpoint& dest) {
+    sockaddr_in addr = to_sockaddr(dest);
+    size_t sent = 0;
+    for (size_t i = 0; i < count;) {
+        size_t n = 1;
+#ifdef __linux__
+        // A run of equally sized datagrams, within the segment count and the 64 KB send limit.
+        // Each segment must fit one IP packet on the path, or the kernel refuses the whole run.
+        const size_t segment = datagrams[i].size();
+        const size_t max_segment = options_.path_mtu > UDP_IPV4_OVERHEAD ? options_.path_mtu - UDP_IPV4_OVERHEAD : 0;
+        if (gso_.load(std::memory_order_relaxed) && segment > 0 && segment <= max_segment) {
+            while (i + n < count && n < GSO_MAX_SEGMENTS && datagrams[i + n].size() == segment &&
+                   (n + 1) * segment <= GSO_MAX_BYTES) {
+                ++n;
+            }
+        }
+        if (n > 1 && send_segmented(datagrams + i, n, addr)) {
+            sent += n;
+            i += n;
+            continue;
+        }
+#endif
+        // This run only; the next one may segment again
+        for (size_t end = i + n; i < end; ++i) {
+            if (send_raw(datagrams[i].data(), datagrams[i].size(), addr)) ++sent;
+        }
+    }
+    return sent;
+}
+
+#ifdef __linux__
+bool UdpEndpoint::send_segmented(const Payload* datagrams, size_t count, const sockaddr_in& addr) {
+    // The kernel gathers the iovecs into one buffer and cuts it into gso_size datagrams
+    iovec iov[GSO_MAX_SEGMENTS];
+    for (size_t i = 0; i < count; ++i) {
+        iov[i].iov_base = const_cast<uint8_t*>(datagrams[i].data());
+        iov[i].iov_len = datagrams[i].size();
+    }
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+    msghdr mh{};
+    mh.msg_name = const_cast<sockaddr_in*>(&addr);
+    mh.msg_namelen = sizeof(addr);
+    mh.msg_iov = iov;
+    mh.msg_iovlen = count;
+    mh.msg_control = control;
+    mh.msg_controllen = sizeof(control);
+    cmsghdr* c = CMSG_FIRSTHDR(&mh);
+    c->cmsg_level = SOL_UDP;
+    c->cmsg_type = UDP_SEGMENT;
+    c->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t gso_size = static_cast<uint16_t>(datagrams[0].size());
+    std::memcpy(CMSG_DATA(c), &gso_size, sizeof(gso_size));
+
+    ssize_t sent = sendmsg(sock_, &mh, 0);
+    if (sent < 0) {
+        if (errno == ENOPROTOOPT) {
+            // The kernel predates UDP_SEGMENT; no later send will do better
+            gso_.store(false, std::memory_order_relaxed);
+            log_error("UDP_SEGMENT unavailable, sending datagrams one by one");
+        } else if ((errno == EIO || errno == EINVAL) && gso_refused_.fetch_add(1, std::memory_order_relaxed) == 0) {
+            // This route cannot segment this run (e.g. no checksum offload, or a segment above
+            // the device MTU); the caller sends it one by one and tries again with the next
+            log_error(std::string("UDP_SEGMENT refused: ") + std::strerror(errno) + "; sending such runs one by one");
+        }
+        return false;
+    }
+    if (capture_) {
+        for (size_t i = 0; i < count; ++i) {
+            capture_->record(datagrams[i].data(), datagrams[i].size(), local_addr_, bind_port_,
+                             ntohl(addr.sin_addr.s_addr), ntohs(addr.sin_port));
+        }
+    }
+    return true;
+}
 #endif
-    return (sent == (int)data.size());
+
+void UdpEndpoint::reject(const uint8_t* data, size_t len, const sockaddr_in& src) {
+    // Only requests get an answer, so two endpoints cannot bounce errors back and forth
+    if (len < SomeIpHeader::SIZE || data[14] != static_cast<uint8_t>(MessageType::REQUEST)) return;
+    uint8_t err[SomeIpHeader::SIZE];
+    std::memcpy(err, data, SomeIpHeader::SIZE);
+    err[4] = err[5] = err[6] = 0;
+    err[7] = SomeIpHeader::MIN_LENGTH;
+    err[14] = static_cast<uint8_t>(MessageType::ERR);
+    err[15] = static_cast<uint8_t>(ReturnCode::E_NOT_OK);
+    send_raw(err, sizeof(err), src);
 }
 
 void UdpEndpoint::receive_loop() {
+    apply_thread_options(options_.thread);
+    const bool poll = options_.mode == ReceiveMode::BUSY_POLL;
+    IdleBackoff backoff(options_);
+#ifdef _WIN32
+    const int recv_flags = 0;  // the socket itself is non-blocking in BUSY_POLL mode
+#else
+    const int recv_flags = poll ? MSG_DONTWAIT : 0;
+#endif
+#ifdef __linux__
+    // Backoff sleeps are a few microseconds; the default 50 us timer slack would swamp them
+    if (poll) prctl(PR_SET_TIMERSLACK, 1000UL);
+#endif
     while (running_) {
         uint8_t buffer[65536];
         sockaddr_in src{};
-#ifdef _WIN32
+#ifdef __linux__
+        alignas(cmsghdr) char control[256];
+        iovec iov{buffer, sizeof(buffer)};
+        msghdr mh{};
+        mh.msg_name = &src;
+        mh.msg_namelen = sizeof(src);
+        mh.msg_iov = &iov;
+        mh.msg_iovlen = 1;
+        mh.msg_control = control;
+        mh.msg_controllen = sizeof(control);
+        int r = (int)recvmsg(sock_, &mh, recv_flags);
+#elif defined(_WIN32)
         int slen = sizeof(src);
-        int r = recvfrom(sock_, (char*)buffer, (int)sizeof(buffer), 0, (struct sockaddr*)&src, &slen);
+        int r = recvfrom(sock_, (char*)buffer, (int)sizeof(buffer), recv_flags, (struct sockaddr*)&src, &slen);
 #else
         socklen_t slen = sizeof(src);
-        int r = recvfrom(sock_, (char*)buffer, sizeof(buffer), 0, (struct sockaddr*)&src, &slen);
+        int r = recvfrom(sock_, (char*)buffer, sizeof(buffer), recv_flags, (struct sockaddr*)&src, &slen);
 #endif
         if (r <= 0) {
             if (!running_) break;
+            if (poll) backoff.idle();
             continue;
         }
-        Payload p(buffer, buffer + r);
-        try {
-            SomeIpMessage msg = SomeIpMessage::deserialize(p);
-            char srcip[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &(src.sin_addr), srcip, INET_ADDRSTRLEN);
-            Endpoint src_ep(std::string(srcip), ntohs(src.sin_port));
-            Endpoint dst_ep(bind_ip_, bind_port_);
-            if (callback_) callback_(msg, src_ep, dst_ep, TransportProtocol::UDP);
-        } catch (const std::exception& e) {
-            log_error(std::string("Failed to parse SOME/IP message: ") + e.what());
+        if (poll) backoff.reset();
+        RxTimestamp rx;
+        size_t segment = (size_t)r;
+        Uint64 socket_delay = 0;
+#ifdef __linux__
+        ControlInfo info;
+        read_control(mh, info);
+        rx = info.rx;
+        if (info.have_drops) socket_drops_.store(info.drops, std::memory_order_relaxed);
+        if (info.software_ns) {
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            Uint64 now_ns = timespec_ns(now);
+            socket_delay = now_ns > info.software_ns ? now_ns - info.software_ns : 0;
+        }
+        if (info.gro_size) segment = info.gro_size;
+#endif
+        rx.user_ns = steady_ns();
+        // A GRO buffer holds several datagrams from one sender, all `segment` bytes but the last
+        for (size_t off = 0; off < (size_t)r; off += segment) {
+            handle_datagram(buffer + off, std::min(segment, (size_t)r - off), src, rx, socket_delay);
+        }
+    }
+}
+
+void UdpEndpoint::handle_datagram(uint8_t* data, size_t len, const sockaddr_in& src, const RxTimestamp& rx,
+                                  Uint64 socket_delay) {
+    received_.fetch_add(1, std::memory_order_relaxed);
+    if (capture_) {
+        capture_->record(data, len, ntohl(src.sin_addr.s_addr), ntohs(src.sin_port), local_addr_, bind_port_);
+    }
+    if (filter_) {
+        FilterVerdict verdict = filter_(data, len, ntohl(src.sin_addr.s_addr), ntohs(src.sin_port));
+        if (verdict != FilterVerdict::ACCEPT) {
+            if (verdict == FilterVerdict::REJECT) reject(data, len, src);
+            return;
         }
     }
+    if (hook_ && hook_(data, len, ntohl(src.sin_addr.s_addr), ntohs(src.sin_port))) return;
+    try {
+        SomeIpMessage msg = SomeIpMessage::deserialize(data, len);
+        msg.rx = rx;
+        if (socket_delay) metrics::MethodRecorder(msg.header.service_id, msg.header.method_id).socket_delay(socket_delay);
+        char srcip[INET_ADDRSTRLEN];
+        inet_ntop(AF_INET, &(src.sin_addr), srcip, INET_ADDRSTRLEN);
+        Endpoint src_ep(std::string(srcip), ntohs(src.sin_port));
+        Endpoint dst_ep(bind_ip_, bind_port_);
+        if (callback_) callback_(msg, src_ep, dst_ep, TransportProtocol::UDP);
+    } catch (const std::exception& e) {
+        // Not per method: the IDs of a malformed datagram are as untrustworthy as the rest
+        parse_errors_.fetch_add(1, std::memory_order_relaxed);
+        SOMEIP_LOG_ERROR("Failed to parse SOME/IP message: %s", e.what());
+    }
 }
 
 } // namespace someip
\ No newline at end of file
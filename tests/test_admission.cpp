@@ -0,0 +1,174 @@
+#include "someip/admission.hpp"
+#include "someip/api.hpp"
+#include "someip/dispatcher.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+static SomeIpHeader header(ServiceId service, MethodId method, ClientId client) {
+    return SomeIpHeader{service, method, SomeIpHeader::MIN_LENGTH, client, 1, 1, 1,
+                        static_cast<uint8_t>(MessageType::REQUEST), 0};
+}
+
+static FilterVerdict admit(AdmissionControl& ac, ServiceId service, MethodId method, ClientId client,
+                           uint16_t port = 5000) {
+    uint8_t raw[SomeIpHeader::SIZE];
+    header(service, method, client).serialize_to(raw);
+    return ac.admit(raw, sizeof(raw), 0x7F000001, port);
+}
+
+int main() {
+    // Token bucket: burst first, then the refill rate
+    {
+        TokenBucket bucket(RateLimit{10, 2}, 0);
+        assert(bucket.take(0) && bucket.take(0) && !bucket.take(0));
+        assert(!bucket.take(50000000) && bucket.take(100000000));
+        assert(!bucket.full(100000000) && bucket.full(300000000));
+    }
+
+    // Per-client limits are per service; other clients and services are unaffected
+    {
+        AdmissionControl ac;
+        ac.set_client_limit(0x1300, RateLimit{0, 2});
+        assert(admit(ac, 0x1300, 1, 7) == FilterVerdict::ACCEPT);
+        assert(admit(ac, 0x1300, 2, 7) == FilterVerdict::ACCEPT);
+        assert(admit(ac, 0x1300, 1, 7) == FilterVerdict::DROP);
+        assert(admit(ac, 0x1300, 1, 8) == FilterVerdict::ACCEPT);
+        assert(admit(ac, 0x1400, 1, 7) == FilterVerdict::ACCEPT);
+        assert(ac.admitted() == 4 && ac.rate_limited() == 1);
+    }
+
+    // Per-source limits with a default for all services; a service-specific limit overrides it
+    {
+        AdmissionControl ac(FilterVerdict::REJECT);
+        ac.set_source_limit(AdmissionControl::ANY_SERVICE, RateLimit{0, 1});
+        ac.set_source_limit(0x1400, RateLimit{0, 3});
+        assert(admit(ac, 0x1300, 1, 1, 5000) == FilterVerdict::ACCEPT);
+        assert(admit(ac, 0x1300, 1, 2, 5000) == FilterVerdict::REJECT);
+        assert(admit(ac, 0x1300, 1, 1, 5001) == FilterVerdict::ACCEPT);
+        for (int i = 0; i < 3; ++i) assert(admit(ac, 0x1400, 1, 1, 5000) == FilterVerdict::ACCEPT);
+        assert(admit(ac, 0x1400, 1, 1, 5000) == FilterVerdict::REJECT);
+    }
+
+    // Spoofed sources are capped: the least recently used bucket makes room, active ones stay
+    {
+        AdmissionControl ac;
+        ac.set_source_limit(AdmissionControl::ANY_SERVICE, RateLimit{0, 1});
+        assert(admit(ac, 0x1300, 1, 1, 1) == FilterVerdict::ACCEPT);
+        for (uint16_t port = 2; port < 2 * AdmissionControl::MAX_BUCKETS; ++port) {
+            assert(admit(ac, 0x1300, 1, 1, port) == FilterVerdict::ACCEPT);
+            if (port % 1024 == 0) assert(admit(ac, 0x1300, 1, 1, 1) == FilterVerdict::DROP);
+        }
+        assert(ac.buckets() == AdmissionControl::MAX_BUCKETS);
+        // Port 2 was forgotten and starts with a full burst again
+        assert(admit(ac, 0x1300, 1, 1, 2) == FilterVerdict::ACCEPT);
+    }
+
+    // REJECT over UDP: the second request never reaches the server and is answered with E_NOT_OK
+    {
+        auto server = create_udp_endpoint("127.0.0.1", 4030);
+        auto client = create_udp_endpoint("127.0.0.1", 4032);
+        assert(server && client);
+        AdmissionControl ac(FilterVerdict::REJECT);
+        ac.set_client_limit(0x1300, RateLimit{0, 1});
+        server->set_filter(ac.filter());
+        std::atomic<int> delivered{0};
+        server->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            delivered++;
+        });
+        std::mutex mutex;
+        std::condition_variable cv;
+        std::vector<SomeIpHeader> replies;
+        client->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+            std::lock_guard<std::mutex> lk(mutex);
+            replies.push_back(msg.header);
+            cv.notify_all();
+        });
+
+        Endpoint to_server("127.0.0.1", 4030);
+        SomeIpHeader first = header(0x1300, 0x0010, 0x0042);
+        SomeIpHeader second = first;
+        second.session_id = 2;
+        assert(client->send_to(first.serialize(), to_server));
+        assert(client->send_to(second.serialize(), to_server));
+
+        std::unique_lock<std::mutex> lk(mutex);
+        assert(cv.wait_for(lk, std::chrono::seconds(2), [&] { return !replies.empty(); }));
+        const SomeIpHeader& err = replies[0];
+        assert(err.message_type == static_cast<uint8_t>(MessageType::ERR));
+        assert(err.return_code == static_cast<uint8_t>(ReturnCode::E_NOT_OK));
+        assert(err.session_id == 2 && err.client_id == 0x0042 && err.length == SomeIpHeader::MIN_LENGTH);
+        assert(delivered == 1 && ac.rate_limited() == 1);
+    }
+
+    // Overload shedding: the lowest class goes first, then the next; class 0 always gets through
+    {
+        ServiceRegistry registry;
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool blocked = false, open = false;
+        registry.register_method(0x1300, 0x00FF, [&](const Payload&, const Endpoint&) {
+            std::unique_lock<std::mutex> lk(mutex);
+            blocked = true;
+            cv.notify_all();
+            cv.wait(lk, [&] { return open; });
+            return MethodResult{ReturnCode::E_OK, {}};
+        });
+        MessageRouter router(nullptr, registry);
+        DispatcherOptions options;
+        options.queue_capacity = 4;  // 12 slots over 3 classes
+        Dispatcher d(router, options);
+        d.set_class(0x1300, 1, 1);
+        d.set_class(0x1300, 2, 2);
+        assert(d.start());
+
+        AdmissionControl ac;
+        ac.attach(d, 0.5);
+        Endpoint ep("127.0.0.1", 1);
+        auto submit = [&](MethodId method) {
+            assert(d.submit(SomeIpMessage{header(0x1300, method, 1), {}}, ep, ep, TransportProtocol::UDP));
+        };
+        submit(0x00FF);
+        {
+            std::unique_lock<std::mutex> lk(mutex);
+            cv.wait(lk, [&] { return blocked; });
+        }
+        assert(ac.shed_level() == 0 && admit(ac, 0x1300, 2, 1) == FilterVerdict::ACCEPT);
+
+        for (int i = 0; i < 4; ++i) submit(1);
+        for (int i = 0; i < 3; ++i) submit(0);
+        assert(ac.shed_level() == 1);  // 7/12 queued
+        assert(admit(ac, 0x1300, 2, 1) == FilterVerdict::DROP);
+        assert(admit(ac, 0x1300, 1, 1) == FilterVerdict::ACCEPT);
+
+        for (int i = 0; i < 4; ++i) submit(2);
+        assert(ac.shed_level() == 2);  // 11/12 queued
+        assert(admit(ac, 0x1300, 1, 1) == FilterVerdict::DROP);
+        assert(admit(ac, 0x1300, 0, 1) == FilterVerdict::ACCEPT);
+        assert(ac.shed() == 2);
+
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            open = true;
+            cv.notify_all();
+        }
+        d.stop();
+        assert(ac.shed_level() == 0);
+
+        // Rising socket drops shed the lowest class for a while even with empty queues
+        ac.note_socket_drops(5);
+        assert(ac.shed_level() == 1 && admit(ac, 0x1300, 2, 1) == FilterVerdict::DROP);
+        std::this_thread::sleep_for(std::chrono::milliseconds(150));
+        ac.note_socket_drops(5);
+        assert(ac.shed_level() == 0 && admit(ac, 0x1300, 2, 1) == FilterVerdict::ACCEPT);
+    }
+
+    std::cout << "test_admission passed\n";
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "someip/api.hpp"
+#include "someip/buffer_pool.hpp"
+#include "someip/message_router.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+using namespace someip;
+
+// Count global operator new calls made by threads that opted in
+static thread_local bool counting = false;
+static std::atomic<int> global_news{0};
+
+void* operator new(size_t n) {
+    if (counting) global_news.fetch_add(1);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) {
+    return operator new(n);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+int main() {
+    // Blocks are recycled per class; sizes round up to the next power of two
+    void* a = pool::allocate(100);
+    pool::deallocate(a, 100);
+    void* b = pool::allocate(128);
+    assert(a == b);
+    pool::deallocate(b, 128);
+    assert(reinterpret_cast<uintptr_t>(pool::allocate(1)) % pool::MIN_BLOCK == 0);
+
+    Uint64 large = pool::stats().large_allocations;
+    void* big = pool::allocate(pool::MAX_BLOCK + 1);
+    assert(pool::stats().large_allocations == large + 1);
+    pool::deallocate(big, pool::MAX_BLOCK + 1);
+
+    // Payload copies, growth and blocks freed on another thread
+    Payload p = {1, 2, 3};
+    for (int i = 0; i < 5000; ++i) p.push_back(uint8_t(i));
+    Payload copy = p;
+    assert(copy == p && copy.size() == 5003);
+    std::thread([moved = std::move(copy)]() mutable { moved.clear(); moved.shrink_to_fit(); }).join();
+    std::vector<Payload> produced;
+    std::thread([&] {
+        for (int i = 0; i < 20000; ++i) produced.emplace_back(size_t(64 + i % 4000), uint8_t(i));
+    }).join();
+    for (size_t i = 0; i < produced.size(); ++i) assert(produced[i][0] == uint8_t(i));
+    produced.clear();  // spills the other thread's blocks into this thread's cache and back
+
+    // pmr view of the same pool
+    std::pmr::vector<uint8_t> v(pool::resource());
+    v.assign(300, 9);
+    assert(v[299] == 9);
+
+    // A full request/response cycle over UDP makes no global new calls once warmed up:
+    // parse, handler lookup, response payload, serialization and send all stay in the pool
+    auto server_ep = create_udp_endpoint("127.0.0.1", 4090);
+    auto client_ep = create_udp_endpoint("127.0.0.1", 4092);
+    assert(server_ep && client_ep);
+    ServiceRegistry registry;
+    registry.register_method(0x1000, 0x0001, [](const Payload& in, const Endpoint&) {
+        Payload out(in.rbegin(), in.rend());
+        out.resize(256);
+        return MethodResult{ReturnCode::E_OK, std::move(out)};
+    });
+    MessageRouter router(server_ep, registry);
+    const int WARMUP = 20, TOTAL = 200;
+    std::atomic<int> served{0};
+    server_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst,
+                                TransportProtocol proto) {
+        counting = served.load() >= WARMUP;
+        router.route(msg, src, dst, proto);
+        served.fetch_add(1);
+    });
+    std::atomic<int> responses{0};
+    client_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        if (msg.payload.size() == 256 && msg.payload[0] == 0x20) responses.fetch_add(1);
+    });
+    SomeIpHeader h{0x1000, 0x0001, SomeIpHeader::MIN_LENGTH + 33, 1, 1, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    Payload body(33, 0x10);
+    body.back() = 0x20;
+    Payload request = SomeIpMessage{h, body}.serialize();
+    Endpoint server_addr(std::string("127.0.0.1"), (uint16_t)4090);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    for (int i = 0; i < TOTAL && std::chrono::steady_clock::now() < deadline; ++i) {
+        int want = responses.load() + 1;
+        client_ep->send_to(request, server_addr);
+        while (responses.load() < want && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+    assert(responses.load() == TOTAL);
+#if SOMEIP_POOLED_PAYLOAD
+    assert(global_news.load() == 0);
+#endif
+
+    std::cout << "test_buffer_pool passed\n";
+    return 0;
+}
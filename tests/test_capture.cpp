@@ -0,0 +1,76 @@
+#include "someip/api.hpp"
+#include "someip/capture.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+int main() {
+    const std::string path = "test_capture.pcap";
+    auto capture = PacketCapture::open(path);
+    assert(capture);
+
+    auto server_ep = create_udp_endpoint("127.0.0.1", 4010);
+    assert(server_ep);
+    server_ep->set_capture(capture);
+    ServiceRegistry registry;
+    registry.register_method(0x1300, 0x0030, [](const Payload&, const Endpoint&) -> MethodResult {
+        return {ReturnCode::E_OK, {0x01}};
+    });
+    auto router = create_message_router(server_ep, registry);
+    server_ep->set_callback([&router](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+        router->route(msg, src, dst, proto);
+    });
+
+    auto client_ep = create_udp_endpoint("127.0.0.1", 4012);
+    assert(client_ep);
+    std::atomic<int> responses{0};
+    client_ep->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+        ++responses;
+    });
+
+    const int N = 20;
+    for (int i = 0; i < N; ++i) {
+        SomeIpHeader h{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH + 2, 0x0001, (SessionId)(i + 1), 1, 1,
+                       static_cast<uint8_t>(MessageType::REQUEST), 0};
+        SomeIpMessage req{h, {0xAB, (uint8_t)i}};
+        client_ep->send_to(req.serialize(), Endpoint("127.0.0.1", 4010));
+    }
+    for (int i = 0; i < 200 && responses < N; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    assert(responses == N);
+
+    server_ep->stop();
+    capture->close();
+    assert(capture->captured() == 2 * N);
+    assert(capture->dropped() == 0);
+
+    PcapReader reader;
+    assert(reader.open(path));
+    CapturedPacket pkt;
+    int requests = 0, replies = 0;
+    Uint64 last_ts = 0;
+    while (reader.next(pkt)) {
+        assert(pkt.timestamp_ns >= last_ts);
+        last_ts = pkt.timestamp_ns;
+        assert(pkt.src_ip == 0x7F000001 && pkt.dst_ip == 0x7F000001);
+        SomeIpMessage msg = SomeIpMessage::deserialize(pkt.data);
+        if (pkt.dst_port == 4010) {
+            assert(pkt.src_port == 4012);
+            assert(msg.header.message_type == static_cast<uint8_t>(MessageType::REQUEST));
+            assert(msg.payload.size() == 2 && msg.payload[1] == requests);
+            ++requests;
+        } else {
+            assert(pkt.src_port == 4010 && pkt.dst_port == 4012);
+            assert(msg.header.message_type == static_cast<uint8_t>(MessageType::RESPONSE));
+            ++replies;
+        }
+    }
+    assert(requests == N && replies == N);
+    std::remove(path.c_str());
+    std::cout << "test_capture passed\n";
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include "someip/crypto.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace someip;
+
+static Payload from_hex(const char* hex) {
+    Payload out;
+    for (size_t i = 0; hex[i] && hex[i + 1]; i += 2) {
+        out.push_back((uint8_t)std::stoi(std::string(hex + i, 2), nullptr, 16));
+    }
+    return out;
+}
+
+int main() {
+    assert(Crypto::is_available());
+
+    // AES-256-GCM known answer (GCM spec test case 16)
+    Crypto kat;
+    assert(kat.set_key(from_hex("feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308")));
+    Payload sealed = from_hex("cafebabefacedbaddecaf888");
+    Payload ct = from_hex("522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+                          "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662");
+    Payload tag = from_hex("76fc6ece0f4e1768cddf8853bb2d551b");
+    sealed.insert(sealed.end(), ct.begin(), ct.end());
+    sealed.insert(sealed.end(), tag.begin(), tag.end());
+    auto pt = kat.decrypt(sealed, from_hex("feedfacedeadbeeffeedfacedeadbeefabaddad2"));
+    assert(pt && *pt == from_hex("d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+                                 "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39"));
+
+    Crypto c;
+    assert(!c.encrypt({1, 2, 3}));  // no key yet
+    Payload k = Crypto::generate_key();
+    assert(c.set_key(k));
+
+    // Round trip, unique IVs, tamper detection
+    Payload msg = {1, 2, 3, 4, 5};
+    Payload aad = {9, 9};
+    auto a = c.encrypt(msg, aad);
+    auto b = c.encrypt(msg, aad);
+    assert(a && b && a->size() == msg.size() + Crypto::OVERHEAD);
+    assert(*a != *b);
+    assert(c.decrypt(*a, aad) == msg);
+    assert(!c.decrypt(*a, {9, 8}));
+    (*a)[Crypto::HEADROOM] ^= 1;
+    assert(!c.decrypt(*a, aad));
+
+    // Another context under the same key, or the same one re-keyed, does not restart the IVs
+    Crypto twin;
+    assert(twin.set_key(k));
+    auto t = twin.encrypt(msg, aad);
+    assert(t && !std::equal(t->begin(), t->begin() + Crypto::HEADROOM, b->begin()));
+    assert(c.set_key(k));
+    auto r = c.encrypt(msg, aad);
+    assert(r && !std::equal(r->begin(), r->begin() + Crypto::HEADROOM, b->begin()) && twin.decrypt(*r, aad) == msg);
+
+    // In-place with reserved headroom/tailroom
+    Payload buf(Crypto::HEADROOM + msg.size() + Crypto::TAILROOM);
+    std::copy(msg.begin(), msg.end(), buf.begin() + Crypto::HEADROOM);
+    assert(c.encrypt_in_place(buf.data(), msg.size()));
+    assert(c.decrypt_in_place(buf.data(), buf.size()));
+    assert(std::equal(msg.begin(), msg.end(), buf.begin() + Crypto::HEADROOM));
+
+    // Batch
+    std::vector<Payload> bufs(8, Payload(Crypto::OVERHEAD + 100, 0x42));
+    std::vector<Crypto::BufferRef> refs;
+    for (auto& p : bufs) refs.push_back({p.data(), 100, false});
+    assert(c.encrypt_batch(refs.data(), refs.size()) == refs.size());
+    for (auto& r : refs) r.len += Crypto::OVERHEAD;
+    assert(c.decrypt_batch(refs.data(), refs.size()) == refs.size());
+    assert(bufs[7][Crypto::HEADROOM + 99] == 0x42);
+
+    // Helpers
+    assert(Crypto::sha256({}) == from_hex("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"));
+    Payload key(20, 0x0b);
+    Payload hi = {'H', 'i', ' ', 'T', 'h', 'e', 'r', 'e'};
+    assert(Crypto::hmac_sha256(key, hi) ==
+           from_hex("b0344c61d8db38535ca8afceaf0bf12b881dc200c9833da726e9376c2e32cff7"));
+    assert(Crypto::derive_key("pw", {1, 2, 3}, 1000).size() == Crypto::AES_KEY_SIZE);
+
+    // Secure SOME/IP messages
+    Payload psk = Crypto::generate_key();
+    SecureCommunication tx, rx;
+    assert(tx.set_psk(psk) && rx.set_psk(psk));
+    SomeIpMessage m{SomeIpHeader{0x1300, 0x0010, SomeIpHeader::MIN_LENGTH + 3, 1, 7, 1, 1,
+                                 static_cast<uint8_t>(MessageType::REQUEST), 0}, {0xA, 0xB, 0xC}};
+    auto wire = tx.encrypt_message(m);
+    assert(wire);
+    auto back = rx.decrypt_message(*wire);
+    assert(back && back->payload == m.payload && back->header.session_id == 7 &&
+           back->header.length == m.header.length);
+    assert(!rx.decrypt_message(*wire) && rx.replays_rejected() == 1);
+    auto wire2 = tx.encrypt_message(m);
+    (*wire2)[8] ^= 0x01;  // header byte inside the AAD
+    assert(!rx.decrypt_message(*wire2));
+
+    // Anti-replay window: reordering inside the window is fine, duplicates and stale numbers are not
+    ReplayWindow win;
+    assert(win.check_and_update(100) && win.check_and_update(98) && win.check_and_update(99));
+    assert(!win.check_and_update(98) && win.is_stale(99));
+    assert(win.check_and_update(100 + ReplayWindow::WINDOW));
+    assert(!win.check_and_update(100) && !win.check_and_update(97) && win.is_stale(100));
+    assert(!win.is_stale(101) && win.check_and_update(101));
+    assert(win.check_and_update(101 + ReplayWindow::WINDOW) && !win.check_and_update(101));
+
+    // Concurrent senders and receivers share one instance each
+    SecureCommunication ctx, crx;
+    assert(ctx.set_psk(psk) && crx.set_psk(psk));
+    std::vector<std::vector<Payload>> sent(4);
+    std::vector<std::thread> threads;
+    for (auto& out : sent) {
+        threads.emplace_back([&ctx, &out, &m] {
+            for (int i = 0; i < 200; ++i) out.push_back(*ctx.encrypt_message(m));
+        });
+    }
+    for (auto& t : threads) t.join();
+    threads.clear();
+    std::atomic<int> accepted{0};
+    for (auto& in : sent) {
+        threads.emplace_back([&crx, &in, &accepted] {
+            for (const auto& w : in) accepted += crx.decrypt_message(w).has_value();
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(accepted == 800 && ctx.current_sequence() == 800);
+    assert(!crx.decrypt_message(sent[2][17]));
+
+    std::cout << "test_crypto passed\n";
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "someip/dispatcher.hpp"
+#include "someip/service.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+static SomeIpMessage request(MethodId method) {
+    return SomeIpMessage{SomeIpHeader{0x1300, method, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                                      static_cast<uint8_t>(MessageType::REQUEST), 0}, {}};
+}
+
+// Handlers record the order they ran in; method 0x00FF blocks until released so the tests
+// can fill the queues first
+struct Harness {
+    ServiceRegistry registry;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool gate_open = false;
+    bool blocked = false;
+    std::vector<MethodId> order;
+    Endpoint ep{"127.0.0.1", 1};
+
+    Harness() {
+        registry.register_method(0x1300, 0x00FF, [this](const Payload&, const Endpoint&) {
+            std::unique_lock<std::mutex> lk(mutex);
+            blocked = true;
+            cv.notify_all();
+            cv.wait(lk, [this] { return gate_open; });
+            return MethodResult{ReturnCode::E_OK, {}};
+        });
+        for (MethodId m = 1; m <= 3; ++m) {
+            registry.register_method(0x1300, m, [this, m](const Payload&, const Endpoint&) {
+                std::lock_guard<std::mutex> lk(mutex);
+                order.push_back(m);
+                return MethodResult{ReturnCode::E_OK, {}};
+            });
+        }
+    }
+
+    void block(Dispatcher& d) {
+        d.submit(request(0x00FF), ep, ep, TransportProtocol::UDP);
+        std::unique_lock<std::mutex> lk(mutex);
+        cv.wait(lk, [this] { return blocked; });
+    }
+    void release() {
+        std::lock_guard<std::mutex> lk(mutex);
+        gate_open = true;
+        cv.notify_all();
+    }
+    size_t wait_for(size_t n) {
+        for (int i = 0; i < 2000; ++i) {
+            {
+                std::lock_guard<std::mutex> lk(mutex);
+                if (order.size() >= n) return order.size();
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return order.size();
+    }
+};
+
+int main() {
+    // Strict priority: queued brake commands (class 0) overtake earlier diagnostics (class 2)
+    {
+        Harness h;
+        MessageRouter router(nullptr, h.registry);
+        Dispatcher d(router);
+        d.set_class(0x1300, 1, 0);
+        d.set_class(0x1300, 3, 2);
+        d.set_class(0x1300, 0x00FF, 2);
+        assert(d.start());
+        h.block(d);
+        for (int i = 0; i < 3; ++i) assert(d.submit(request(3), h.ep, h.ep, TransportProtocol::UDP));
+        for (int i = 0; i < 2; ++i) assert(d.submit(request(1), h.ep, h.ep, TransportProtocol::UDP));
+        assert(d.stats(2).depth == 3 && d.stats(0).depth == 2);
+        h.release();
+        assert(h.wait_for(5) == 5);
+        assert(h.order == std::vector<MethodId>({1, 1, 3, 3, 3}));
+        assert(d.stats(0).dispatched == 2 && d.stats(0).queue_delay.count() == 2);
+    }
+
+    // Weighted fair: 3:1 turns while both classes are backlogged
+    {
+        Harness h;
+        MessageRouter router(nullptr, h.registry);
+        DispatcherOptions options;
+        options.policy = DispatchPolicy::WEIGHTED_FAIR;
+        options.classes = 2;
+        options.weights = {3, 1};
+        options.default_class = 1;
+        Dispatcher d(router, options);
+        d.set_class(0x1300, 1, 0);
+        assert(d.start());
+        h.block(d);
+        for (int i = 0; i < 6; ++i) assert(d.submit(request(1), h.ep, h.ep, TransportProtocol::UDP));
+        for (int i = 0; i < 3; ++i) assert(d.submit(request(2), h.ep, h.ep, TransportProtocol::UDP));
+        h.release();
+        assert(h.wait_for(9) == 9);
+        assert(h.order == std::vector<MethodId>({1, 1, 1, 2, 1, 1, 1, 2, 2}));
+    }
+
+    // Deadlines: requests that expire in the queue never reach the handler; full queues drop
+    {
+        Harness h;
+        MessageRouter router(nullptr, h.registry);
+        DispatcherOptions options;
+        options.queue_capacity = 2;
+        Dispatcher d(router, options);
+        d.set_class(0x1300, 1, 0, std::chrono::microseconds(1000));
+        assert(d.start());
+        h.block(d);
+        assert(d.submit(request(1), h.ep, h.ep, TransportProtocol::UDP));
+        assert(d.submit(request(2), h.ep, h.ep, TransportProtocol::UDP, Dispatcher::now_ns() + 60000000000ULL));
+        assert(!d.submit(request(2), h.ep, h.ep, TransportProtocol::UDP));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        h.release();
+        assert(h.wait_for(1) == 1 && h.order[0] == 2);
+        auto s = d.stats(0);
+        assert(s.expired == 1 && s.rejected == 1 && s.dispatched == 2);
+        assert(s.queue_delay.max() >= 5000000);
+    }
+
+    // Expired requests of a protected method are dropped unanswered; their checks never ran
+    {
+        struct CountingStage : ProtectionStage {
+            std::atomic<int> protected_count{0};
+            bool check(const SomeIpHeader&, Payload&) override { return true; }
+            bool protect(const SomeIpHeader&, Payload&) override {
+                ++protected_count;
+                return true;
+            }
+        };
+        Harness h;
+        MessageRouter router(nullptr, h.registry);
+        auto stage = std::make_shared<CountingStage>();
+        router.add_protection(0x1300, 1, stage);
+        Dispatcher d(router);
+        d.set_class(0x1300, 1, 0, std::chrono::microseconds(1000));
+        assert(d.start());
+        h.block(d);
+        assert(d.submit(request(1), h.ep, h.ep, TransportProtocol::UDP));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        h.release();
+        for (int i = 0; i < 2000 && d.stats(0).expired == 0; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        assert(d.stats(0).expired == 1 && stage->protected_count == 0 && h.order.empty());
+    }
+
+    // Receive timestamps travel with the request to the handler
+    {
+        ServiceRegistry registry;
+        RxTimestamp seen;
+        std::atomic<bool> done{false};
+        registry.register_method(0x1300, 4, [&](const Payload&, const Endpoint&) {
+            seen = MessageRouter::current_request()->rx;
+            done = true;
+            return MethodResult{ReturnCode::E_OK, {}};
+        });
+        MessageRouter router(nullptr, registry);
+        Dispatcher d(router);
+        assert(d.start());
+        SomeIpMessage msg = request(4);
+        msg.rx.kernel_ns = 1111;
+        msg.rx.user_ns = 2222;
+        msg.rx.hardware = true;
+        Endpoint ep{"127.0.0.1", 1};
+        assert(d.submit(msg, ep, ep, TransportProtocol::UDP));
+        for (int i = 0; i < 2000 && !done; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        assert(done && seen.kernel_ns == 1111 && seen.user_ns == 2222 && seen.hardware);
+    }
+
+    std::cout << "test_dispatcher passed\n";
+    return 0;
+}
@@ -0,0 +1,175 @@
+#include "someip/api.hpp"
+#include "someip/duplicate_window.hpp"
+#include "someip/loopback.hpp"
+#include "someip/metrics.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+constexpr ServiceId SVC = 0x5200;
+constexpr MethodId PRESS = 0x0010, NESTED = 0x0020, SECURED = 0x0030;
+
+// Accepts each trailing counter value once, like a SecOC freshness check
+struct ReplayCheck : ProtectionStage {
+    int last = -1;
+    bool check(const SomeIpHeader&, Payload& payload) override {
+        if (payload.empty() || int(payload.back()) <= last) return false;
+        last = payload.back();
+        payload.pop_back();
+        return true;
+    }
+    bool protect(const SomeIpHeader&, Payload&) override { return true; }
+};
+
+SomeIpMessage request(MethodId method, ClientId client, SessionId session, Payload payload) {
+    return SomeIpMessage{SomeIpHeader{SVC, method, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + payload.size()), client,
+                                      session, 1, 1, static_cast<uint8_t>(MessageType::REQUEST), 0},
+                         std::move(payload)};
+}
+
+int main() {
+    // The window on its own
+    {
+        DuplicateWindowOptions options;
+        options.clients = 16;  // one per shard
+        options.requests_per_client = 2;
+        options.max_response = 4;
+        DuplicateWindow window(options);
+        Payload out;
+        DuplicateWindow::Key a{0x0001, 1, SVC, PRESS, 0xAAAA};
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::NEW);
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::IN_PROGRESS);
+        window.complete(a, Payload{1, 2});
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::DUPLICATE && out == Payload({1, 2}));
+
+        // Same session, other payload: a new request replaces the entry
+        DuplicateWindow::Key a2 = a;
+        a2.payload_crc = 0xBBBB;
+        assert(window.begin(a2, out) == DuplicateWindow::Verdict::NEW);
+        window.abandon(a2);
+        assert(window.begin(a2, out) == DuplicateWindow::Verdict::NEW);
+        window.complete(a2, Payload{1, 2, 3, 4, 5});  // above max_response: not kept
+        assert(window.begin(a2, out) == DuplicateWindow::Verdict::NEW);
+        window.complete(a2, Payload{9});
+
+        // Two requests per client: the third pushes out the oldest
+        DuplicateWindow::Key b = a, c = a;
+        b.session = 2;
+        c.session = 3;
+        window.begin(b, out);
+        window.complete(b, Payload{2});
+        window.begin(c, out);
+        window.complete(c, Payload{3});
+        assert(window.begin(a2, out) == DuplicateWindow::Verdict::NEW);
+        window.complete(a2, Payload{9});
+        assert(window.begin(c, out) == DuplicateWindow::Verdict::DUPLICATE);
+
+        // One client per shard: 0x0011 shares 0x0001's shard and displaces it
+        DuplicateWindow::Key other{0x0011, 1, SVC, PRESS, 0xAAAA};
+        assert(window.begin(other, out) == DuplicateWindow::Verdict::NEW);
+        window.complete(other, Payload{7});
+        assert(window.begin(c, out) == DuplicateWindow::Verdict::NEW);
+
+        // The same IDs from another address or port are another client
+        DuplicateWindow::Key moved = other, elsewhere = other;
+        moved.source_port = 40001;
+        elsewhere.source_addr = 0x0A000003;
+        assert(window.begin(moved, out) == DuplicateWindow::Verdict::NEW);
+        assert(window.begin(elsewhere, out) == DuplicateWindow::Verdict::NEW);
+    }
+    // Entries older than max_age no longer answer
+    {
+        DuplicateWindowOptions options;
+        options.max_age = std::chrono::milliseconds(20);
+        DuplicateWindow window(options);
+        Payload out;
+        DuplicateWindow::Key a{0x0001, 1, SVC, PRESS, 0xAAAA, 0x0A000002, 40000};
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::NEW);
+        window.complete(a, Payload{1});
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::DUPLICATE);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        assert(window.begin(a, out) == DuplicateWindow::Verdict::NEW);
+    }
+
+    auto net = LoopbackNetwork::create();
+    auto server_ep = net->create_endpoint("10.0.0.1", 30501);
+    auto client_ep = net->create_endpoint("10.0.0.2", 40000);
+    auto other_ep = net->create_endpoint("10.0.0.3", 40000);
+    ServiceRegistry registry;
+    std::unique_ptr<MessageRouter> router;
+    int presses = 0, nested = 0, secured = 0;
+    registry.register_method(SVC, PRESS, [&](const Payload& in, const Endpoint&) -> MethodResult {
+        ++presses;
+        return {ReturnCode::E_OK, Payload{in.empty() ? Uint8(0) : in[0], static_cast<Uint8>(presses)}};
+    });
+    registry.register_method(SVC, NESTED, [&](const Payload&, const Endpoint& src) -> MethodResult {
+        // A retransmission arriving while the original runs is not handled twice
+        if (++nested == 1) router->route(*MessageRouter::current_request(), src, src, TransportProtocol::UDP);
+        return {ReturnCode::E_OK, {}};
+    });
+    registry.register_method(SVC, SECURED, [&](const Payload&, const Endpoint&) -> MethodResult {
+        ++secured;
+        return {ReturnCode::E_OK, Payload{0x5E}};
+    });
+    router = create_message_router(server_ep, registry);
+    router->add_protection(SVC, SECURED, std::make_shared<ReplayCheck>());
+    router->enable_duplicate_detection();
+    server_ep->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) {
+        router->route(m, s, d, p);
+    });
+    std::vector<SomeIpMessage> replies;
+    client_ep->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) {
+        replies.push_back(m);
+    });
+    std::vector<SomeIpMessage> other_replies;
+    other_ep->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) {
+        other_replies.push_back(m);
+    });
+    assert(server_ep->start() && client_ep->start() && other_ep->start());
+    const Endpoint server("10.0.0.1", 30501);
+    auto send = [&](const SomeIpMessage& m) {
+        client_ep->send_to(m.serialize(), server);
+        net->run();
+    };
+
+    // A retry after a lost response gets the original answer; the brake is pressed once
+    send(request(PRESS, 0x0001, 5, {0x01}));
+    send(request(PRESS, 0x0001, 5, {0x01}));
+    assert(presses == 1 && replies.size() == 2);
+    assert(replies[0].serialize() == replies[1].serialize() && replies[1].payload == Payload({0x01, 1}));
+
+    // New sessions, other clients and untracked session 0 all run the handler
+    send(request(PRESS, 0x0001, 6, {0x01}));
+    send(request(PRESS, 0x0002, 5, {0x01}));
+    send(request(PRESS, 0x0001, 0, {0x01}));
+    send(request(PRESS, 0x0001, 0, {0x01}));
+    assert(presses == 5 && replies.size() == 6 && replies.back().payload == Payload({0x01, 5}));
+
+    // Another ECU reusing client 0x0001 and session 5 is not answered with the first one's reply
+    other_ep->send_to(request(PRESS, 0x0001, 5, {0x01}).serialize(), server);
+    net->run();
+    assert(presses == 6 && other_replies.size() == 1 && other_replies[0].payload == Payload({0x01, 6}));
+
+    send(request(NESTED, 0x0001, 7, {}));
+    assert(nested == 1 && replies.size() == 7);
+
+    // The retry carries the same freshness value, which the protection check would refuse
+    send(request(SECURED, 0x0001, 8, {0x00, 3}));
+    send(request(SECURED, 0x0001, 8, {0x00, 3}));
+    assert(secured == 1 && replies.size() == 9 && replies.back().payload == Payload({0x5E}));
+    // A request that fails its check leaves no entry behind
+    send(request(SECURED, 0x0001, 9, {0x00, 2}));
+    assert(replies.size() == 9);
+
+    if (metrics::enabled) {
+        metrics::Snapshot snap = metrics::snapshot();
+        assert(snap.find(SVC, PRESS)->duplicates == 1 && snap.find(SVC, NESTED)->duplicates == 1);
+        assert(snap.find(SVC, SECURED)->duplicates == 1 && snap.find(SVC, SECURED)->dropped == 1);
+    }
+
+    std::cout << "test_duplicates passed\n";
+    return 0;
+}
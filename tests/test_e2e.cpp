@@ -0,0 +1,168 @@
+#include "someip/e2e.hpp"
+#include "someip/crc.hpp"
+#include "someip/message_router.hpp"
+#include "someip/service.hpp"
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+using namespace someip;
+
+// Bitwise reference for the reflected 32-bit CRCs
+static Uint32 reference32(Uint32 poly, const uint8_t* data, size_t len) {
+    Uint32 crc = 0xFFFFFFFF;
+    for (size_t i = 0; i < len; ++i) {
+        crc ^= data[i];
+        for (int b = 0; b < 8; ++b) crc = (crc >> 1) ^ (poly & (0u - (crc & 1)));
+    }
+    return ~crc;
+}
+
+static SomeIpHeader request_header() {
+    return SomeIpHeader{0x1300, 0x0010, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                        static_cast<uint8_t>(MessageType::REQUEST), 0};
+}
+
+int main() {
+    // Catalogue check values
+    const uint8_t* check = reinterpret_cast<const uint8_t*>("123456789");
+    assert(crc::crc8(check, 9) == 0x4B);
+    assert(crc::crc8h2f(check, 9) == 0xDF);
+    assert(crc::crc16(check, 9) == 0x29B1);
+    assert(crc::crc32(check, 9) == 0xCBF43926);
+    assert(crc::crc32c(check, 9) == 0xE3069283);
+    assert(crc::crc32p4(check, 9) == 0x1697D06A);
+
+    // Hardware and table kernels agree with the bitwise reference for every length and
+    // alignment around the folding block sizes, and chaining matches one-shot results
+    Payload data(4096 + 64);
+    for (size_t i = 0; i < data.size(); ++i) data[i] = uint8_t(i * 131 + (i >> 7));
+    for (int hw = 1; hw >= 0; --hw) {
+        crc::set_hardware_enabled(hw != 0);
+        for (size_t len = 0; len <= 300; ++len) {
+            for (size_t off = 0; off < 3; ++off) {
+                const uint8_t* p = data.data() + off;
+                assert(crc::crc32(p, len) == reference32(0xEDB88320, p, len));
+                assert(crc::crc32c(p, len) == reference32(0x82F63B78, p, len));
+                assert(crc::crc32p4(p, len) == reference32(0xC8DF352F, p, len));
+            }
+        }
+        size_t n = data.size(), split = 1000;
+        assert(crc::crc32(data.data() + split, n - split, crc::crc32(data.data(), split)) ==
+               reference32(0xEDB88320, data.data(), n));
+        assert(crc::crc32c(data.data() + split, n - split, crc::crc32c(data.data(), split)) ==
+               reference32(0x82F63B78, data.data(), n));
+        assert(crc::crc16(data.data() + 7, n - 7, crc::crc16(data.data(), 7)) == crc::crc16(data.data(), n));
+        assert(crc::crc8(data.data() + 7, n - 7, crc::crc8(data.data(), 7)) == crc::crc8(data.data(), n));
+    }
+    assert(std::strcmp(crc::crc32_implementation(), "slice8") == 0);
+    crc::set_hardware_enabled(true);
+
+    // Invalid configurations
+    E2EConfig bad;
+    bad.profile = E2EProfile::P01;
+    bad.data_id = 0x12345;
+    assert(!E2EStage::create(bad));
+    bad.data_id = 1;
+    bad.max_delta_counter = 0;
+    assert(!E2EStage::create(bad));
+    bad.max_delta_counter = 1;
+    bad.max_peers = 0;
+    assert(!E2EStage::create(bad));
+
+    SomeIpHeader h = request_header();
+    for (E2EProfile profile : {E2EProfile::P01, E2EProfile::P05, E2EProfile::P04, E2EProfile::P04_CRC32C}) {
+        E2EConfig config;
+        config.profile = profile;
+        config.data_id = 0x0123;
+        config.max_delta_counter = 2;
+        auto tx = E2EStage::create(config);
+        auto rx = E2EStage::create(config);
+        size_t hs = tx->header_size();
+
+        // Round trip strips the header
+        Payload p = {1, 2, 3, 4};
+        assert(tx->protect(h, p) && p.size() == 4 + hs);
+        Payload repeated = p;
+        assert(rx->check(h, p) && p == Payload({1, 2, 3, 4}));
+
+        // Same counter again, then every single-bit flip is detected
+        assert(rx->check_status(repeated.data(), repeated.size()) == E2EStatus::REPEATED);
+        Payload next = {5, 6, 7};
+        assert(tx->protect(h, next));
+        for (size_t bit = 0; bit < next.size() * 8; ++bit) {
+            Payload corrupt = next;
+            corrupt[bit / 8] ^= uint8_t(1 << (bit % 8));
+            assert(rx->check_status(corrupt.data(), corrupt.size()) == E2EStatus::ERROR);
+        }
+        assert(rx->check_status(next.data(), hs - 1) == E2EStatus::ERROR);
+
+        // A different data ID never verifies
+        E2EConfig other = config;
+        other.data_id = 0x0124;
+        assert(E2EStage::create(other)->check_status(next.data(), next.size()) == E2EStatus::ERROR);
+        assert(rx->check(h, next));
+
+        // One lost message is within max_delta_counter, three are not (and resynchronize)
+        Payload skip = {1};
+        tx->protect(h, skip);
+        skip = {1};
+        tx->protect(h, skip);
+        assert(rx->check_status(skip.data(), skip.size()) == E2EStatus::OK);
+        for (int i = 0; i < 3; ++i) {
+            skip = {1};
+            tx->protect(h, skip);
+        }
+        assert(rx->check_status(skip.data(), skip.size()) == E2EStatus::WRONG_SEQUENCE);
+        skip = {1};
+        tx->protect(h, skip);
+        assert(rx->check_status(skip.data(), skip.size()) == E2EStatus::OK);
+
+        // The counter wraps without a sequence error
+        for (int i = 0; i < 300; ++i) {
+            Payload w = {uint8_t(i)};
+            assert(tx->protect(h, w) && rx->check(h, w) && w[0] == uint8_t(i));
+        }
+        assert(rx->count(E2EStatus::REPEATED) == 1 && rx->count(E2EStatus::WRONG_SEQUENCE) == 1);
+    }
+
+    // Router integration: corrupted requests never reach the handler
+    ServiceRegistry registry;
+    int calls = 0;
+    registry.register_method(0x1300, 0x0010, [&](const Payload& in, const Endpoint&) {
+        ++calls;
+        assert(in == Payload({9}));
+        return MethodResult{ReturnCode::E_OK, {}};
+    });
+    E2EConfig config;
+    config.data_id = 0xCAFE;
+    auto tx = E2EStage::create(config);
+    auto rx = E2EStage::create(config);
+    MessageRouter router(nullptr, registry);
+    router.add_protection(0x1300, 0x0010, rx);
+    Endpoint src{"127.0.0.1", 1};
+    SomeIpMessage protected_msg{h, {9}};
+    assert(tx->protect(h, protected_msg.payload));
+    SomeIpMessage corrupt = protected_msg;
+    corrupt.payload.back() ^= 0x80;
+    router.route(corrupt, src, src, TransportProtocol::UDP);
+    assert(calls == 0);
+    router.route(protected_msg, src, src, TransportProtocol::UDP);
+    assert(calls == 1);
+
+    // Two clients with their own counters interleave without REPEATED or WRONG_SEQUENCE
+    auto tx2 = E2EStage::create(config);
+    Endpoint src2{"127.0.0.1", 2};
+    for (int i = 0; i < 4; ++i) {
+        SomeIpMessage a{h, {9}}, b{h, {9}};
+        assert(tx->protect(h, a.payload) && tx2->protect(h, b.payload));
+        router.route(a, src, src, TransportProtocol::UDP);
+        router.route(b, src2, src2, TransportProtocol::UDP);
+    }
+    assert(calls == 9);
+    assert(rx->count(E2EStatus::REPEATED) == 0 && rx->count(E2EStatus::WRONG_SEQUENCE) == 0);
+    assert(rx->peers() == 2);
+
+    std::cout << "test_e2e passed\n";
+    return 0;
+}
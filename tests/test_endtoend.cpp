@@ -4,6 +4,7 @@
 #include <thread>
 #include <chrono>
 #include <cassert>
+#include <future>
 #include <iostream>
 
 using namespace someip;
@@ -19,6 +20,15 @@ int main() {
         r.payload = {0xAA};
         return r;
     });
+    // Buffer form: the response is written in place behind the header headroom
+    registry.register_method(0x1000, 0x0002, [](const Payload& p, const Endpoint&, SerializationBuffer& out) {
+        assert(out.buf.size() == SomeIpHeader::SIZE);
+        out.write_uint16(0xBEEF);
+        out.write_bytes(p);
+        return ReturnCode::E_OK;
+    });
+    auto adapted = registry.find_handler(0x1000, 0x0002);
+    assert(adapted && (*adapted)({7}, Endpoint("127.0.0.1", 1)).payload == Payload({0xBE, 0xEF, 7}));
     auto router = create_message_router(server_ep, registry);
     server_ep->set_callback([&router](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto){
         router->route(msg, src, dst, proto);
@@ -27,10 +37,16 @@ int main() {
     // Start client endpoint
     auto client_ep = create_udp_endpoint("127.0.0.1", 4002);
     assert(client_ep);
-    bool received = false;
+    std::promise<void> received, received_buffer;
+    auto received_future = received.get_future();
+    auto received_buffer_future = received_buffer.get_future();
     client_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol){
         if (msg.header.message_type == static_cast<uint8_t>(MessageType::RESPONSE)) {
-            if (!msg.payload.empty() && msg.payload[0] == 0xAA) received = true;
+            if (msg.header.method_id == 0x0001 && !msg.payload.empty() && msg.payload[0] == 0xAA) received.set_value();
+            if (msg.header.method_id == 0x0002 && msg.header.length == SomeIpHeader::MIN_LENGTH + 4 &&
+                msg.payload == Payload({0xBE, 0xEF, 1, 2})) {
+                received_buffer.set_value();
+            }
         }
     });
 
@@ -48,9 +64,17 @@ int main() {
     SomeIpMessage req{h, {}};
     client_ep->send_to(req.serialize(), std::make_pair(std::string("127.0.0.1"), (uint16_t)4000));
 
-    // wait a bit
-    std::this_thread::sleep_for(std::chrono::seconds(1));
-    assert(received);
+    // wait for the response (returns as soon as it arrives)
+    bool ok = received_future.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+    assert(ok);
+
+    h.method_id = 0x0002;
+    h.length = SomeIpHeader::MIN_LENGTH + 2;
+    SomeIpMessage buffer_req{h, {1, 2}};
+    client_ep->send_to(buffer_req.serialize(), std::make_pair(std::string("127.0.0.1"), (uint16_t)4000));
+    ok = received_buffer_future.wait_for(std::chrono::seconds(2)) == std::future_status::ready;
+    assert(ok);
+    (void)ok;
     std::cout << "test_endtoend passed\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "someip/api.hpp"
+#include "someip/field.hpp"
+#include "someip/loopback.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+static std::mutex seen_mutex;
+static std::vector<Payload> seen;
+
+static size_t wait_for(size_t count) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    for (;;) {
+        {
+            std::lock_guard<std::mutex> lk(seen_mutex);
+            if (seen.size() >= count || std::chrono::steady_clock::now() > deadline) return seen.size();
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+static Payload call(ServiceRegistry& registry, MethodId method, const Payload& in, ReturnCode& rc) {
+    auto m = registry.lookup(0x1300, method);
+    assert(m && m->buffer_handler);
+    SerializationBuffer out;
+    out.buf.resize(SomeIpHeader::SIZE);
+    rc = m->buffer_handler(in, Endpoint("127.0.0.1", 1), out);
+    return Payload(out.buf.begin() + SomeIpHeader::SIZE, out.buf.end());
+}
+
+int main() {
+    // Codec: big-endian integers and floats
+    SerializationBuffer buf;
+    FieldCodec<Uint32>::write(buf, 0x01020304);
+    FieldCodec<float>::write(buf, 1.5f);
+    assert(buf.buf == Payload({1, 2, 3, 4, 0x3F, 0xC0, 0, 0}));
+    DeserializationBuffer in(buf.buf);
+    assert(FieldCodec<Uint32>::read(in) == 0x01020304 && FieldCodec<float>::read(in) == 1.5f);
+
+    auto server = create_udp_endpoint("127.0.0.1", 4020);
+    auto client = create_udp_endpoint("127.0.0.1", 4022);
+    assert(server && client);
+    client->set_callback([](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        assert(msg.header.message_type == static_cast<uint8_t>(MessageType::NOTIFICATION));
+        assert(msg.header.method_id == 0x8030);
+        std::lock_guard<std::mutex> lk(seen_mutex);
+        seen.push_back(msg.payload);
+    });
+
+    FieldOptions options;
+    options.getter = 0x0030;
+    options.setter = 0x0031;
+    options.notifier = 0x8030;
+    Field<Uint16> speed(0x1300, options, 100, [](const Uint16& v) { return v <= 300; });
+    ServiceRegistry registry;
+    speed.attach(registry, server);
+
+    // Getters answer from the cache
+    ReturnCode rc;
+    assert(call(registry, 0x0030, {}, rc) == Payload({0, 100}) && rc == ReturnCode::E_OK);
+    assert(speed.getter_hits() == 1);
+
+    // Subscribing sends the current value; unchanged values are not sent again
+    Endpoint subscriber("127.0.0.1", 4022);
+    speed.subscribe(subscriber);
+    assert(wait_for(1) == 1);
+    assert(speed.set(100) && speed.notifications_suppressed() == 1);
+    assert(speed.set(120));
+    assert(wait_for(2) == 2 && seen[1] == Payload({0, 120}));
+
+    // Setter: validated, malformed requests rejected, response carries the current value
+    assert(call(registry, 0x0031, {0x01, 0x2C}, rc) == Payload({0x01, 0x2C}) && rc == ReturnCode::E_OK);
+    assert(speed.get() == 300 && wait_for(3) == 3);
+    assert(call(registry, 0x0031, {0x01, 0x2D}, rc) == Payload({0x01, 0x2C}) && rc == ReturnCode::E_NOT_OK);
+    assert(call(registry, 0x0031, {0x01}, rc) == Payload({0x01, 0x2C}) && rc == ReturnCode::E_MALFORMED_MESSAGE);
+    assert(!speed.set(301) && speed.get() == 300);
+
+    // Change threshold: small steps update the getter value but are not notified
+    speed.set_change_threshold(10);
+    assert(speed.set(295) && speed.set(292));
+    assert(call(registry, 0x0030, {}, rc) == Payload({0x01, 0x24}));
+    assert(speed.set(289));
+    assert(wait_for(4) == 4 && seen[3] == Payload({0x01, 0x21}));
+
+    // Cyclic notifications repeat the value even when it does not change
+    FieldOptions cyclic = options;
+    cyclic.getter = cyclic.setter = 0;
+    cyclic.cycle = std::chrono::milliseconds(5);
+    Field<Uint8> status(0x1300, cyclic, 1);
+    status.attach(registry, server);
+    status.subscribe(subscriber);
+    assert(status.notifications_sent() == 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    status.poll();
+    assert(status.notifications_sent() == 2 && wait_for(6) == 6 && seen[5] == Payload({1}));
+
+    // Session IDs run 1..0xFFFF and wrap to 1, never 0 and never 1 twice in a row
+    {
+        auto net = LoopbackNetwork::create();
+        auto field_ep = net->create_endpoint("10.0.0.1", 30501);
+        auto sub_ep = net->create_endpoint("10.0.0.2", 40000);
+        std::vector<SessionId> sessions;
+        sub_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+            sessions.push_back(msg.header.session_id);
+        });
+        assert(field_ep->start() && sub_ep->start());
+        FieldOptions plain = options;
+        plain.getter = plain.setter = 0;
+        Field<Uint32> counter(0x1300, plain, 0);
+        ServiceRegistry counter_registry;
+        counter.attach(counter_registry, field_ep);
+        counter.subscribe(Endpoint("10.0.0.2", 40000));
+        for (Uint32 v = 1; v <= 0x10001; ++v) {
+            counter.set(v);
+            if (v % 4096 == 0) net->run();
+        }
+        net->run();
+        assert(sessions.size() == 0x10002);
+        for (size_t i = 0; i < sessions.size(); ++i) assert(sessions[i] == i % 0xFFFF + 1);
+    }
+
+    std::cout << "test_field passed\n";
+    return 0;
+}
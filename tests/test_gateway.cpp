@@ -0,0 +1,149 @@
+#include "someip/api.hpp"
+#include "someip/gateway.hpp"
+#include "someip/loopback.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+constexpr ServiceId BRAKE = 0x1300;
+constexpr MethodId PRESS = 0x0010;
+constexpr MethodId STATUS_EVENT = 0x8030;
+
+SomeIpMessage make(ServiceId service, MethodId method, ClientId client, SessionId session, MessageType type, Payload payload) {
+    return SomeIpMessage{SomeIpHeader{service, method, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + payload.size()), client,
+                                      session, 1, 1, static_cast<uint8_t>(type), 0},
+                         std::move(payload)};
+}
+
+int main() {
+    auto net = LoopbackNetwork::create();
+
+    // Two brake instances on the server network, each answering with its own marker
+    ServiceRegistry left_registry, right_registry;
+    std::vector<ClientId> seen_clients;
+    left_registry.register_method(BRAKE, PRESS, [&](const Payload& in, const Endpoint&) -> MethodResult {
+        seen_clients.push_back(MessageRouter::current_request()->header.client_id);
+        Payload out(in);
+        out.push_back(0x01);
+        return {ReturnCode::E_OK, out};
+    });
+    right_registry.register_method(BRAKE, PRESS, [&](const Payload& in, const Endpoint&) -> MethodResult {
+        Payload out(in);
+        out.push_back(0x02);
+        return {ReturnCode::E_OK, out};
+    });
+    auto left_ep = net->create_endpoint("10.0.2.10", 30501);
+    auto right_ep = net->create_endpoint("10.0.2.11", 30501);
+    auto left_router = create_message_router(left_ep, left_registry);
+    auto right_router = create_message_router(right_ep, right_registry);
+    left_ep->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) { left_router->route(m, s, d, p); });
+    right_ep->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) { right_router->route(m, s, d, p); });
+
+    // The gateway: one endpoint per instance towards the clients, one towards the servers
+    auto gw_left = net->create_endpoint("10.0.1.1", 30501);
+    auto gw_right = net->create_endpoint("10.0.1.1", 30502);
+    auto gw_servers = net->create_endpoint("10.0.2.1", 40000);
+    Gateway gateway(0x7F00, std::chrono::milliseconds(200));
+    gateway.attach(gw_left, 1);
+    gateway.attach(gw_right, 2);
+    GatewayRule to_left;
+    to_left.service = BRAKE;
+    to_left.instance = 1;
+    to_left.to = gw_servers;
+    to_left.dest = Endpoint("10.0.2.10", 30501);
+    gateway.add_rule(to_left);
+    GatewayRule to_right = to_left;
+    to_right.instance = 2;
+    to_right.dest = Endpoint("10.0.2.11", 30501);
+    gateway.add_rule(to_right);
+    // Events from the left brake go to one subscriber
+    GatewayRule events;
+    events.service = BRAKE;
+    events.method = STATUS_EVENT;
+    events.from = gw_servers;
+    events.to = gw_left;
+    events.dest = Endpoint("10.0.0.2", 40000);
+    gateway.add_rule(events);
+
+    // Anything without a rule reaches the transport's own callback
+    int local = 0;
+    gw_left->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) {
+        assert(m.header.service_id == 0x4000);
+        ++local;
+    });
+
+    auto client = net->create_endpoint("10.0.0.2", 40000);
+    std::vector<SomeIpMessage> received;
+    client->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) { received.push_back(m); });
+    for (auto ep : {left_ep, right_ep, gw_left, gw_right, gw_servers, client}) assert(ep->start());
+
+    client->send_to(make(BRAKE, PRESS, 0x0042, 7, MessageType::REQUEST, {0xAA}).serialize(), Endpoint("10.0.1.1", 30501));
+    client->send_to(make(BRAKE, PRESS, 0x0042, 8, MessageType::REQUEST, {0xBB}).serialize(), Endpoint("10.0.1.1", 30502));
+    client->send_to(make(0x4000, 0x0001, 0x0042, 9, MessageType::REQUEST, {}).serialize(), Endpoint("10.0.1.1", 30501));
+    net->run();
+
+    // Responses carry the client's own client and session IDs again; payloads pass untouched
+    assert(received.size() == 2 && local == 1);
+    assert(received[0].header.session_id == 7 && received[0].header.client_id == 0x0042);
+    assert(received[0].header.message_type == static_cast<uint8_t>(MessageType::RESPONSE));
+    assert(received[0].payload == Payload({0xAA, 0x01}));
+    assert(received[1].header.session_id == 8 && received[1].payload == Payload({0xBB, 0x02}));
+    assert(seen_clients.size() == 1 && seen_clients[0] == 0x7F00);
+
+    // An event from the server side is forwarded unchanged
+    left_ep->send_to(make(BRAKE, STATUS_EVENT, 0, 1, MessageType::NOTIFICATION, {0x01}).serialize(), Endpoint("10.0.2.1", 40000));
+    net->run();
+    assert(received.size() == 3 && received[2].header.method_id == STATUS_EVENT && received[2].payload == Payload({0x01}));
+
+    // A response nobody asked for is dropped
+    left_ep->send_to(make(BRAKE, PRESS, 0x7F00, 500, MessageType::RESPONSE, {}).serialize(), Endpoint("10.0.2.1", 40000));
+    net->run();
+    assert(received.size() == 3);
+
+    // A server that answers late; a third party guessing the session cannot answer for it
+    auto slow = net->create_endpoint("10.0.2.20", 30501);
+    std::vector<SomeIpMessage> slow_requests;
+    slow->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) { slow_requests.push_back(m); });
+    GatewayRule to_slow;
+    to_slow.service = 0x1400;
+    to_slow.to = gw_servers;
+    to_slow.dest = Endpoint("10.0.2.20", 30501);
+    gateway.add_rule(to_slow);
+    auto attacker = net->create_endpoint("10.0.2.30", 30501);
+    assert(slow->start() && attacker->start());
+    client->send_to(make(0x1400, 0x0001, 0x0042, 10, MessageType::REQUEST, {}).serialize(), Endpoint("10.0.1.1", 30501));
+    net->run();
+    assert(slow_requests.size() == 1 && slow_requests[0].header.session_id == 3);
+    SomeIpMessage answer = slow_requests[0];
+    answer.header.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
+    answer.payload = {0xEE};
+    answer.header.length = SomeIpHeader::MIN_LENGTH + 1;
+    attacker->send_to(answer.serialize(), Endpoint("10.0.2.1", 40000));
+    right_ep->send_to(answer.serialize(), Endpoint("10.0.2.1", 40000));
+    net->run();
+    assert(received.size() == 3);
+    slow->send_to(answer.serialize(), Endpoint("10.0.2.1", 40000));
+    net->run();
+    assert(received.size() == 4 && received[3].header.session_id == 10 && received[3].payload == Payload({0xEE}));
+
+    // Unanswered requests are forgotten after the timeout; a late response is then orphaned
+    client->send_to(make(0x1400, 0x0001, 0x0042, 11, MessageType::REQUEST, {}).serialize(), Endpoint("10.0.1.1", 30501));
+    net->run();
+    assert(gateway.expire_pending() == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    assert(gateway.expire_pending() == 1);
+    answer = slow_requests[1];
+    answer.header.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
+    slow->send_to(answer.serialize(), Endpoint("10.0.2.1", 40000));
+    net->run();
+    assert(received.size() == 4);
+
+    Gateway::Stats stats = gateway.stats();
+    assert(stats.requests == 4 && stats.responses == 3 && stats.messages == 1 && stats.orphaned == 4);
+    assert(stats.expired == 1 && stats.send_failures == 0);
+
+    std::cout << "test_gateway passed\n";
+    return 0;
+}
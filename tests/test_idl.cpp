@@ -0,0 +1,187 @@
+#include "test_service_someip.hpp"
+#include "someip/api.hpp"
+#include "someip/loopback.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace someip;
+using namespace test::idl;
+
+// Layouts and IDs are compile-time constants
+static_assert(Telemetry::SERVICE_ID == 0x4321 && Telemetry::INTERFACE_VERSION == 2, "service");
+static_assert(Telemetry::ECHO == 0x0001 && Telemetry::POSITION_NOTIFY == 0x8010, "IDs");
+static_assert(Point::SIZE == 4 && Sample::SIZE == 45 && Sample::Offset::where == 41, "layout");
+static_assert(EchoRequest::Offset::cookie == 45 && !EchoRequest::VARIABLE, "nested layout");
+static_assert(UploadRequest::SIZE == 2 && UploadRequest::VARIABLE, "trailing bytes");
+
+// Appends a marker byte and checks it, standing in for SecOC or E2E
+struct MarkerStage : ProtectionStage {
+    bool check(const SomeIpHeader&, Payload& payload) override {
+        if (payload.empty() || payload.back() != 0xA5) return false;
+        payload.pop_back();
+        return true;
+    }
+    bool protect(const SomeIpHeader&, Payload& payload) override {
+        payload.push_back(0xA5);
+        return true;
+    }
+};
+
+class Server : public TelemetrySkeleton {
+public:
+    ReturnCode echo(const EchoRequest::View& in, EchoResponse& out, const Endpoint&) override {
+        out.sample = in.sample().value();
+        out.cookie = in.cookie() + 1;
+        return ReturnCode::E_OK;
+    }
+    ReturnCode upload(const UploadRequest::View& in, UploadResponse& out, const Endpoint&) override {
+        // The bytes are read in place from the request payload
+        wire::BytesView data = in.data();
+        out.length = static_cast<Uint32>(data.size);
+        Uint8 sum = 0;
+        for (size_t i = 0; i < data.size; ++i) sum = static_cast<Uint8>(sum + data.data[i]);
+        out.digest = {in.channel() == 7 ? Uint8(7) : Uint8(0), sum};
+        return ReturnCode::E_OK;
+    }
+    ReturnCode reset(const ResetRequest::View&, ResetResponse&, const Endpoint&) override {
+        return ReturnCode::E_NOT_OK;
+    }
+};
+
+int main() {
+    // Records write big-endian at their constexpr offsets and views read them back in place
+    {
+        Sample s;
+        s.valid = true;
+        s.u8 = 0x12;
+        s.u16 = 0x3456;
+        s.u32 = 0x789ABCDE;
+        s.u64 = 0x0102030405060708ULL;
+        s.i8 = -5;
+        s.i32 = -100000;
+        s.i64 = -(1LL << 40);
+        s.f32 = 1.5f;
+        s.f64 = -2.25;
+        s.where = Point{-3, 4};
+        Payload bytes(Sample::SIZE);
+        s.write(bytes.data());
+        assert(bytes[Sample::Offset::u16] == 0x34 && bytes[Sample::Offset::u16 + 1] == 0x56);
+        assert(bytes[Sample::Offset::u64 + 7] == 0x08);
+        Sample::View v(bytes.data(), bytes.size());
+        assert(v.valid() && v.u8() == 0x12 && v.u16() == 0x3456 && v.u32() == 0x789ABCDE);
+        assert(v.u64() == 0x0102030405060708ULL && v.i8() == -5 && v.i32() == -100000 && v.i64() == -(1LL << 40));
+        assert(v.f32() == 1.5f && v.f64() == -2.25 && v.where().x() == -3 && v.where().y() == 4);
+        Sample back = v.value();
+        assert(back.u32 == s.u32 && back.where.y == 4);
+
+        Blob blob{9, {1, 2, 3}};
+        assert(blob.wire_size() == 5);
+        Payload blob_bytes(blob.wire_size());
+        blob.write(blob_bytes.data());
+        assert(blob_bytes == Payload({0, 9, 1, 2, 3}));
+        assert(Blob::fits(2) && !Blob::fits(1) && !Point::fits(5));
+    }
+
+    // Skeleton and proxy over a simulated network
+    auto net = LoopbackNetwork::create();
+    auto server_ep = net->create_endpoint("10.0.0.1", 30501);
+    auto client_ep = net->create_endpoint("10.0.0.2", 40000);
+    ServiceRegistry registry;
+    Server server;
+    server.attach(registry, server_ep);
+    auto router = create_message_router(server_ep, registry);
+    router->add_protection(Telemetry::SERVICE_ID, Telemetry::UPLOAD, std::make_shared<MarkerStage>());
+    server_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+        router->route(msg, src, dst, proto);
+    });
+    TelemetryProxy proxy(client_ep, Endpoint("10.0.0.1", 30501));
+    proxy.add_protection(Telemetry::UPLOAD, std::make_shared<MarkerStage>());
+    int unhandled = 0;
+    client_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        if (!proxy.handle(msg)) ++unhandled;
+    });
+    assert(server_ep->start() && client_ep->start());
+
+    int echoed = 0;
+    proxy.on_echo([&](ReturnCode rc, const EchoResponse::View* res) {
+        assert(rc == ReturnCode::E_OK && res);
+        assert(res->cookie() == 43 && res->sample().u16() == 0xBEEF && res->sample().where().x() == 7);
+        ++echoed;
+    });
+    Sample sample;
+    sample.u16 = 0xBEEF;
+    sample.where.x = 7;
+    assert(proxy.echo(sample, 42));
+
+    int uploaded = 0;
+    proxy.on_upload([&](ReturnCode rc, const UploadResponse::View* res) {
+        assert(rc == ReturnCode::E_OK && res);
+        assert(res->length() == 3 && res->digest().size == 2 && res->digest().data[0] == 7 && res->digest().data[1] == 6);
+        ++uploaded;
+    });
+    Payload data{1, 2, 3};
+    assert(proxy.upload(7, data));
+
+    int reset_errors = 0;
+    proxy.on_reset([&](ReturnCode rc, const ResetResponse::View* res) {
+        assert(rc == ReturnCode::E_NOT_OK && !res);
+        ++reset_errors;
+    });
+    assert(proxy.reset());
+    net->run();
+    assert(echoed == 1 && uploaded == 1 && reset_errors == 1);
+
+    // Fields: setter and getter responses and notifications all reach on_<field>()
+    std::vector<Point> positions;
+    proxy.on_position([&](const Point& p) { positions.push_back(p); });
+    server.position.subscribe(Endpoint("10.0.0.2", 40000));
+    net->run();
+    assert(positions.size() == 1 && positions[0].x == 0);  // initial value on subscribe
+    assert(proxy.set_position(Point{5, -6}));
+    net->run();
+    // The setter response and the change notification
+    assert(positions.size() == 3 && positions[1].x == 5 && positions[2].y == -6);
+    assert(server.position.get().y == -6);
+    assert(proxy.get_position());
+    net->run();
+    assert(positions.size() == 4 && positions[3].x == 5);
+
+    Blob label;
+    proxy.on_label([&](const Blob& b) { label = b; });
+    assert(proxy.set_label(Blob{3, {9, 9}}));
+    net->run();
+    assert(label.tag == 3 && label.data == Payload({9, 9}));
+
+    float level = 0;
+    proxy.on_level([&](const float& v) { level = v; });
+    server.level.set(0.75f);
+    assert(proxy.get_level());
+    net->run();
+    assert(level == 0.75f);
+
+    // Events
+    int moved = 0;
+    proxy.on_moved([&](const MovedEvent::View& ev) {
+        assert(ev.from().x() == 1 && ev.to().y() == -2);
+        ++moved;
+    });
+    assert(server.send_moved(Endpoint("10.0.0.2", 40000), Point{1, 1}, Point{2, -2}));
+    net->run();
+    assert(moved == 1);
+
+    // A request of the wrong size is refused before the handler runs
+    int malformed = 0;
+    proxy.on_echo([&](ReturnCode rc, const EchoResponse::View* res) {
+        assert(rc == ReturnCode::E_MALFORMED_MESSAGE && !res);
+        ++malformed;
+    });
+    SomeIpMessage short_echo{SomeIpHeader{Telemetry::SERVICE_ID, Telemetry::ECHO, SomeIpHeader::MIN_LENGTH + 3, 1, 1, 1,
+                                          Telemetry::INTERFACE_VERSION, static_cast<uint8_t>(MessageType::REQUEST), 0},
+                             Payload{1, 2, 3}};
+    client_ep->send_to(short_echo.serialize(), Endpoint("10.0.0.1", 30501));
+    net->run();
+    assert(malformed == 1 && unhandled == 0);
+
+    std::cout << "test_idl passed\n";
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include "someip/api.hpp"
+#include "someip/instances.hpp"
+#include "someip/loopback.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+using namespace std::chrono_literals;
+
+constexpr ServiceId BRAKE = 0x1300;
+constexpr MethodId PRESS = 0x0010;
+constexpr InstanceId FRONT_LEFT = 1, FRONT_RIGHT = 2;
+
+SomeIpMessage press_request(Uint16 session) {
+    return SomeIpMessage{SomeIpHeader{BRAKE, PRESS, SomeIpHeader::MIN_LENGTH, 1, session, 1, 1,
+                                      static_cast<uint8_t>(MessageType::REQUEST), 0},
+                         {}};
+}
+
+int main() {
+    // Two instances of one service in one process, found through SD by instance ID
+    {
+        auto net = LoopbackNetwork::create();
+        InstanceHost host;
+        ServiceInstance* left = host.add(BRAKE, FRONT_LEFT, net->create_endpoint("10.0.0.1", 30501));
+        ServiceInstance* right = host.add(BRAKE, FRONT_RIGHT, net->create_endpoint("10.0.0.1", 30502));
+        assert(left && right && host.size() == 2);
+        assert(!host.add(BRAKE, FRONT_LEFT, net->create_endpoint("10.0.0.1", 30503)));
+        assert(!host.add(BRAKE, 3, nullptr));
+        assert(host.find(BRAKE, FRONT_RIGHT) == right && !host.find(BRAKE, 3) && !host.find(0x1301, FRONT_LEFT));
+        auto brakes = host.instances(BRAKE);
+        assert(brakes.size() == 2 && brakes[0] == left && brakes[1] == right);
+
+        left->register_method(PRESS, [](const Payload&, const Endpoint&) -> MethodResult {
+            return {ReturnCode::E_OK, Payload{0x01}};
+        });
+        right->register_method(PRESS, [](const Payload&, const Endpoint&, SerializationBuffer& out) {
+            out.write_uint8(0x02);
+            return ReturnCode::E_OK;
+        });
+        // Registries are per instance
+        assert(left->registry().lookup(BRAKE, PRESS)->handler && right->registry().lookup(BRAKE, PRESS)->buffer_handler);
+        assert(host.start());
+
+        ServiceDiscovery server_sd, client_sd;
+        server_sd.set_transport(net->create_endpoint("10.0.0.1", DEFAULT_SD_PORT));
+        client_sd.set_transport(net->create_endpoint("10.0.0.2", DEFAULT_SD_PORT));
+        server_sd.set_offer_interval(0ms);
+        client_sd.set_offer_interval(0ms);
+        assert(server_sd.start() && client_sd.start());
+        host.offer(server_sd);
+        net->run();
+
+        auto found_left = client_sd.find(BRAKE, FRONT_LEFT);
+        auto found_right = client_sd.find(BRAKE, FRONT_RIGHT);
+        assert(found_left && found_left->port == 30501 && found_left->ip == "10.0.0.1");
+        assert(found_right && found_right->port == 30502 && !client_sd.find(BRAKE, 3));
+
+        auto client = net->create_endpoint("10.0.0.2", 40000);
+        std::vector<Payload> replies;
+        client->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+            replies.push_back(msg.payload);
+        });
+        assert(client->start());
+        client->send_to(press_request(1).serialize(), Endpoint(found_right->ip, found_right->port));
+        client->send_to(press_request(2).serialize(), Endpoint(found_left->ip, found_left->port));
+        net->run();
+        assert(replies.size() == 2 && replies[0] == Payload({0x02}) && replies[1] == Payload({0x01}));
+
+        host.stop_offer(server_sd);
+        server_sd.stop();
+        client_sd.stop();
+        host.stop();
+    }
+
+    // An endpoint that outlives its instance no longer routes into the destroyed router
+    {
+        auto net = LoopbackNetwork::create();
+        auto endpoint = net->create_endpoint("10.0.0.1", 30501);
+        auto client = net->create_endpoint("10.0.0.2", 40000);
+        int calls = 0;
+        {
+            ServiceInstance instance(BRAKE, FRONT_LEFT, endpoint);
+            instance.register_method(PRESS, [&](const Payload&, const Endpoint&) -> MethodResult {
+                ++calls;
+                return {ReturnCode::E_OK, {}};
+            });
+            assert(endpoint->start() && client->start());
+            client->send_to(press_request(1).serialize(), Endpoint("10.0.0.1", 30501));
+            net->run();
+            assert(calls == 1);
+        }
+        assert(endpoint->start());
+        client->send_to(press_request(2).serialize(), Endpoint("10.0.0.1", 30501));
+        net->run();
+        assert(calls == 1 && endpoint->datagrams_received() == 2);
+    }
+
+    // Over UDP, each instance is routed on its own receive thread
+    {
+        InstanceHost host;
+        std::atomic<int> calls[2] = {{0}, {0}};
+        std::thread::id routed_on[2];
+        for (InstanceId inst : {FRONT_LEFT, FRONT_RIGHT}) {
+            ServiceInstance* instance = host.add_udp(BRAKE, inst, "127.0.0.1", static_cast<uint16_t>(31600 + inst));
+            assert(instance);
+            const int idx = inst - 1;
+            instance->register_method(PRESS, [&, idx](const Payload&, const Endpoint&) -> MethodResult {
+                routed_on[idx] = std::this_thread::get_id();
+                ++calls[idx];
+                return {ReturnCode::E_OK, {}};
+            });
+        }
+        assert(!host.add_udp(BRAKE, FRONT_LEFT, "127.0.0.1", 31603));
+        assert(host.start());
+
+        auto client = create_udp_endpoint("127.0.0.1", 31610);
+        assert(client);
+        std::atomic<int> responses{0};
+        client->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) { ++responses; });
+        for (Uint16 i = 0; i < 20; ++i) {
+            client->send_to(press_request(i).serialize(), Endpoint("127.0.0.1", static_cast<uint16_t>(31601 + i % 2)));
+        }
+        for (int i = 0; i < 200 && responses < 20; ++i) std::this_thread::sleep_for(10ms);
+        assert(responses == 20 && calls[0] == 10 && calls[1] == 10);
+        assert(routed_on[0] != routed_on[1] && routed_on[0] != std::this_thread::get_id());
+        client->stop();
+        host.stop();
+    }
+
+    std::cout << "test_instances passed\n";
+    return 0;
+}
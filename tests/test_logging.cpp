@@ -0,0 +1,63 @@
+#include "someip/types.hpp"
+#include <cassert>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace someip;
+
+static std::mutex lines_mutex;
+static std::vector<std::string> lines;
+
+static int side_effect() {
+    static int calls = 0;
+    return ++calls;
+}
+
+int main() {
+    logging::set_sink([](logging::Level, const char* line) {
+        std::lock_guard<std::mutex> lk(lines_mutex);
+        lines.emplace_back(line);
+    });
+
+    // Binary records are formatted on the logger thread
+    SOMEIP_LOG_INFO("svc=0x%04X mth=%u len=%zu ratio=%.2f name=%s neg=%d", 0x1300, 16u, size_t(42), 0.5, "brake", -7);
+    log_error("plain text");
+    logging::flush();
+    {
+        std::lock_guard<std::mutex> lk(lines_mutex);
+        assert(lines.size() == 2);
+        assert(lines[0] == "[INFO] svc=0x1300 mth=16 len=42 ratio=0.50 name=brake neg=-7");
+        assert(lines[1] == "[ERROR] plain text");
+        lines.clear();
+    }
+
+    // Debug logging is compiled out at the default level, arguments included
+    SOMEIP_LOG_DEBUG("never %d", side_effect());
+    if (logging::compiled_level > 0) assert(side_effect() == 1);
+
+    // Repeated errors from one call site are rate-limited
+    for (int i = 0; i < 1000; ++i) {
+        SOMEIP_LOG_ERROR("flood %d", i);
+    }
+    logging::flush();
+    {
+        std::lock_guard<std::mutex> lk(lines_mutex);
+        assert(lines.size() == 10);
+        lines.clear();
+    }
+
+    // Records from exiting threads are not lost
+    std::thread t([] { SOMEIP_LOG_INFO("from thread %d", 1); });
+    t.join();
+    logging::flush();
+    {
+        std::lock_guard<std::mutex> lk(lines_mutex);
+        assert(lines.size() == 1 && lines[0] == "[INFO] from thread 1");
+    }
+
+    logging::set_sink(nullptr);
+    std::cout << "test_logging passed\n";
+    return 0;
+}
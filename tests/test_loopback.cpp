@@ -0,0 +1,214 @@
+#include "someip/api.hpp"
+#include "someip/loopback.hpp"
+#include "someip/message_router.hpp"
+#include "someip/metrics.hpp"
+#include "someip/service_discovery.hpp"
+#include <cassert>
+#include <chrono>
+#include <future>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+using namespace std::chrono_literals;
+
+static Payload request(Uint16 session) {
+    SomeIpMessage msg{SomeIpHeader{0x1000, 0x0001, SomeIpHeader::MIN_LENGTH + 1, 0x1, session, 1, 1,
+                                   static_cast<uint8_t>(MessageType::REQUEST), 0},
+                      Payload{static_cast<uint8_t>(session)}};
+    return msg.serialize();
+}
+
+// Sends `count` requests through a lossy network; returns the sessions answered, in order
+static std::vector<Uint16> lossy_run(Uint64 seed, int count) {
+    LoopbackOptions options;
+    options.loss = 0.3;
+    options.seed = seed;
+    auto net = LoopbackNetwork::create(options);
+    auto server = net->create_endpoint("10.0.0.1", 30501);
+    auto client = net->create_endpoint("10.0.0.2", 40000);
+    ServiceRegistry registry;
+    registry.register_method(0x1000, 0x0001, [](const Payload& p, const Endpoint&) {
+        return MethodResult{ReturnCode::E_OK, p};
+    });
+    auto router = create_message_router(server, registry);
+    server->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+        router->route(msg, src, dst, proto);
+    });
+    std::vector<Uint16> answered;
+    client->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        answered.push_back(msg.header.session_id);
+    });
+    assert(server->start() && client->start());
+    for (int i = 1; i <= count; ++i) client->send_to(request(static_cast<Uint16>(i)), Endpoint("10.0.0.1", 30501));
+    net->run();
+    auto stats = net->stats();
+    assert(stats.sent == stats.delivered + stats.lost);
+    return answered;
+}
+
+int main() {
+    // Request/response through the router on a virtual clock: time advances by the link latency
+    {
+        LoopbackOptions options;
+        options.latency = 250us;
+        auto net = LoopbackNetwork::create(options);
+        auto server = net->create_endpoint("10.0.0.1", 30501);
+        auto client = net->create_endpoint("10.0.0.2", 40000);
+        ServiceRegistry registry;
+        registry.register_method(0x1000, 0x0001, [](const Payload&, const Endpoint& src) {
+            assert(src == Endpoint("10.0.0.2", 40000));
+            return MethodResult{ReturnCode::E_OK, {0xAA}};
+        });
+        auto router = create_message_router(server, registry);
+        server->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+            router->route(msg, src, dst, proto);
+        });
+        Uint64 answered_at = 0;
+        client->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint&, TransportProtocol) {
+            assert(src == Endpoint("10.0.0.1", 30501));
+            assert(msg.header.message_type == static_cast<uint8_t>(MessageType::RESPONSE) && msg.payload == Payload{0xAA});
+            answered_at = net->now_ns();
+        });
+        assert(server->start() && client->start());
+        // The address is taken while the server is bound
+        auto twin = net->create_endpoint("10.0.0.1", 30501);
+        assert(!twin->start());
+
+        client->send_to(request(1), Endpoint("10.0.0.1", 30501));
+        assert(net->run_for(100us) == 0 && answered_at == 0);
+        assert(net->run() == 2);
+        assert(answered_at == 500000);
+        assert(server->datagrams_received() == 1 && client->datagrams_received() == 1);
+
+        // Garbage counts as a parse error of the endpoint, not against the method IDs it starts with
+        client->send_to(Payload{0x13, 0x00, 0x00, 0x01, 0xFF}, Endpoint("10.0.0.1", 30501));
+        net->run();
+        assert(server->parse_errors() == 1 && client->parse_errors() == 0);
+        assert(!metrics::snapshot().find(0x1300, 0x0001));
+
+        // Nothing listens here
+        client->send_to(request(2), Endpoint("10.0.0.9", 30501));
+        net->run();
+        assert(net->stats().unreachable == 1);
+
+        // Timers run on the same clock
+        int ticks = 0;
+        net->every(1ms, [&] { ++ticks; });
+        net->run_for(10ms);
+        assert(ticks == 10);
+    }
+
+    // Loss is drawn from the seed: the same seed replays the same run
+    {
+        auto a = lossy_run(7, 1000);
+        auto b = lossy_run(7, 1000);
+        auto c = lossy_run(8, 1000);
+        assert(a == b && a != c);
+        // Both directions lose 30%
+        assert(a.size() > 400 && a.size() < 580);
+    }
+
+    // SD convergence: 100 ECUs offer one service each on the shared multicast group
+    {
+        auto net = LoopbackNetwork::create();
+        const int ecus = 100;
+        std::vector<std::unique_ptr<ServiceDiscovery>> sds;
+        for (int i = 0; i < ecus; ++i) {
+            std::string ip = "10.0.1." + std::to_string(i + 1);
+            auto sd = std::make_unique<ServiceDiscovery>();
+            sd->set_transport(net->create_endpoint(ip, DEFAULT_SD_PORT));
+            sd->set_offer_interval(0ms);
+            assert(sd->start());
+            sd->offer_service(SdOffer{static_cast<ServiceId>(0x2000 + i), 1, ip, 30501, 3});
+            ServiceDiscovery* raw = sd.get();
+            net->every(1s, [raw] { raw->send_offers(); });
+            sds.push_back(std::move(sd));
+        }
+        net->run_for(0ns);
+        for (const auto& sd : sds) assert(sd->found().size() == size_t(ecus));
+        auto stats = net->stats();
+        assert(stats.sent == size_t(ecus) && stats.delivered == size_t(ecus * ecus));
+        net->run_for(3s);
+        assert(net->stats().sent == size_t(4 * ecus));
+        for (auto& sd : sds) sd->stop();
+    }
+
+    // Real clock: a network thread delivers asynchronously
+    {
+        LoopbackOptions options;
+        options.virtual_clock = false;
+        options.latency = 1ms;
+        auto net = LoopbackNetwork::create(options);
+        auto server = net->create_endpoint("0.0.0.0", 30501);
+        auto client = net->create_endpoint("10.0.0.2", 40000);
+        server->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint&, TransportProtocol) {
+            assert(msg.rx.user_ns != 0);
+            server->send_to(msg.serialize(), src);
+        });
+        std::promise<Uint64> echoed;
+        Uint64 t0 = net->now_ns();
+        client->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            echoed.set_value(net->now_ns());
+        });
+        assert(server->start() && client->start());
+        client->send_to(request(1), Endpoint("10.0.0.1", 30501));
+        auto f = echoed.get_future();
+        assert(f.wait_for(2s) == std::future_status::ready);
+        assert(f.get() - t0 >= 2000000);
+        server->stop();
+        client->stop();
+    }
+
+    // stop() waits for a callback in flight on the network thread, and a callback may stop
+    // its own endpoint
+    {
+        LoopbackOptions options;
+        options.virtual_clock = false;
+        auto net = LoopbackNetwork::create(options);
+        auto server = net->create_endpoint("10.0.0.1", 30501);
+        auto client = net->create_endpoint("10.0.0.2", 40000);
+        std::promise<void> entered;
+        std::atomic<bool> finished{false};
+        server->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            entered.set_value();
+            std::this_thread::sleep_for(50ms);
+            finished = true;
+        });
+        std::promise<void> self_stopped;
+        client->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            client->stop();
+            self_stopped.set_value();
+        });
+        assert(server->start() && client->start());
+        client->send_to(request(1), Endpoint("10.0.0.1", 30501));
+        auto f = entered.get_future();
+        assert(f.wait_for(2s) == std::future_status::ready);
+        server->stop();
+        assert(finished);
+
+        assert(server->start());
+        server->send_to(request(2), Endpoint("10.0.0.2", 40000));
+        auto s = self_stopped.get_future();
+        assert(s.wait_for(2s) == std::future_status::ready);
+        server->stop();
+    }
+
+    // The last reference dropped by a timer on the network thread: the network is destroyed
+    // there, and the thread stops without touching it again
+    {
+        LoopbackOptions options;
+        options.virtual_clock = false;
+        auto net = LoopbackNetwork::create(options);
+        std::weak_ptr<LoopbackNetwork> weak = net;
+        auto holder = std::make_shared<std::shared_ptr<LoopbackNetwork>>(net);
+        net->at(net->now_ns(), [holder] { holder->reset(); });
+        net.reset();
+        for (int i = 0; i < 2000 && !weak.expired(); ++i) std::this_thread::sleep_for(1ms);
+        assert(weak.expired());
+        std::this_thread::sleep_for(10ms);
+    }
+
+    std::cout << "test_loopback passed\n";
+    return 0;
+}
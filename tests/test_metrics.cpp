@@ -0,0 +1,59 @@
+#include "someip/metrics.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+int main() {
+    // Histogram bucketing stays within 12.5% of the recorded value
+    metrics::LatencyHistogram h;
+    for (Uint64 v = 1; v <= 1000; ++v) h.record(v * 1000);
+    assert(h.count() == 1000);
+    assert(h.min() == 1000);
+    assert(h.max() == 1000000);
+    Uint64 p50 = h.percentile(0.50);
+    assert(p50 >= 500000 && p50 <= 562500);
+    Uint64 p99 = h.percentile(0.99);
+    assert(p99 >= 990000 && p99 <= 1000000);
+    for (unsigned i = 8; i < metrics::LatencyHistogram::BUCKETS; ++i) {
+        assert(metrics::LatencyHistogram::bucket_index(metrics::LatencyHistogram::bucket_lower_bound(i)) == i);
+        assert(metrics::LatencyHistogram::bucket_index(metrics::LatencyHistogram::bucket_upper_bound(i)) == i);
+    }
+
+    // Recordings from several threads are merged on read, including exited threads
+    auto work = [] {
+        metrics::MethodRecorder rec(0x1300, 0x0010);
+        for (int i = 0; i < 1000; ++i) {
+            rec.received();
+            rec.dispatched();
+            rec.handler_time(2000);
+            rec.receive_to_send(5000);
+        }
+        metrics::MethodRecorder(0x1300, 0x0020).dropped();
+    };
+    std::thread t1(work), t2(work);
+    t1.join();
+    t2.join();
+    work();
+
+    metrics::Snapshot snap = metrics::snapshot();
+    const metrics::MethodSnapshot* m = snap.find(0x1300, 0x0010);
+    if (metrics::enabled) {
+        assert(m);
+        assert(m->received == 3000);
+        assert(m->dispatched == 3000);
+        assert(m->errored == 0);
+        assert(m->handler_time.count() == 3000);
+        assert(m->receive_to_send.percentile(0.5) >= 5000);
+        assert(snap.find(0x1300, 0x0020)->dropped == 3);
+
+        std::string text = metrics::to_prometheus(snap);
+        assert(text.find("someip_messages_received_total{service=\"0x1300\",method=\"0x0010\"} 3000") != std::string::npos);
+        assert(text.find("someip_handler_duration_seconds_count{service=\"0x1300\",method=\"0x0010\"} 3000") != std::string::npos);
+    } else {
+        assert(!m);
+    }
+    std::cout << "test_metrics passed\n";
+    return 0;
+}
@@ -0,0 +1,53 @@
+#include "someip/api.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+
+int main() {
+    // Pinning to CPU 0 is always allowed; an out-of-range CPU is refused without aborting
+    assert(apply_thread_options(ThreadOptions{0, 0}));
+    assert(!apply_thread_options(ThreadOptions{1 << 20, 0}));
+
+    // A busy-polling, pinned server answers a blocking client
+    EndpointOptions polling;
+    polling.mode = ReceiveMode::BUSY_POLL;
+    polling.thread.cpu = 0;
+    polling.max_backoff = std::chrono::microseconds(20);
+    auto server = create_udp_endpoint("127.0.0.1", 4036, polling);
+    auto client = create_udp_endpoint("127.0.0.1", 4038);
+    assert(server && client);
+    Endpoint client_ep("127.0.0.1", 4038);
+    server->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        SomeIpHeader h = msg.header;
+        h.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
+        server->send_to(h.serialize(), client_ep);
+    });
+    std::atomic<int> answered{0};
+    client->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        assert(msg.header.message_type == static_cast<uint8_t>(MessageType::RESPONSE));
+        answered++;
+    });
+
+    SomeIpHeader request{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                         static_cast<uint8_t>(MessageType::REQUEST), 0};
+    for (int i = 0; i < 100; ++i) {
+        // let the server back off to its sleep phase between some of the requests
+        if (i % 10 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        assert(client->send_to(request.serialize(), Endpoint("127.0.0.1", 4036)));
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (answered < i + 1 && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+        assert(answered == i + 1);
+    }
+
+    // Stopping a polling endpoint does not wait for traffic
+    auto t0 = std::chrono::steady_clock::now();
+    server->stop();
+    assert(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(100));
+
+    std::cout << "test_receive_modes passed\n";
+    return 0;
+}
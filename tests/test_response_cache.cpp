@@ -0,0 +1,165 @@
+#include "someip/api.hpp"
+#include "someip/loopback.hpp"
+#include "someip/metrics.hpp"
+#include "someip/response_cache.hpp"
+#include <cassert>
+#include <iostream>
+#include <thread>
+
+using namespace someip;
+using namespace std::chrono_literals;
+
+constexpr ServiceId SVC = 0x5100;
+constexpr MethodId READ = 0x0001, READ_BUFFER = 0x0002, FAILING = 0x0003, PROTECTED = 0x0004, RACING = 0x0005;
+
+// Appends a counter that must differ in every response, like a SecOC freshness value
+struct CounterStage : ProtectionStage {
+    Uint8 counter = 0;
+    bool check(const SomeIpHeader&, Payload&) override { return true; }
+    bool protect(const SomeIpHeader&, Payload& payload) override {
+        payload.push_back(++counter);
+        return true;
+    }
+};
+
+SomeIpMessage request(MethodId method, ClientId client, SessionId session, Payload payload) {
+    return SomeIpMessage{SomeIpHeader{SVC, method, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + payload.size()), client,
+                                      session, 1, 1, static_cast<uint8_t>(MessageType::REQUEST), 0},
+                         std::move(payload)};
+}
+
+int main() {
+    // The cache on its own
+    {
+        ResponseCacheOptions options;
+        options.capacity = 2;
+        options.ttl = 0ms;
+        ResponseCache cache(options);
+        Payload out;
+        Uint64 evicted = 0;
+        assert(!cache.lookup(Payload{1}, out, evicted));
+        assert(cache.store(Payload{1}, Payload{0xA1}) == 0);
+        assert(cache.store(Payload{2}, Payload{0xA2}) == 0);
+        assert(cache.lookup(Payload{1}, out, evicted) && out == Payload({0xA1}));
+        // Full: the least recently used entry ({2}) makes room
+        assert(cache.store(Payload{3}, Payload{0xA3}) == 1);
+        assert(!cache.lookup(Payload{2}, out, evicted) && cache.lookup(Payload{1}, out, evicted));
+        assert(cache.size() == 2 && cache.clear() == 2 && cache.size() == 0 && evicted == 0);
+        // A response computed before a clear is not stored after it
+        Uint64 generation = cache.generation();
+        cache.clear();
+        assert(cache.store(Payload{1}, Payload{0xA1}, generation) == 0 && cache.size() == 0);
+        assert(cache.store(Payload{1}, Payload{0xA1}, cache.generation()) == 0 && cache.size() == 1);
+
+        options.ttl = 1ms;
+        ResponseCache short_lived(options);
+        short_lived.store(Payload{}, Payload{0xB0});
+        assert(short_lived.lookup(Payload{}, out, evicted) && out == Payload({0xB0}));
+        std::this_thread::sleep_for(5ms);
+        assert(!short_lived.lookup(Payload{}, out, evicted) && evicted == 1 && short_lived.size() == 0);
+    }
+
+    auto net = LoopbackNetwork::create();
+    auto server_ep = net->create_endpoint("10.0.0.1", 30501);
+    auto client_ep = net->create_endpoint("10.0.0.2", 40000);
+    ServiceRegistry registry;
+    int reads = 0, buffer_reads = 0, failures = 0, protected_reads = 0, racing_reads = 0;
+    std::unique_ptr<MessageRouter> router;
+    Uint8 state = 7;
+    registry.register_method(SVC, READ, [&](const Payload& in, const Endpoint&) -> MethodResult {
+        ++reads;
+        Payload out(in);
+        out.push_back(state);
+        return {ReturnCode::E_OK, out};
+    });
+    registry.register_method(SVC, READ_BUFFER, [&](const Payload&, const Endpoint&, SerializationBuffer& out) {
+        ++buffer_reads;
+        out.write_uint16(0xCAFE);
+        return ReturnCode::E_OK;
+    });
+    registry.register_method(SVC, FAILING, [&](const Payload&, const Endpoint&) -> MethodResult {
+        ++failures;
+        return {ReturnCode::E_NOT_OK, {}};
+    });
+    registry.register_method(SVC, PROTECTED, [&](const Payload&, const Endpoint&) -> MethodResult {
+        ++protected_reads;
+        return {ReturnCode::E_OK, Payload{0x55}};
+    });
+    registry.register_method(SVC, RACING, [&](const Payload&, const Endpoint&) -> MethodResult {
+        // The state changes while the handler runs, after it read the old value
+        Payload out{state};
+        if (++racing_reads == 1) router->invalidate_cache(SVC, RACING);
+        return {ReturnCode::E_OK, out};
+    });
+    router = create_message_router(server_ep, registry);
+    for (MethodId m : {READ, READ_BUFFER, FAILING, PROTECTED, RACING}) router->enable_cache(SVC, m);
+    router->add_protection(SVC, PROTECTED, std::make_shared<CounterStage>());
+    server_ep->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) {
+        router->route(m, s, d, p);
+    });
+    std::vector<SomeIpMessage> replies;
+    client_ep->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) {
+        replies.push_back(m);
+    });
+    assert(server_ep->start() && client_ep->start());
+    const Endpoint server("10.0.0.1", 30501);
+    auto send = [&](const SomeIpMessage& m) {
+        client_ep->send_to(m.serialize(), server);
+        net->run();
+    };
+
+    // Repeated polls with the same payload run the handler once; each answer carries its own IDs
+    send(request(READ, 0x0011, 1, {0x01}));
+    send(request(READ, 0x0022, 9, {0x01}));
+    send(request(READ, 0x0033, 4, {0x01}));
+    assert(reads == 1 && replies.size() == 3);
+    for (const SomeIpMessage& r : replies) assert(r.payload == Payload({0x01, 7}));
+    assert(replies[1].header.client_id == 0x0022 && replies[1].header.session_id == 9);
+    assert(replies[2].header.client_id == 0x0033 && replies[2].header.session_id == 4);
+    assert(replies[2].header.message_type == static_cast<uint8_t>(MessageType::RESPONSE));
+
+    // Another payload is another entry; invalidation makes the next poll see the new state
+    send(request(READ, 0x0011, 2, {0x02}));
+    assert(reads == 2 && replies.back().payload == Payload({0x02, 7}));
+    state = 8;
+    router->invalidate_cache(SVC, READ);
+    send(request(READ, 0x0011, 3, {0x01}));
+    assert(reads == 3 && replies.back().payload == Payload({0x01, 8}));
+
+    // Buffer handlers are cached the same way; errors are not cached
+    send(request(READ_BUFFER, 0x0011, 5, {}));
+    send(request(READ_BUFFER, 0x0011, 6, {}));
+    assert(buffer_reads == 1 && replies.back().payload == Payload({0xCA, 0xFE}) && replies.back().header.session_id == 6);
+    send(request(FAILING, 0x0011, 7, {}));
+    send(request(FAILING, 0x0011, 8, {}));
+    assert(failures == 2 && replies.back().header.return_code == static_cast<uint8_t>(ReturnCode::E_NOT_OK));
+
+    // Protected responses are cached before protection, so every answer gets a fresh counter
+    send(request(PROTECTED, 0x0011, 10, {}));
+    send(request(PROTECTED, 0x0011, 11, {}));
+    assert(protected_reads == 1);
+    assert(replies[replies.size() - 2].payload == Payload({0x55, 1}) && replies.back().payload == Payload({0x55, 2}));
+
+    // A response computed across an invalidation is sent but not cached
+    send(request(RACING, 0x0011, 12, {}));
+    send(request(RACING, 0x0011, 13, {}));
+    send(request(RACING, 0x0011, 14, {}));
+    assert(racing_reads == 2 && replies.size() == 14);
+
+    // Only the E_OK responses since the last invalidation remain
+    assert(router->cached_responses(SVC, READ) == 1 && router->cached_responses(SVC, READ_BUFFER) == 1);
+    assert(router->cached_responses(SVC, FAILING) == 0 && router->cached_responses(SVC, PROTECTED) == 1);
+    assert(router->cached_responses(SVC, RACING) == 1);
+
+    if (metrics::enabled) {
+        metrics::Snapshot snap = metrics::snapshot();
+        const metrics::MethodSnapshot* read = snap.find(SVC, READ);
+        assert(read && read->cache_hits == 2 && read->cache_misses == 3 && read->cache_evictions == 2);
+        assert(snap.find(SVC, FAILING)->cache_misses == 2 && snap.find(SVC, PROTECTED)->cache_hits == 1);
+        assert(metrics::to_prometheus(snap).find(
+                   "someip_response_cache_hits_total{service=\"0x5100\",method=\"0x0001\"} 2") != std::string::npos);
+    }
+
+    std::cout << "test_response_cache passed\n";
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include "someip/secoc.hpp"
+#include "someip/loopback.hpp"
+#include "someip/message_router.hpp"
+#include "someip/service.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <openssl/evp.h>
+
+using namespace someip;
+
+static SomeIpHeader request_header(Uint16 session) {
+    return SomeIpHeader{0x1300, 0x0010, SomeIpHeader::MIN_LENGTH, 1, session, 1, 1,
+                        static_cast<uint8_t>(MessageType::REQUEST), 0};
+}
+
+int main() {
+    SecOcProfile profile;
+    profile.key = Payload(16, 0x2B);
+    auto tx = SecOcStage::create(profile);
+    auto rx = SecOcStage::create(profile);
+    assert(tx && rx && tx->overhead() == 6);
+
+    // Full MACs match OpenSSL's one-shot CMAC and HMAC over header IDs | payload | freshness
+    SomeIpHeader kh = request_header(0x0102);
+    Payload body, msg;
+    uint8_t mac[32];
+    for (size_t len = 0; len <= 40; ++len) {  // covers partial and complete final blocks
+        body.assign(len, 0x6B);
+        msg = {0x13, 0x00, 0x00, 0x10, 0x00, 0x01, 0x01, 0x02, 1, 1, 0, 0};
+        msg.insert(msg.end(), body.begin(), body.end());
+        msg.insert(msg.end(), {0, 0, 0, 5});
+        assert(tx->compute_mac(kh, body.data(), body.size(), 5, mac) == 16);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+        uint8_t ref[16];
+        size_t ref_len = 0;
+        assert(EVP_Q_mac(nullptr, "CMAC", nullptr, "AES-128-CBC", nullptr, profile.key.data(), 16,
+                         msg.data(), msg.size(), ref, sizeof(ref), &ref_len));
+        assert(ref_len == 16 && Payload(mac, mac + 16) == Payload(ref, ref + 16));
+#endif
+    }
+    SecOcProfile full_hmac;
+    full_hmac.algorithm = SecOcProfile::Algorithm::HMAC_SHA256;
+    full_hmac.key = Payload(20, 0x0B);
+    assert(SecOcStage::create(full_hmac)->compute_mac(kh, body.data(), body.size(), 5, mac) == 32);
+    assert(Payload(mac, mac + 32) == Crypto::hmac_sha256(full_hmac.key, msg));
+
+    // Invalid profiles
+    SecOcProfile bad = profile;
+    bad.key.resize(10);
+    assert(!SecOcStage::create(bad));
+    bad = profile;
+    bad.mac_bytes = 17;
+    assert(!SecOcStage::create(bad));
+    bad = profile;
+    bad.freshness = SecOcProfile::Freshness::TIME;
+    bad.freshness_bytes = 1;  // 256 ms on the wire cannot cover a 2 s tolerance
+    assert(!SecOcStage::create(bad));
+
+    // Round trip, tampering and replay
+    SomeIpHeader h = request_header(1);
+    Payload p = {1, 2, 3};
+    assert(tx->protect(h, p) && p.size() == 3 + 6);
+    Payload copy = p;
+    assert(rx->check(h, p) && p == Payload({1, 2, 3}));
+    Payload replayed = copy;
+    assert(!rx->check(h, replayed));
+    Payload next = {1, 2, 3};
+    assert(tx->protect(h, next));
+    Payload flipped = next;
+    flipped[0] ^= 1;
+    assert(!rx->check(h, flipped));
+    SomeIpHeader other = request_header(2);
+    Payload wrong_header = next;
+    assert(!rx->check(other, wrong_header));
+    assert(rx->check(h, next) && rx->rejected() == 3);
+
+    // One freshness byte on the wire: the counter is reconstructed across wraps and
+    // reordered messages are still accepted
+    SecOcProfile hmac;
+    hmac.algorithm = SecOcProfile::Algorithm::HMAC_SHA256;
+    hmac.key = Payload(40, 0x0B);
+    hmac.mac_bytes = 8;
+    hmac.freshness_bytes = 1;
+    auto htx = SecOcStage::create(hmac);
+    auto hrx = SecOcStage::create(hmac);
+    for (int i = 0; i < 600; i += 2) {
+        Payload a = {uint8_t(i)}, b = {uint8_t(i + 1)};
+        assert(htx->protect(h, a) && htx->protect(h, b));
+        assert(hrx->check(h, b) && hrx->check(h, a) && a[0] == uint8_t(i));
+    }
+
+    // Freshness is kept per peer: a second client, or the same client ID from another
+    // address, has its own counter. A counter restarted on the same endpoint is stale.
+    const Endpoint server{"10.0.0.1", 30501}, ecu_a{"10.0.0.2", 40000}, ecu_b{"10.0.0.3", 40000};
+    auto shared_rx = SecOcStage::create(profile);
+    auto tx_a = SecOcStage::create(profile), tx_b = SecOcStage::create(profile);
+    for (int i = 0; i < 3; ++i) {
+        Payload a = {1};
+        assert(tx_a->protect(h, a, server) && shared_rx->check(h, a, ecu_a));
+    }
+    Payload from_b = {2};
+    assert(tx_b->protect(h, from_b, server) && shared_rx->check(h, from_b, ecu_b));
+    Payload restarted = {1};
+    assert(SecOcStage::create(profile)->protect(h, restarted, server) && !shared_rx->check(h, restarted, ecu_a));
+    // Messages that fail authentication leave no state behind
+    Payload forged = {1, 0, 1, 0, 0, 0, 0};
+    assert(!shared_rx->check(h, forged, Endpoint{"10.0.0.9", 1}) && shared_rx->peers() == 2);
+
+    // Time-based freshness: replays are refused, bursts step past the clock, and a sender
+    // that restarts carries on without the receiver resetting anything
+    SecOcProfile timed = profile;
+    timed.freshness = SecOcProfile::Freshness::TIME;
+    auto trx = SecOcStage::create(timed), ttx = SecOcStage::create(timed);
+    Payload t = {1};
+    assert(ttx->protect(h, t, server));
+    Payload t_copy = t;
+    assert(trx->check(h, t, ecu_a) && !trx->check(h, t_copy, ecu_a));
+    for (int i = 0; i < 20; ++i) {
+        Payload burst = {uint8_t(i)};
+        assert(ttx->protect(h, burst, server) && trx->check(h, burst, ecu_a));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    Payload after_restart = {3};
+    assert(SecOcStage::create(timed)->protect(h, after_restart, server) && trx->check(h, after_restart, ecu_a));
+
+    // More than one message per millisecond only until the tolerance is used up; everything
+    // sent is still accepted, and sending resumes once the clock catches up
+    timed.time_tolerance_ms = 5;
+    auto fast_rx = SecOcStage::create(timed), fast_tx = SecOcStage::create(timed);
+    int refused = 0;
+    for (int i = 0; i < 100; ++i) {
+        Payload m = {uint8_t(i)};
+        if (!fast_tx->protect(h, m, server)) ++refused;
+        else assert(fast_rx->check(h, m, ecu_a));
+    }
+    assert(refused > 0 && fast_rx->rejected() == 0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    Payload resumed = {1};
+    assert(fast_tx->protect(h, resumed, server) && fast_rx->check(h, resumed, ecu_a));
+
+    // Router integration: unauthenticated requests never reach the handler
+    ServiceRegistry registry;
+    int calls = 0;
+    registry.register_method(0x1300, 0x0010, [&](const Payload& in, const Endpoint&) {
+        ++calls;
+        assert(in == Payload({9}));
+        return MethodResult{ReturnCode::E_OK, {}};
+    });
+    MessageRouter router(nullptr, registry);
+    router.add_protection(0x1300, 0x0010, rx);
+    Endpoint src{"127.0.0.1", 1};
+    SomeIpMessage plain{h, {9}};
+    router.route(plain, src, src, TransportProtocol::UDP);
+    assert(calls == 0);
+    SomeIpMessage secured{h, {9}};
+    assert(tx->protect(h, secured.payload));
+    router.route(secured, src, src, TransportProtocol::UDP);
+    assert(calls == 1);
+
+    // Errors for a protected method are authenticated like responses
+    auto net = LoopbackNetwork::create();
+    auto server_ep = net->create_endpoint("10.0.0.1", 30501);
+    auto client_ep = net->create_endpoint("10.0.0.2", 40000);
+    MessageRouter served(server_ep, registry);
+    auto server_stage = SecOcStage::create(profile), client_stage = SecOcStage::create(profile);
+    served.add_protection(0x1300, 0x0011, server_stage);
+    server_ep->set_callback([&](const SomeIpMessage& m, const Endpoint& s, const Endpoint& d, TransportProtocol p) {
+        served.route(m, s, d, p);
+    });
+    std::vector<SomeIpMessage> errors;
+    client_ep->set_callback([&](const SomeIpMessage& m, const Endpoint&, const Endpoint&, TransportProtocol) {
+        errors.push_back(m);
+    });
+    assert(server_ep->start() && client_ep->start());
+    SomeIpMessage unhandled{SomeIpHeader{0x1300, 0x0011, SomeIpHeader::MIN_LENGTH, 1, 3, 1, 1,
+                                         static_cast<uint8_t>(MessageType::REQUEST), 0},
+                            {}};
+    assert(client_stage->protect(unhandled.header, unhandled.payload, server));
+    unhandled.header.length = static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + unhandled.payload.size());
+    client_ep->send_to(unhandled.serialize(), server);
+    net->run();
+    assert(errors.size() == 1 && errors[0].header.message_type == static_cast<uint8_t>(MessageType::ERR));
+    assert(errors[0].payload.size() == client_stage->overhead());
+    assert(client_stage->check(errors[0].header, errors[0].payload, server) && errors[0].payload.empty());
+
+    std::cout << "test_secoc passed\n";
+    return 0;
+}
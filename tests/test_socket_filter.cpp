@@ -0,0 +1,107 @@
+#include "someip/api.hpp"
+#include "someip/socket_filter.hpp"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+static Payload message(ServiceId svc, MessageType type, ClientId client = 0x0001, SessionId session = 1) {
+    SomeIpMessage msg{SomeIpHeader{svc, 0x0001, SomeIpHeader::MIN_LENGTH + 1, client, session, 1, 1,
+                                   static_cast<uint8_t>(type), 0},
+                      Payload{0x42}};
+    return msg.serialize();
+}
+
+// Wait until `ep` has received `n` datagrams
+static bool wait_for(const UdpEndpoint& ep, Uint64 n) {
+    for (int i = 0; i < 2000 && ep.datagrams_received() < n; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return ep.datagrams_received() >= n;
+}
+
+int main() {
+    assert(someip_socket_filter({}).size() == 4);        // length check only
+    assert(someip_socket_filter({0x1000, 0x1000, 0x2000}, {MessageType::REQUEST}).size() == 9);
+    std::vector<ServiceId> many;
+    for (ServiceId s = 0x1000; s < 0x1000 + 300; ++s) many.push_back(s);
+    assert(someip_socket_filter(many).size() == 7);      // range check
+    assert(client_steering_program(4).size() == 3);
+
+    ServiceRegistry registry;
+    registry.register_method(0x1100, 0x0001, [](const Payload&, const Endpoint&) { return MethodResult{}; });
+    registry.register_method(0x1100, 0x0002, [](const Payload&, const Endpoint&) { return MethodResult{}; });
+    registry.register_method(0x1200, 0x0001, [](const Payload&, const Endpoint&) { return MethodResult{}; });
+    assert(registry.services() == std::vector<ServiceId>({0x1100, 0x1200}));
+
+    // Requests for hosted services pass; other services, other message types and runts never
+    // reach the socket
+    EndpointOptions options;
+    options.socket_filter = someip_socket_filter(registry.services(), {MessageType::REQUEST});
+    auto receiver = create_udp_endpoint("127.0.0.1", 4080, options);
+    auto sender = create_udp_endpoint("127.0.0.1", 4081);
+    assert(receiver && sender);
+    std::mutex mutex;
+    std::vector<ServiceId> seen;
+    receiver->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        std::lock_guard<std::mutex> lk(mutex);
+        seen.push_back(msg.header.service_id);
+    });
+    const Endpoint dest("127.0.0.1", 4080);
+    sender->send_to(message(0x1100, MessageType::REQUEST), dest);
+    sender->send_to(message(0x1300, MessageType::REQUEST), dest);
+    sender->send_to(message(0x1100, MessageType::NOTIFICATION), dest);
+    sender->send_to(Payload{0x11, 0x00, 0x00, 0x01, 0x00}, dest);
+    sender->send_to(message(0x1200, MessageType::REQUEST), dest);
+    assert(wait_for(*receiver, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(receiver->datagrams_received() == 2);
+
+    // Removed, everything arrives again; replaced by a range, the services around it do not
+    assert(receiver->set_socket_filter({}));
+    sender->send_to(message(0x1300, MessageType::REQUEST), dest);
+    assert(wait_for(*receiver, 3));
+    assert(receiver->set_socket_filter(someip_socket_filter(many)));
+    sender->send_to(message(0x0FFF, MessageType::REQUEST), dest);
+    sender->send_to(message(0x2000, MessageType::REQUEST), dest);
+    sender->send_to(message(0x1001, MessageType::RESPONSE), dest);
+    assert(wait_for(*receiver, 4));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    {
+        std::lock_guard<std::mutex> lk(mutex);
+        assert(seen == std::vector<ServiceId>({0x1100, 0x1200, 0x1300, 0x1001}));
+    }
+    receiver->stop();
+
+    // Two sockets on one port: each client's requests all land on socket client_id % 2
+    EndpointOptions shard_options;
+    shard_options.reuse_port = true;
+    shard_options.reuseport_program = client_steering_program(2);
+    std::shared_ptr<UdpEndpoint> shards[2] = {create_udp_endpoint("127.0.0.1", 4082, shard_options),
+                                              create_udp_endpoint("127.0.0.1", 4082, shard_options)};
+    assert(shards[0] && shards[1]);
+    std::vector<ClientId> clients[2];
+    for (int i = 0; i < 2; ++i) {
+        shards[i]->set_callback([&, i](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+            std::lock_guard<std::mutex> lk(mutex);
+            clients[i].push_back(msg.header.client_id);
+        });
+    }
+    for (SessionId session = 1; session <= 4; ++session) {
+        for (ClientId client = 0x0010; client < 0x0018; ++client) {
+            sender->send_to(message(0x1100, MessageType::REQUEST, client, session), Endpoint("127.0.0.1", 4082));
+        }
+    }
+    for (int i = 0; i < 2000 && shards[0]->datagrams_received() + shards[1]->datagrams_received() < 32; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::lock_guard<std::mutex> lk(mutex);
+    assert(clients[0].size() == 16 && clients[1].size() == 16);
+    for (int i = 0; i < 2; ++i) {
+        for (ClientId c : clients[i]) assert(c % 2 == i);
+    }
+
+    std::cout << "test_socket_filter passed\n";
+    return 0;
+}
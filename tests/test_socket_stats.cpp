@@ -0,0 +1,103 @@
+#include "someip/api.hpp"
+#include "someip/metrics.hpp"
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+using namespace someip;
+
+static Uint64 realtime_ns() {
+    return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+int main() {
+    // Handlers see the receive timestamps of the request they serve
+    {
+        auto server = create_udp_endpoint("127.0.0.1", 4050);
+        auto client = create_udp_endpoint("127.0.0.1", 4052);
+        assert(server && client);
+        ServiceRegistry registry;
+        std::atomic<Uint64> kernel_ns{0}, user_ns{0};
+        registry.register_method(0x1300, 0x0040, [&](const Payload&, const Endpoint&) {
+            const SomeIpMessage* request = MessageRouter::current_request();
+            assert(request && request->header.method_id == 0x0040);
+            kernel_ns = request->rx.kernel_ns;
+            user_ns = request->rx.user_ns;
+            return MethodResult{ReturnCode::E_OK, {}};
+        });
+        auto router = create_message_router(server, registry);
+        server->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol p) {
+            assert(msg.rx.user_ns != 0);
+            router->route(msg, src, dst, p);
+        });
+        std::atomic<bool> answered{false};
+        client->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            answered = true;
+        });
+
+        Uint64 before = realtime_ns();
+        SomeIpHeader request{0x1300, 0x0040, SomeIpHeader::MIN_LENGTH, 1, 1, 1, 1,
+                             static_cast<uint8_t>(MessageType::REQUEST), 0};
+        assert(client->send_to(request.serialize(), Endpoint("127.0.0.1", 4050)));
+        for (int i = 0; i < 2000 && !answered; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        assert(answered && user_ns != 0);
+        assert(MessageRouter::current_request() == nullptr);
+#ifdef __linux__
+        assert(kernel_ns >= before && kernel_ns <= realtime_ns());
+        const metrics::MethodSnapshot* m = metrics::snapshot().find(0x1300, 0x0040);
+        assert(!metrics::enabled || (m && m->socket_delay.count() == 2));  // request and response
+#endif
+        assert(server->datagrams_received() == 1 && server->socket_drops() == 0);
+    }
+
+#ifdef __linux__
+    // A flood into a small, stalled receive buffer is counted as kernel drops
+    {
+        EndpointOptions small;
+        small.rcvbuf = 4096;
+        auto server = create_udp_endpoint("127.0.0.1", 4054, small);
+        auto client = create_udp_endpoint("127.0.0.1", 4056);
+        assert(server && client);
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool stalled = false, resume = false;
+        server->set_callback([&](const SomeIpMessage&, const Endpoint&, const Endpoint&, TransportProtocol) {
+            std::unique_lock<std::mutex> lk(mutex);
+            if (stalled) return;
+            stalled = true;
+            cv.notify_all();
+            cv.wait(lk, [&] { return resume; });
+        });
+
+        SomeIpHeader h{0x1300, 0x0041, SomeIpHeader::MIN_LENGTH + 1000, 1, 1, 1, 1,
+                       static_cast<uint8_t>(MessageType::REQUEST), 0};
+        SomeIpMessage msg{h, Payload(1000, 0x55)};
+        Endpoint to_server("127.0.0.1", 4054);
+        assert(client->send_to(msg.serialize(), to_server));
+        {
+            std::unique_lock<std::mutex> lk(mutex);
+            assert(cv.wait_for(lk, std::chrono::seconds(2), [&] { return stalled; }));
+        }
+        for (int i = 0; i < 200; ++i) client->send_to(msg.serialize(), to_server);
+        {
+            std::lock_guard<std::mutex> lk(mutex);
+            resume = true;
+            cv.notify_all();
+        }
+        // The counter rides on datagrams queued after the drops, so probe until the queue drained
+        for (int i = 0; i < 2000 && server->socket_drops() == 0; ++i) {
+            client->send_to(msg.serialize(), to_server);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(server->socket_drops() > 0 && server->datagrams_received() > 1);
+    }
+#endif
+
+    std::cout << "test_socket_stats passed\n";
+    return 0;
+}
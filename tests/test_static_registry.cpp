@@ -0,0 +1,106 @@
+#include "someip/api.hpp"
+#include "someip/loopback.hpp"
+#include "someip/message_router.hpp"
+#include "someip/static_registry.hpp"
+#include <cassert>
+#include <iostream>
+
+using namespace someip;
+
+static int echo_calls = 0;
+
+MethodResult echo(const Payload& in, const Endpoint&) {
+    ++echo_calls;
+    return {ReturnCode::E_OK, in};
+}
+
+ReturnCode sum(const Payload& in, const Endpoint&, SerializationBuffer& out) {
+    // The request is visible to the handler like with the dynamic registry
+    assert(MessageRouter::current_request() && MessageRouter::current_request()->header.method_id == 0x0002);
+    Uint8 total = 0;
+    for (Uint8 b : in) total = static_cast<Uint8>(total + b);
+    out.write_uint8(total);
+    return ReturnCode::E_OK;
+}
+
+ReturnCode refuse(const Payload&, const Endpoint&, SerializationBuffer& out) {
+    out.write_uint8(0xFF);
+    return ReturnCode::E_NOT_OK;
+}
+
+using Routes = StaticRegistry<
+    StaticService<0x1000, StaticMethod<0x0001, &echo>,
+                          StaticMethod<0x0002, &sum>>,
+    StaticService<0x2000, StaticMethod<0x0001, &refuse>>>;
+
+static_assert(Routes::method_count() == 3, "method count");
+static_assert(Routes::contains(0x1000, 0x0002) && Routes::contains(0x2000, 0x0001), "contains");
+static_assert(!Routes::contains(0x1000, 0x0003) && !Routes::contains(0x2000, 0x0002), "missing method");
+static_assert(!Routes::contains(0x3000, 0x0001), "missing service");
+
+SomeIpMessage request(ServiceId service, MethodId method, const Payload& payload) {
+    return SomeIpMessage{SomeIpHeader{service, method, static_cast<Uint32>(SomeIpHeader::MIN_LENGTH + payload.size()), 1, 1, 1, 1,
+                                      static_cast<uint8_t>(MessageType::REQUEST), 0},
+                         payload};
+}
+
+int main() {
+    // Direct dispatch
+    {
+        Payload in{1, 2, 3};
+        SerializationBuffer out;
+        ReturnCode rc = ReturnCode::E_UNKNOWN;
+        assert(Routes::dispatch(0x1000, 0x0001, in, Endpoint(), out, rc));
+        assert(rc == ReturnCode::E_OK && out.buf == in && echo_calls == 1);
+        out.buf.clear();
+        rc = ReturnCode::E_UNKNOWN;
+        assert(!Routes::dispatch(0x1000, 0x0009, in, Endpoint(), out, rc));
+        assert(!Routes::dispatch(0x3000, 0x0001, in, Endpoint(), out, rc));
+        assert(rc == ReturnCode::E_UNKNOWN && out.buf.empty());
+    }
+
+    // Through the router, with the dynamic registry behind the static table
+    auto net = LoopbackNetwork::create();
+    auto server_ep = net->create_endpoint("10.0.0.1", 30501);
+    auto client_ep = net->create_endpoint("10.0.0.2", 40000);
+    ServiceRegistry registry;
+    int dynamic_calls = 0;
+    registry.register_method(0x1000, 0x0001, [&](const Payload&, const Endpoint&) -> MethodResult {
+        ++dynamic_calls;  // shadowed by the static table
+        return {ReturnCode::E_OK, {}};
+    });
+    registry.register_method(0x1000, 0x0003, [&](const Payload&, const Endpoint&) -> MethodResult {
+        ++dynamic_calls;
+        return {ReturnCode::E_OK, Payload{0x33}};
+    });
+    auto router = create_message_router(server_ep, registry);
+    router->set_static_routes(Routes::routes());
+    server_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint& dst, TransportProtocol proto) {
+        router->route(msg, src, dst, proto);
+    });
+    std::vector<SomeIpMessage> replies;
+    client_ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        replies.push_back(msg);
+    });
+    assert(server_ep->start() && client_ep->start());
+
+    const Endpoint server("10.0.0.1", 30501);
+    client_ep->send_to(request(0x1000, 0x0001, Payload{7, 8}).serialize(), server);
+    client_ep->send_to(request(0x1000, 0x0002, Payload{1, 2, 3}).serialize(), server);
+    client_ep->send_to(request(0x2000, 0x0001, Payload{}).serialize(), server);
+    client_ep->send_to(request(0x1000, 0x0003, Payload{}).serialize(), server);
+    client_ep->send_to(request(0x4000, 0x0001, Payload{}).serialize(), server);
+    net->run();
+
+    assert(replies.size() == 5);
+    assert(replies[0].header.message_type == static_cast<uint8_t>(MessageType::RESPONSE));
+    assert(replies[0].payload == Payload({7, 8}) && echo_calls == 2);
+    assert(replies[1].header.method_id == 0x0002 && replies[1].payload == Payload({6}));
+    // Like a BufferMethodHandler, the return code goes out in a RESPONSE along with the payload
+    assert(replies[2].header.return_code == static_cast<uint8_t>(ReturnCode::E_NOT_OK) && replies[2].payload == Payload({0xFF}));
+    assert(replies[3].payload == Payload({0x33}) && dynamic_calls == 1);
+    assert(replies[4].header.return_code == static_cast<uint8_t>(ReturnCode::E_UNKNOWN));
+
+    std::cout << "test_static_registry passed\n";
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include "someip/certificates.hpp"
+#include "someip/tls_transport.hpp"
+#include <cassert>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace someip;
+
+static std::string read_text(const std::string& name) {
+    std::ifstream in(std::string(SOMEIP_TEST_DATA_DIR) + "/" + name);
+    std::stringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+static Payload request(Uint16 session) {
+    SomeIpHeader h{0x1300, 0x0030, SomeIpHeader::MIN_LENGTH + 1, 1, session, 1, 1,
+                   static_cast<uint8_t>(MessageType::REQUEST), 0};
+    return SomeIpMessage{h, {0x42}}.serialize();
+}
+
+// Connect, do one request/response and disconnect
+static bool round_trip(TlsClient& client, uint16_t port, Uint16 session) {
+    if (!client.connect("127.0.0.1", port)) return false;
+    bool ok = client.send(request(session));
+    auto resp = client.receive();
+    client.disconnect();
+    return ok && resp && resp->header.session_id == session && resp->payload == Payload({0x43});
+}
+
+int main() {
+    std::string ca = read_text("ca.pem"), inter = read_text("intermediate.pem"), leaf = read_text("server.pem");
+
+    // Identity and certificate information
+    auto server_certs = std::make_shared<CertificateManager>();
+    assert(server_certs->load_certificate_pem(leaf + inter));
+    assert(server_certs->load_private_key(std::string(SOMEIP_TEST_DATA_DIR) + "/server.key"));
+    auto info = server_certs->get_certificate_info();
+    assert(info && info->subject == "CN=localhost" && !info->is_ca && info->key_size_bits == 256);
+    assert(info->subject_alt_names.size() == 2 && info->subject_alt_names[1] == "127.0.0.1");
+    assert(info->not_after > std::chrono::system_clock::now());
+
+    // Chain verification and the verification cache
+    auto client_certs = std::make_shared<CertificateManager>();
+    assert(client_certs->add_ca_certificate_pem(ca));
+    assert(!client_certs->verify_certificate(leaf).valid);
+    assert(client_certs->verify_certificate(leaf, {inter}).valid);
+    assert(client_certs->verify_certificate(leaf, {inter}).valid);
+    assert(client_certs->cache_misses() == 2 && client_certs->cache_hits() == 1);
+    // Not cleared: the handshake below checks the chain for the server purpose and must miss
+    Uint64 misses = client_certs->cache_misses(), hits = client_certs->cache_hits();
+    assert(CertificateManager::fingerprint(Payload(leaf.begin(), leaf.end())).size() == 64);
+
+    // TLS echo server
+    TlsServer server(server_certs);
+    server.set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint&, TransportProtocol proto) {
+        assert(proto == TransportProtocol::TCP);
+        SomeIpMessage resp = msg;
+        resp.header.message_type = static_cast<uint8_t>(MessageType::RESPONSE);
+        resp.payload[0] += 1;
+        server.send_to(resp.serialize(), src);
+    });
+    assert(server.start("127.0.0.1", 0) && server.local_port() != 0);
+
+    // The first connection is a full handshake, reconnects resume the session
+    TlsOptions opts;
+    opts.server_name = "127.0.0.1";
+    TlsClient client(client_certs, opts);
+    assert(round_trip(client, server.local_port(), 1) && !client.session_resumed());
+    assert(round_trip(client, server.local_port(), 2) && client.session_resumed());
+    assert(round_trip(client, server.local_port(), 3) && client.session_resumed());
+    assert(server.handshakes() == 3 && server.resumed_handshakes() == 2);
+    assert(client_certs->cache_misses() == misses + 1);
+
+    // A second client with a fresh session still skips chain validation through the cache
+    TlsClient other(client_certs, opts);
+    assert(round_trip(other, server.local_port(), 4) && !other.session_resumed());
+    assert(client_certs->cache_hits() == hits + 1);
+
+    // Wrong expected name, and an untrusted server
+    TlsOptions wrong = opts;
+    wrong.server_name = "brake.example.com";
+    TlsClient mismatched(client_certs, wrong);
+    assert(!mismatched.connect("127.0.0.1", server.local_port()));
+    TlsClient untrusting(std::make_shared<CertificateManager>(), opts);
+    assert(!untrusting.connect("127.0.0.1", server.local_port()));
+    TlsClient blind(nullptr, opts);
+    assert(!blind.connect("127.0.0.1", server.local_port()));
+    server.stop();
+
+    // Without tickets or a server session cache every reconnect is a full handshake
+    TlsOptions no_resume;
+    no_resume.session_tickets = false;
+    no_resume.session_cache = false;
+    TlsServer plain(server_certs, no_resume);
+    plain.set_callback([&](const SomeIpMessage& msg, const Endpoint& src, const Endpoint&, TransportProtocol) {
+        SomeIpMessage resp = msg;
+        resp.payload[0] += 1;
+        plain.send_to(resp.serialize(), src);
+    });
+    assert(plain.start("127.0.0.1", 0));
+    TlsClient again(client_certs, opts);
+    assert(round_trip(again, plain.local_port(), 5) && round_trip(again, plain.local_port(), 6));
+    assert(!again.session_resumed() && plain.resumed_handshakes() == 0);
+
+    std::cout << "test_tls passed\n";
+    return 0;
+}
@@ -0,0 +1,760 @@
+// Generates typed SOME/IP skeletons and proxies from an interface description (.sidl):
+//
+//   package brake;                         // C++ namespace (a.b -> a::b)
+//   struct Pressure { uint16 front; uint16 rear; }
+//   service Brake 0x1300 version 1 {
+//       method press 0x0010 (uint8 force) -> (bool applied);
+//       event overheat 0x8040 (int16 temperature);
+//       field status : uint8 { getter 0x0030; setter 0x0031; notifier 0x8030; }
+//   }
+//
+// Types: bool, int8..int64, uint8..uint64, float32, float64, structs declared earlier, and
+// `bytes` (variable length; only as the last member). Every struct and parameter list becomes a
+// record with a constexpr big-endian layout and a zero-copy View; see include/someip/idl_support.hpp.
+//
+// usage: someip_idlc <input.sidl> [-o <output.hpp>]
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Error {
+    int line;
+    std::string message;
+};
+
+// ---- Lexer -------------------------------------------------------------------------------
+
+enum class Tok { IDENT, NUMBER, PUNCT, END };
+
+struct Token {
+    Tok kind;
+    std::string text;
+    unsigned long value = 0;
+    int line = 0;
+};
+
+std::vector<Token> lex(const std::string& src) {
+    std::vector<Token> out;
+    int line = 1;
+    size_t i = 0;
+    while (i < src.size()) {
+        char c = src[i];
+        if (c == '\n') {
+            ++line;
+            ++i;
+        } else if (std::isspace(static_cast<unsigned char>(c))) {
+            ++i;
+        } else if (src.compare(i, 2, "//") == 0) {
+            while (i < src.size() && src[i] != '\n') ++i;
+        } else if (src.compare(i, 2, "/*") == 0) {
+            size_t end = src.find("*/", i + 2);
+            if (end == std::string::npos) throw Error{line, "unterminated comment"};
+            for (size_t k = i; k < end; ++k) line += src[k] == '\n';
+            i = end + 2;
+        } else if (std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = i;
+            while (i < src.size() && (std::isalnum(static_cast<unsigned char>(src[i])) || src[i] == '_')) ++i;
+            out.push_back({Tok::IDENT, src.substr(start, i - start), 0, line});
+        } else if (std::isdigit(static_cast<unsigned char>(c))) {
+            size_t start = i;
+            while (i < src.size() && std::isalnum(static_cast<unsigned char>(src[i]))) ++i;
+            std::string text = src.substr(start, i - start);
+            char* end = nullptr;
+            unsigned long v = std::strtoul(text.c_str(), &end, 0);
+            if (*end != '\0') throw Error{line, "bad number '" + text + "'"};
+            out.push_back({Tok::NUMBER, text, v, line});
+        } else if (src.compare(i, 2, "->") == 0) {
+            out.push_back({Tok::PUNCT, "->", 0, line});
+            i += 2;
+        } else if (std::string("{}();:,.").find(c) != std::string::npos) {
+            out.push_back({Tok::PUNCT, std::string(1, c), 0, line});
+            ++i;
+        } else {
+            throw Error{line, std::string("unexpected character '") + c + "'"};
+        }
+    }
+    out.push_back({Tok::END, "end of file", 0, line});
+    return out;
+}
+
+// ---- Model -------------------------------------------------------------------------------
+
+struct Record;
+
+struct Type {
+    enum Kind { SCALAR, BYTES, RECORD } kind = SCALAR;
+    std::string cpp;  // value type
+    size_t size = 0;  // fixed wire size
+    const Record* record = nullptr;
+};
+
+struct Member {
+    std::string name;
+    Type type;
+    size_t offset = 0;
+    int line = 0;
+};
+
+struct Record {
+    std::string name;
+    std::vector<Member> members;
+    size_t size = 0;        // fixed part
+    bool variable = false;  // trailing bytes
+};
+
+struct Method {
+    std::string name;
+    unsigned id = 0;
+    const Record* request = nullptr;
+    const Record* response = nullptr;
+};
+
+struct Event {
+    std::string name;
+    unsigned id = 0;
+    const Record* args = nullptr;
+};
+
+struct FieldDef {
+    std::string name;
+    Type type;
+    unsigned getter = 0, setter = 0, notifier = 0;
+};
+
+struct Service {
+    std::string name;
+    unsigned id = 0;
+    unsigned version = 1;
+    std::vector<Method> methods;
+    std::vector<Event> events;
+    std::vector<FieldDef> fields;
+};
+
+struct Interface {
+    std::vector<std::string> package;
+    std::vector<std::unique_ptr<Record>> records;  // in declaration order
+    std::vector<Service> services;
+};
+
+std::string camel(const std::string& snake) {
+    std::string out;
+    bool up = true;
+    for (char c : snake) {
+        if (c == '_') {
+            up = true;
+        } else {
+            out += up ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : c;
+            up = false;
+        }
+    }
+    return out;
+}
+
+std::string upper(const std::string& s) {
+    std::string out;
+    for (char c : s) out += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return out;
+}
+
+std::string hex(unsigned v) {
+    char buf[8];
+    std::snprintf(buf, sizeof(buf), "0x%04X", v);
+    return buf;
+}
+
+// Names generated code uses for itself, and C++ keywords likely to show up as names
+const std::set<std::string>& reserved() {
+    static const std::set<std::string> names = {
+        "SIZE", "VARIABLE", "Offset", "View", "fits", "wire_size", "write", "value", "size", "d", "p", "dest",
+        "auto", "bool", "break", "case", "char", "class", "const", "default", "delete", "do", "double",
+        "else", "enum", "explicit", "false", "float", "for", "friend", "goto", "if", "inline", "int",
+        "long", "namespace", "new", "operator", "private", "protected", "public", "register", "return",
+        "short", "signed", "sizeof", "static", "struct", "switch", "template", "this", "throw", "true",
+        "try", "typedef", "typename", "union", "unsigned", "using", "virtual", "void", "volatile", "while"};
+    return names;
+}
+
+// ---- Parser ------------------------------------------------------------------------------
+
+class Parser {
+public:
+    explicit Parser(std::vector<Token> tokens) : t_(std::move(tokens)) {}
+
+    Interface parse() {
+        while (peek().kind != Tok::END) {
+            std::string kw = ident("'package', 'struct' or 'service'");
+            if (kw == "package") parse_package();
+            else if (kw == "struct") parse_struct();
+            else if (kw == "service") parse_service();
+            else fail("expected 'package', 'struct' or 'service', got '" + kw + "'");
+        }
+        return std::move(ifc_);
+    }
+
+private:
+    const Token& peek() const { return t_[pos_]; }
+    const Token& next() { return t_[pos_ < t_.size() - 1 ? pos_++ : pos_]; }
+    [[noreturn]] void fail(const std::string& msg) const { throw Error{peek().line, msg}; }
+
+    bool accept(const std::string& punct) {
+        if (peek().kind == Tok::PUNCT && peek().text == punct) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+    void expect(const std::string& punct) {
+        if (!accept(punct)) fail("expected '" + punct + "', got '" + peek().text + "'");
+    }
+    std::string ident(const std::string& what) {
+        if (peek().kind != Tok::IDENT) fail("expected " + what + ", got '" + peek().text + "'");
+        return next().text;
+    }
+    std::string name(const std::string& what) {
+        int line = peek().line;
+        std::string n = ident(what);
+        if (reserved().count(n)) throw Error{line, "'" + n + "' is reserved"};
+        return n;
+    }
+    unsigned number(const std::string& what, unsigned max) {
+        if (peek().kind != Tok::NUMBER) fail("expected " + what + ", got '" + peek().text + "'");
+        const Token& tok = next();
+        if (tok.value > max) throw Error{tok.line, what + " " + tok.text + " out of range"};
+        return static_cast<unsigned>(tok.value);
+    }
+
+    void parse_package() {
+        if (!ifc_.package.empty()) fail("duplicate package");
+        do {
+            ifc_.package.push_back(name("package name"));
+        } while (accept("."));
+        expect(";");
+    }
+
+    Type parse_type() {
+        static const std::map<std::string, std::pair<std::string, size_t>> scalars = {
+            {"bool", {"bool", 1}},           {"uint8", {"someip::Uint8", 1}},   {"uint16", {"someip::Uint16", 2}},
+            {"uint32", {"someip::Uint32", 4}}, {"uint64", {"someip::Uint64", 8}}, {"int8", {"int8_t", 1}},
+            {"int16", {"int16_t", 2}},       {"int32", {"int32_t", 4}},         {"int64", {"int64_t", 8}},
+            {"float32", {"float", 4}},       {"float64", {"double", 8}}};
+        int line = peek().line;
+        std::string n = ident("type");
+        Type t;
+        auto s = scalars.find(n);
+        if (s != scalars.end()) {
+            t.cpp = s->second.first;
+            t.size = s->second.second;
+        } else if (n == "bytes") {
+            t.kind = Type::BYTES;
+            t.cpp = "someip::Payload";
+        } else {
+            auto r = records_.find(n);
+            if (r == records_.end()) throw Error{line, "unknown type '" + n + "' (structs must be declared before use)"};
+            t.kind = Type::RECORD;
+            t.cpp = n;
+            t.record = r->second;
+            t.size = r->second->size;
+        }
+        return t;
+    }
+
+    // Lay out members back to back; checks names and the position of variable-size members
+    void add_member(Record& r, Member m) {
+        for (const Member& other : r.members) {
+            if (other.name == m.name) throw Error{m.line, "duplicate member '" + m.name + "' in " + r.name};
+        }
+        if (r.variable) throw Error{m.line, "'bytes' must be the last member of " + r.name};
+        if (m.type.kind == Type::RECORD && m.type.record->variable) {
+            throw Error{m.line, "struct " + m.type.cpp + " ends in bytes and cannot be nested"};
+        }
+        m.offset = r.size;
+        if (m.type.kind == Type::BYTES) r.variable = true;
+        else r.size += m.type.size;
+        r.members.push_back(std::move(m));
+    }
+
+    Record* new_record(const std::string& n, int line) {
+        if (records_.count(n)) throw Error{line, "duplicate type name '" + n + "'"};
+        ifc_.records.push_back(std::make_unique<Record>());
+        Record* r = ifc_.records.back().get();
+        r->name = n;
+        records_[n] = r;
+        return r;
+    }
+
+    void parse_struct() {
+        int line = peek().line;
+        Record* r = new_record(name("struct name"), line);
+        expect("{");
+        while (!accept("}")) {
+            Member m;
+            m.line = peek().line;
+            m.type = parse_type();
+            m.name = name("member name");
+            expect(";");
+            add_member(*r, std::move(m));
+        }
+        accept(";");
+    }
+
+    const Record* parse_params(const std::string& record_name, int line) {
+        Record* r = new_record(record_name, line);
+        expect("(");
+        if (!accept(")")) {
+            do {
+                Member m;
+                m.line = peek().line;
+                m.type = parse_type();
+                m.name = name("parameter name");
+                add_member(*r, std::move(m));
+            } while (accept(","));
+            expect(")");
+        }
+        return r;
+    }
+
+    void parse_service() {
+        Service s;
+        int line = peek().line;
+        s.name = name("service name");
+        if (records_.count(s.name)) throw Error{line, "service '" + s.name + "' clashes with a type name"};
+        s.id = number("service ID", 0xFFFE);
+        if (peek().kind == Tok::IDENT && peek().text == "version") {
+            next();
+            s.version = number("interface version", 0xFF);
+        }
+        expect("{");
+        std::map<unsigned, std::string> ids;
+        std::set<std::string> names;
+        auto claim_id = [&](unsigned id, const std::string& what, int at, bool event) {
+            if (event && (id < 0x8000 || id == 0xFFFF)) throw Error{at, what + ": event IDs are 0x8000..0xFFFE"};
+            if (!event && (id == 0 || id >= 0x8000)) throw Error{at, what + ": method IDs are 0x0001..0x7FFF"};
+            auto it = ids.find(id);
+            if (it != ids.end()) throw Error{at, what + ": ID " + hex(id) + " already used by " + it->second};
+            ids[id] = what;
+        };
+        auto claim_name = [&](const std::string& n, int at) {
+            if (!names.insert(n).second) throw Error{at, "duplicate name '" + n + "' in service " + s.name};
+        };
+        while (!accept("}")) {
+            int at = peek().line;
+            std::string kw = ident("'method', 'event' or 'field'");
+            if (kw == "method") {
+                Method m;
+                m.name = name("method name");
+                claim_name(m.name, at);
+                m.id = number("method ID", 0xFFFF);
+                claim_id(m.id, "method " + m.name, at, false);
+                m.request = parse_params(camel(m.name) + "Request", at);
+                if (accept("->")) {
+                    m.response = parse_params(camel(m.name) + "Response", at);
+                } else {
+                    m.response = new_record(camel(m.name) + "Response", at);
+                }
+                expect(";");
+                s.methods.push_back(m);
+            } else if (kw == "event") {
+                Event e;
+                e.name = name("event name");
+                claim_name(e.name, at);
+                e.id = number("event ID", 0xFFFF);
+                claim_id(e.id, "event " + e.name, at, true);
+                e.args = parse_params(camel(e.name) + "Event", at);
+                expect(";");
+                s.events.push_back(e);
+            } else if (kw == "field") {
+                FieldDef f;
+                f.name = name("field name");
+                claim_name(f.name, at);
+                expect(":");
+                f.type = parse_type();
+                if (f.type.kind == Type::BYTES) f.type.cpp = "someip::Payload";
+                expect("{");
+                while (!accept("}")) {
+                    int k_at = peek().line;
+                    std::string k = ident("'getter', 'setter' or 'notifier'");
+                    unsigned id = number(k + " ID", 0xFFFF);
+                    expect(";");
+                    unsigned* slot = k == "getter" ? &f.getter : k == "setter" ? &f.setter : k == "notifier" ? &f.notifier : nullptr;
+                    if (!slot) throw Error{k_at, "expected 'getter', 'setter' or 'notifier', got '" + k + "'"};
+                    if (*slot) throw Error{k_at, "duplicate " + k + " for field " + f.name};
+                    *slot = id;
+                    claim_id(id, "field " + f.name + " " + k, k_at, k == "notifier");
+                }
+                if (!f.getter && !f.setter && !f.notifier) throw Error{at, "field " + f.name + " has no getter, setter or notifier"};
+                s.fields.push_back(f);
+            } else {
+                throw Error{at, "expected 'method', 'event' or 'field', got '" + kw + "'"};
+            }
+        }
+        accept(";");
+        // The ID constants must not collide either (e.g. method status_get and field status)
+        std::set<std::string> constants;
+        auto constant = [&](const std::string& c) {
+            if (!constants.insert(c).second) throw Error{line, "generated constant " + s.name + "::" + c + " is ambiguous"};
+        };
+        for (const Method& m : s.methods) constant(upper(m.name));
+        for (const Event& e : s.events) constant(upper(e.name));
+        for (const FieldDef& f : s.fields) {
+            if (f.getter) constant(upper(f.name) + "_GET");
+            if (f.setter) constant(upper(f.name) + "_SET");
+            if (f.notifier) constant(upper(f.name) + "_NOTIFY");
+        }
+        ifc_.services.push_back(std::move(s));
+    }
+
+    std::vector<Token> t_;
+    size_t pos_ = 0;
+    Interface ifc_;
+    std::map<std::string, Record*> records_;
+};
+
+// ---- Emitter -----------------------------------------------------------------------------
+
+// How a member is passed to generated send functions
+std::string arg_type(const Type& t) {
+    if (t.kind == Type::BYTES) return "someip::wire::BytesView";
+    if (t.kind == Type::RECORD) return "const " + t.cpp + "&";
+    return t.cpp;
+}
+
+std::string params(const Record& r) {
+    std::string out;
+    for (const Member& m : r.members) {
+        if (!out.empty()) out += ", ";
+        out += arg_type(m.type) + " " + m.name;
+    }
+    return out;
+}
+
+std::string payload_size(const Record& r) {
+    std::string out = r.name + "::SIZE";
+    if (r.variable) out += " + " + r.members.back().name + ".size";
+    return out;
+}
+
+void emit_record(std::ostream& o, const Record& r) {
+    o << "struct " << r.name << " {\n";
+    for (const Member& m : r.members) o << "    " << m.type.cpp << " " << m.name << "{};\n";
+    if (!r.members.empty()) o << "\n";
+    o << "    // Wire layout: big-endian, no padding" << (r.variable ? "; the fixed part, then the bytes" : "") << "\n";
+    o << "    static constexpr size_t SIZE = " << r.size << ";\n";
+    o << "    static constexpr bool VARIABLE = " << (r.variable ? "true" : "false") << ";\n";
+    if (r.members.empty()) {
+        o << "    struct Offset {};\n";
+    } else {
+        o << "    struct Offset {\n";
+        for (const Member& m : r.members) o << "        static constexpr size_t " << m.name << " = " << m.offset << ";\n";
+        o << "    };\n";
+    }
+    o << "    static constexpr bool fits(size_t n) { return VARIABLE ? n >= SIZE : n == SIZE; }\n";
+    o << "    size_t wire_size() const { return SIZE" << (r.variable ? " + " + r.members.back().name + ".size()" : "") << "; }\n";
+    if (r.members.empty()) {
+        o << "    void write(uint8_t*) const {}\n\n";
+    } else {
+        o << "    void write(uint8_t* p) const {\n";
+        for (const Member& m : r.members) o << "        someip::wire::put(p + Offset::" << m.name << ", " << m.name << ");\n";
+        o << "    }\n\n";
+    }
+    o << "    // Zero-copy accessors over received bytes; check fits() first\n";
+    o << "    class View {\n";
+    o << "    public:\n";
+    o << "        View(const uint8_t* p, size_t n) : p_(p), n_(n) {}\n";
+    o << "        size_t size() const { return n_; }\n";
+    for (const Member& m : r.members) {
+        if (m.type.kind == Type::SCALAR) {
+            o << "        " << m.type.cpp << " " << m.name << "() const { return someip::wire::load<" << m.type.cpp
+              << ">(p_ + Offset::" << m.name << "); }\n";
+        } else if (m.type.kind == Type::RECORD) {
+            o << "        " << m.type.cpp << "::View " << m.name << "() const { return " << m.type.cpp << "::View(p_ + Offset::"
+              << m.name << ", " << m.type.cpp << "::SIZE); }\n";
+        } else {
+            o << "        someip::wire::BytesView " << m.name << "() const { return someip::wire::BytesView(p_ + SIZE, n_ - SIZE); }\n";
+        }
+    }
+    o << "        " << r.name << " value() const {\n";
+    o << "            " << r.name << " v;\n";
+    for (const Member& m : r.members) {
+        o << "            v." << m.name << " = " << m.name << "()";
+        if (m.type.kind == Type::RECORD) o << ".value()";
+        if (m.type.kind == Type::BYTES) o << ".to_payload()";
+        o << ";\n";
+    }
+    o << "            return v;\n";
+    o << "        }\n\n";
+    o << "    private:\n";
+    o << "        const uint8_t* p_;\n";
+    o << "        size_t n_;\n";
+    o << "    };\n";
+    o << "};\n\n";
+}
+
+// Body that allocates datagram `d` and writes the members of `r` from same-named parameters
+void emit_fill(std::ostream& o, const Record& r) {
+    o << "    someip::Payload d = someip::wire::datagram(" << payload_size(r) << ");\n";
+    if (!r.members.empty()) {
+        o << "    uint8_t* p = d.data() + someip::SomeIpHeader::SIZE;\n";
+        for (const Member& m : r.members) {
+            o << "    someip::wire::put(p + " << r.name << "::Offset::" << m.name << ", " << m.name << ");\n";
+        }
+    }
+}
+
+void emit_service(std::ostream& o, const Service& s) {
+    const std::string& S = s.name;
+    o << "// Service " << S << " (" << hex(s.id) << ", interface version " << s.version << ")\n";
+    o << "struct " << S << " {\n";
+    o << "    static constexpr someip::ServiceId SERVICE_ID = " << hex(s.id) << ";\n";
+    o << "    static constexpr someip::Uint8 INTERFACE_VERSION = " << s.version << ";\n";
+    for (const Method& m : s.methods) o << "    static constexpr someip::MethodId " << upper(m.name) << " = " << hex(m.id) << ";\n";
+    for (const Event& e : s.events) o << "    static constexpr someip::MethodId " << upper(e.name) << " = " << hex(e.id) << ";\n";
+    for (const FieldDef& f : s.fields) {
+        if (f.getter) o << "    static constexpr someip::MethodId " << upper(f.name) << "_GET = " << hex(f.getter) << ";\n";
+        if (f.setter) o << "    static constexpr someip::MethodId " << upper(f.name) << "_SET = " << hex(f.setter) << ";\n";
+        if (f.notifier) o << "    static constexpr someip::MethodId " << upper(f.name) << "_NOTIFY = " << hex(f.notifier) << ";\n";
+    }
+    o << "};\n\n";
+
+    auto field_id = [&](const FieldDef& f, unsigned id, const char* suffix) {
+        return id ? S + "::" + upper(f.name) + suffix : std::string("0");
+    };
+
+    // Skeleton
+    o << "// Server side of " << S << ": implement the methods, then attach() to a registry. Requests\n";
+    o << "// are decoded in place and responses are written straight into the router's buffer.\n";
+    o << "class " << S << "Skeleton : public someip::SkeletonBase {\n";
+    o << "public:\n";
+    o << "    " << S << "Skeleton()\n";
+    o << "        : SkeletonBase(" << S << "::SERVICE_ID, " << S << "::INTERFACE_VERSION)";
+    for (const FieldDef& f : s.fields) {
+        o << ",\n          " << f.name << "(" << S << "::SERVICE_ID, someip::FieldOptions{" << field_id(f, f.getter, "_GET") << ", "
+          << field_id(f, f.setter, "_SET") << ", " << field_id(f, f.notifier, "_NOTIFY") << "})";
+    }
+    o << " {}\n\n";
+    o << "    // Register methods and fields with `registry`; notifications and events go out through\n";
+    o << "    // `transport`. The skeleton must outlive the registration.\n";
+    o << "    void attach(someip::ServiceRegistry& registry, std::shared_ptr<someip::Transport> transport);\n";
+    for (const Method& m : s.methods) {
+        o << "\n    // " << m.name << " (" << hex(m.id) << "); `out` is sent only with E_OK\n";
+        o << "    virtual someip::ReturnCode " << m.name << "(const " << m.request->name << "::View& in, " << m.response->name
+          << "& out, const someip::Endpoint& src) = 0;\n";
+    }
+    for (const Event& e : s.events) {
+        o << "\n    // Notify `dest` of " << e.name << " (" << hex(e.id) << ")\n";
+        o << "    bool send_" << e.name << "(const someip::Endpoint& dest" << (e.args->members.empty() ? "" : ", ") << params(*e.args) << ");\n";
+    }
+    if (!s.fields.empty()) o << "\n";
+    for (const FieldDef& f : s.fields) o << "    someip::Field<" << f.type.cpp << "> " << f.name << ";\n";
+    o << "};\n\n";
+
+    // Proxy
+    std::string P = S + "Proxy";
+    o << "// Client side of " << S << ": typed requests, and callbacks for responses, field values and\n";
+    o << "// events. Pass every received message to handle().\n";
+    o << "class " << P << " : public someip::ProxyBase {\n";
+    o << "public:\n";
+    o << "    " << P << "(std::shared_ptr<someip::Transport> transport, someip::Endpoint server, someip::ClientId client = 1)\n";
+    o << "        : ProxyBase(" << S << "::SERVICE_ID, " << S << "::INTERFACE_VERSION, std::move(transport), std::move(server), client) {}\n\n";
+    o << "    // Requests; false if not sent\n";
+    for (const Method& m : s.methods) o << "    bool " << m.name << "(" << params(*m.request) << ");\n";
+    for (const FieldDef& f : s.fields) {
+        if (f.getter) o << "    bool get_" << f.name << "();\n";
+        if (f.setter) o << "    bool set_" << f.name << "(" << arg_type(f.type) << " value);\n";
+    }
+    o << "\n    // Callbacks run on the thread calling handle(). Method responses pass a view of the\n";
+    o << "    // response, or nullptr with the error code.\n";
+    for (const Method& m : s.methods) {
+        o << "    using " << camel(m.name) << "Callback = std::function<void(someip::ReturnCode, const " << m.response->name << "::View*)>;\n";
+        o << "    void on_" << m.name << "(" << camel(m.name) << "Callback cb) { on_" << m.name << "_ = std::move(cb); }\n";
+    }
+    for (const FieldDef& f : s.fields) {
+        o << "    // " << f.name << ": getter and setter responses and notifications\n";
+        o << "    void on_" << f.name << "(std::function<void(const " << f.type.cpp << "&)> cb) { on_" << f.name << "_ = std::move(cb); }\n";
+    }
+    for (const Event& e : s.events) {
+        o << "    void on_" << e.name << "(std::function<void(const " << e.args->name << "::View&)> cb) { on_" << e.name
+          << "_ = std::move(cb); }\n";
+    }
+    o << "\n    // Dispatch a message of this service to its callback; false if it is not one\n";
+    o << "    bool handle(const someip::SomeIpMessage& msg);\n\n";
+    o << "private:\n";
+    for (const Method& m : s.methods) o << "    " << camel(m.name) << "Callback on_" << m.name << "_;\n";
+    for (const FieldDef& f : s.fields) o << "    std::function<void(const " << f.type.cpp << "&)> on_" << f.name << "_;\n";
+    for (const Event& e : s.events) o << "    std::function<void(const " << e.args->name << "::View&)> on_" << e.name << "_;\n";
+    o << "};\n\n";
+
+    // Skeleton definitions
+    o << "inline void " << S << "Skeleton::attach(someip::ServiceRegistry& registry, std::shared_ptr<someip::Transport> transport) {\n";
+    o << "    set_transport(transport);\n";
+    for (const Method& m : s.methods) {
+        o << "    registry.register_method(" << S << "::SERVICE_ID, " << S << "::" << upper(m.name) << ", someip::BufferMethodHandler(\n";
+        o << "        [this](const someip::Payload& in, const someip::Endpoint& src, someip::SerializationBuffer& out) {\n";
+        o << "            if (!" << m.request->name << "::fits(in.size())) return someip::ReturnCode::E_MALFORMED_MESSAGE;\n";
+        o << "            " << m.response->name << " res;\n";
+        o << "            someip::ReturnCode rc = " << m.name << "(" << m.request->name << "::View(in.data(), in.size()), res, src);\n";
+        o << "            if (rc == someip::ReturnCode::E_OK) someip::wire::append(out, res);\n";
+        o << "            return rc;\n";
+        o << "        }));\n";
+    }
+    for (const FieldDef& f : s.fields) o << "    " << f.name << ".attach(registry, transport);\n";
+    o << "}\n\n";
+    for (const Event& e : s.events) {
+        o << "inline bool " << S << "Skeleton::send_" << e.name << "(const someip::Endpoint& dest" << (e.args->members.empty() ? "" : ", ")
+          << params(*e.args) << ") {\n";
+        emit_fill(o, *e.args);
+        o << "    return send_event(" << S << "::" << upper(e.name) << ", d, dest);\n";
+        o << "}\n\n";
+    }
+
+    // Proxy definitions
+    for (const Method& m : s.methods) {
+        o << "inline bool " << P << "::" << m.name << "(" << params(*m.request) << ") {\n";
+        emit_fill(o, *m.request);
+        o << "    return send_request(" << S << "::" << upper(m.name) << ", d);\n";
+        o << "}\n\n";
+    }
+    for (const FieldDef& f : s.fields) {
+        if (f.getter) {
+            o << "inline bool " << P << "::get_" << f.name << "() {\n";
+            o << "    someip::Payload d = someip::wire::datagram(0);\n";
+            o << "    return send_request(" << S << "::" << upper(f.name) << "_GET, d);\n";
+            o << "}\n\n";
+        }
+        if (f.setter) {
+            o << "inline bool " << P << "::set_" << f.name << "(" << arg_type(f.type) << " value) {\n";
+            o << "    someip::Payload d = someip::wire::datagram(" << (f.type.kind == Type::BYTES ? "value.size" : "someip::wire::size_of(value)") << ");\n";
+            o << "    someip::wire::put(d.data() + someip::SomeIpHeader::SIZE, value);\n";
+            o << "    return send_request(" << S << "::" << upper(f.name) << "_SET, d);\n";
+            o << "}\n\n";
+        }
+    }
+    o << "inline bool " << P << "::handle(const someip::SomeIpMessage& msg) {\n";
+    o << "    if (msg.header.service_id != " << S << "::SERVICE_ID) return false;\n";
+    o << "    someip::Payload scratch;\n";
+    o << "    const someip::Payload* payload = checked_payload(msg, scratch);\n";
+    o << "    if (!payload) return true;  // failed its protection check\n";
+    o << "    const auto rc = static_cast<someip::ReturnCode>(msg.header.return_code);\n";
+    o << "    const bool ok = rc == someip::ReturnCode::E_OK && msg.header.message_type != static_cast<uint8_t>(someip::MessageType::ERR);\n";
+    if (s.methods.empty() && s.fields.empty()) o << "    (void)ok;\n";
+    o << "    switch (msg.header.method_id) {\n";
+    for (const Method& m : s.methods) {
+        const std::string& R = m.response->name;
+        o << "    case " << S << "::" << upper(m.name) << ":\n";
+        o << "        if (on_" << m.name << "_) {\n";
+        o << "            if (ok && " << R << "::fits(payload->size())) {\n";
+        o << "                " << R << "::View view(payload->data(), payload->size());\n";
+        o << "                on_" << m.name << "_(rc, &view);\n";
+        o << "            } else {\n";
+        o << "                on_" << m.name << "_(ok ? someip::ReturnCode::E_MALFORMED_MESSAGE : rc, nullptr);\n";
+        o << "            }\n";
+        o << "        }\n";
+        o << "        return true;\n";
+    }
+    for (const FieldDef& f : s.fields) {
+        if (f.getter) o << "    case " << S << "::" << upper(f.name) << "_GET:\n";
+        if (f.setter) o << "    case " << S << "::" << upper(f.name) << "_SET:\n";
+        if (f.notifier) o << "    case " << S << "::" << upper(f.name) << "_NOTIFY:\n";
+        o << "        if (on_" << f.name << "_ && ok) {\n";
+        o << "            " << f.type.cpp << " value;\n";
+        o << "            if (someip::wire::decode(*payload, value)) on_" << f.name << "_(value);\n";
+        o << "        }\n";
+        o << "        return true;\n";
+    }
+    for (const Event& e : s.events) {
+        o << "    case " << S << "::" << upper(e.name) << ":\n";
+        o << "        if (on_" << e.name << "_ && " << e.args->name << "::fits(payload->size())) {\n";
+        o << "            on_" << e.name << "_(" << e.args->name << "::View(payload->data(), payload->size()));\n";
+        o << "        }\n";
+        o << "        return true;\n";
+    }
+    o << "    default:\n";
+    o << "        return false;\n";
+    o << "    }\n";
+    o << "}\n\n";
+}
+
+std::string emit(const Interface& ifc, const std::string& source, const std::string& guard) {
+    std::ostringstream o;
+    o << "// Generated by someip_idlc from " << source << ". Do not edit.\n";
+    o << "#ifndef " << guard << "\n";
+    o << "#define " << guard << "\n\n";
+    o << "#include \"someip/idl_support.hpp\"\n";
+    o << "#include <functional>\n";
+    o << "#include <memory>\n\n";
+    std::string ns;
+    for (const std::string& part : ifc.package) ns += (ns.empty() ? "" : "::") + part;
+    if (!ns.empty()) o << "namespace " << ns << " {\n\n";
+    for (const auto& r : ifc.records) emit_record(o, *r);
+    for (const Service& s : ifc.services) emit_service(o, s);
+    if (!ns.empty()) o << "} // namespace " << ns << "\n\n";
+    o << "#endif // " << guard << "\n";
+    return o.str();
+}
+
+std::string guard_for(const std::string& path) {
+    size_t slash = path.find_last_of("/\\");
+    std::string base = slash == std::string::npos ? path : path.substr(slash + 1);
+    std::string g = "SOMEIP_GENERATED_";
+    for (char c : base) g += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+    return g;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string input, output;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-o" && i + 1 < argc) output = argv[++i];
+        else if (input.empty() && arg[0] != '-') input = arg;
+        else input.clear(), i = argc;
+    }
+    if (input.empty()) {
+        std::cerr << "usage: someip_idlc <input.sidl> [-o <output.hpp>]\n";
+        return 2;
+    }
+    std::ifstream in(input);
+    if (!in) {
+        std::cerr << input << ": cannot open\n";
+        return 1;
+    }
+    std::stringstream src;
+    src << in.rdbuf();
+
+    std::string code;
+    try {
+        Interface ifc = Parser(lex(src.str())).parse();
+        size_t slash = input.find_last_of("/\\");
+        code = emit(ifc, slash == std::string::npos ? input : input.substr(slash + 1), guard_for(output.empty() ? input + ".hpp" : output));
+    } catch (const Error& e) {
+        std::cerr << input << ":" << e.line << ": error: " << e.message << "\n";
+        return 1;
+    }
+    if (output.empty()) {
+        std::cout << code;
+        return 0;
+    }
+    // Leave an unchanged header alone so dependents are not rebuilt
+    std::ifstream existing(output);
+    std::stringstream old;
+    old << existing.rdbuf();
+    if (existing && old.str() == code) return 0;
+    existing.close();
+    std::ofstream out(output);
+    out << code;
+    if (!out) {
+        std::cerr << output << ": cannot write\n";
+        return 1;
+    }
+    return 0;
+}
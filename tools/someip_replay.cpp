@@ -0,0 +1,160 @@
+// Replays the SOME/IP requests of a pcap capture against a server and reports the
+// achieved send rate and response latency percentiles.
+#include "someip/api.hpp"
+#include "someip/capture.hpp"
+#include "someip/metrics.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace someip;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::string capture;
+    std::string target_ip;
+    uint16_t target_port = 0;
+    std::string bind_ip = "127.0.0.1";
+    uint16_t bind_port = 0;
+    uint16_t filter_port = 0;
+    bool fast = false;
+    double speed = 1.0;
+    int wait_ms = 1000;
+};
+
+void usage() {
+    std::cerr << "usage: someip_replay <capture.pcap> [options]\n"
+                 "  --target ip:port  send every request here (default: recorded destination)\n"
+                 "  --bind ip:port    local endpoint for requests and responses (default 127.0.0.1:0)\n"
+                 "  --port N          only replay requests recorded towards port N\n"
+                 "  --fast            send as fast as possible instead of at recorded timing\n"
+                 "  --speed X         scale recorded timing (2 = twice as fast)\n"
+                 "  --wait-ms N       time to wait for outstanding responses (default 1000)\n";
+}
+
+bool split_endpoint(const std::string& s, std::string& ip, uint16_t& port) {
+    auto colon = s.rfind(':');
+    if (colon == std::string::npos) return false;
+    ip = s.substr(0, colon);
+    port = static_cast<uint16_t>(std::atoi(s.c_str() + colon + 1));
+    return true;
+}
+
+bool parse_args(int argc, char** argv, Options& o) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : ""; };
+        if (a == "--target") { if (!split_endpoint(value(), o.target_ip, o.target_port)) return false; }
+        else if (a == "--bind") { if (!split_endpoint(value(), o.bind_ip, o.bind_port)) return false; }
+        else if (a == "--port") o.filter_port = static_cast<uint16_t>(std::atoi(value()));
+        else if (a == "--fast") o.fast = true;
+        else if (a == "--speed") o.speed = std::atof(value());
+        else if (a == "--wait-ms") o.wait_ms = std::atoi(value());
+        else if (a[0] != '-' && o.capture.empty()) o.capture = a;
+        else return false;
+    }
+    return !o.capture.empty() && o.speed > 0;
+}
+
+struct Request {
+    Uint64 offset_ns;  // relative to the first request
+    Endpoint dest;
+    Payload data;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        usage();
+        return 2;
+    }
+
+    PcapReader reader;
+    if (!reader.open(opts.capture)) {
+        std::cerr << "[ERROR] Cannot read capture " << opts.capture << "\n";
+        return 1;
+    }
+    std::vector<Request> requests;
+    CapturedPacket pkt;
+    Uint64 first_ts = 0;
+    while (reader.next(pkt)) {
+        if (pkt.data.size() < SomeIpHeader::SIZE) continue;
+        if (pkt.data[14] != static_cast<uint8_t>(MessageType::REQUEST)) continue;
+        if (opts.filter_port && pkt.dst_port != opts.filter_port) continue;
+        if (requests.empty()) first_ts = pkt.timestamp_ns;
+        Endpoint dest = opts.target_ip.empty()
+            ? Endpoint(ipv4_to_string(pkt.dst_ip), pkt.dst_port)
+            : Endpoint(opts.target_ip, opts.target_port);
+        requests.push_back({pkt.timestamp_ns - first_ts, dest, std::move(pkt.data)});
+    }
+    if (requests.empty()) {
+        std::cerr << "[ERROR] No SOME/IP requests found in " << opts.capture << "\n";
+        return 1;
+    }
+
+    // Session IDs are rewritten to count through 1..0xFFFF (0 means "no session"), so every
+    // response maps to one send time. A slot still waiting when its session comes round again
+    // is counted lost: a late answer for it could not be told apart from the new request's.
+    static std::array<std::atomic<Uint64>, 65536> sent_at{};
+    metrics::LatencyHistogram latency;
+    std::atomic<Uint64> responses{0};
+    Uint64 overtaken = 0;
+    auto now_ns = [] {
+        return static_cast<Uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count());
+    };
+
+    auto ep = create_udp_endpoint(opts.bind_ip, opts.bind_port);
+    if (!ep) {
+        std::cerr << "[ERROR] Failed to create UDP endpoint\n";
+        return 1;
+    }
+    ep->set_callback([&](const SomeIpMessage& msg, const Endpoint&, const Endpoint&, TransportProtocol) {
+        if (msg.header.message_type != static_cast<uint8_t>(MessageType::RESPONSE) &&
+            msg.header.message_type != static_cast<uint8_t>(MessageType::ERR)) return;
+        Uint64 t = sent_at[msg.header.session_id].exchange(0, std::memory_order_acq_rel);
+        if (!t) return;
+        latency.record(now_ns() - t);
+        responses.fetch_add(1, std::memory_order_relaxed);
+    });
+
+    Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < requests.size(); ++i) {
+        Request& r = requests[i];
+        if (!opts.fast) {
+            auto due = start + std::chrono::nanoseconds(static_cast<Uint64>(double(r.offset_ns) / opts.speed));
+            std::this_thread::sleep_until(due);
+        }
+        uint16_t session = static_cast<uint16_t>(i % 0xFFFF + 1);
+        r.data[10] = static_cast<uint8_t>(session >> 8);
+        r.data[11] = static_cast<uint8_t>(session);
+        if (sent_at[session].exchange(now_ns(), std::memory_order_acq_rel)) ++overtaken;
+        ep->send_to(r.data, r.dest);
+    }
+    double send_secs = std::chrono::duration<double>(Clock::now() - start).count();
+
+    auto deadline = Clock::now() + std::chrono::milliseconds(opts.wait_ms);
+    while (responses.load() < requests.size() && Clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ep->stop();
+
+    Uint64 got = responses.load();
+    printf("requests=%zu responses=%llu lost=%llu (session reused while waiting=%llu) duration=%.3fs rate=%.0f msg/s\n",
+           requests.size(), (unsigned long long)got, (unsigned long long)(requests.size() - got),
+           (unsigned long long)overtaken, send_secs, send_secs > 0 ? double(requests.size()) / send_secs : 0.0);
+    printf("latency_us p50=%.1f p90=%.1f p99=%.1f p999=%.1f max=%.1f\n",
+           latency.percentile(0.50) / 1e3, latency.percentile(0.90) / 1e3, latency.percentile(0.99) / 1e3,
+           latency.percentile(0.999) / 1e3, latency.max() / 1e3);
+    return 0;
+}